@@ -0,0 +1,105 @@
+/*    Copyright (c) 2010-2018, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#include <memory>
+#include <stdexcept>
+
+#include <Tudat/Mathematics/Interpolators/createInterpolator.h>
+
+#include "covariancePropagation.h"
+
+namespace tudat_applications
+{
+
+//! Function to propagate a state covariance over a sequence of consecutive arcs, by chaining the state transition matrices
+std::map< double, Eigen::Matrix6d > propagateCovarianceOverArcs(
+        const std::vector< std::map< double, Eigen::MatrixXd > >& stateTransitionMatrixHistories,
+        const Eigen::Matrix6d& initialCovariance,
+        const std::vector< double >& outputEpochs )
+{
+    const int numberOfArcs = stateTransitionMatrixHistories.size( );
+    for( int i = 0; i < numberOfArcs; i++ )
+    {
+        if( stateTransitionMatrixHistories.at( i ).size( ) < 2 )
+        {
+            throw std::runtime_error( "Error when propagating covariance, state transition matrix history is too short" );
+        }
+        if( stateTransitionMatrixHistories.at( i ).begin( )->second.rows( ) != 6 ||
+                stateTransitionMatrixHistories.at( i ).begin( )->second.cols( ) != 6 )
+        {
+            throw std::runtime_error( "Error when propagating covariance, state transition matrices must be 6x6" );
+        }
+    }
+
+    // Chain state transition matrices to obtain covariance at the start of each arc
+    std::vector< Eigen::Matrix6d > arcInitialCovariances;
+    Eigen::Matrix6d currentCovariance = initialCovariance;
+    for( int i = 0; i < numberOfArcs; i++ )
+    {
+        arcInitialCovariances.push_back( currentCovariance );
+        const Eigen::Matrix6d arcStateTransitionMatrix = stateTransitionMatrixHistories.at( i ).rbegin( )->second;
+        currentCovariance = arcStateTransitionMatrix * currentCovariance * arcStateTransitionMatrix.transpose( );
+    }
+
+    std::map< double, Eigen::Matrix6d > covarianceHistory;
+    if( outputEpochs.size( ) == 0 )
+    {
+        // Map covariance to all epochs (in reverse arc order, so that the start of an arc takes precedence at its boundary)
+        for( int i = numberOfArcs - 1; i >= 0; i-- )
+        {
+            for( const auto& matrixIterator : stateTransitionMatrixHistories.at( i ) )
+            {
+                const Eigen::Matrix6d stateTransitionMatrix = matrixIterator.second;
+                covarianceHistory[ matrixIterator.first ] =
+                        stateTransitionMatrix * arcInitialCovariances.at( i ) * stateTransitionMatrix.transpose( );
+            }
+        }
+    }
+    else
+    {
+        // Map covariance to output epochs, interpolating the state transition matrix on the arc containing each epoch
+        std::vector< std::shared_ptr< tudat::interpolators::OneDimensionalInterpolator< double, Eigen::MatrixXd > > >
+                stateTransitionMatrixInterpolators( numberOfArcs );
+        for( unsigned int j = 0; j < outputEpochs.size( ); j++ )
+        {
+            const double epoch = outputEpochs.at( j );
+            int arcIndex = -1;
+            for( int i = 0; i < numberOfArcs; i++ )
+            {
+                if( epoch >= stateTransitionMatrixHistories.at( i ).begin( )->first &&
+                        epoch <= stateTransitionMatrixHistories.at( i ).rbegin( )->first )
+                {
+                    arcIndex = i;
+                    break;
+                }
+            }
+            if( arcIndex < 0 )
+            {
+                throw std::runtime_error( "Error when propagating covariance, output epoch is not on any arc" );
+            }
+
+            if( stateTransitionMatrixInterpolators.at( arcIndex ) == nullptr )
+            {
+                stateTransitionMatrixInterpolators.at( arcIndex ) =
+                        tudat::interpolators::createOneDimensionalInterpolator< double, Eigen::MatrixXd >(
+                            stateTransitionMatrixHistories.at( arcIndex ),
+                            std::make_shared< tudat::interpolators::LagrangeInterpolatorSettings >( 8 ) );
+            }
+            const Eigen::Matrix6d stateTransitionMatrix =
+                    stateTransitionMatrixInterpolators.at( arcIndex )->interpolate( epoch );
+            covarianceHistory[ epoch ] =
+                    stateTransitionMatrix * arcInitialCovariances.at( arcIndex ) * stateTransitionMatrix.transpose( );
+        }
+    }
+
+    return covarianceHistory;
+}
+
+} // namespace tudat_applications
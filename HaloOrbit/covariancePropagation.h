@@ -0,0 +1,47 @@
+/*    Copyright (c) 2010-2018, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_COVARIANCEPROPAGATION_H
+#define TUDAT_COVARIANCEPROPAGATION_H
+
+#include <map>
+#include <vector>
+
+#include <Tudat/Basics/basicTypedefs.h>
+
+namespace tudat_applications
+{
+
+//! Function to propagate a state covariance over a sequence of consecutive arcs, by chaining the state transition matrices
+/*!
+ *  Function to propagate a (Cartesian) state covariance over a sequence of consecutive arcs, by chaining the state transition
+ *  matrices of the arcs (linear covariance analysis). On each arc, the covariance is mapped from the start of the arc as
+ *  P( t ) = Phi( t, t_0 ) P( t_0 ) Phi( t, t_0 )^T, and the covariance at the end of each arc is used as the covariance at the
+ *  start of the next arc. Since each state transition matrix history only depends on its own arc, the histories can be
+ *  computed concurrently, after which the (inexpensive) chaining is performed by this function.
+ *
+ *  If no output epochs are provided, the covariance is computed at all epochs of the state transition matrix histories
+ *  (at arc boundaries, the covariance at the start of the next arc is stored). Otherwise, it is computed only at the output
+ *  epochs, for which the state transition matrix is interpolated on the arc containing the epoch (8th order Lagrange
+ *  interpolation).
+ *  \param stateTransitionMatrixHistories State transition matrix history of each arc, w.r.t. the start of the arc (6x6
+ *  matrices, arcs in chronological order)
+ *  \param initialCovariance Covariance at the start of the first arc
+ *  \param outputEpochs Epochs at which the covariance is to be computed (all epochs of the histories if empty)
+ *  \return Covariance history
+ */
+std::map< double, Eigen::Matrix6d > propagateCovarianceOverArcs(
+        const std::vector< std::map< double, Eigen::MatrixXd > >& stateTransitionMatrixHistories,
+        const Eigen::Matrix6d& initialCovariance,
+        const std::vector< double >& outputEpochs = std::vector< double >( ) );
+
+} // namespace tudat_applications
+
+#endif // TUDAT_COVARIANCEPROPAGATION_H
@@ -0,0 +1,211 @@
+/*    Copyright (c) 2010-2018, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <stdexcept>
+
+#include <Eigen/LU>
+
+#include <Tudat/InputOutput/matrixTextFileReader.h>
+#include <Tudat/SimulationSetup/PropagationSetup/propagationCR3BPFullProblem.h>
+
+#include "haloFamilyTable.h"
+#include "poincareSectionMatching.h"
+
+namespace tudat_applications
+{
+
+//! Function to compute the Jacobi constant of a state in the CR3BP
+double computeJacobiConstant( const double massParameter, const Eigen::Vector6d& normalizedState )
+{
+    const double distanceToPrimary = ( normalizedState.segment( 0, 3 ) -
+                                       Eigen::Vector3d( -massParameter, 0.0, 0.0 ) ).norm( );
+    const double distanceToSecondary = ( normalizedState.segment( 0, 3 ) -
+                                         Eigen::Vector3d( 1.0 - massParameter, 0.0, 0.0 ) ).norm( );
+    return normalizedState( 0 ) * normalizedState( 0 ) + normalizedState( 1 ) * normalizedState( 1 ) +
+            2.0 * ( 1.0 - massParameter ) / distanceToPrimary + 2.0 * massParameter / distanceToSecondary -
+            normalizedState.segment( 3, 3 ).squaredNorm( );
+}
+
+//! Constructor from a table of family members
+HaloFamilyTable::HaloFamilyTable( const Eigen::MatrixXd& familyMembers, const double massParameter ):
+    familyMembers_( familyMembers ), massParameter_( massParameter )
+{
+    createParameterIndices( );
+}
+
+//! Constructor from a file containing a table of family members
+HaloFamilyTable::HaloFamilyTable( const std::string& fileName, const double massParameter ):
+    familyMembers_( tudat::input_output::readMatrixFromFile( fileName ) ), massParameter_( massParameter )
+{
+    createParameterIndices( );
+}
+
+//! Function to check the table, and construct the sorted parameter indices and splines
+void HaloFamilyTable::createParameterIndices( )
+{
+    if( familyMembers_.cols( ) != 7 )
+    {
+        throw std::runtime_error( "Error when creating halo family table, table must have 7 columns (period and state)" );
+    }
+    if( familyMembers_.rows( ) < 3 )
+    {
+        throw std::runtime_error( "Error when creating halo family table, table must have at least 3 family members" );
+    }
+
+    const int numberOfMembers = familyMembers_.rows( );
+    for( int i = 0; i < 3; i++ )
+    {
+        const HaloFamilyParameter parameter = static_cast< HaloFamilyParameter >( i );
+
+        // Determine range of parameter, and check whether it is strictly monotonic along family
+        const double firstDifference = computeParameterValue( parameter, 1 ) - computeParameterValue( parameter, 0 );
+        parameterRanges_[ i ] = std::make_pair( computeParameterValue( parameter, 0 ), computeParameterValue( parameter, 0 ) );
+        isParameterMonotonic_[ i ] = true;
+        for( int j = 1; j < numberOfMembers; j++ )
+        {
+            const double parameterValue = computeParameterValue( parameter, j );
+            parameterRanges_[ i ].first = std::min( parameterRanges_[ i ].first, parameterValue );
+            parameterRanges_[ i ].second = std::max( parameterRanges_[ i ].second, parameterValue );
+            if( !( ( parameterValue - computeParameterValue( parameter, j - 1 ) ) * firstDifference > 0.0 ) )
+            {
+                isParameterMonotonic_[ i ] = false;
+            }
+        }
+
+        if( !isParameterMonotonic_[ i ] )
+        {
+            continue;
+        }
+
+        // Sort members by parameter value, and create splines (binary search lookup, which is independent of previous calls)
+        std::map< double, Eigen::Vector6d > initialStateMap;
+        std::map< double, double > periodMap;
+        for( int j = 0; j < numberOfMembers; j++ )
+        {
+            initialStateMap[ computeParameterValue( parameter, j ) ] = familyMembers_.block( j, 1, 1, 6 ).transpose( );
+            periodMap[ computeParameterValue( parameter, j ) ] = familyMembers_( j, 0 );
+        }
+        initialStateInterpolators_[ i ] =
+                std::make_shared< tudat::interpolators::CubicSplineInterpolator< double, Eigen::Vector6d > >(
+                    initialStateMap, tudat::interpolators::binarySearch );
+        periodInterpolators_[ i ] = std::make_shared< tudat::interpolators::CubicSplineInterpolator< double, double > >(
+                    periodMap, tudat::interpolators::binarySearch );
+    }
+}
+
+//! Function to compute the value of a parameter for a family member
+double HaloFamilyTable::computeParameterValue( const HaloFamilyParameter parameter, const int memberIndex ) const
+{
+    switch( parameter )
+    {
+    case halo_amplitude_parameter:
+        return std::fabs( familyMembers_( memberIndex, 3 ) );
+    case halo_jacobi_constant_parameter:
+        return computeJacobiConstant( massParameter_, familyMembers_.block( memberIndex, 1, 1, 6 ).transpose( ) );
+    case halo_period_parameter:
+        return familyMembers_( memberIndex, 0 );
+    default:
+        throw std::runtime_error( "Error, halo family parameter not recognized" );
+    }
+}
+
+//! Function to retrieve the interpolated initial state of the family member with the given parameter value
+Eigen::Vector6d HaloFamilyTable::getInitialState(
+        const HaloFamilyParameter parameter, const double parameterValue, double& period ) const
+{
+    const std::pair< double, double > parameterRange = getParameterRange( parameter );
+    if( !isParameterMonotonic_[ parameter ] )
+    {
+        throw std::runtime_error( "Error when retrieving halo family member, parameter is not monotonic along family" );
+    }
+    if( !( parameterValue >= parameterRange.first && parameterValue <= parameterRange.second ) )
+    {
+        throw std::runtime_error( "Error when retrieving halo family member, parameter value is outside range of table" );
+    }
+
+    period = periodInterpolators_[ parameter ]->interpolate( parameterValue );
+    return initialStateInterpolators_[ parameter ]->interpolate( parameterValue );
+}
+
+//! Function to correct an initial state from the table, such that it is periodic in the CR3BP
+int HaloFamilyTable::correctInitialState(
+        Eigen::Vector6d& initialState,
+        double& period,
+        const std::shared_ptr< tudat::numerical_integrators::IntegratorSettings< > > integratorSettings,
+        const double velocityTolerance,
+        const int maximumNumberOfIterations ) const
+{
+    // Propagate over (somewhat more than) half a period, and retrieve state and time at the crossing of the x-z plane
+    const double initialTime = integratorSettings->initialTime_;
+    const int crossingDirection = ( initialState( 4 ) > 0.0 ) ? -1 : 1;
+    auto computeHalfPeriodCrossing = [ & ]( const Eigen::Vector6d& currentInitialState, double& halfPeriod )
+    {
+        std::vector< std::map< double, Eigen::Vector6d > > stateHistory = { tudat::propagators::performCR3BPIntegration(
+                        integratorSettings, massParameter_, currentInitialState, initialTime + 0.75 * period, true ) };
+        PoincareSection section = computePoincareSection( stateHistory, massParameter_, 1, 0.0, crossingDirection );
+        if( section.getNumberOfPoints( ) == 0 )
+        {
+            throw std::runtime_error( "Error when correcting halo initial state, no crossing of x-z plane found" );
+        }
+        halfPeriod = section.times( 0 ) - initialTime;
+        return Eigen::Vector6d( section.states.col( 0 ) );
+    };
+
+    const double perturbationSize = 1.0E-8;
+    for( int i = 0; i <= maximumNumberOfIterations; i++ )
+    {
+        double halfPeriod;
+        const Eigen::Vector6d crossingState = computeHalfPeriodCrossing( initialState, halfPeriod );
+        const Eigen::Vector2d crossingVelocity( crossingState( 3 ), crossingState( 5 ) );
+        period = 2.0 * halfPeriod;
+        if( crossingVelocity.cwiseAbs( ).maxCoeff( ) < velocityTolerance )
+        {
+            return i;
+        }
+        else if( i == maximumNumberOfIterations )
+        {
+            break;
+        }
+
+        // Compute sensitivity of x- and z-velocity at crossing to initial x-coordinate and y-velocity, and apply correction
+        Eigen::Matrix2d crossingVelocityPartials;
+        const int correctedEntries[ 2 ] = { 0, 4 };
+        for( int j = 0; j < 2; j++ )
+        {
+            Eigen::Vector6d perturbedInitialState = initialState;
+            perturbedInitialState( correctedEntries[ j ] ) += perturbationSize;
+            double perturbedHalfPeriod;
+            const Eigen::Vector6d perturbedCrossingState = computeHalfPeriodCrossing( perturbedInitialState, perturbedHalfPeriod );
+            crossingVelocityPartials.col( j ) =
+                    ( Eigen::Vector2d( perturbedCrossingState( 3 ), perturbedCrossingState( 5 ) ) - crossingVelocity ) /
+                    perturbationSize;
+        }
+        const Eigen::Vector2d correction = -crossingVelocityPartials.fullPivLu( ).solve( crossingVelocity );
+        initialState( 0 ) += correction( 0 );
+        initialState( 4 ) += correction( 1 );
+    }
+
+    throw std::runtime_error( "Error when correcting halo initial state, tolerance not met in maximum number of iterations" );
+}
+
+//! Function to retrieve the range of values of a parameter in the table
+std::pair< double, double > HaloFamilyTable::getParameterRange( const HaloFamilyParameter parameter ) const
+{
+    if( parameter < 0 || parameter > 2 )
+    {
+        throw std::runtime_error( "Error, halo family parameter not recognized" );
+    }
+    return parameterRanges_[ parameter ];
+}
+
+} // namespace tudat_applications
@@ -0,0 +1,165 @@
+/*    Copyright (c) 2010-2018, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_HALOFAMILYTABLE_H
+#define TUDAT_HALOFAMILYTABLE_H
+
+#include <memory>
+#include <string>
+
+#include <Tudat/Basics/basicTypedefs.h>
+#include <Tudat/Mathematics/Interpolators/cubicSplineInterpolator.h>
+#include <Tudat/Mathematics/NumericalIntegrators/createNumericalIntegrator.h>
+
+namespace tudat_applications
+{
+
+//! Enum defining the parameters by which a member of a halo orbit family can be selected
+enum HaloFamilyParameter
+{
+    halo_amplitude_parameter = 0,
+    halo_jacobi_constant_parameter = 1,
+    halo_period_parameter = 2
+};
+
+//! Function to compute the Jacobi constant of a state in the CR3BP
+/*!
+ *  Function to compute the Jacobi constant of a state in the CR3BP, C = x^2 + y^2 + 2 (1 - mu) / r_1 + 2 mu / r_2 - v^2
+ *  \param massParameter Mass parameter of the CR3BP
+ *  \param normalizedState State in normalized corotating coordinates
+ *  \return Jacobi constant of the state
+ */
+double computeJacobiConstant( const double massParameter, const Eigen::Vector6d& normalizedState );
+
+//! Class for the retrieval of initial conditions of a halo orbit family member with a given amplitude, Jacobi constant or period
+/*!
+ *  Class for the retrieval of initial conditions of a halo orbit family member with a given amplitude, Jacobi constant or
+ *  period, in the CR3BP. The family is loaded once (from a table with one member per row, containing the period and the
+ *  normalized corotating initial state at the crossing of the x-z plane, as in L2_2_initial_conditions_ES.txt). For each of the
+ *  three parameters, the members are sorted by parameter value, and a natural cubic spline of the initial state and period is
+ *  constructed with the parameter as independent variable. An initial state is then retrieved by a binary search in the sorted
+ *  parameter values and the evaluation of a single spline segment (O(log n) in the number of family members), without
+ *  modifying the table, so that a single table can be used by concurrent lookups.
+ *
+ *  The amplitude is defined as the absolute value of the z-coordinate of the initial state (normalized units). A parameter can
+ *  only be used for lookups if it is strictly monotonic along the family (as ordered in the table); otherwise, a value of the
+ *  parameter does not identify a single member. Since the interpolated initial state is only periodic to within the accuracy of
+ *  the interpolation, it can be polished by a differential correction (see correctInitialState).
+ */
+class HaloFamilyTable
+{
+public:
+
+    //! Constructor from a table of family members
+    /*!
+     *  Constructor from a table of family members
+     *  \param familyMembers Table of family members, one member per row: period, followed by the normalized corotating
+     *  initial state (at the crossing of the x-z plane), in family order
+     *  \param massParameter Mass parameter of the CR3BP
+     */
+    HaloFamilyTable( const Eigen::MatrixXd& familyMembers, const double massParameter );
+
+    //! Constructor from a file containing a table of family members
+    /*!
+     *  Constructor from a file containing a table of family members (format as in the other constructor)
+     *  \param fileName Name of file with the table of family members
+     *  \param massParameter Mass parameter of the CR3BP
+     */
+    HaloFamilyTable( const std::string& fileName, const double massParameter );
+
+    //! Function to retrieve the interpolated initial state of the family member with the given parameter value
+    /*!
+     *  Function to retrieve the interpolated initial state of the family member with the given parameter value
+     *  \param parameter Parameter by which the family member is selected
+     *  \param parameterValue Value of the parameter (must be within the range of the table)
+     *  \param period Interpolated period of the family member (returned by reference)
+     *  \return Interpolated normalized corotating initial state of the family member
+     */
+    Eigen::Vector6d getInitialState( const HaloFamilyParameter parameter, const double parameterValue, double& period ) const;
+
+    //! Function to retrieve the interpolated initial state of the family member with the given parameter value
+    Eigen::Vector6d getInitialState( const HaloFamilyParameter parameter, const double parameterValue ) const
+    {
+        double period;
+        return getInitialState( parameter, parameterValue, period );
+    }
+
+    //! Function to correct an initial state from the table, such that it is periodic in the CR3BP
+    /*!
+     *  Function to correct an initial state from the table (or any initial state at the crossing of the x-z plane, with only x,
+     *  z and y-velocity non-zero) such that it is periodic in the CR3BP, by single shooting over half a period. Using the
+     *  symmetry of halo orbits w.r.t. the x-z plane, the x-coordinate and y-velocity are corrected (with the amplitude
+     *  fixed) until the x- and z-velocity at the next crossing of the x-z plane are zero. The sensitivities are computed by
+     *  finite differences (two additional half-period propagations per iteration).
+     *  \param initialState Initial state that is to be corrected (modified by reference)
+     *  \param period Estimated period of the orbit (used to set the propagation time); corrected period on output
+     *  \param integratorSettings Settings for the integration of the CR3BP (initial time must be zero)
+     *  \param velocityTolerance Tolerance on the x- and z-velocity at the crossing of the x-z plane
+     *  \param maximumNumberOfIterations Maximum number of iterations
+     *  \return Number of iterations that was performed (exception thrown if the tolerance is not met)
+     */
+    int correctInitialState(
+            Eigen::Vector6d& initialState,
+            double& period,
+            const std::shared_ptr< tudat::numerical_integrators::IntegratorSettings< > > integratorSettings,
+            const double velocityTolerance = 1.0E-12,
+            const int maximumNumberOfIterations = 10 ) const;
+
+    //! Function to retrieve the range of values of a parameter in the table
+    /*!
+     *  Function to retrieve the range of values of a parameter in the table
+     *  \param parameter Parameter of which the range is to be retrieved
+     *  \return Minimum and maximum value of the parameter
+     */
+    std::pair< double, double > getParameterRange( const HaloFamilyParameter parameter ) const;
+
+    //! Function to retrieve the number of family members in the table
+    int getNumberOfFamilyMembers( ) const
+    {
+        return familyMembers_.rows( );
+    }
+
+    //! Function to retrieve the mass parameter of the CR3BP
+    double getMassParameter( ) const
+    {
+        return massParameter_;
+    }
+
+private:
+
+    //! Function to check the table, and construct the sorted parameter indices and splines
+    void createParameterIndices( );
+
+    //! Function to compute the value of a parameter for a family member
+    double computeParameterValue( const HaloFamilyParameter parameter, const int memberIndex ) const;
+
+    //! Table of family members (period and initial state, one member per row)
+    Eigen::MatrixXd familyMembers_;
+
+    //! Mass parameter of the CR3BP
+    double massParameter_;
+
+    //! Boolean denoting, per parameter, whether the parameter is strictly monotonic along the family
+    bool isParameterMonotonic_[ 3 ];
+
+    //! Minimum and maximum value of each parameter
+    std::pair< double, double > parameterRanges_[ 3 ];
+
+    //! Spline of the initial state as a function of each parameter (nullptr if parameter is not monotonic)
+    std::shared_ptr< tudat::interpolators::CubicSplineInterpolator< double, Eigen::Vector6d > >
+    initialStateInterpolators_[ 3 ];
+
+    //! Spline of the period as a function of each parameter (nullptr if parameter is not monotonic)
+    std::shared_ptr< tudat::interpolators::CubicSplineInterpolator< double, double > > periodInterpolators_[ 3 ];
+};
+
+} // namespace tudat_applications
+
+#endif // TUDAT_HALOFAMILYTABLE_H
@@ -0,0 +1,223 @@
+/*    Copyright (c) 2010-2018, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+#include <Tudat/Astrodynamics/Gravitation/stateDerivativeCircularRestrictedThreeBodyProblem.h>
+
+#include "../kdTree.h"
+#include "../parallelExecution.h"
+#include "poincareSectionMatching.h"
+
+namespace tudat_applications
+{
+
+//! Function to evaluate the cubic Hermite interpolant of the state between two consecutive states
+static Eigen::Vector6d computeHermiteInterpolatedState(
+        const Eigen::Vector6d& initialState, const Eigen::Vector6d& initialStateDerivative,
+        const Eigen::Vector6d& finalState, const Eigen::Vector6d& finalStateDerivative,
+        const double timeInterval, const double normalizedTime )
+{
+    const double s = normalizedTime;
+    return ( 2.0 * s * s * s - 3.0 * s * s + 1.0 ) * initialState +
+            ( s * s * s - 2.0 * s * s + s ) * timeInterval * initialStateDerivative +
+            ( -2.0 * s * s * s + 3.0 * s * s ) * finalState +
+            ( s * s * s - s * s ) * timeInterval * finalStateDerivative;
+}
+
+//! Function to compute the intersections of a set of CR3BP trajectories with a Poincare section
+PoincareSection computePoincareSection(
+        const std::vector< std::map< double, Eigen::Vector6d > >& stateHistories,
+        const double massParameter,
+        const int sectionCoordinateIndex,
+        const double sectionCoordinateValue,
+        const int crossingDirection,
+        const int maximumNumberOfCrossings,
+        const bool isPropagationBackward,
+        const int numberOfThreads )
+{
+    if( sectionCoordinateIndex < 0 || sectionCoordinateIndex > 5 )
+    {
+        throw std::runtime_error( "Error when computing Poincare section, coordinate index must be in range [0,5]" );
+    }
+
+    // Compute intersections of each trajectory (time and state)
+    std::vector< std::vector< std::pair< double, Eigen::Vector6d > > > trajectoryCrossings( stateHistories.size( ) );
+    parallelForEachIndex( stateHistories.size( ), [ & ]( const int trajectoryIndex, const int )
+    {
+        tudat::circular_restricted_three_body_problem::StateDerivativeCircularRestrictedThreeBodyProblem
+                stateDerivativeModel( massParameter );
+        const std::map< double, Eigen::Vector6d >& stateHistory = stateHistories.at( trajectoryIndex );
+        std::vector< std::pair< double, Eigen::Vector6d > >& crossings = trajectoryCrossings.at( trajectoryIndex );
+
+        // Check for crossing on each interval, in order of propagation
+        const int numberOfIntervals = static_cast< int >( stateHistory.size( ) ) - 1;
+        std::map< double, Eigen::Vector6d >::const_iterator forwardIterator = stateHistory.begin( );
+        std::map< double, Eigen::Vector6d >::const_reverse_iterator backwardIterator = stateHistory.rbegin( );
+        for( int i = 0; i < numberOfIntervals; i++ )
+        {
+            if( maximumNumberOfCrossings > 0 && static_cast< int >( crossings.size( ) ) >= maximumNumberOfCrossings )
+            {
+                break;
+            }
+
+            std::map< double, Eigen::Vector6d >::const_iterator initialIterator, finalIterator;
+            if( isPropagationBackward )
+            {
+                finalIterator = std::prev( ( backwardIterator++ ).base( ) );
+                initialIterator = std::prev( finalIterator );
+            }
+            else
+            {
+                initialIterator = forwardIterator++;
+                finalIterator = forwardIterator;
+            }
+
+            // Crossing occurs if the coordinate is on the other side of the section at the end of the interval (or on it)
+            const double initialDifference = initialIterator->second( sectionCoordinateIndex ) - sectionCoordinateValue;
+            const double finalDifference = finalIterator->second( sectionCoordinateIndex ) - sectionCoordinateValue;
+            const bool isIncreasingCrossing = ( initialDifference < 0.0 && finalDifference >= 0.0 );
+            const bool isDecreasingCrossing = ( initialDifference > 0.0 && finalDifference <= 0.0 );
+            if( !( ( isIncreasingCrossing && crossingDirection >= 0 ) || ( isDecreasingCrossing && crossingDirection <= 0 ) ) )
+            {
+                continue;
+            }
+
+            // Locate crossing on Hermite interpolant by bisection
+            const double timeInterval = finalIterator->first - initialIterator->first;
+            const Eigen::Vector6d initialStateDerivative = stateDerivativeModel.computeStateDerivative(
+                        initialIterator->first, initialIterator->second );
+            const Eigen::Vector6d finalStateDerivative = stateDerivativeModel.computeStateDerivative(
+                        finalIterator->first, finalIterator->second );
+            double lowerNormalizedTime = 0.0;
+            double upperNormalizedTime = 1.0;
+            for( int j = 0; j < 50; j++ )
+            {
+                const double normalizedTime = ( lowerNormalizedTime + upperNormalizedTime ) / 2.0;
+                const double difference = computeHermiteInterpolatedState(
+                            initialIterator->second, initialStateDerivative, finalIterator->second,
+                            finalStateDerivative, timeInterval, normalizedTime )( sectionCoordinateIndex ) -
+                        sectionCoordinateValue;
+                if( ( difference < 0.0 ) == ( initialDifference < 0.0 ) )
+                {
+                    lowerNormalizedTime = normalizedTime;
+                }
+                else
+                {
+                    upperNormalizedTime = normalizedTime;
+                }
+            }
+
+            const double normalizedTime = ( lowerNormalizedTime + upperNormalizedTime ) / 2.0;
+            Eigen::Vector6d crossingState = computeHermiteInterpolatedState(
+                        initialIterator->second, initialStateDerivative, finalIterator->second,
+                        finalStateDerivative, timeInterval, normalizedTime );
+            crossingState( sectionCoordinateIndex ) = sectionCoordinateValue;
+            crossings.push_back( std::make_pair( initialIterator->first + normalizedTime * timeInterval, crossingState ) );
+        }
+    }, numberOfThreads );
+
+    // Collect intersections of all trajectories
+    int numberOfPoints = 0;
+    for( unsigned int i = 0; i < trajectoryCrossings.size( ); i++ )
+    {
+        numberOfPoints += trajectoryCrossings.at( i ).size( );
+    }
+
+    PoincareSection section;
+    section.states.resize( 6, numberOfPoints );
+    section.times.resize( numberOfPoints );
+    section.trajectoryIndices.resize( numberOfPoints );
+    int currentPoint = 0;
+    for( unsigned int i = 0; i < trajectoryCrossings.size( ); i++ )
+    {
+        for( unsigned int j = 0; j < trajectoryCrossings.at( i ).size( ); j++ )
+        {
+            section.times( currentPoint ) = trajectoryCrossings.at( i ).at( j ).first;
+            section.states.col( currentPoint ) = trajectoryCrossings.at( i ).at( j ).second;
+            section.trajectoryIndices( currentPoint ) = i;
+            currentPoint++;
+        }
+    }
+    return section;
+}
+
+//! Function to find the best matches between the points on two Poincare sections, ranked by Delta V
+std::vector< PoincareSectionMatch > matchPoincareSections(
+        const PoincareSection& firstSection,
+        const PoincareSection& secondSection,
+        const double positionTolerance,
+        const double maximumDeltaV,
+        const int numberOfNeighbours,
+        const int numberOfThreads )
+{
+    if( !( positionTolerance > 0.0 ) || !( maximumDeltaV > 0.0 ) )
+    {
+        throw std::runtime_error( "Error when matching Poincare sections, tolerances must be positive" );
+    }
+
+    std::vector< PoincareSectionMatch > matches;
+    if( firstSection.getNumberOfPoints( ) == 0 || secondSection.getNumberOfPoints( ) == 0 )
+    {
+        return matches;
+    }
+
+    // Build k-d tree over second section, with positions and velocities normalized by their tolerances
+    Eigen::VectorXd weights( 6 );
+    weights << Eigen::Vector3d::Constant( 1.0 / ( positionTolerance * positionTolerance ) ),
+            Eigen::Vector3d::Constant( 1.0 / ( maximumDeltaV * maximumDeltaV ) );
+    KdTree tree( secondSection.states.data( ), secondSection.getNumberOfPoints( ), 6, 6, weights );
+
+    // Find best match of each point of the first section
+    std::vector< PoincareSectionMatch > bestMatches( firstSection.getNumberOfPoints( ) );
+    parallelForEachBlock( firstSection.getNumberOfPoints( ), [ & ]( const int startIndex, const int blockSize, const int )
+    {
+        for( int i = startIndex; i < startIndex + blockSize; i++ )
+        {
+            const Eigen::VectorXd queryState = firstSection.states.col( i );
+            PoincareSectionMatch& bestMatch = bestMatches.at( i );
+            bestMatch.firstPointIndex = i;
+            bestMatch.secondPointIndex = -1;
+            bestMatch.deltaV = maximumDeltaV;
+
+            const std::vector< int > neighbourIndices = tree.findNearestNeighbours( queryState, numberOfNeighbours );
+            for( unsigned int j = 0; j < neighbourIndices.size( ); j++ )
+            {
+                const Eigen::Vector6d stateDifference = secondSection.states.col( neighbourIndices.at( j ) ) - queryState;
+                const double positionDifference = stateDifference.segment( 0, 3 ).norm( );
+                const double deltaV = stateDifference.segment( 3, 3 ).norm( );
+                if( positionDifference <= positionTolerance && deltaV <= bestMatch.deltaV )
+                {
+                    bestMatch.secondPointIndex = neighbourIndices.at( j );
+                    bestMatch.positionDifference = positionDifference;
+                    bestMatch.deltaV = deltaV;
+                }
+            }
+        }
+    }, numberOfThreads );
+
+    // Retain points for which a match was found, and sort by Delta V
+    for( unsigned int i = 0; i < bestMatches.size( ); i++ )
+    {
+        if( bestMatches.at( i ).secondPointIndex >= 0 )
+        {
+            matches.push_back( bestMatches.at( i ) );
+        }
+    }
+    std::sort( matches.begin( ), matches.end( ), [ ]( const PoincareSectionMatch& first, const PoincareSectionMatch& second )
+    {
+        return first.deltaV < second.deltaV;
+    } );
+    return matches;
+}
+
+} // namespace tudat_applications
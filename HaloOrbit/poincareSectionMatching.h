@@ -0,0 +1,116 @@
+/*    Copyright (c) 2010-2018, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_POINCARESECTIONMATCHING_H
+#define TUDAT_POINCARESECTIONMATCHING_H
+
+#include <map>
+#include <vector>
+
+#include <Tudat/Basics/basicTypedefs.h>
+
+namespace tudat_applications
+{
+
+//! Struct containing the intersections of a set of trajectories with a Poincare section
+/*!
+ *  Struct containing the intersections of a set of trajectories with a Poincare section (a plane on which one of the
+ *  coordinates is constant), in normalized corotating CR3BP coordinates.
+ */
+struct PoincareSection
+{
+    //! States at the intersections (one column per intersection)
+    Eigen::MatrixXd states;
+
+    //! Times of the intersections
+    Eigen::VectorXd times;
+
+    //! Index of the trajectory to which each intersection belongs
+    Eigen::VectorXi trajectoryIndices;
+
+    //! Function to retrieve the number of intersections
+    int getNumberOfPoints( ) const
+    {
+        return times.rows( );
+    }
+};
+
+//! Struct defining a match between a point on one Poincare section, and a point on another
+struct PoincareSectionMatch
+{
+    //! Index of the point on the first section
+    int firstPointIndex;
+
+    //! Index of the point on the second section
+    int secondPointIndex;
+
+    //! Norm of the position difference between the points
+    double positionDifference;
+
+    //! Norm of the velocity difference between the points (impulsive Delta V required to patch the trajectories)
+    double deltaV;
+};
+
+//! Function to compute the intersections of a set of CR3BP trajectories with a Poincare section
+/*!
+ *  Function to compute the intersections of a set of CR3BP trajectories with a Poincare section, on which the coordinate with
+ *  the given index (0-5) has a constant value. Each intersection is located between two consecutive states of the state
+ *  history, and computed by a cubic Hermite interpolation of the state (using the CR3BP state derivatives at both states),
+ *  so that the full state at the section is obtained to the order of the integrator, also for large output steps. The
+ *  trajectories are processed concurrently; the intersections are stored in order of trajectory index.
+ *  \param stateHistories State histories of the trajectories (in normalized corotating coordinates)
+ *  \param massParameter Mass parameter of the CR3BP
+ *  \param sectionCoordinateIndex Index of the coordinate that is constant on the section
+ *  \param sectionCoordinateValue Value of the coordinate on the section
+ *  \param crossingDirection Direction of the crossings that are retained (1: coordinate increasing with time, -1: coordinate
+ *  decreasing with time, 0: both)
+ *  \param maximumNumberOfCrossings Maximum number of crossings that is retained per trajectory (all if smaller than 1)
+ *  \param isPropagationBackward Boolean denoting whether the trajectories were propagated backwards in time, in which case the
+ *  crossings are counted from the end of the state history (crossing direction is always w.r.t. increasing time)
+ *  \param numberOfThreads Number of threads to use (if smaller than 1, the default number of threads is used)
+ *  \return Intersections of the trajectories with the section
+ */
+PoincareSection computePoincareSection(
+        const std::vector< std::map< double, Eigen::Vector6d > >& stateHistories,
+        const double massParameter,
+        const int sectionCoordinateIndex,
+        const double sectionCoordinateValue,
+        const int crossingDirection,
+        const int maximumNumberOfCrossings = 1,
+        const bool isPropagationBackward = false,
+        const int numberOfThreads = 1 );
+
+//! Function to find the best matches between the points on two Poincare sections, ranked by Delta V
+/*!
+ *  Function to find the best matches between the points on two Poincare sections (e.g. the stable manifold of a periodic orbit
+ *  and a set of departure trajectories), ranked by Delta V. A k-d tree is built over the points of the second section, in
+ *  (position, velocity) space, with the position and velocity differences weighted by the inverse of their tolerances. For
+ *  each point of the first section, the nearest points in the tree are retrieved (concurrently), of which the point with
+ *  the lowest Delta V within both tolerances is retained. The computational cost is therefore of order N log(N), instead of
+ *  order N^2 for an all-pairs comparison.
+ *  \param firstSection First Poincare section (for each point of which the best match is searched)
+ *  \param secondSection Second Poincare section (over which the k-d tree is built)
+ *  \param positionTolerance Maximum norm of the position difference of a match
+ *  \param maximumDeltaV Maximum norm of the velocity difference of a match
+ *  \param numberOfNeighbours Number of nearest points retrieved for each point of the first section
+ *  \param numberOfThreads Number of threads to use (if smaller than 1, the default number of threads is used)
+ *  \return Best match of each point of the first section for which a match exists, sorted by increasing Delta V
+ */
+std::vector< PoincareSectionMatch > matchPoincareSections(
+        const PoincareSection& firstSection,
+        const PoincareSection& secondSection,
+        const double positionTolerance,
+        const double maximumDeltaV,
+        const int numberOfNeighbours = 8,
+        const int numberOfThreads = 1 );
+
+} // namespace tudat_applications
+
+#endif // TUDAT_POINCARESECTIONMATCHING_H
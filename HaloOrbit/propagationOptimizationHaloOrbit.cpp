@@ -1,11 +1,19 @@
 
 #include "Tudat/Astrodynamics/BasicAstrodynamics/celestialBodyConstants.h"
 #include "Tudat/SimulationSetup/tudatSimulationHeader.h"
+#include "Tudat/SimulationSetup/tudatEstimationHeader.h"
 #include "Tudat/SimulationSetup/PropagationSetup/propagationCR3BPFullProblem.h"
 #include "Tudat/Astrodynamics/Gravitation/unitConversionsCircularRestrictedThreeBodyProblem.h"
 #include "Tudat/Astrodynamics/Gravitation/librationPoint.h"
 
+#include <Eigen/Eigenvalues>
+
 #include "../applicationOutput.h"
+#include "../pararealIntegration.h"
+#include "../sundmanPropagation.h"
+#include "covariancePropagation.h"
+#include "haloFamilyTable.h"
+#include "poincareSectionMatching.h"
 
 using namespace tudat;
 using namespace tudat::ephemerides;
@@ -33,19 +41,58 @@ SelectedAccelerationMap getHaloOrbitAccelerationsMap( )
     return accelerationSettingsMap;
 }
 
+//! Create point mass gravity model (consistent with getHaloOrbitAccelerationsMap), to be used in regularized propagation
+tudat_applications::PointMassGravityModel getHaloOrbitPointMassGravityModel(
+        const NamedBodyMap& bodyMap,
+        const std::string& centralBody )
+{
+    std::shared_ptr< ephemerides::Ephemeris > centralBodyEphemeris = bodyMap.at( centralBody )->getEphemeris( );
+    std::vector< std::function< Eigen::Vector3d( const double ) > > perturbingBodyPositionFunctions;
+    std::vector< double > perturbingBodyGravitationalParameters;
+    for( const auto& accelerationIterator : getHaloOrbitAccelerationsMap( ).at( "Spacecraft" ) )
+    {
+        if( accelerationIterator.first != centralBody )
+        {
+            std::shared_ptr< ephemerides::Ephemeris > bodyEphemeris =
+                    bodyMap.at( accelerationIterator.first )->getEphemeris( );
+            perturbingBodyPositionFunctions.push_back( [ = ]( const double time )
+            {
+                return Eigen::Vector3d( ( bodyEphemeris->getCartesianState( time ) -
+                                          centralBodyEphemeris->getCartesianState( time ) ).segment( 0, 3 ) );
+            } );
+            perturbingBodyGravitationalParameters.push_back(
+                        bodyMap.at( accelerationIterator.first )->getGravityFieldModel( )->getGravitationalParameter( ) );
+        }
+    }
+
+    return tudat_applications::PointMassGravityModel(
+                bodyMap.at( centralBody )->getGravityFieldModel( )->getGravitationalParameter( ),
+                perturbingBodyPositionFunctions, perturbingBodyGravitationalParameters );
+}
+
 
 //! Create body map, to be used in simulations
+/*!
+ *  Create body map, to be used in simulations. By default, the ephemerides of Mars and Jupiter are retrieved directly from
+ *  Spice. If an ephemeris time interval is provided, they are instead tabulated (from Spice) when the body map is created, so
+ *  that the body map can be used in a propagation that runs concurrently with others (Spice is not thread-safe).
+ */
 NamedBodyMap getHaloOrbitBodyMap(
         const double primarySecondaryDistance,
         const double primaryGravitationalParameter,
         const double secondaryGravitationalParameter,
-        const std::string& nameBodyToPropagate )
+        const std::string& nameBodyToPropagate,
+        const double initialEphemerisTime = TUDAT_NAN,
+        const double finalEphemerisTime = TUDAT_NAN,
+        const double ephemerisTimeStep = TUDAT_NAN )
 {
     std::map< std::string, std::shared_ptr< simulation_setup::BodySettings > > bodySettings = setupBodySettingsCR3BP(
                 primarySecondaryDistance,
                 "Sun", "Earth", "ECLIPJ2000", primaryGravitationalParameter, secondaryGravitationalParameter );
-    bodySettings[ "Mars" ] = simulation_setup::getDefaultSingleBodySettings( "Mars", TUDAT_NAN, TUDAT_NAN, TUDAT_NAN );
-    bodySettings[ "Jupiter" ] = simulation_setup::getDefaultSingleBodySettings( "Jupiter", TUDAT_NAN, TUDAT_NAN, TUDAT_NAN );
+    bodySettings[ "Mars" ] = simulation_setup::getDefaultSingleBodySettings(
+                "Mars", initialEphemerisTime, finalEphemerisTime, ephemerisTimeStep );
+    bodySettings[ "Jupiter" ] = simulation_setup::getDefaultSingleBodySettings(
+                "Jupiter", initialEphemerisTime, finalEphemerisTime, ephemerisTimeStep );
 
     simulation_setup::NamedBodyMap bodyMap = createBodies( bodySettings );
     bodyMap[ nameBodyToPropagate ] = std::make_shared< simulation_setup::Body >( );
@@ -78,9 +125,35 @@ NamedBodyMap getHaloOrbitBodyMap(
  *   normalizedPropagatedStateHistory: Dynamics, in normalized, corotating coordinates, as computed by the full
  *      numerical propagation. Computed from propagatedStateHistory in post-processing.
  *
+ *   Optionally (usePararealPropagation), the full numerical propagation is also performed as a single continuous propagation
+ *   over the full time interval, using the Parareal algorithm: the CR3BP propagation is used as coarse propagator, and the full
+ *   numerical propagation of all time slices is run concurrently (with one body map per thread). The result is that of a
+ *   serial full numerical propagation from the initial state, to within the convergence tolerance:
+ *
+ *   pararealStateHistory: Dynamics, in unnormalized, inertial Cartesian coordinates, as computed by the full numerical
+ *      propagation over the full time interval.
+ *   normalizedPararealStateHistory: Dynamics, in normalized, corotating coordinates, as computed by the full numerical
+ *      propagation over the full time interval. Computed from pararealStateHistory in post-processing.
+ *
+ *   Optionally (propagateCovariance), the state transition matrix is propagated along each arc of the full numerical
+ *   propagation (concurrently for all arcs), and an initial covariance is mapped along the arcs by chaining the state
+ *   transition matrices at the arc boundaries (linear covariance analysis):
+ *
+ *   covarianceHistory: Covariance of the inertial Cartesian state (6x6 entries per epoch), at all integration epochs, or at
+ *      the requested output epochs only.
+ *
+ *   Optionally (matchManifoldWithDepartures), the stable manifold of the halo orbit (in the CR3BP) is matched with a set of
+ *   trajectories departing from a parking orbit around the Earth, on a Poincare section between the Earth and the halo
+ *   orbit:
+ *
+ *   manifoldDepartureMatches: Best matches, ranked by the Delta V needed to patch the departure trajectory onto the
+ *      manifold (if computed).
+ *
  *   Input parameters:
  *
  *   normalizedInitialState: Initial conditions of the dynamics, given in normalized, corotating elements.
+ *   useHaloFamilyTable/haloOrbitAmplitude: If set, the initial conditions are instead taken from the L2 halo orbit family
+ *      member with the given out-of-plane amplitude (interpolated in the family table, and corrected to be periodic).
  */
 int main( )
 {
@@ -108,6 +181,27 @@ int main( )
                 simulation_setup::getDefaultGravityFieldSettings( "Earth", TUDAT_NAN, TUDAT_NAN ),
                 "Earth" )->getGravitationalParameter( );
 
+    // Set whether the initial state is instead taken from the family of L2 halo orbits, for a given out-of-plane amplitude
+    // (interpolated in L2_2_initial_conditions_ES.txt, and corrected to be periodic in the CR3BP)
+    bool useHaloFamilyTable = false;
+    double haloOrbitAmplitude = 1.5E8;
+    if( useHaloFamilyTable )
+    {
+        std::string sourceFile( __FILE__ );
+        tudat_applications::HaloFamilyTable haloFamilyTable(
+                    sourceFile.substr( 0, sourceFile.find_last_of( "/\\" ) + 1 ) + "L2_2_initial_conditions_ES.txt",
+                    circular_restricted_three_body_problem::computeMassParameter(
+                        primaryGravitationalParameter, secondaryGravitationalParameter ) );
+
+        double haloOrbitPeriod;
+        normalizedInitialState = haloFamilyTable.getInitialState(
+                    tudat_applications::halo_amplitude_parameter, haloOrbitAmplitude / primarySecondaryDistance,
+                    haloOrbitPeriod );
+        haloFamilyTable.correctInitialState(
+                    normalizedInitialState, haloOrbitPeriod, std::make_shared< numerical_integrators::IntegratorSettings< > >(
+                        numerical_integrators::rungeKutta4, 0.0, 1.0E-3 ) );
+    }
+
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     ///////////////////////        CREATE ENVIRONMENT                 /////////////////////////////////////////////////////
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -116,11 +210,38 @@ int main( )
     double finalTotalPropagationTime = 1.0 * tudat::physical_constants::JULIAN_YEAR;
     double integrationTimeStep = 1.0E3;
 
+    // Set whether the full numerical propagation uses Sundman-regularized time (fixed steps in regularized time, with
+    // physical steps proportional to the local orbital time scale w.r.t. the nearest massive body; the integration time step
+    // is then the physical step at the primary-secondary distance from the Sun)
+    bool useRegularizedPropagation = false;
+    double regularizationExponent = 1.5;
+
     // Split dynamics propagation into arcs.
     int numberOfArcs = 6;
     double arcDuration = ( finalTotalPropagationTime - initialTotalPropagationTime ) /
             static_cast< double >( numberOfArcs );
 
+    // Set whether the full numerical propagation is also performed over the full time interval, with the Parareal algorithm
+    // (coarse CR3BP propagation with a large time step, fine full numerical propagations of all time slices concurrently)
+    bool usePararealPropagation = false;
+    int numberOfThreads = tudat_applications::getDefaultNumberOfThreads( );
+    int numberOfPararealSlices = 4 * numberOfThreads;
+    double coarseIntegrationTimeStep = 2.0E4;
+    double pararealPositionTolerance = 1.0E2;
+    double pararealVelocityTolerance = 1.0E-5;
+
+    // Set whether the state covariance is propagated along the arcs (state transition matrices of all arcs computed
+    // concurrently), the initial position and velocity uncertainty, and the interval at which the covariance is stored
+    // (if zero, it is stored at every integration step)
+    bool propagateCovariance = false;
+    double initialPositionUncertainty = 1.0E3;
+    double initialVelocityUncertainty = 1.0E-2;
+    double covarianceOutputInterval = tudat::physical_constants::JULIAN_DAY;
+
+    // Set whether the stable manifold of the halo orbit is matched with trajectories departing from a parking orbit around
+    // the Earth, on a Poincare section between the Earth and the halo orbit
+    bool matchManifoldWithDepartures = false;
+
     // Create environment
     NamedBodyMap bodyMap = getHaloOrbitBodyMap(
                 primarySecondaryDistance, primaryGravitationalParameter, secondaryGravitationalParameter, "Spacecraft" );
@@ -130,6 +251,7 @@ int main( )
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
     Eigen::VectorXd currentNormalizedInitialState = normalizedInitialState;
+    std::vector< Eigen::VectorXd > arcInitialCartesianStates;
 
     // Propagate dynamics for each arc
     for( int j = 0; j < numberOfArcs; j++ )
@@ -178,7 +300,7 @@ int main( )
                     massParameter, currentNormalizedInitialState, dimensionLessFinalTime, true );
 
         // Convert CR3BP results to non-rotating unnormalized Cartesian state
-        for( auto stateIterator : cr3bpStateHistory )
+        for( const auto& stateIterator : cr3bpStateHistory )
         {
             unnormalizedCr3bpStateHistory[ circular_restricted_three_body_problem::convertDimensionlessTimeToDimensionalTime(
                         stateIterator.first, primaryGravitationalParameter, secondaryGravitationalParameter,
@@ -208,6 +330,8 @@ int main( )
                     primarySecondaryDistance, currentNormalizedInitialState, dimensionLessInitialTime ) -
                 bodyMap.at( centralBodyOfPropagation )->getEphemeris( )->getCartesianState( initialPropagationTime );
 
+        arcInitialCartesianStates.push_back( initialCartesianState );
+
         // Define propagator type
         TranslationalPropagatorType propagatorType = cowell;
 
@@ -220,23 +344,39 @@ int main( )
                 std::make_shared < numerical_integrators::IntegratorSettings < > >
                 ( numerical_integrators::rungeKutta4, initialPropagationTime, integrationTimeStep );
 
-        // Propagate dynamics of current arc
-        SingleArcDynamicsSimulator< > dynamicsSimulator = SingleArcDynamicsSimulator< >(
-                    bodyMap, integratorSettings, propagatorSettings );
-
         // Process propagation results, convert fron Sun-centered to barycentric, and convert to normalized corotating coordinates
-        std::map< double, Eigen::VectorXd > rawPropagatedStateHistory = dynamicsSimulator.getEquationsOfMotionNumericalSolution( );
-        for( auto stateIterator : rawPropagatedStateHistory )
+        auto processPropagatedState = [ & ]( const double time, const Eigen::Vector6d& state )
         {
-            propagatedStateHistory[ stateIterator.first ] = stateIterator.second +
-                    bodyMap.at( centralBodyOfPropagation )->getEphemeris( )->getCartesianState( stateIterator.first );
+            propagatedStateHistory[ time ] = state +
+                    bodyMap.at( centralBodyOfPropagation )->getEphemeris( )->getCartesianState( time );
 
             normalizedPropagatedStateHistory[ circular_restricted_three_body_problem::convertDimensionalTimeToDimensionlessTime(
-                        stateIterator.first, primaryGravitationalParameter, secondaryGravitationalParameter,
+                        time, primaryGravitationalParameter, secondaryGravitationalParameter,
                         primarySecondaryDistance ) ] =
                     circular_restricted_three_body_problem::convertCartesianToCorotatingNormalizedCoordinates(
                         secondaryGravitationalParameter, primaryGravitationalParameter,
-                        primarySecondaryDistance, propagatedStateHistory[ stateIterator.first ], stateIterator.first );
+                        primarySecondaryDistance, propagatedStateHistory[ time ], time );
+        };
+
+        // Propagate dynamics of current arc, processing the results directly from the propagation output (without copying it)
+        if( useRegularizedPropagation )
+        {
+            for( const auto& stateIterator : tudat_applications::propagateWithSundmanRegularization(
+                     getHaloOrbitPointMassGravityModel( bodyMap, centralBodyOfPropagation ), initialPropagationTime,
+                     initialCartesianState, finalPropagationTime, primarySecondaryDistance, integrationTimeStep,
+                     regularizationExponent ) )
+            {
+                processPropagatedState( stateIterator.first, stateIterator.second );
+            }
+        }
+        else
+        {
+            SingleArcDynamicsSimulator< > dynamicsSimulator = SingleArcDynamicsSimulator< >(
+                        bodyMap, integratorSettings, propagatorSettings );
+            for( const auto& stateIterator : dynamicsSimulator.getEquationsOfMotionNumericalSolution( ) )
+            {
+                processPropagatedState( stateIterator.first, stateIterator.second );
+            }
         }
 
         // Set initial state for next arc
@@ -256,6 +396,389 @@ int main( )
                                                       "_" + std::to_string( j ) + ".dat", outputPath );
     }
 
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ///////////////////////  PROPAGATE FULL ORBIT NUMERICALLY WITH PARAREAL          /////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // Create body map for each thread, with ephemerides tabulated in this thread (for concurrent full numerical propagations)
+    std::vector< NamedBodyMap > threadBodyMaps;
+    if( usePararealPropagation || propagateCovariance )
+    {
+        for( int i = 0; i < numberOfThreads; i++ )
+        {
+            threadBodyMaps.push_back( getHaloOrbitBodyMap(
+                                          primarySecondaryDistance, primaryGravitationalParameter,
+                                          secondaryGravitationalParameter, "Spacecraft",
+                                          initialTotalPropagationTime - 10.0 * 3600.0,
+                                          finalTotalPropagationTime + 10.0 * 3600.0, 3600.0 ) );
+        }
+    }
+
+    if( usePararealPropagation )
+    {
+        std::string centralBodyOfPropagation = "Sun";
+        double sliceDuration = ( finalTotalPropagationTime - initialTotalPropagationTime ) /
+                static_cast< double >( numberOfPararealSlices );
+        double massParameter = circular_restricted_three_body_problem::computeMassParameter(
+                    primaryGravitationalParameter, secondaryGravitationalParameter );
+
+        // Coarse propagator: CR3BP, Sun-centered Cartesian state converted to/from normalized corotating coordinates
+        auto coarsePropagator = [ & ]( const int sliceIndex, const Eigen::VectorXd& sliceInitialState )
+        {
+            double initialPropagationTime = initialTotalPropagationTime + static_cast< double >( sliceIndex ) * sliceDuration;
+            double finalPropagationTime = initialPropagationTime + sliceDuration;
+            Eigen::Vector6d normalizedSliceInitialState =
+                    circular_restricted_three_body_problem::convertCartesianToCorotatingNormalizedCoordinates(
+                        secondaryGravitationalParameter, primaryGravitationalParameter, primarySecondaryDistance,
+                        sliceInitialState + bodyMap.at( centralBodyOfPropagation )->getEphemeris( )->getCartesianState(
+                            initialPropagationTime ), initialPropagationTime );
+
+            std::map< double, Eigen::Vector6d > coarseStateHistory = performCR3BPIntegration(
+                        std::make_shared < numerical_integrators::IntegratorSettings < > >
+                        ( numerical_integrators::rungeKutta4,
+                          circular_restricted_three_body_problem::convertDimensionalTimeToDimensionlessTime(
+                              initialPropagationTime, primaryGravitationalParameter, secondaryGravitationalParameter,
+                              primarySecondaryDistance ),
+                          circular_restricted_three_body_problem::convertDimensionalTimeToDimensionlessTime(
+                              coarseIntegrationTimeStep, primaryGravitationalParameter, secondaryGravitationalParameter,
+                              primarySecondaryDistance ) ),
+                        massParameter, normalizedSliceInitialState,
+                        circular_restricted_three_body_problem::convertDimensionalTimeToDimensionlessTime(
+                            finalPropagationTime, primaryGravitationalParameter, secondaryGravitationalParameter,
+                            primarySecondaryDistance ), true );
+
+            return Eigen::VectorXd(
+                        circular_restricted_three_body_problem::convertCorotatingNormalizedToCartesianCoordinates(
+                            secondaryGravitationalParameter, primaryGravitationalParameter, primarySecondaryDistance,
+                            coarseStateHistory.rbegin( )->second, coarseStateHistory.rbegin( )->first ) -
+                        bodyMap.at( centralBodyOfPropagation )->getEphemeris( )->getCartesianState( finalPropagationTime ) );
+        };
+
+        // Fine propagator: full numerical propagation, using body map of current thread (the dynamics simulator of the last
+        // propagation of each slice is retained, so that its state history is used without copying it)
+        std::vector< std::shared_ptr< SingleArcDynamicsSimulator< > > > sliceDynamicsSimulators( numberOfPararealSlices );
+        auto finePropagator = [ & ]( const int sliceIndex, const Eigen::VectorXd& sliceInitialState, const int threadIndex )
+        {
+            const NamedBodyMap& threadBodyMap = threadBodyMaps.at( threadIndex );
+            double initialPropagationTime = initialTotalPropagationTime + static_cast< double >( sliceIndex ) * sliceDuration;
+            double finalPropagationTime = initialPropagationTime + sliceDuration;
+
+            std::vector< std::string > centralBodies =  { centralBodyOfPropagation };
+            std::vector< std::string > bodiesToPropagate = { "Spacecraft" };
+            basic_astrodynamics::AccelerationMap accelerationModelMap = createAccelerationModelsMap(
+                        threadBodyMap, getHaloOrbitAccelerationsMap( ), bodiesToPropagate, centralBodies );
+
+            std::shared_ptr< TranslationalStatePropagatorSettings< double> > propagatorSettings =
+                    std::make_shared< TranslationalStatePropagatorSettings< double > >
+                    ( centralBodies, accelerationModelMap, bodiesToPropagate, sliceInitialState,
+                      std::make_shared< PropagationTimeTerminationSettings >( finalPropagationTime, true ), cowell );
+            std::shared_ptr< numerical_integrators::IntegratorSettings< > > integratorSettings =
+                    std::make_shared < numerical_integrators::IntegratorSettings < > >
+                    ( numerical_integrators::rungeKutta4, initialPropagationTime, integrationTimeStep );
+
+            sliceDynamicsSimulators.at( sliceIndex ) = std::make_shared< SingleArcDynamicsSimulator< > >(
+                        threadBodyMap, integratorSettings, propagatorSettings );
+            return Eigen::VectorXd(
+                        sliceDynamicsSimulators.at( sliceIndex )->getEquationsOfMotionNumericalSolution( ).rbegin( )->second );
+        };
+
+        // Determine initial Cartesian state w.r.t. Sun, and propagate
+        Eigen::VectorXd initialCartesianState =
+                circular_restricted_three_body_problem::convertCorotatingNormalizedToCartesianCoordinates(
+                    secondaryGravitationalParameter, primaryGravitationalParameter,
+                    primarySecondaryDistance, normalizedInitialState,
+                    circular_restricted_three_body_problem::convertDimensionalTimeToDimensionlessTime(
+                        initialTotalPropagationTime, primaryGravitationalParameter, secondaryGravitationalParameter,
+                        primarySecondaryDistance ) ) -
+                bodyMap.at( centralBodyOfPropagation )->getEphemeris( )->getCartesianState( initialTotalPropagationTime );
+        Eigen::VectorXd convergenceTolerances = ( Eigen::VectorXd( 6 ) <<
+                                                  Eigen::Vector3d::Constant( pararealPositionTolerance ),
+                                                  Eigen::Vector3d::Constant( pararealVelocityTolerance ) ).finished( );
+
+        int numberOfPararealIterations;
+        tudat_applications::propagateWithParareal(
+                    numberOfPararealSlices, initialCartesianState, coarsePropagator, finePropagator,
+                    convergenceTolerances, numberOfPararealIterations, 0, numberOfThreads );
+        std::cout << "Parareal propagation converged in " << numberOfPararealIterations << " iterations, for "
+                  << numberOfPararealSlices << " time slices" << std::endl;
+
+        // Process propagation results, convert fron Sun-centered to barycentric, and convert to normalized corotating coordinates
+        std::map< double, Eigen::VectorXd > pararealStateHistory;
+        std::map< double, Eigen::VectorXd > normalizedPararealStateHistory;
+        for( int i = 0; i < numberOfPararealSlices; i++ )
+        {
+            for( const auto& stateIterator : sliceDynamicsSimulators.at( i )->getEquationsOfMotionNumericalSolution( ) )
+            {
+                pararealStateHistory[ stateIterator.first ] = stateIterator.second +
+                        bodyMap.at( centralBodyOfPropagation )->getEphemeris( )->getCartesianState( stateIterator.first );
+
+                normalizedPararealStateHistory[
+                        circular_restricted_three_body_problem::convertDimensionalTimeToDimensionlessTime(
+                            stateIterator.first, primaryGravitationalParameter, secondaryGravitationalParameter,
+                            primarySecondaryDistance ) ] =
+                        circular_restricted_three_body_problem::convertCartesianToCorotatingNormalizedCoordinates(
+                            secondaryGravitationalParameter, primaryGravitationalParameter,
+                            primarySecondaryDistance, pararealStateHistory[ stateIterator.first ], stateIterator.first );
+            }
+        }
+
+        input_output::writeDataMapToTextFile(
+                    pararealStateHistory, "pararealResultUnnormalized.dat", outputPath );
+        input_output::writeDataMapToTextFile(
+                    normalizedPararealStateHistory, "pararealResultNormalized.dat", outputPath );
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ///////////////////////  PROPAGATE COVARIANCE ALONG ARCS WITH STATE TRANSITION MATRICES        /////////////////////////
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    if( propagateCovariance )
+    {
+        std::string centralBodyOfPropagation = "Sun";
+
+        // Propagate state transition matrix of each arc (w.r.t. start of arc), using body map of current thread
+        std::vector< std::map< double, Eigen::MatrixXd > > stateTransitionMatrixHistories( numberOfArcs );
+        tudat_applications::parallelForEachIndex( numberOfArcs, [ & ]( const int arcIndex, const int threadIndex )
+        {
+            const NamedBodyMap& threadBodyMap = threadBodyMaps.at( threadIndex );
+            double initialPropagationTime = initialTotalPropagationTime + static_cast< double >( arcIndex ) * arcDuration;
+            double finalPropagationTime = initialPropagationTime + arcDuration;
+
+            std::vector< std::string > centralBodies =  { centralBodyOfPropagation };
+            std::vector< std::string > bodiesToPropagate = { "Spacecraft" };
+            basic_astrodynamics::AccelerationMap accelerationModelMap = createAccelerationModelsMap(
+                        threadBodyMap, getHaloOrbitAccelerationsMap( ), bodiesToPropagate, centralBodies );
+
+            std::shared_ptr< TranslationalStatePropagatorSettings< double> > propagatorSettings =
+                    std::make_shared< TranslationalStatePropagatorSettings< double > >
+                    ( centralBodies, accelerationModelMap, bodiesToPropagate, arcInitialCartesianStates.at( arcIndex ),
+                      std::make_shared< PropagationTimeTerminationSettings >( finalPropagationTime, true ), cowell );
+            std::shared_ptr< numerical_integrators::IntegratorSettings< > > integratorSettings =
+                    std::make_shared < numerical_integrators::IntegratorSettings < > >
+                    ( numerical_integrators::rungeKutta4, initialPropagationTime, integrationTimeStep );
+
+            // Define initial state of spacecraft as parameter, and propagate variational equations
+            std::vector< std::shared_ptr< estimatable_parameters::EstimatableParameterSettings > > parameterNames;
+            parameterNames.push_back(
+                        std::make_shared< estimatable_parameters::InitialTranslationalStateEstimatableParameterSettings< double > >(
+                            "Spacecraft", arcInitialCartesianStates.at( arcIndex ), centralBodyOfPropagation ) );
+            std::shared_ptr< estimatable_parameters::EstimatableParameterSet< double > > parametersToEstimate =
+                    createParametersToEstimate( parameterNames, threadBodyMap );
+
+            SingleArcVariationalEquationsSolver< > variationalEquationsSolver(
+                        threadBodyMap, integratorSettings, propagatorSettings, parametersToEstimate, true,
+                        std::shared_ptr< numerical_integrators::IntegratorSettings< double > >( ), false, true );
+            stateTransitionMatrixHistories.at( arcIndex ) =
+                    variationalEquationsSolver.getNumericalVariationalEquationsSolution( ).at( 0 );
+        }, numberOfThreads );
+
+        // Set initial covariance and output epochs, and map covariance along arcs
+        Eigen::Matrix6d initialCovariance = Eigen::Matrix6d::Zero( );
+        initialCovariance.block( 0, 0, 3, 3 ) =
+                initialPositionUncertainty * initialPositionUncertainty * Eigen::Matrix3d::Identity( );
+        initialCovariance.block( 3, 3, 3, 3 ) =
+                initialVelocityUncertainty * initialVelocityUncertainty * Eigen::Matrix3d::Identity( );
+
+        std::vector< double > covarianceOutputEpochs;
+        if( covarianceOutputInterval > 0.0 )
+        {
+            for( double epoch = initialTotalPropagationTime; epoch <= finalTotalPropagationTime;
+                 epoch += covarianceOutputInterval )
+            {
+                covarianceOutputEpochs.push_back( epoch );
+            }
+        }
+
+        std::map< double, Eigen::Matrix6d > covarianceHistory = tudat_applications::propagateCovarianceOverArcs(
+                    stateTransitionMatrixHistories, initialCovariance, covarianceOutputEpochs );
+
+        std::map< double, Eigen::VectorXd > covarianceOutput;
+        for( const auto& covarianceIterator : covarianceHistory )
+        {
+            covarianceOutput[ covarianceIterator.first ] =
+                    Eigen::Map< const Eigen::VectorXd >( covarianceIterator.second.data( ), 36 );
+        }
+        input_output::writeDataMapToTextFile( covarianceOutput, "covarianceHistory.dat", outputPath );
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ///////////////////////  MATCH STABLE MANIFOLD WITH DEPARTURE TRAJECTORIES ON POINCARE SECTION  ////////////////////////
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    if( matchManifoldWithDepartures )
+    {
+        double massParameter = circular_restricted_three_body_problem::computeMassParameter(
+                    primaryGravitationalParameter, secondaryGravitationalParameter );
+        double velocityUnit = primarySecondaryDistance /
+                circular_restricted_three_body_problem::convertDimensionlessTimeToDimensionalTime(
+                    1.0, primaryGravitationalParameter, secondaryGravitationalParameter, primarySecondaryDistance );
+        double dimensionLessTimeStep = circular_restricted_three_body_problem::convertDimensionalTimeToDimensionlessTime(
+                    integrationTimeStep, primaryGravitationalParameter, secondaryGravitationalParameter,
+                    primarySecondaryDistance );
+
+        // Define manifold, departure orbit and section settings (section between Earth and halo orbit, normal to x-axis)
+        int numberOfManifoldTrajectories = 1000;
+        double manifoldPerturbation = 200.0E3 / primarySecondaryDistance;
+        double manifoldPropagationTime = 3.5;
+        double parkingOrbitRadius = 6678.0E3 / primarySecondaryDistance;
+        int numberOfDeparturePhases = 72;
+        int numberOfDepartureInclinations = 9;
+        int numberOfDepartureSpeeds = 11;
+        double departurePropagationTime = 1.7;
+        double sectionCoordinateValue = 1.0 - massParameter + 4.0E-3;
+        double positionMatchTolerance = 2.0E7 / primarySecondaryDistance;
+        double maximumMatchDeltaV = 1.0E3 / velocityUnit;
+
+        std::shared_ptr< numerical_integrators::IntegratorSettings< > > forwardIntegratorSettings =
+                std::make_shared < numerical_integrators::IntegratorSettings < > >
+                ( numerical_integrators::rungeKutta4, 0.0, dimensionLessTimeStep );
+        std::shared_ptr< numerical_integrators::IntegratorSettings< > > backwardIntegratorSettings =
+                std::make_shared < numerical_integrators::IntegratorSettings < > >
+                ( numerical_integrators::rungeKutta4, 0.0, -dimensionLessTimeStep );
+
+        // Determine period of halo orbit from first return to the y=0 plane (on which the initial state is located)
+        std::vector< std::map< double, Eigen::Vector6d > > haloStateHistory = { performCR3BPIntegration(
+                        forwardIntegratorSettings, massParameter, normalizedInitialState, 2.0 * mathematical_constants::PI,
+                        true ) };
+        tudat_applications::PoincareSection haloReturn = tudat_applications::computePoincareSection(
+                    haloStateHistory, massParameter, 1, 0.0, ( normalizedInitialState( 4 ) > 0.0 ) ? 1 : -1 );
+        if( haloReturn.getNumberOfPoints( ) == 0 )
+        {
+            throw std::runtime_error( "Error, halo orbit does not return to initial y=0 plane" );
+        }
+        double haloPeriod = haloReturn.times( 0 );
+
+        // Compute monodromy matrix over one period backward in time by finite differences, of which the dominant
+        // eigenvector is the stable direction (which is more accurate than the smallest eigenvector of the forward monodromy)
+        double stateDifferenceStep = 1.0E-8;
+        std::map< double, Eigen::Vector6d > backwardHaloStateHistory = performCR3BPIntegration(
+                    backwardIntegratorSettings, massParameter, normalizedInitialState, -haloPeriod, true );
+        std::vector< std::map< double, Eigen::Vector6d > > perturbedHaloStateHistories;
+        Eigen::Matrix6d backwardMonodromyMatrix;
+        for( int i = 0; i < 6; i++ )
+        {
+            Eigen::Vector6d perturbedInitialState = normalizedInitialState;
+            perturbedInitialState( i ) += stateDifferenceStep;
+            perturbedHaloStateHistories.push_back( performCR3BPIntegration(
+                                                       backwardIntegratorSettings, massParameter, perturbedInitialState,
+                                                       -haloPeriod, true ) );
+            backwardMonodromyMatrix.col( i ) = ( perturbedHaloStateHistories.at( i ).begin( )->second -
+                                                 backwardHaloStateHistory.begin( )->second ) / stateDifferenceStep;
+        }
+        Eigen::EigenSolver< Eigen::Matrix6d > eigenSolver( backwardMonodromyMatrix );
+        int stableEigenvectorIndex;
+        eigenSolver.eigenvalues( ).cwiseAbs( ).maxCoeff( &stableEigenvectorIndex );
+        Eigen::Vector6d stableEigenvector = eigenSolver.eigenvectors( ).col( stableEigenvectorIndex ).real( );
+
+        // Create initial states of stable manifold, displaced from halo orbit along (propagated) stable direction, towards Earth
+        std::vector< std::pair< double, Eigen::Vector6d > > manifoldInitialStates;
+        std::vector< std::map< double, Eigen::Vector6d >::const_iterator > perturbedStateIterators;
+        for( int i = 0; i < 6; i++ )
+        {
+            perturbedStateIterators.push_back( perturbedHaloStateHistories.at( i ).begin( ) );
+        }
+        int numberOfHaloStates = backwardHaloStateHistory.size( );
+        int currentHaloState = 0;
+        for( const auto& stateIterator : backwardHaloStateHistory )
+        {
+            int numberOfManifoldInitialStates = manifoldInitialStates.size( );
+            if( numberOfManifoldInitialStates < numberOfManifoldTrajectories && currentHaloState ==
+                    ( numberOfManifoldInitialStates * numberOfHaloStates ) / numberOfManifoldTrajectories )
+            {
+                Eigen::Vector6d stableDirection = Eigen::Vector6d::Zero( );
+                for( int i = 0; i < 6; i++ )
+                {
+                    stableDirection += stableEigenvector( i ) * ( perturbedStateIterators.at( i )->second -
+                                                                  stateIterator.second ) / stateDifferenceStep;
+                }
+                stableDirection /= stableDirection.segment( 0, 3 ).norm( );
+                if( stableDirection( 0 ) > 0.0 )
+                {
+                    stableDirection *= -1.0;
+                }
+                manifoldInitialStates.push_back( std::make_pair(
+                                                     stateIterator.first,
+                                                     stateIterator.second + manifoldPerturbation * stableDirection ) );
+            }
+            for( int i = 0; i < 6; i++ )
+            {
+                perturbedStateIterators.at( i )++;
+            }
+            currentHaloState++;
+        }
+
+        // Propagate stable manifold backward in time, and departure trajectories from parking orbit forward in time
+        std::vector< std::map< double, Eigen::Vector6d > > manifoldStateHistories( manifoldInitialStates.size( ) );
+        tudat_applications::parallelForEachIndex( manifoldInitialStates.size( ), [ & ]( const int index, const int )
+        {
+            manifoldStateHistories.at( index ) = performCR3BPIntegration(
+                        std::make_shared < numerical_integrators::IntegratorSettings < > >
+                        ( numerical_integrators::rungeKutta4, manifoldInitialStates.at( index ).first,
+                          -dimensionLessTimeStep ),
+                        massParameter, manifoldInitialStates.at( index ).second,
+                        manifoldInitialStates.at( index ).first - manifoldPropagationTime, true );
+        }, numberOfThreads );
+
+        int numberOfDepartureTrajectories = numberOfDeparturePhases * numberOfDepartureInclinations * numberOfDepartureSpeeds;
+        double escapeSpeed = std::sqrt( 2.0 * massParameter / parkingOrbitRadius );
+        std::vector< std::map< double, Eigen::Vector6d > > departureStateHistories( numberOfDepartureTrajectories );
+        tudat_applications::parallelForEachIndex( numberOfDepartureTrajectories, [ & ]( const int index, const int )
+        {
+            // Set departure state on circular parking orbit, with speed close to escape speed
+            double phase = 2.0 * mathematical_constants::PI * static_cast< double >(
+                        index / ( numberOfDepartureInclinations * numberOfDepartureSpeeds ) ) /
+                    static_cast< double >( numberOfDeparturePhases );
+            double inclination = unit_conversions::convertDegreesToRadians(
+                        -40.0 + 80.0 * static_cast< double >( ( index / numberOfDepartureSpeeds ) %
+                                                              numberOfDepartureInclinations ) /
+                        static_cast< double >( numberOfDepartureInclinations - 1 ) );
+            double speed = escapeSpeed * ( 0.997 + 0.006 * static_cast< double >( index % numberOfDepartureSpeeds ) /
+                                           static_cast< double >( numberOfDepartureSpeeds - 1 ) );
+
+            Eigen::Vector3d radialDirection = ( Eigen::Vector3d( ) << std::cos( phase ),
+                                                std::sin( phase ) * std::cos( inclination ),
+                                                std::sin( phase ) * std::sin( inclination ) ).finished( );
+            Eigen::Vector3d alongTrackDirection = ( Eigen::Vector3d( ) << -std::sin( phase ),
+                                                    std::cos( phase ) * std::cos( inclination ),
+                                                    std::cos( phase ) * std::sin( inclination ) ).finished( );
+            Eigen::Vector6d departureState;
+            departureState.segment( 0, 3 ) = Eigen::Vector3d::UnitX( ) * ( 1.0 - massParameter ) +
+                    parkingOrbitRadius * radialDirection;
+            departureState.segment( 3, 3 ) = speed * alongTrackDirection -
+                    parkingOrbitRadius * Eigen::Vector3d::UnitZ( ).cross( radialDirection );
+
+            departureStateHistories.at( index ) = performCR3BPIntegration(
+                        std::make_shared< RungeKuttaVariableStepSizeSettings< > >
+                        ( rungeKuttaVariableStepSize, 0.0, 1.0E-5, RungeKuttaCoefficients::rungeKuttaFehlberg78,
+                          1.0E-10, 1.0E-1, 1.0E-12, 1.0E-12 ),
+                        massParameter, departureState, departurePropagationTime, true );
+        }, numberOfThreads );
+
+        // Intersect trajectories with section (moving away from Earth), and find best matches
+        tudat_applications::PoincareSection manifoldSection = tudat_applications::computePoincareSection(
+                    manifoldStateHistories, massParameter, 0, sectionCoordinateValue, 1, 1, true, numberOfThreads );
+        tudat_applications::PoincareSection departureSection = tudat_applications::computePoincareSection(
+                    departureStateHistories, massParameter, 0, sectionCoordinateValue, 1, 1, false, numberOfThreads );
+        std::vector< tudat_applications::PoincareSectionMatch > sectionMatches = tudat_applications::matchPoincareSections(
+                    manifoldSection, departureSection, positionMatchTolerance, maximumMatchDeltaV, 8, numberOfThreads );
+        std::cout << "Found " << sectionMatches.size( ) << " matches between " << manifoldSection.getNumberOfPoints( )
+                  << " manifold and " << departureSection.getNumberOfPoints( ) << " departure section points" << std::endl;
+
+        // Write matches (indices of manifold and departure trajectory, section times, position difference and Delta V)
+        std::map< int, Eigen::VectorXd > sectionMatchResults;
+        for( unsigned int i = 0; i < sectionMatches.size( ); i++ )
+        {
+            sectionMatchResults[ i ] = ( Eigen::VectorXd( 6 ) <<
+                                         manifoldSection.trajectoryIndices( sectionMatches.at( i ).firstPointIndex ),
+                                         departureSection.trajectoryIndices( sectionMatches.at( i ).secondPointIndex ),
+                                         manifoldSection.times( sectionMatches.at( i ).firstPointIndex ),
+                                         departureSection.times( sectionMatches.at( i ).secondPointIndex ),
+                                         sectionMatches.at( i ).positionDifference * primarySecondaryDistance,
+                                         sectionMatches.at( i ).deltaV * velocityUnit ).finished( );
+        }
+        input_output::writeDataMapToTextFile( sectionMatchResults, "manifoldDepartureMatches.dat", outputPath );
+    }
+
     // The exit code EXIT_SUCCESS indicates that the program was successfully executed.
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,185 @@
+/*    Copyright (c) 2010-2018, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#include <stdexcept>
+
+#include <Tudat/Astrodynamics/BasicAstrodynamics/physicalConstants.h>
+
+#include "analyticPlanetEphemeris.h"
+
+namespace tudat_applications
+{
+
+//! Constructor
+AnalyticPlanetEphemeris::AnalyticPlanetEphemeris(
+        const std::string& planetName,
+        const double sunGravitationalParameter,
+        const std::string& referenceFrameOrientation ):
+    tudat::ephemerides::Ephemeris( "Sun", referenceFrameOrientation ),
+    sunGravitationalParameter_( sunGravitationalParameter )
+{
+    if( referenceFrameOrientation != "ECLIPJ2000" )
+    {
+        throw std::runtime_error( "Error when creating analytic ephemeris of " + planetName +
+                                  ", only ECLIPJ2000 orientation is supported" );
+    }
+
+    // Mean elements and rates (a [AU, AU/cy], e [-, 1/cy], I, L, longitude of perihelion and of node [deg, deg/cy])
+    std::vector< double > elements;
+    if( planetName == "Mercury" )
+    {
+        elements = { 0.38709927, 0.00000037, 0.20563593, 0.00001906, 7.00497902, -0.00594749,
+                     252.25032350, 149472.67411175, 77.45779628, 0.16047689, 48.33076593, -0.12534081 };
+    }
+    else if( planetName == "Venus" )
+    {
+        elements = { 0.72333566, 0.00000390, 0.00677672, -0.00004107, 3.39467605, -0.00078890,
+                     181.97909950, 58517.81538729, 131.60246718, 0.00268329, 76.67984255, -0.27769418 };
+    }
+    else if( planetName == "Earth" )
+    {
+        elements = { 1.00000261, 0.00000562, 0.01671123, -0.00004392, -0.00001531, -0.01294668,
+                     100.46457166, 35999.37244981, 102.93768193, 0.32327364, 0.0, 0.0 };
+    }
+    else if( planetName == "Mars" )
+    {
+        elements = { 1.52371034, 0.00001847, 0.09339410, 0.00007882, 1.84969142, -0.00813131,
+                     -4.55343205, 19140.30268499, -23.94362959, 0.44441088, 49.55953891, -0.29257343 };
+    }
+    else if( planetName == "Jupiter" )
+    {
+        elements = { 5.20288700, -0.00011607, 0.04838624, -0.00013253, 1.30439695, -0.00183714,
+                     34.39644051, 3034.74612775, 14.72847983, 0.21252668, 100.47390909, 0.20469106 };
+    }
+    else if( planetName == "Saturn" )
+    {
+        elements = { 9.53667594, -0.00125060, 0.05386179, -0.00050991, 2.48599187, 0.00193609,
+                     49.95424423, 1222.49362201, 92.59887831, -0.41897216, 113.66242448, -0.28867794 };
+    }
+    else if( planetName == "Uranus" )
+    {
+        elements = { 19.18916464, -0.00196176, 0.04725744, -0.00004397, 0.77263783, -0.00242939,
+                     313.23810451, 428.48202785, 170.95427630, 0.40805281, 74.01692503, 0.04240589 };
+    }
+    else if( planetName == "Neptune" )
+    {
+        elements = { 30.06992276, 0.00026291, 0.00859048, 0.00005105, 1.77004347, 0.00035372,
+                     -55.12002969, 218.45945325, 44.96476227, -0.32241464, 131.78422574, -0.00508664 };
+    }
+    else
+    {
+        throw std::runtime_error( "Error, no analytic ephemeris available for " + planetName );
+    }
+
+    semiMajorAxis_ = elements.at( 0 ) * tudat::physical_constants::ASTRONOMICAL_UNIT;
+    semiMajorAxisRate_ = elements.at( 1 ) * tudat::physical_constants::ASTRONOMICAL_UNIT;
+    eccentricity_ = elements.at( 2 );
+    eccentricityRate_ = elements.at( 3 );
+    inclination_ = elements.at( 4 );
+    inclinationRate_ = elements.at( 5 );
+    meanLongitude_ = elements.at( 6 );
+    meanLongitudeRate_ = elements.at( 7 );
+    longitudeOfPerihelion_ = elements.at( 8 );
+    longitudeOfPerihelionRate_ = elements.at( 9 );
+    longitudeOfAscendingNode_ = elements.at( 10 );
+    longitudeOfAscendingNodeRate_ = elements.at( 11 );
+}
+
+//! Function to retrieve the gravitational parameter of a solar system body, for use with analytic ephemerides
+double getAnalyticEphemerisGravitationalParameter( const std::string& bodyName )
+{
+    if( bodyName == "Sun" )
+    {
+        return 1.32712440018E20;
+    }
+    else if( bodyName == "Mercury" )
+    {
+        return 2.2032E13;
+    }
+    else if( bodyName == "Venus" )
+    {
+        return 3.24859E14;
+    }
+    else if( bodyName == "Earth" )
+    {
+        return 3.986004418E14;
+    }
+    else if( bodyName == "Mars" )
+    {
+        return 4.282837E13;
+    }
+    else if( bodyName == "Jupiter" )
+    {
+        return 1.26686534E17;
+    }
+    else if( bodyName == "Saturn" )
+    {
+        return 3.7931187E16;
+    }
+    else if( bodyName == "Uranus" )
+    {
+        return 5.793939E15;
+    }
+    else if( bodyName == "Neptune" )
+    {
+        return 6.836529E15;
+    }
+    else
+    {
+        throw std::runtime_error( "Error, no gravitational parameter available for " + bodyName );
+    }
+}
+
+//! Function to create the body map for a patched conics trajectory, using analytic planet ephemerides
+tudat::simulation_setup::NamedBodyMap setupBodyMapFromAnalyticEphemeridesForPatchedConicsTrajectory(
+        const std::string& nameCentralBody,
+        const std::string& nameBodyToPropagate,
+        const std::vector< std::string >& nameTransferBodies,
+        const std::string& frameOrientation )
+{
+    using namespace tudat;
+
+    if( nameCentralBody != "Sun" )
+    {
+        throw std::runtime_error( "Error when creating body map with analytic ephemerides, central body must be the Sun" );
+    }
+
+    simulation_setup::NamedBodyMap bodyMap;
+
+    // Create central body, fixed at the frame origin
+    const double sunGravitationalParameter = getAnalyticEphemerisGravitationalParameter( nameCentralBody );
+    bodyMap[ nameCentralBody ] = std::make_shared< simulation_setup::Body >( );
+    bodyMap[ nameCentralBody ]->setEphemeris( std::make_shared< ephemerides::ConstantEphemeris >(
+                                                  Eigen::Vector6d::Zero( ), "SSB", frameOrientation ) );
+    bodyMap[ nameCentralBody ]->setGravityFieldModel(
+                std::make_shared< gravitation::GravityFieldModel >( sunGravitationalParameter ) );
+
+    // Create transfer bodies
+    for( unsigned int i = 0; i < nameTransferBodies.size( ); i++ )
+    {
+        if( bodyMap.count( nameTransferBodies.at( i ) ) == 0 )
+        {
+            bodyMap[ nameTransferBodies.at( i ) ] = std::make_shared< simulation_setup::Body >( );
+            bodyMap[ nameTransferBodies.at( i ) ]->setEphemeris( std::make_shared< AnalyticPlanetEphemeris >(
+                                                                     nameTransferBodies.at( i ), sunGravitationalParameter,
+                                                                     frameOrientation ) );
+            bodyMap[ nameTransferBodies.at( i ) ]->setGravityFieldModel(
+                        std::make_shared< gravitation::GravityFieldModel >(
+                            getAnalyticEphemerisGravitationalParameter( nameTransferBodies.at( i ) ) ) );
+        }
+    }
+
+    // Create body to propagate
+    bodyMap[ nameBodyToPropagate ] = std::make_shared< simulation_setup::Body >( );
+
+    return bodyMap;
+}
+
+} // namespace tudat_applications
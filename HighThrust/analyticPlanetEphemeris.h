@@ -0,0 +1,190 @@
+/*    Copyright (c) 2010-2018, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_ANALYTICPLANETEPHEMERIS_H
+#define TUDAT_ANALYTICPLANETEPHEMERIS_H
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <Tudat/Mathematics/BasicMathematics/mathematicalConstants.h>
+#include <Tudat/SimulationSetup/tudatSimulationHeader.h>
+
+namespace tudat_applications
+{
+
+//! Class for computing approximate planet states from mean orbital elements with secular rates
+/*!
+ *  Class for computing approximate heliocentric planet states from mean orbital elements with secular rates, w.r.t. the
+ *  ecliptic and equinox of J2000, using the elements of Table 1 of "Keplerian Elements for Approximate Positions of the Major
+ *  Planets" (Standish, JPL), valid from 1800 to 2050 AD. The position error is in the order of 1E-3 to 1E-2 degrees in
+ *  heliocentric longitude for the inner planets, and up to 1E-1 degrees for the outer planets, which is sufficient for
+ *  preliminary screening of transfer trajectories. Velocities are computed from the osculating Keplerian orbit at the epoch.
+ *
+ *  No ephemeris kernels are accessed, and the state computation is defined inline, so that it can be used at negligible cost
+ *  (both through the Ephemeris interface and, without virtual function call, through computeCartesianState).
+ */
+class AnalyticPlanetEphemeris: public tudat::ephemerides::Ephemeris
+{
+public:
+
+    //! Constructor
+    /*!
+     * Constructor
+     * \param planetName Name of planet (Mercury, Venus, Earth, Mars, Jupiter, Saturn, Uranus or Neptune). For the Earth,
+     * the state of the Earth-Moon barycenter is returned.
+     * \param sunGravitationalParameter Gravitational parameter of the Sun, used for the computation of the velocity
+     * \param referenceFrameOrientation Orientation of the reference frame (only ECLIPJ2000 is supported)
+     */
+    AnalyticPlanetEphemeris(
+            const std::string& planetName,
+            const double sunGravitationalParameter,
+            const std::string& referenceFrameOrientation = "ECLIPJ2000" );
+
+    //! Function to compute the heliocentric Cartesian state of the planet (without virtual function call)
+    /*!
+     * Function to compute the heliocentric Cartesian state of the planet (without virtual function call)
+     * \param secondsSinceEpoch Seconds since J2000
+     * \return Heliocentric Cartesian state of the planet, in the ecliptic J2000 frame
+     */
+    Eigen::Vector6d computeCartesianState( const double secondsSinceEpoch ) const
+    {
+        const double degreesToRadians = tudat::mathematical_constants::PI / 180.0;
+        const double centuriesSinceEpoch = secondsSinceEpoch / ( 36525.0 * 86400.0 );
+
+        // Compute mean elements at current epoch
+        const double semiMajorAxis = semiMajorAxis_ + semiMajorAxisRate_ * centuriesSinceEpoch;
+        const double eccentricity = eccentricity_ + eccentricityRate_ * centuriesSinceEpoch;
+        const double inclination = degreesToRadians * ( inclination_ + inclinationRate_ * centuriesSinceEpoch );
+        const double meanLongitude = meanLongitude_ + meanLongitudeRate_ * centuriesSinceEpoch;
+        const double longitudeOfPerihelion =
+                longitudeOfPerihelion_ + longitudeOfPerihelionRate_ * centuriesSinceEpoch;
+        const double longitudeOfAscendingNode = degreesToRadians *
+                ( longitudeOfAscendingNode_ + longitudeOfAscendingNodeRate_ * centuriesSinceEpoch );
+        const double argumentOfPerihelion = degreesToRadians * longitudeOfPerihelion - longitudeOfAscendingNode;
+        const double meanAnomaly = degreesToRadians *
+                ( std::remainder( meanLongitude - longitudeOfPerihelion, 360.0 ) );
+
+        // Solve Kepler's equation (converges in a few iterations for the low planetary eccentricities)
+        double eccentricAnomaly = meanAnomaly + eccentricity * std::sin( meanAnomaly );
+        for( int i = 0; i < 10; i++ )
+        {
+            const double correction = ( eccentricAnomaly - eccentricity * std::sin( eccentricAnomaly ) - meanAnomaly ) /
+                    ( 1.0 - eccentricity * std::cos( eccentricAnomaly ) );
+            eccentricAnomaly -= correction;
+            if( std::fabs( correction ) < 1.0E-14 )
+            {
+                break;
+            }
+        }
+
+        // Compute state in orbital plane
+        const double cosineEccentricAnomaly = std::cos( eccentricAnomaly );
+        const double sineEccentricAnomaly = std::sin( eccentricAnomaly );
+        const double semiMinorAxisRatio = std::sqrt( 1.0 - eccentricity * eccentricity );
+        const double eccentricAnomalyRate = std::sqrt( sunGravitationalParameter_ / semiMajorAxis ) / semiMajorAxis /
+                ( 1.0 - eccentricity * cosineEccentricAnomaly );
+
+        const double planePositionX = semiMajorAxis * ( cosineEccentricAnomaly - eccentricity );
+        const double planePositionY = semiMajorAxis * semiMinorAxisRatio * sineEccentricAnomaly;
+        const double planeVelocityX = -semiMajorAxis * sineEccentricAnomaly * eccentricAnomalyRate;
+        const double planeVelocityY = semiMajorAxis * semiMinorAxisRatio * cosineEccentricAnomaly * eccentricAnomalyRate;
+
+        // Rotate to ecliptic frame
+        const double cosineArgument = std::cos( argumentOfPerihelion );
+        const double sineArgument = std::sin( argumentOfPerihelion );
+        const double cosineNode = std::cos( longitudeOfAscendingNode );
+        const double sineNode = std::sin( longitudeOfAscendingNode );
+        const double cosineInclination = std::cos( inclination );
+        const double sineInclination = std::sin( inclination );
+
+        const double xx = cosineArgument * cosineNode - sineArgument * sineNode * cosineInclination;
+        const double xy = -sineArgument * cosineNode - cosineArgument * sineNode * cosineInclination;
+        const double yx = cosineArgument * sineNode + sineArgument * cosineNode * cosineInclination;
+        const double yy = -sineArgument * sineNode + cosineArgument * cosineNode * cosineInclination;
+        const double zx = sineArgument * sineInclination;
+        const double zy = cosineArgument * sineInclination;
+
+        Eigen::Vector6d cartesianState;
+        cartesianState << xx * planePositionX + xy * planePositionY,
+                yx * planePositionX + yy * planePositionY,
+                zx * planePositionX + zy * planePositionY,
+                xx * planeVelocityX + xy * planeVelocityY,
+                yx * planeVelocityX + yy * planeVelocityY,
+                zx * planeVelocityX + zy * planeVelocityY;
+        return cartesianState;
+    }
+
+    //! Function to get the heliocentric Cartesian state of the planet
+    /*!
+     * Function to get the heliocentric Cartesian state of the planet
+     * \param secondsSinceEpoch Seconds since J2000
+     * \return Heliocentric Cartesian state of the planet, in the ecliptic J2000 frame
+     */
+    Eigen::Vector6d getCartesianState( const double secondsSinceEpoch )
+    {
+        return computeCartesianState( secondsSinceEpoch );
+    }
+
+private:
+
+    //! Semi-major axis (m) at J2000, and its rate (m/century)
+    double semiMajorAxis_, semiMajorAxisRate_;
+
+    //! Eccentricity at J2000, and its rate (1/century)
+    double eccentricity_, eccentricityRate_;
+
+    //! Inclination (deg) at J2000, and its rate (deg/century)
+    double inclination_, inclinationRate_;
+
+    //! Mean longitude (deg) at J2000, and its rate (deg/century)
+    double meanLongitude_, meanLongitudeRate_;
+
+    //! Longitude of perihelion (deg) at J2000, and its rate (deg/century)
+    double longitudeOfPerihelion_, longitudeOfPerihelionRate_;
+
+    //! Longitude of the ascending node (deg) at J2000, and its rate (deg/century)
+    double longitudeOfAscendingNode_, longitudeOfAscendingNodeRate_;
+
+    //! Gravitational parameter of the Sun
+    double sunGravitationalParameter_;
+};
+
+//! Function to retrieve the gravitational parameter of a solar system body, for use with analytic ephemerides
+/*!
+ *  Function to retrieve the gravitational parameter of a solar system body (Sun or planets), for use with analytic
+ *  ephemerides, so that no ephemeris or planetary constant kernels are required.
+ *  \param bodyName Name of body
+ *  \return Gravitational parameter of body
+ */
+double getAnalyticEphemerisGravitationalParameter( const std::string& bodyName );
+
+//! Function to create the body map for a patched conics trajectory, using analytic planet ephemerides
+/*!
+ *  Function to create the body map for a patched conics trajectory, using analytic planet ephemerides (see
+ *  AnalyticPlanetEphemeris), as alternative to setupBodyMapFromEphemeridesForPatchedConicsTrajectory. The central body (the
+ *  Sun) is placed at the origin of the frame, and the gravitational parameters are taken from
+ *  getAnalyticEphemerisGravitationalParameter. No Spice kernels are required to create or use the body map.
+ *  \param nameCentralBody Name of the central body (must be the Sun)
+ *  \param nameBodyToPropagate Name of the body to propagate (created without any properties)
+ *  \param nameTransferBodies Names of the bodies visited by the transfer
+ *  \param frameOrientation Orientation of the reference frame (only ECLIPJ2000 is supported)
+ *  \return Body map containing central body, transfer bodies and body to propagate
+ */
+tudat::simulation_setup::NamedBodyMap setupBodyMapFromAnalyticEphemeridesForPatchedConicsTrajectory(
+        const std::string& nameCentralBody,
+        const std::string& nameBodyToPropagate,
+        const std::vector< std::string >& nameTransferBodies,
+        const std::string& frameOrientation = "ECLIPJ2000" );
+
+} // namespace tudat_applications
+
+#endif // TUDAT_ANALYTICPLANETEPHEMERIS_H
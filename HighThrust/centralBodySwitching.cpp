@@ -0,0 +1,273 @@
+/*    Copyright (c) 2010-2018, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "centralBodySwitching.h"
+
+namespace tudat_applications
+{
+
+//! Function to retrieve the Cartesian state of a body w.r.t. another body, from their ephemerides
+static Eigen::Vector6d getRelativeStateFromEphemerides(
+        const tudat::simulation_setup::NamedBodyMap& bodyMap,
+        const std::string& bodyName,
+        const std::string& centralBodyName,
+        const double time )
+{
+    return bodyMap.at( bodyName )->getEphemeris( )->getCartesianState( time ) -
+            bodyMap.at( centralBodyName )->getEphemeris( )->getCartesianState( time );
+}
+
+//! Function to compute the radius of the sphere of influence of a body (Laplace definition)
+double computeSphereOfInfluenceRadius(
+        const tudat::simulation_setup::NamedBodyMap& bodyMap,
+        const std::string& bodyName,
+        const std::string& centralBodyName,
+        const double time )
+{
+    const double distance =
+            getRelativeStateFromEphemerides( bodyMap, bodyName, centralBodyName, time ).segment( 0, 3 ).norm( );
+    return distance * std::pow( bodyMap.at( bodyName )->getGravityFieldModel( )->getGravitationalParameter( ) /
+                                bodyMap.at( centralBodyName )->getGravityFieldModel( )->getGravitationalParameter( ), 0.4 );
+}
+
+//! Function to compute the pericenter state of a (ballistic) flyby from the incoming and outgoing excess velocities
+Eigen::Vector6d computeFlybyPericenterState(
+        const Eigen::Vector3d& incomingExcessVelocity,
+        const Eigen::Vector3d& outgoingExcessVelocity,
+        const double gravitationalParameter )
+{
+    const double excessSpeed = ( incomingExcessVelocity.norm( ) + outgoingExcessVelocity.norm( ) ) / 2.0;
+    const Eigen::Vector3d incomingDirection = incomingExcessVelocity.normalized( );
+    const Eigen::Vector3d outgoingDirection = outgoingExcessVelocity.normalized( );
+
+    // Compute pericenter radius from bending angle
+    const double bendingAngle = std::acos( std::max( -1.0, std::min( 1.0, incomingDirection.dot( outgoingDirection ) ) ) );
+    if( !( bendingAngle > 1.0E-10 ) || !( excessSpeed > 0.0 ) )
+    {
+        throw std::runtime_error( "Error when computing flyby pericenter state, excess velocity is not turned" );
+    }
+    const double pericenterRadius = gravitationalParameter / ( excessSpeed * excessSpeed ) *
+            ( 1.0 / std::sin( bendingAngle / 2.0 ) - 1.0 );
+
+    // Velocity at pericenter is along bisector of asymptotes, position is opposite to direction of velocity change
+    Eigen::Vector6d pericenterState;
+    pericenterState.segment( 0, 3 ) = pericenterRadius * ( incomingDirection - outgoingDirection ).normalized( );
+    pericenterState.segment( 3, 3 ) =
+            std::sqrt( excessSpeed * excessSpeed + 2.0 * gravitationalParameter / pericenterRadius ) *
+            ( incomingDirection + outgoingDirection ).normalized( );
+    return pericenterState;
+}
+
+//! Function to numerically propagate a translational state, with the central body switched inside spheres of influence
+std::map< double, Eigen::Vector6d > propagateWithCentralBodySwitching(
+        const tudat::simulation_setup::NamedBodyMap& bodyMap,
+        const tudat::simulation_setup::SelectedAccelerationMap& accelerationSettings,
+        const std::string& bodyToPropagate,
+        const std::string& globalCentralBody,
+        const std::vector< std::string >& switchingBodies,
+        const Eigen::Vector6d& initialState,
+        const double finalTime,
+        const std::shared_ptr< tudat::numerical_integrators::IntegratorSettings< > > integratorSettings,
+        std::vector< std::pair< double, std::string > >& centralBodySegments )
+{
+    using namespace tudat::propagators;
+
+    const double initialTime = integratorSettings->initialTime_;
+    const double initialTimeStep = integratorSettings->initialTimeStep_;
+    const double propagationDirection = ( finalTime >= initialTime ) ? 1.0 : -1.0;
+
+    // Retrieve maximum step size (if variable step size integrator is used), which is limited outside spheres of influence
+    std::shared_ptr< tudat::numerical_integrators::RungeKuttaVariableStepSizeSettings< > > variableStepSizeSettings =
+            std::dynamic_pointer_cast< tudat::numerical_integrators::RungeKuttaVariableStepSizeSettings< > >(
+                integratorSettings );
+    const double maximumStepSize = ( variableStepSizeSettings != nullptr ) ?
+                variableStepSizeSettings->maximumStepSize_ : TUDAT_NAN;
+
+    // Locate sphere of influence crossings exactly (in time)
+    std::shared_ptr< tudat::root_finders::RootFinderSettings > crossingRootFinderSettings =
+            std::make_shared< tudat::root_finders::RootFinderSettings >(
+                tudat::root_finders::bisection_root_finder, 1.0E-3, 100 );
+
+    // Compute sphere of influence radii at initial epoch
+    std::vector< double > sphereOfInfluenceRadii;
+    for( unsigned int i = 0; i < switchingBodies.size( ); i++ )
+    {
+        sphereOfInfluenceRadii.push_back( computeSphereOfInfluenceRadius(
+                                              bodyMap, switchingBodies.at( i ), globalCentralBody, initialTime ) );
+    }
+
+    std::map< double, Eigen::Vector6d > stateHistory;
+    centralBodySegments.clear( );
+
+    double currentTime = initialTime;
+    Eigen::Vector6d currentState = initialState;
+    stateHistory[ currentTime ] = currentState;
+
+    // Determine initial central body: switching body in whose sphere of influence the body is located (if any). For later
+    // segments, the central body follows from the sphere of influence crossing that ended the previous segment, since the
+    // state is then (to within the root finder tolerance) on the boundary.
+    int currentSwitchingBody = -1;
+    double lowestRelativeDistance = 1.0;
+    for( unsigned int i = 0; i < switchingBodies.size( ); i++ )
+    {
+        const double relativeDistance =
+                ( currentState - getRelativeStateFromEphemerides(
+                      bodyMap, switchingBodies.at( i ), globalCentralBody, currentTime ) ).segment( 0, 3 ).norm( ) /
+                sphereOfInfluenceRadii.at( i );
+        if( relativeDistance < lowestRelativeDistance )
+        {
+            lowestRelativeDistance = relativeDistance;
+            currentSwitchingBody = i;
+        }
+    }
+
+    while( propagationDirection * ( finalTime - currentTime ) > 0.0 )
+    {
+        if( centralBodySegments.size( ) > 100 )
+        {
+            throw std::runtime_error( "Error when propagating with central body switching, too many switches" );
+        }
+
+        // Set central body and termination settings of current segment (sphere of influence entry or exit)
+        std::string currentCentralBody;
+        Eigen::Vector6d centralBodyState = Eigen::Vector6d::Zero( );
+        std::vector< std::shared_ptr< PropagationTerminationSettings > > terminationSettingsList;
+        terminationSettingsList.push_back( std::make_shared< PropagationTimeTerminationSettings >( finalTime ) );
+        double segmentMaximumStepSize = maximumStepSize;
+        if( currentSwitchingBody < 0 )
+        {
+            currentCentralBody = globalCentralBody;
+            for( unsigned int i = 0; i < switchingBodies.size( ); i++ )
+            {
+                terminationSettingsList.push_back( std::make_shared< PropagationDependentVariableTerminationSettings >(
+                                                       std::make_shared< SingleDependentVariableSaveSettings >(
+                                                           relative_distance_dependent_variable, bodyToPropagate,
+                                                           switchingBodies.at( i ) ),
+                                                       sphereOfInfluenceRadii.at( i ), true, true,
+                                                       crossingRootFinderSettings ) );
+
+                // Limit step size to the time needed to cross the sphere of influence radius (at current relative speed),
+                // so that a sphere of influence cannot be entered and left within a single step
+                const double relativeSpeed = ( currentState - getRelativeStateFromEphemerides(
+                                                   bodyMap, switchingBodies.at( i ), globalCentralBody, currentTime ) ).
+                        segment( 3, 3 ).norm( );
+                if( relativeSpeed > 0.0 )
+                {
+                    segmentMaximumStepSize = std::min(
+                                segmentMaximumStepSize, sphereOfInfluenceRadii.at( i ) / relativeSpeed );
+                }
+            }
+        }
+        else
+        {
+            currentCentralBody = switchingBodies.at( currentSwitchingBody );
+            centralBodyState = getRelativeStateFromEphemerides(
+                        bodyMap, currentCentralBody, globalCentralBody, currentTime );
+            terminationSettingsList.push_back( std::make_shared< PropagationDependentVariableTerminationSettings >(
+                                                   std::make_shared< SingleDependentVariableSaveSettings >(
+                                                       relative_distance_dependent_variable, bodyToPropagate,
+                                                       currentCentralBody ),
+                                                   sphereOfInfluenceRadii.at( currentSwitchingBody ), false, true,
+                                                   crossingRootFinderSettings ) );
+        }
+        centralBodySegments.push_back( std::make_pair( currentTime, currentCentralBody ) );
+
+        // Create acceleration models and propagator settings w.r.t. current central body
+        std::vector< std::string > bodiesToPropagate = { bodyToPropagate };
+        std::vector< std::string > centralBodies = { currentCentralBody };
+        tudat::basic_astrodynamics::AccelerationMap accelerationModelMap = createAccelerationModelsMap(
+                    bodyMap, accelerationSettings, bodiesToPropagate, centralBodies );
+        std::shared_ptr< TranslationalStatePropagatorSettings< double > > propagatorSettings =
+                std::make_shared< TranslationalStatePropagatorSettings< double > >(
+                    centralBodies, accelerationModelMap, bodiesToPropagate,
+                    Eigen::VectorXd( currentState - centralBodyState ),
+                    std::make_shared< PropagationHybridTerminationSettings >( terminationSettingsList, true ), cowell );
+
+        // Propagate current segment
+        integratorSettings->initialTime_ = currentTime;
+        integratorSettings->initialTimeStep_ = propagationDirection * std::fabs( initialTimeStep );
+        if( variableStepSizeSettings != nullptr )
+        {
+            variableStepSizeSettings->maximumStepSize_ = segmentMaximumStepSize;
+            integratorSettings->initialTimeStep_ = propagationDirection * std::min(
+                        std::fabs( initialTimeStep ), segmentMaximumStepSize );
+        }
+        SingleArcDynamicsSimulator< > dynamicsSimulator( bodyMap, integratorSettings, propagatorSettings );
+
+        // Convert segment results to global central body
+        const std::map< double, Eigen::VectorXd >& segmentStateHistory =
+                dynamicsSimulator.getEquationsOfMotionNumericalSolution( );
+        for( const auto& stateIterator : segmentStateHistory )
+        {
+            Eigen::Vector6d globalState = stateIterator.second;
+            if( currentSwitchingBody >= 0 )
+            {
+                globalState += getRelativeStateFromEphemerides(
+                            bodyMap, currentCentralBody, globalCentralBody, stateIterator.first );
+            }
+            stateHistory[ stateIterator.first ] = globalState;
+        }
+
+        const double segmentFinalTime = ( propagationDirection > 0.0 ) ?
+                    segmentStateHistory.rbegin( )->first : segmentStateHistory.begin( )->first;
+        if( !( propagationDirection * ( segmentFinalTime - currentTime ) > 0.0 ) )
+        {
+            throw std::runtime_error( "Error when propagating with central body switching, no progress in segment" );
+        }
+        currentTime = segmentFinalTime;
+        currentState = stateHistory.at( currentTime );
+
+        // Determine central body of next segment from the crossing that terminated the current one (the first condition is
+        // the final time; the others are the exit of the current sphere of influence, or the entry of each switching body)
+        std::shared_ptr< PropagationTerminationDetails > terminationDetails =
+                dynamicsSimulator.getPropagationTerminationReason( );
+        if( terminationDetails->getPropagationTerminationReason( ) != termination_condition_reached )
+        {
+            throw std::runtime_error( "Error when propagating with central body switching, segment did not terminate on a "
+                                      "termination condition" );
+        }
+        std::vector< bool > wasConditionMet = std::dynamic_pointer_cast< PropagationTerminationDetailsFromHybridCondition >(
+                    terminationDetails )->getWasConditionMetWhenStopping( );
+        if( !wasConditionMet.at( 0 ) )
+        {
+            if( currentSwitchingBody >= 0 )
+            {
+                currentSwitchingBody = -1;
+            }
+            else
+            {
+                for( unsigned int i = 0; i < switchingBodies.size( ); i++ )
+                {
+                    if( wasConditionMet.at( i + 1 ) )
+                    {
+                        currentSwitchingBody = i;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    // Reset integrator settings
+    integratorSettings->initialTime_ = initialTime;
+    integratorSettings->initialTimeStep_ = initialTimeStep;
+    if( variableStepSizeSettings != nullptr )
+    {
+        variableStepSizeSettings->maximumStepSize_ = maximumStepSize;
+    }
+
+    return stateHistory;
+}
+
+} // namespace tudat_applications
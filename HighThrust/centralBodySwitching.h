@@ -0,0 +1,102 @@
+/*    Copyright (c) 2010-2018, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_CENTRALBODYSWITCHING_H
+#define TUDAT_CENTRALBODYSWITCHING_H
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <Tudat/SimulationSetup/tudatSimulationHeader.h>
+
+namespace tudat_applications
+{
+
+//! Function to compute the radius of the sphere of influence of a body (Laplace definition)
+/*!
+ *  Function to compute the radius of the sphere of influence of a body w.r.t. a central body (Laplace definition),
+ *  r_SOI = d * ( mu / mu_central )^(2/5), where d is the current distance between the bodies.
+ *  \param bodyMap List of body objects (ephemerides and gravity fields of both bodies must be defined)
+ *  \param bodyName Name of body for which the sphere of influence is to be computed
+ *  \param centralBodyName Name of central body
+ *  \param time Epoch at which the distance between the bodies is evaluated
+ *  \return Radius of sphere of influence
+ */
+double computeSphereOfInfluenceRadius(
+        const tudat::simulation_setup::NamedBodyMap& bodyMap,
+        const std::string& bodyName,
+        const std::string& centralBodyName,
+        const double time );
+
+//! Function to compute the pericenter state of a (ballistic) flyby from the incoming and outgoing excess velocities
+/*!
+ *  Function to compute the pericenter state of a (ballistic) flyby from the incoming and outgoing excess velocities, such that
+ *  the flyby hyperbola turns the incoming into the outgoing excess velocity direction. The excess speed of the hyperbola is
+ *  the mean of the incoming and outgoing excess speeds (a difference between the two would require a powered flyby).
+ *  \param incomingExcessVelocity Incoming excess velocity (w.r.t. flyby body)
+ *  \param outgoingExcessVelocity Outgoing excess velocity (w.r.t. flyby body)
+ *  \param gravitationalParameter Gravitational parameter of flyby body
+ *  \return Cartesian state at pericenter, w.r.t. flyby body
+ */
+Eigen::Vector6d computeFlybyPericenterState(
+        const Eigen::Vector3d& incomingExcessVelocity,
+        const Eigen::Vector3d& outgoingExcessVelocity,
+        const double gravitationalParameter );
+
+//! Function to numerically propagate a translational state, with the central body switched inside spheres of influence
+/*!
+ *  Function to numerically propagate a translational state, with the central body switched inside spheres of influence. Outside
+ *  all spheres of influence, the state is propagated w.r.t. the global central body (e.g. the Sun). When the propagated body
+ *  enters the sphere of influence of one of the switching bodies (e.g. the flyby planets), the propagation is terminated, the
+ *  state is converted to that body, and the propagation continues with that body as central body, until the propagated body
+ *  leaves the sphere of influence again (and vice versa). Since the dominant acceleration is then always a central one, with
+ *  the other bodies acting as third-body perturbations, the integrator is not forced to resolve a close flyby in heliocentric
+ *  coordinates, and can take large steps on both sides of the boundary.
+ *
+ *  The sphere of influence crossings are located exactly (by a root finder on the distance to the body). Outside all spheres
+ *  of influence, the maximum step size of a variable step size integrator is limited to the time needed to cross the
+ *  radius of each sphere of influence (at the relative speed at the start of the segment), so that a sphere of influence
+ *  cannot be stepped over (for a fixed step size integrator, the step size should be chosen accordingly).
+ *
+ *  The same acceleration settings and integrator settings are used for each segment; the acceleration models are recreated
+ *  for each segment, with the current central body. The acceleration settings must therefore contain point mass gravity of
+ *  the global central body and of all switching bodies. The sphere of influence radii are computed once, at the initial
+ *  epoch. Propagation is performed backwards if the final time is smaller than the initial time. Note that the dynamics in
+ *  the two frames are only identical if the ephemerides are consistent with the acceleration models (the indirect third-body
+ *  terms assume that each central body is accelerated by the other bodies, which is not the case for a Sun fixed at the
+ *  origin).
+ *  \param bodyMap List of body objects
+ *  \param accelerationSettings Acceleration settings of propagated body
+ *  \param bodyToPropagate Name of propagated body
+ *  \param globalCentralBody Name of global central body
+ *  \param switchingBodies Names of bodies inside whose sphere of influence the central body is switched
+ *  \param initialState Initial Cartesian state, w.r.t. global central body
+ *  \param finalTime Final epoch of propagation
+ *  \param integratorSettings Integrator settings, with the initial epoch of propagation (initial time, time step and maximum
+ *  step size are modified during the propagation, and reset afterwards)
+ *  \param centralBodySegments List of propagation segments (start epoch and central body), returned by reference
+ *  \return State history of propagated body, w.r.t. global central body
+ */
+std::map< double, Eigen::Vector6d > propagateWithCentralBodySwitching(
+        const tudat::simulation_setup::NamedBodyMap& bodyMap,
+        const tudat::simulation_setup::SelectedAccelerationMap& accelerationSettings,
+        const std::string& bodyToPropagate,
+        const std::string& globalCentralBody,
+        const std::vector< std::string >& switchingBodies,
+        const Eigen::Vector6d& initialState,
+        const double finalTime,
+        const std::shared_ptr< tudat::numerical_integrators::IntegratorSettings< > > integratorSettings,
+        std::vector< std::pair< double, std::string > >& centralBodySegments );
+
+} // namespace tudat_applications
+
+#endif // TUDAT_CENTRALBODYSWITCHING_H
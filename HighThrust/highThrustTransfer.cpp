@@ -0,0 +1,276 @@
+/*    Copyright (c) 2010-2018, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "highThrustTransfer.h"
+
+namespace tudat_applications
+{
+
+//! Function to compute the Stumpff functions C(z) and S(z), used in the universal-variable formulation of Kepler's equation
+void computeStumpffFunctions( const double z, double& stumpffC, double& stumpffS )
+{
+    if( z > 1.0E-6 )
+    {
+        double squareRootZ = std::sqrt( z );
+        stumpffC = ( 1.0 - std::cos( squareRootZ ) ) / z;
+        stumpffS = ( squareRootZ - std::sin( squareRootZ ) ) / ( z * squareRootZ );
+    }
+    else if( z < -1.0E-6 )
+    {
+        double squareRootMinusZ = std::sqrt( -z );
+        stumpffC = ( 1.0 - std::cosh( squareRootMinusZ ) ) / z;
+        stumpffS = ( std::sinh( squareRootMinusZ ) - squareRootMinusZ ) / ( -z * squareRootMinusZ );
+    }
+    else
+    {
+        stumpffC = 1.0 / 2.0 - z / 24.0 + z * z / 720.0;
+        stumpffS = 1.0 / 6.0 - z / 120.0 + z * z / 5040.0;
+    }
+}
+
+//! Function to propagate a Cartesian state along a Keplerian orbit, using universal variables and Lagrange coefficients
+Eigen::Vector6d propagateKeplerOrbitWithUniversalVariables(
+        const Eigen::Vector6d& initialCartesianState,
+        const double propagationTime,
+        const double gravitationalParameter,
+        const double tolerance,
+        const int maximumNumberOfIterations )
+{
+    if( propagationTime == 0.0 )
+    {
+        return initialCartesianState;
+    }
+
+    const Eigen::Vector3d initialPosition = initialCartesianState.segment( 0, 3 );
+    const Eigen::Vector3d initialVelocity = initialCartesianState.segment( 3, 3 );
+
+    const double initialRadius = initialPosition.norm( );
+    const double squareRootGravitationalParameter = std::sqrt( gravitationalParameter );
+    const double radialVelocityTerm = initialPosition.dot( initialVelocity ) / squareRootGravitationalParameter;
+
+    // Reciprocal of semi-major axis (positive for elliptical, negative for hyperbolic orbits)
+    const double alpha = 2.0 / initialRadius - initialVelocity.squaredNorm( ) / gravitationalParameter;
+
+    // Set initial guess for universal anomaly (see Vallado, 2013)
+    double universalAnomaly;
+    if( alpha > 1.0E-12 )
+    {
+        universalAnomaly = squareRootGravitationalParameter * propagationTime * alpha;
+    }
+    else if( alpha < -1.0E-12 )
+    {
+        double semiMajorAxis = 1.0 / alpha;
+        double timeSign = ( propagationTime > 0.0 ) ? 1.0 : -1.0;
+        universalAnomaly = timeSign * std::sqrt( -semiMajorAxis ) * std::log(
+                    ( -2.0 * gravitationalParameter * alpha * propagationTime ) /
+                    ( initialPosition.dot( initialVelocity ) + timeSign * std::sqrt( -gravitationalParameter * semiMajorAxis ) *
+                      ( 1.0 - initialRadius * alpha ) ) );
+    }
+    else
+    {
+        universalAnomaly = squareRootGravitationalParameter * propagationTime / initialRadius;
+    }
+
+    // Solve universal Kepler equation using Laguerre-Conway iterations (which, contrary to Newton-Raphson iterations, do not
+    // diverge for long arcs on highly eccentric orbits)
+    double z = 0.0, stumpffC = 0.5, stumpffS = 1.0 / 6.0;
+    double currentRadius = initialRadius;
+    for( int i = 0; i < maximumNumberOfIterations; i++ )
+    {
+        double universalAnomalySquared = universalAnomaly * universalAnomaly;
+        z = alpha * universalAnomalySquared;
+        computeStumpffFunctions( z, stumpffC, stumpffS );
+
+        double timeFunction =
+                radialVelocityTerm * universalAnomalySquared * stumpffC +
+                ( 1.0 - alpha * initialRadius ) * universalAnomalySquared * universalAnomaly * stumpffS +
+                initialRadius * universalAnomaly - squareRootGravitationalParameter * propagationTime;
+        currentRadius =
+                universalAnomalySquared * stumpffC +
+                radialVelocityTerm * universalAnomaly * ( 1.0 - z * stumpffS ) +
+                initialRadius * ( 1.0 - z * stumpffC );
+
+        double radiusDerivative =
+                radialVelocityTerm * ( 1.0 - z * stumpffC ) +
+                ( 1.0 - alpha * initialRadius ) * universalAnomaly * ( 1.0 - z * stumpffS );
+
+        double universalAnomalyCorrection = 5.0 * timeFunction / ( currentRadius + std::sqrt( std::fabs(
+                16.0 * currentRadius * currentRadius - 20.0 * timeFunction * radiusDerivative ) ) );
+        universalAnomaly -= universalAnomalyCorrection;
+
+        if( std::fabs( universalAnomalyCorrection ) <= tolerance * std::max( 1.0, std::fabs( universalAnomaly ) ) )
+        {
+            break;
+        }
+    }
+
+    // Update Stumpff functions and radius for converged universal anomaly
+    double universalAnomalySquared = universalAnomaly * universalAnomaly;
+    z = alpha * universalAnomalySquared;
+    computeStumpffFunctions( z, stumpffC, stumpffS );
+
+    // Compute Lagrange coefficients and propagated state
+    double lagrangeF = 1.0 - universalAnomalySquared / initialRadius * stumpffC;
+    double lagrangeG = propagationTime -
+            universalAnomalySquared * universalAnomaly / squareRootGravitationalParameter * stumpffS;
+
+    Eigen::Vector6d propagatedState;
+    propagatedState.segment( 0, 3 ) = lagrangeF * initialPosition + lagrangeG * initialVelocity;
+    currentRadius = propagatedState.segment( 0, 3 ).norm( );
+
+    double lagrangeFDot = squareRootGravitationalParameter / ( currentRadius * initialRadius ) *
+            universalAnomaly * ( z * stumpffS - 1.0 );
+    double lagrangeGDot = 1.0 - universalAnomalySquared / currentRadius * stumpffC;
+    propagatedState.segment( 3, 3 ) = lagrangeFDot * initialPosition + lagrangeGDot * initialVelocity;
+
+    return propagatedState;
+}
+
+//! Typedef for arrays used in the batch Kepler propagation, allocated on the stack (chunks of at most 64 states)
+typedef Eigen::Array< double, Eigen::Dynamic, 1, Eigen::ColMajor, 64, 1 > KeplerChunkArray;
+
+//! Function to compute the Stumpff functions C(z) and S(z) for an array of arguments
+static void computeStumpffFunctions( const KeplerChunkArray& z, KeplerChunkArray& stumpffC, KeplerChunkArray& stumpffS )
+{
+    // Start from series expansion, and overwrite elliptic/hyperbolic entries. Each branch is only evaluated if it is required
+    // for any of the entries (values of the branch for other entries are discarded).
+    stumpffC = 1.0 / 2.0 - z / 24.0 + z * z / 720.0;
+    stumpffS = 1.0 / 6.0 - z / 120.0 + z * z / 5040.0;
+
+    if( ( z > 1.0E-6 ).any( ) )
+    {
+        KeplerChunkArray squareRootZ = z.max( 1.0E-6 ).sqrt( );
+        stumpffC = ( z > 1.0E-6 ).select( ( 1.0 - squareRootZ.cos( ) ) / z, stumpffC );
+        stumpffS = ( z > 1.0E-6 ).select( ( squareRootZ - squareRootZ.sin( ) ) / ( z * squareRootZ ), stumpffS );
+    }
+
+    if( ( z < -1.0E-6 ).any( ) )
+    {
+        KeplerChunkArray squareRootMinusZ = ( -z ).max( 1.0E-6 ).sqrt( );
+        stumpffC = ( z < -1.0E-6 ).select( ( 1.0 - squareRootMinusZ.cosh( ) ) / z, stumpffC );
+        stumpffS = ( z < -1.0E-6 ).select(
+                    ( squareRootMinusZ.sinh( ) - squareRootMinusZ ) / ( -z * squareRootMinusZ ), stumpffS );
+    }
+}
+
+//! Function to propagate a chunk of Cartesian states along Keplerian orbits, using universal variables (in-place)
+static void propagateKeplerOrbitChunkWithUniversalVariables(
+        Eigen::Ref< BatchCartesianStates > cartesianStates,
+        const Eigen::Ref< const Eigen::ArrayXd >& propagationTimes,
+        const double gravitationalParameter,
+        const double tolerance,
+        const int maximumNumberOfIterations )
+{
+    const int numberOfStates = static_cast< int >( cartesianStates.rows( ) );
+
+    const double squareRootGravitationalParameter = std::sqrt( gravitationalParameter );
+
+    // Retrieve initial position and velocity components (each contiguous over the batch)
+    const KeplerChunkArray x0 = cartesianStates.col( 0 ).array( );
+    const KeplerChunkArray y0 = cartesianStates.col( 1 ).array( );
+    const KeplerChunkArray z0 = cartesianStates.col( 2 ).array( );
+    const KeplerChunkArray vx0 = cartesianStates.col( 3 ).array( );
+    const KeplerChunkArray vy0 = cartesianStates.col( 4 ).array( );
+    const KeplerChunkArray vz0 = cartesianStates.col( 5 ).array( );
+
+    const KeplerChunkArray initialRadius = ( x0 * x0 + y0 * y0 + z0 * z0 ).sqrt( );
+    const KeplerChunkArray positionDotVelocity = x0 * vx0 + y0 * vy0 + z0 * vz0;
+    const KeplerChunkArray radialVelocityTerm = positionDotVelocity / squareRootGravitationalParameter;
+    const KeplerChunkArray alpha = 2.0 / initialRadius - ( vx0 * vx0 + vy0 * vy0 + vz0 * vz0 ) / gravitationalParameter;
+
+    // Set initial guess for universal anomaly (see Vallado, 2013)
+    KeplerChunkArray ellipticGuess = squareRootGravitationalParameter * propagationTimes * alpha;
+    KeplerChunkArray hyperbolicSemiMajorAxis = 1.0 / alpha.min( -1.0E-12 );
+    KeplerChunkArray timeSign = ( propagationTimes > 0.0 ).select(
+                KeplerChunkArray::Ones( numberOfStates ), -KeplerChunkArray::Ones( numberOfStates ) );
+    KeplerChunkArray hyperbolicGuess = timeSign * ( -hyperbolicSemiMajorAxis ).sqrt( ) * (
+                ( -2.0 * gravitationalParameter / hyperbolicSemiMajorAxis * propagationTimes ) /
+                ( positionDotVelocity + timeSign * ( -gravitationalParameter * hyperbolicSemiMajorAxis ).sqrt( ) *
+                  ( 1.0 - initialRadius / hyperbolicSemiMajorAxis ) ) ).log( );
+    KeplerChunkArray parabolicGuess = squareRootGravitationalParameter * propagationTimes / initialRadius;
+    KeplerChunkArray universalAnomaly = ( propagationTimes == 0.0 ).select(
+                0.0, ( alpha > 1.0E-12 ).select(
+                    ellipticGuess, ( alpha < -1.0E-12 ).select( hyperbolicGuess, parabolicGuess ) ) );
+
+    // Solve universal Kepler equation for all states simultaneously, using Laguerre-Conway iterations
+    KeplerChunkArray universalAnomalySquared, z, stumpffC, stumpffS, timeFunction, currentRadius, universalAnomalyCorrection;
+    for( int i = 0; i < maximumNumberOfIterations; i++ )
+    {
+        universalAnomalySquared = universalAnomaly.square( );
+        z = alpha * universalAnomalySquared;
+        computeStumpffFunctions( z, stumpffC, stumpffS );
+
+        timeFunction = radialVelocityTerm * universalAnomalySquared * stumpffC +
+                ( 1.0 - alpha * initialRadius ) * universalAnomalySquared * universalAnomaly * stumpffS +
+                initialRadius * universalAnomaly - squareRootGravitationalParameter * propagationTimes;
+        currentRadius = universalAnomalySquared * stumpffC +
+                radialVelocityTerm * universalAnomaly * ( 1.0 - z * stumpffS ) +
+                initialRadius * ( 1.0 - z * stumpffC );
+
+        universalAnomalyCorrection = 5.0 * timeFunction / ( currentRadius + ( 16.0 * currentRadius.square( ) - 20.0 *
+                timeFunction * ( radialVelocityTerm * ( 1.0 - z * stumpffC ) +
+                                 ( 1.0 - alpha * initialRadius ) * universalAnomaly * ( 1.0 - z * stumpffS ) ) ).abs( ).sqrt( ) );
+        universalAnomaly -= universalAnomalyCorrection;
+
+        if( !( universalAnomalyCorrection.abs( ) > tolerance * universalAnomaly.abs( ).max( 1.0 ) ).any( ) )
+        {
+            break;
+        }
+    }
+
+    // Compute Lagrange coefficients for converged universal anomalies
+    universalAnomalySquared = universalAnomaly.square( );
+    z = alpha * universalAnomalySquared;
+    computeStumpffFunctions( z, stumpffC, stumpffS );
+
+    const KeplerChunkArray lagrangeF = 1.0 - universalAnomalySquared / initialRadius * stumpffC;
+    const KeplerChunkArray lagrangeG = propagationTimes -
+            universalAnomalySquared * universalAnomaly / squareRootGravitationalParameter * stumpffS;
+
+    cartesianStates.col( 0 ).array( ) = lagrangeF * x0 + lagrangeG * vx0;
+    cartesianStates.col( 1 ).array( ) = lagrangeF * y0 + lagrangeG * vy0;
+    cartesianStates.col( 2 ).array( ) = lagrangeF * z0 + lagrangeG * vz0;
+
+    currentRadius = cartesianStates.leftCols( 3 ).rowwise( ).norm( ).array( );
+    const KeplerChunkArray lagrangeFDot = squareRootGravitationalParameter / ( currentRadius * initialRadius ) *
+            universalAnomaly * ( z * stumpffS - 1.0 );
+    const KeplerChunkArray lagrangeGDot = 1.0 - universalAnomalySquared / currentRadius * stumpffC;
+
+    cartesianStates.col( 3 ).array( ) = lagrangeFDot * x0 + lagrangeGDot * vx0;
+    cartesianStates.col( 4 ).array( ) = lagrangeFDot * y0 + lagrangeGDot * vy0;
+    cartesianStates.col( 5 ).array( ) = lagrangeFDot * z0 + lagrangeGDot * vz0;
+}
+
+//! Function to propagate a batch of Cartesian states along Keplerian orbits, using universal variables (in-place)
+void propagateKeplerOrbitsWithUniversalVariables(
+        Eigen::Ref< BatchCartesianStates > cartesianStates,
+        const Eigen::Ref< const Eigen::ArrayXd >& propagationTimes,
+        const double gravitationalParameter,
+        const double tolerance,
+        const int maximumNumberOfIterations )
+{
+    // Process batch in chunks, so that the working arrays stay in cache, and the number of iterations is determined by the
+    // slowest-converging state of each chunk, instead of the entire batch
+    const int chunkSize = 64;
+    const int numberOfStates = static_cast< int >( cartesianStates.rows( ) );
+    for( int startIndex = 0; startIndex < numberOfStates; startIndex += chunkSize )
+    {
+        int currentChunkSize = std::min( chunkSize, numberOfStates - startIndex );
+        propagateKeplerOrbitChunkWithUniversalVariables(
+                    cartesianStates.middleRows( startIndex, currentChunkSize ),
+                    propagationTimes.segment( startIndex, currentChunkSize ),
+                    gravitationalParameter, tolerance, maximumNumberOfIterations );
+    }
+}
+
+} // namespace tudat_applications
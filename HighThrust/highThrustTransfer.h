@@ -0,0 +1,79 @@
+/*    Copyright (c) 2010-2018, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_HIGHTHRUSTTRANSFER_H
+#define TUDAT_HIGHTHRUSTTRANSFER_H
+
+#include <Tudat/Basics/basicTypedefs.h>
+
+namespace tudat_applications
+{
+
+//! Typedef for the Cartesian states of a batch of trajectories, in structure-of-arrays layout (one row per trajectory)
+/*!
+ *  Typedef for the Cartesian states of a batch of trajectories, in structure-of-arrays layout (one row per trajectory). Since
+ *  the matrix is stored column-major, each state component is contiguous in memory over all trajectories.
+ */
+typedef Eigen::Matrix< double, Eigen::Dynamic, 6 > BatchCartesianStates;
+
+//! Function to compute the Stumpff functions C(z) and S(z), used in the universal-variable formulation of Kepler's equation
+/*!
+ *  Function to compute the Stumpff functions C(z) and S(z), used in the universal-variable formulation of Kepler's equation.
+ *  For |z| close to zero, a series expansion is used to avoid cancellation errors.
+ *  \param z Argument of the Stumpff functions (alpha * chi^2)
+ *  \param stumpffC Stumpff function C(z) (returned by reference)
+ *  \param stumpffS Stumpff function S(z) (returned by reference)
+ */
+void computeStumpffFunctions( const double z, double& stumpffC, double& stumpffS );
+
+//! Function to propagate a Cartesian state along a Keplerian orbit, using universal variables and Lagrange coefficients
+/*!
+ *  Function to propagate a Cartesian state along a Keplerian orbit, using universal variables and Lagrange coefficients.
+ *  Contrary to a propagation in Keplerian elements, no element conversions are required, and the same function is valid for
+ *  elliptical, parabolic and hyperbolic orbits. This makes it suitable for fast evaluation of (many) short coast arcs, such as
+ *  the segments of a Sims-Flanagan low-thrust leg.
+ *  \param initialCartesianState Cartesian state at the start of the propagation
+ *  \param propagationTime Time over which the state is to be propagated (may be negative)
+ *  \param gravitationalParameter Gravitational parameter of the central body
+ *  \param tolerance Relative tolerance on the universal anomaly used to terminate the Laguerre-Conway iterations
+ *  \param maximumNumberOfIterations Maximum number of Laguerre-Conway iterations
+ *  \return Cartesian state after the propagation
+ */
+Eigen::Vector6d propagateKeplerOrbitWithUniversalVariables(
+        const Eigen::Vector6d& initialCartesianState,
+        const double propagationTime,
+        const double gravitationalParameter,
+        const double tolerance = 1.0E-13,
+        const int maximumNumberOfIterations = 50 );
+
+//! Function to propagate a batch of Cartesian states along Keplerian orbits, using universal variables (in-place)
+/*!
+ *  Function to propagate a batch of Cartesian states along Keplerian orbits, using universal variables. Identical to
+ *  propagateKeplerOrbitWithUniversalVariables, but all trajectories in the batch are processed simultaneously using array
+ *  operations on the structure-of-arrays state storage, so that the Laguerre-Conway iterations for the universal anomaly are
+ *  vectorized over the batch. Iterations proceed until all trajectories have converged (or the maximum number of iterations is
+ *  reached).
+ *  \param cartesianStates Cartesian states at the start of the propagation (one row per trajectory). Overwritten by the
+ *  propagated states.
+ *  \param propagationTimes Time over which each of the states is to be propagated
+ *  \param gravitationalParameter Gravitational parameter of the central body
+ *  \param tolerance Relative tolerance on the universal anomaly used to terminate the Laguerre-Conway iterations
+ *  \param maximumNumberOfIterations Maximum number of Laguerre-Conway iterations
+ */
+void propagateKeplerOrbitsWithUniversalVariables(
+        Eigen::Ref< BatchCartesianStates > cartesianStates,
+        const Eigen::Ref< const Eigen::ArrayXd >& propagationTimes,
+        const double gravitationalParameter,
+        const double tolerance = 1.0E-13,
+        const int maximumNumberOfIterations = 50 );
+
+} // namespace tudat_applications
+
+#endif // TUDAT_HIGHTHRUSTTRANSFER_H
@@ -0,0 +1,117 @@
+/*    Copyright (c) 2010-2018, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "../parallelExecution.h"
+#include "lambertGridSweep.h"
+#include "multiRevolutionLambert.h"
+
+namespace tudat_applications
+{
+
+//! Function to solve the (zero-revolution) Lambert problems on a grid of departure epochs and times of flight
+LambertGridSweepResults sweepLambertGrid(
+        const std::shared_ptr< tudat::ephemerides::Ephemeris > departureBodyEphemeris,
+        const std::shared_ptr< tudat::ephemerides::Ephemeris > arrivalBodyEphemeris,
+        const Eigen::VectorXd& departureEpochs,
+        const Eigen::VectorXd& timesOfFlight,
+        const double centralBodyGravitationalParameter,
+        const bool useWarmStart,
+        const int numberOfThreads )
+{
+    const int numberOfDepartureEpochs = departureEpochs.rows( );
+    const int numberOfTimesOfFlight = timesOfFlight.rows( );
+    if( numberOfDepartureEpochs == 0 || numberOfTimesOfFlight == 0 )
+    {
+        throw std::runtime_error( "Error when sweeping Lambert grid, grid is empty" );
+    }
+
+    // Retrieve all body states in calling thread (ephemerides need not be thread-safe)
+    std::vector< Eigen::Vector6d > departureStates( numberOfDepartureEpochs );
+    std::vector< Eigen::Vector6d > arrivalStates( numberOfDepartureEpochs * numberOfTimesOfFlight );
+    for( int i = 0; i < numberOfDepartureEpochs; i++ )
+    {
+        departureStates[ i ] = departureBodyEphemeris->getCartesianState( departureEpochs( i ) );
+        for( int j = 0; j < numberOfTimesOfFlight; j++ )
+        {
+            arrivalStates[ i * numberOfTimesOfFlight + j ] =
+                    arrivalBodyEphemeris->getCartesianState( departureEpochs( i ) + timesOfFlight( j ) );
+        }
+    }
+
+    LambertGridSweepResults results;
+    results.departureExcessVelocities.resize( numberOfDepartureEpochs, numberOfTimesOfFlight );
+    results.arrivalExcessVelocities.resize( numberOfDepartureEpochs, numberOfTimesOfFlight );
+    results.numberOfIterations.resize( numberOfDepartureEpochs, numberOfTimesOfFlight );
+
+    // Sweep each block of rows in serpentine order
+    parallelForEachBlock( numberOfDepartureEpochs, [ & ]( const int startIndex, const int blockSize, const int )
+    {
+        std::vector< double > initialGuess;
+        double previousX = std::numeric_limits< double >::quiet_NaN( );
+        double secondPreviousX = std::numeric_limits< double >::quiet_NaN( );
+        for( int i = startIndex; i < startIndex + blockSize; i++ )
+        {
+            const bool isReversedRow = ( ( i - startIndex ) % 2 == 1 );
+            for( int k = 0; k < numberOfTimesOfFlight; k++ )
+            {
+                const int j = isReversedRow ? ( numberOfTimesOfFlight - 1 - k ) : k;
+
+                // Set initial guess from previous cell, extrapolated along the row if the two previous cells are on it
+                initialGuess.clear( );
+                if( useWarmStart && std::isfinite( previousX ) )
+                {
+                    double extrapolatedX = previousX;
+                    if( k > 1 && std::isfinite( secondPreviousX ) )
+                    {
+                        extrapolatedX = 2.0 * previousX - secondPreviousX;
+                    }
+                    initialGuess.push_back( ( extrapolatedX > -1.0 ) ? extrapolatedX : previousX );
+                }
+
+                std::vector< LambertBranchSolution > solution = solveLambertProblemForAllBranches(
+                            departureStates[ i ].segment( 0, 3 ),
+                            arrivalStates[ i * numberOfTimesOfFlight + j ].segment( 0, 3 ),
+                            timesOfFlight( j ), centralBodyGravitationalParameter, 0, false, initialGuess );
+                int numberOfIterations = solution.at( 0 ).numberOfIterations;
+
+                // Solve again from generic initial guess if warm-started solution did not converge
+                if( initialGuess.size( ) > 0 && ( numberOfIterations >= 15 ||
+                                                  !std::isfinite( solution.at( 0 ).independentVariable ) ) )
+                {
+                    solution = solveLambertProblemForAllBranches(
+                                departureStates[ i ].segment( 0, 3 ),
+                                arrivalStates[ i * numberOfTimesOfFlight + j ].segment( 0, 3 ),
+                                timesOfFlight( j ), centralBodyGravitationalParameter, 0 );
+                    numberOfIterations += solution.at( 0 ).numberOfIterations;
+                }
+
+                results.departureExcessVelocities( i, j ) =
+                        ( solution.at( 0 ).departureVelocity - departureStates[ i ].segment( 3, 3 ) ).norm( );
+                results.arrivalExcessVelocities( i, j ) =
+                        ( solution.at( 0 ).arrivalVelocity -
+                          arrivalStates[ i * numberOfTimesOfFlight + j ].segment( 3, 3 ) ).norm( );
+                results.numberOfIterations( i, j ) = numberOfIterations;
+
+                // Reset extrapolation at start of each row
+                secondPreviousX = ( k > 0 ) ? previousX : std::numeric_limits< double >::quiet_NaN( );
+                previousX = solution.at( 0 ).independentVariable;
+            }
+        }
+    }, numberOfThreads );
+
+    return results;
+}
+
+} // namespace tudat_applications
@@ -0,0 +1,77 @@
+/*    Copyright (c) 2010-2018, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_LAMBERTGRIDSWEEP_H
+#define TUDAT_LAMBERTGRIDSWEEP_H
+
+#include <memory>
+
+#include <Tudat/Basics/basicTypedefs.h>
+#include <Tudat/Astrodynamics/Ephemerides/ephemeris.h>
+
+namespace tudat_applications
+{
+
+//! Struct containing the results of a Lambert problem sweep over a grid of departure epochs and times of flight
+/*!
+ *  Struct containing the results of a Lambert problem sweep over a grid of departure epochs and times of flight (e.g. for a
+ *  porkchop plot). In all matrices, each row corresponds to a departure epoch, and each column to a time of flight.
+ */
+struct LambertGridSweepResults
+{
+    //! Norm of excess velocity at departure
+    Eigen::MatrixXd departureExcessVelocities;
+
+    //! Norm of excess velocity at arrival
+    Eigen::MatrixXd arrivalExcessVelocities;
+
+    //! Number of iterations required for convergence of the Lambert solver
+    Eigen::MatrixXi numberOfIterations;
+
+    //! Function to retrieve the average number of iterations per Lambert problem
+    double getAverageNumberOfIterations( ) const
+    {
+        return numberOfIterations.cast< double >( ).mean( );
+    }
+};
+
+//! Function to solve the (zero-revolution) Lambert problems on a grid of departure epochs and times of flight
+/*!
+ *  Function to solve the (zero-revolution) Lambert problems on a grid of departure epochs and times of flight, for a transfer
+ *  between two bodies (e.g. for a porkchop plot or launch window analysis). Since adjacent grid cells have nearly identical
+ *  solutions, the grid can be evaluated in sweep order: the rows (departure epochs) are traversed in serpentine order (time
+ *  of flight increasing on even rows, decreasing on odd rows), so that each cell is a direct neighbour of the previously
+ *  evaluated cell. The converged independent variable of the previous cell(s) is then used as initial guess of the solver
+ *  (linearly extrapolated along the current row where possible), instead of the generic initial guess. If a warm-started
+ *  solution does not converge, the Lambert problem is solved again from the generic initial guess.
+ *
+ *  The body states are retrieved from the ephemerides in the calling thread; when using multiple threads, the rows are
+ *  distributed over the threads in contiguous blocks, each of which is swept independently.
+ *  \param departureBodyEphemeris Ephemeris of departure body (w.r.t. central body)
+ *  \param arrivalBodyEphemeris Ephemeris of arrival body (w.r.t. central body)
+ *  \param departureEpochs Departure epochs of the grid
+ *  \param timesOfFlight Times of flight of the grid
+ *  \param centralBodyGravitationalParameter Gravitational parameter of the central body
+ *  \param useWarmStart Boolean denoting whether the solution of neighbouring cells is used as initial guess
+ *  \param numberOfThreads Number of threads to use (if smaller than 1, the default number of threads is used)
+ *  \return Excess velocities and number of solver iterations for all grid cells
+ */
+LambertGridSweepResults sweepLambertGrid(
+        const std::shared_ptr< tudat::ephemerides::Ephemeris > departureBodyEphemeris,
+        const std::shared_ptr< tudat::ephemerides::Ephemeris > arrivalBodyEphemeris,
+        const Eigen::VectorXd& departureEpochs,
+        const Eigen::VectorXd& timesOfFlight,
+        const double centralBodyGravitationalParameter,
+        const bool useWarmStart = true,
+        const int numberOfThreads = 1 );
+
+} // namespace tudat_applications
+
+#endif // TUDAT_LAMBERTGRIDSWEEP_H
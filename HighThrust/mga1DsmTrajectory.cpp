@@ -0,0 +1,291 @@
+/*    Copyright (c) 2010-2018, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include <Tudat/Astrodynamics/MissionSegments/lambertRoutines.h>
+#include <Tudat/Mathematics/BasicMathematics/mathematicalConstants.h>
+
+#include "../parallelExecution.h"
+#include "mga1DsmTrajectory.h"
+#include "multiRevolutionLambert.h"
+
+namespace tudat_applications
+{
+
+//! Typedef for a batch of three-dimensional vectors, in structure-of-arrays layout (one row per trajectory)
+typedef Eigen::Array< double, Eigen::Dynamic, 3 > BatchVectors;
+
+//! Function to compute the row-wise cross product of two batches of vectors
+static BatchVectors computeRowWiseCrossProduct( const BatchVectors& firstVectors, const BatchVectors& secondVectors )
+{
+    BatchVectors crossProducts( firstVectors.rows( ), 3 );
+    crossProducts.col( 0 ) = firstVectors.col( 1 ) * secondVectors.col( 2 ) - firstVectors.col( 2 ) * secondVectors.col( 1 );
+    crossProducts.col( 1 ) = firstVectors.col( 2 ) * secondVectors.col( 0 ) - firstVectors.col( 0 ) * secondVectors.col( 2 );
+    crossProducts.col( 2 ) = firstVectors.col( 0 ) * secondVectors.col( 1 ) - firstVectors.col( 1 ) * secondVectors.col( 0 );
+    return crossProducts;
+}
+
+//! Function to compute the row-wise norm of a batch of vectors
+static Eigen::ArrayXd computeRowWiseNorm( const BatchVectors& vectors )
+{
+    return vectors.square( ).rowwise( ).sum( ).sqrt( );
+}
+
+//! Function to compute the outgoing excess velocity of a batch of unpowered flybys
+/*!
+ *  Function to compute the outgoing excess velocity of a batch of unpowered flybys, by rotating the incoming excess velocity
+ *  over the turn angle that corresponds to the pericenter radius, in the plane defined by the b-plane angle.
+ */
+static BatchVectors computeOutgoingExcessVelocities(
+        const BatchVectors& incomingExcessVelocities,
+        const BatchVectors& planetVelocities,
+        const Eigen::ArrayXd& pericenterRadii,
+        const Eigen::ArrayXd& bPlaneAngles,
+        const double planetGravitationalParameter )
+{
+    const Eigen::ArrayXd incomingSpeed = computeRowWiseNorm( incomingExcessVelocities );
+
+    // Set up flyby frame
+    BatchVectors firstUnitVectors = incomingExcessVelocities.colwise( ) / incomingSpeed;
+    BatchVectors secondUnitVectors = computeRowWiseCrossProduct( firstUnitVectors, planetVelocities );
+    secondUnitVectors.colwise( ) /= computeRowWiseNorm( secondUnitVectors );
+    BatchVectors thirdUnitVectors = computeRowWiseCrossProduct( firstUnitVectors, secondUnitVectors );
+
+    // Compute turn angle of hyperbolic flyby
+    const Eigen::ArrayXd eccentricity =
+            1.0 + pericenterRadii * incomingSpeed.square( ) / planetGravitationalParameter;
+    const Eigen::ArrayXd turnAngle = 2.0 * ( 1.0 / eccentricity ).asin( );
+
+    const Eigen::ArrayXd firstComponent = incomingSpeed * turnAngle.cos( );
+    const Eigen::ArrayXd secondComponent = incomingSpeed * turnAngle.sin( ) * bPlaneAngles.cos( );
+    const Eigen::ArrayXd thirdComponent = incomingSpeed * turnAngle.sin( ) * bPlaneAngles.sin( );
+
+    return firstUnitVectors.colwise( ) * firstComponent + secondUnitVectors.colwise( ) * secondComponent +
+            thirdUnitVectors.colwise( ) * thirdComponent;
+}
+
+//! Function to retrieve the index of the leg duration in the decision vector
+static int getLegDurationIndex( const int legIndex )
+{
+    return ( legIndex == 0 ) ? 5 : ( 9 + 4 * ( legIndex - 1 ) );
+}
+
+//! Function to retrieve the index of the DSM epoch fraction in the decision vector
+static int getDsmFractionIndex( const int legIndex )
+{
+    return ( legIndex == 0 ) ? 4 : ( 8 + 4 * ( legIndex - 1 ) );
+}
+
+//! Constructor
+Mga1DsmTrajectory::Mga1DsmTrajectory(
+        const tudat::simulation_setup::NamedBodyMap& bodyMap,
+        const std::vector< std::string >& transferBodyOrder,
+        const std::string& centralBody,
+        const std::vector< double >& minimumPericenterRadii,
+        const double captureSemiMajorAxis,
+        const double captureEccentricity,
+        const bool includeDepartureDeltaV,
+        const int maximumNumberOfRevolutions ):
+    numberOfLegs_( static_cast< int >( transferBodyOrder.size( ) ) - 1 ),
+    minimumPericenterRadii_( minimumPericenterRadii ),
+    captureSemiMajorAxis_( captureSemiMajorAxis ),
+    captureEccentricity_( captureEccentricity ),
+    includeDepartureDeltaV_( includeDepartureDeltaV ),
+    maximumNumberOfRevolutions_( maximumNumberOfRevolutions )
+{
+    if( numberOfLegs_ < 1 )
+    {
+        throw std::runtime_error( "Error when creating MGA-1DSM trajectory, at least two bodies are required" );
+    }
+    if( minimumPericenterRadii.size( ) != transferBodyOrder.size( ) )
+    {
+        throw std::runtime_error( "Error when creating MGA-1DSM trajectory, pericenter radii inconsistent with body order" );
+    }
+
+    centralBodyEphemeris_ = bodyMap.at( centralBody )->getEphemeris( );
+    centralBodyGravitationalParameter_ =
+            bodyMap.at( centralBody )->getGravityFieldModel( )->getGravitationalParameter( );
+    for( unsigned int i = 0; i < transferBodyOrder.size( ); i++ )
+    {
+        bodyEphemerides_.push_back( bodyMap.at( transferBodyOrder.at( i ) )->getEphemeris( ) );
+        bodyGravitationalParameters_.push_back(
+                    bodyMap.at( transferBodyOrder.at( i ) )->getGravityFieldModel( )->getGravitationalParameter( ) );
+    }
+}
+
+//! Function to compute the total Delta V of a single trajectory
+double Mga1DsmTrajectory::evaluateTrajectory( const Eigen::VectorXd& decisionVector ) const
+{
+    return evaluatePopulation( decisionVector.transpose( ), 1 )( 0 );
+}
+
+//! Function to compute the total Delta V of all trajectories in a population
+Eigen::VectorXd Mga1DsmTrajectory::evaluatePopulation( const Eigen::MatrixXd& population, const int numberOfThreads ) const
+{
+    Eigen::MatrixXd maneuverDeltaVs = computeManeuverDeltaVs( population, numberOfThreads );
+    Eigen::VectorXd totalDeltaVs = maneuverDeltaVs.rowwise( ).sum( );
+    if( !includeDepartureDeltaV_ )
+    {
+        totalDeltaVs -= maneuverDeltaVs.col( 0 );
+    }
+    return totalDeltaVs;
+}
+
+//! Function to compute the Delta V of each maneuver of all trajectories in a population
+Eigen::MatrixXd Mga1DsmTrajectory::computeManeuverDeltaVs(
+        const Eigen::MatrixXd& population, const int numberOfThreads ) const
+{
+    if( population.cols( ) != getDecisionVectorSize( ) )
+    {
+        throw std::runtime_error( "Error when evaluating MGA-1DSM population, decision vector has incorrect size" );
+    }
+
+    const int populationSize = static_cast< int >( population.rows( ) );
+
+    // Retrieve body states at the departure, flyby and arrival epochs of the whole population. This is done in the calling
+    // thread, since ephemerides (e.g. Spice) are not necessarily thread-safe.
+    std::vector< BatchCartesianStates > bodyStates( numberOfLegs_ + 1, BatchCartesianStates( populationSize, 6 ) );
+    for( int i = 0; i < populationSize; i++ )
+    {
+        double currentEpoch = population( i, 0 );
+        for( int j = 0; j <= numberOfLegs_; j++ )
+        {
+            if( j > 0 )
+            {
+                currentEpoch += population( i, getLegDurationIndex( j - 1 ) );
+            }
+            bodyStates[ j ].row( i ) = ( bodyEphemerides_.at( j )->getCartesianState( currentEpoch ) -
+                                         centralBodyEphemeris_->getCartesianState( currentEpoch ) ).transpose( );
+        }
+    }
+
+    // Evaluate trajectories in contiguous blocks of the population
+    Eigen::MatrixXd maneuverDeltaVs = Eigen::MatrixXd::Zero( populationSize, numberOfLegs_ + 2 );
+    parallelForEachBlock( populationSize, [ & ]( const int startIndex, const int blockSize, const int )
+    {
+        computeManeuverDeltaVsOfBlock( population, bodyStates, startIndex, blockSize, maneuverDeltaVs );
+    }, numberOfThreads );
+
+    return maneuverDeltaVs;
+}
+
+//! Function to compute the maneuver Delta Vs for a contiguous block of the population
+void Mga1DsmTrajectory::computeManeuverDeltaVsOfBlock(
+        const Eigen::MatrixXd& population,
+        const std::vector< BatchCartesianStates >& bodyStates,
+        const int startIndex,
+        const int blockSize,
+        Eigen::MatrixXd& maneuverDeltaVs ) const
+{
+    using tudat::mathematical_constants::PI;
+
+    // Compute departure excess velocity from magnitude and direction
+    const Eigen::ArrayXd departureSpeed = population.block( startIndex, 1, blockSize, 1 ).array( );
+    const Eigen::ArrayXd rightAscension = 2.0 * PI * population.block( startIndex, 2, blockSize, 1 ).array( );
+    const Eigen::ArrayXd declination = ( 2.0 * population.block( startIndex, 3, blockSize, 1 ).array( ) - 1.0 ).acos( ) - PI / 2.0;
+
+    BatchVectors excessVelocities( blockSize, 3 );
+    excessVelocities.col( 0 ) = departureSpeed * rightAscension.cos( ) * declination.cos( );
+    excessVelocities.col( 1 ) = departureSpeed * rightAscension.sin( ) * declination.cos( );
+    excessVelocities.col( 2 ) = departureSpeed * declination.sin( );
+    maneuverDeltaVs.block( startIndex, 0, blockSize, 1 ) = departureSpeed.matrix( );
+
+    BatchCartesianStates currentStates( blockSize, 6 );
+    BatchVectors arrivalVelocities( blockSize, 3 );
+    Eigen::Vector3d lambertDepartureVelocity, lambertArrivalVelocity;
+    for( int i = 0; i < numberOfLegs_; i++ )
+    {
+        const BatchCartesianStates planetStates = bodyStates.at( i ).middleRows( startIndex, blockSize );
+
+        // Compute excess velocity after unpowered flyby
+        if( i > 0 )
+        {
+            excessVelocities = computeOutgoingExcessVelocities(
+                        arrivalVelocities - planetStates.rightCols( 3 ).array( ), planetStates.rightCols( 3 ).array( ),
+                        minimumPericenterRadii_.at( i ) *
+                        population.block( startIndex, 6 + 4 * ( i - 1 ), blockSize, 1 ).array( ),
+                        population.block( startIndex, 7 + 4 * ( i - 1 ), blockSize, 1 ).array( ),
+                        bodyGravitationalParameters_.at( i ) );
+        }
+
+        // Propagate from planet to DSM
+        const Eigen::ArrayXd dsmFraction = population.block( startIndex, getDsmFractionIndex( i ), blockSize, 1 ).array( );
+        const Eigen::ArrayXd legDuration = population.block( startIndex, getLegDurationIndex( i ), blockSize, 1 ).array( );
+        currentStates = planetStates;
+        currentStates.rightCols( 3 ) += excessVelocities.matrix( );
+        propagateKeplerOrbitsWithUniversalVariables(
+                    currentStates, dsmFraction * legDuration, centralBodyGravitationalParameter_ );
+
+        // Target next planet from DSM location, and compute DSM Delta V
+        const BatchCartesianStates& targetStates = bodyStates.at( i + 1 );
+        for( int j = 0; j < blockSize; j++ )
+        {
+            double remainingTime = ( 1.0 - dsmFraction( j ) ) * legDuration( j );
+            bool isLambertSolved = false;
+            if( remainingTime > 0.0 )
+            {
+                try
+                {
+                    if( maximumNumberOfRevolutions_ > 0 )
+                    {
+                        // Evaluate all branches, and select the one with the lowest DSM Delta V
+                        const std::vector< LambertBranchSolution > branchSolutions = solveLambertProblemForAllBranches(
+                                    currentStates.block( j, 0, 1, 3 ).transpose( ),
+                                    targetStates.block( startIndex + j, 0, 1, 3 ).transpose( ),
+                                    remainingTime, centralBodyGravitationalParameter_, maximumNumberOfRevolutions_ );
+                        const LambertBranchSolution& bestSolution = branchSolutions.at(
+                                    getBestLambertBranch( branchSolutions, currentStates.block( j, 3, 1, 3 ).transpose( ),
+                                                          Eigen::Vector3d::Zero( ), 1.0, 0.0 ) );
+                        lambertDepartureVelocity = bestSolution.departureVelocity;
+                        lambertArrivalVelocity = bestSolution.arrivalVelocity;
+                    }
+                    else
+                    {
+                        tudat::mission_segments::solveLambertProblemIzzo(
+                                    currentStates.block( j, 0, 1, 3 ).transpose( ),
+                                    targetStates.block( startIndex + j, 0, 1, 3 ).transpose( ),
+                                    remainingTime, centralBodyGravitationalParameter_,
+                                    lambertDepartureVelocity, lambertArrivalVelocity );
+                    }
+                    isLambertSolved = true;
+                }
+                catch( std::runtime_error& )
+                {
+                }
+            }
+
+            if( isLambertSolved )
+            {
+                maneuverDeltaVs( startIndex + j, i + 1 ) =
+                        ( lambertDepartureVelocity - currentStates.block( j, 3, 1, 3 ).transpose( ) ).norm( );
+                arrivalVelocities.row( j ) = lambertArrivalVelocity.transpose( ).array( );
+            }
+            else
+            {
+                maneuverDeltaVs( startIndex + j, i + 1 ) = std::numeric_limits< double >::quiet_NaN( );
+                arrivalVelocities.row( j ).setConstant( std::numeric_limits< double >::quiet_NaN( ) );
+            }
+        }
+    }
+
+    // Compute capture Delta V at final planet
+    const double arrivalGravitationalParameter = bodyGravitationalParameters_.at( numberOfLegs_ );
+    const double capturePericenterRadius = captureSemiMajorAxis_ * ( 1.0 - captureEccentricity_ );
+    const Eigen::ArrayXd arrivalSpeed = computeRowWiseNorm(
+                arrivalVelocities - bodyStates.at( numberOfLegs_ ).block( startIndex, 3, blockSize, 3 ).array( ) );
+    maneuverDeltaVs.block( startIndex, numberOfLegs_ + 1, blockSize, 1 ) =
+            ( ( arrivalSpeed.square( ) + 2.0 * arrivalGravitationalParameter / capturePericenterRadius ).sqrt( ) -
+              std::sqrt( arrivalGravitationalParameter * ( 1.0 + captureEccentricity_ ) / capturePericenterRadius ) ).matrix( );
+}
+
+} // namespace tudat_applications
@@ -0,0 +1,159 @@
+/*    Copyright (c) 2010-2018, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_MGA1DSMTRAJECTORY_H
+#define TUDAT_MGA1DSMTRAJECTORY_H
+
+#include <string>
+#include <vector>
+
+#include <Tudat/SimulationSetup/tudatSimulationHeader.h>
+
+#include "highThrustTransfer.h"
+
+namespace tudat_applications
+{
+
+//! Class to evaluate multiple gravity assist trajectories with one deep-space maneuver per leg (MGA-1DSM)
+/*!
+ *  Class to evaluate multiple gravity assist trajectories with one deep-space maneuver (DSM) per leg, using the velocity
+ *  formulation of the MGA-1DSM model (Vinko and Izzo, 2008). Each leg starts at a planet with a given hyperbolic excess
+ *  velocity, after which the spacecraft coasts on a Keplerian orbit until the DSM epoch. From the DSM, a Lambert arc is used to
+ *  reach the next planet. The excess velocity at the start of a leg is obtained from the launcher (first leg), or from an
+ *  unpowered flyby, defined by the pericenter radius and the b-plane angle (subsequent legs). The total Delta V consists of
+ *  the DSMs and the capture at the final planet (and optionally the departure excess velocity). Optionally, multi-revolution
+ *  Lambert arcs are considered, in which case the branch with the lowest DSM is selected for each leg.
+ *
+ *  The decision vector for a trajectory with N legs is defined as follows (size 4N + 2):
+ *
+ *  - Entry 0: Departure epoch (seconds since J2000)
+ *  - Entry 1: Magnitude of departure hyperbolic excess velocity (m/s)
+ *  - Entry 2-3: Direction of the departure hyperbolic excess velocity u, v in [0,1], with right ascension 2*pi*u and
+ *    declination acos(2v-1)-pi/2 in the frame of the central body
+ *  - Entry 4-5: DSM epoch, as fraction of the leg duration (in (0,1)), and duration (s) of the first leg
+ *  - Entry 6+4(i-1) - 9+4(i-1), for leg i > 0: Pericenter radius of flyby at start of the leg (as a multiple of the minimum
+ *    pericenter radius, >= 1), b-plane angle of the flyby, DSM epoch fraction and duration of the leg
+ *
+ *  For the evaluation of a population, the decision vectors are stored as rows of a matrix, and the evaluation is performed
+ *  stage-wise over the whole population (planet ephemerides, Kepler propagation, Lambert targeting, flybys), on
+ *  structure-of-arrays storage. Within each stage, the population can be distributed over multiple threads.
+ */
+class Mga1DsmTrajectory
+{
+public:
+
+    //! Constructor
+    /*!
+     * Constructor
+     * \param bodyMap List of body objects, from which planet ephemerides and gravitational parameters are retrieved
+     * \param transferBodyOrder Names of bodies visited by the trajectory (departure, flybys, arrival)
+     * \param centralBody Name of central body of the transfer
+     * \param minimumPericenterRadii Minimum pericenter radius, per body in transferBodyOrder
+     * \param captureSemiMajorAxis Semi-major axis of the capture orbit at the final planet
+     * \param captureEccentricity Eccentricity of the capture orbit at the final planet
+     * \param includeDepartureDeltaV Boolean denoting whether the departure excess velocity is included in the total Delta V
+     * \param maximumNumberOfRevolutions Maximum number of revolutions of the Lambert arcs. If larger than zero, all feasible
+     * Lambert branches are evaluated for each DSM, and the branch with the lowest DSM Delta V is used.
+     */
+    Mga1DsmTrajectory(
+            const tudat::simulation_setup::NamedBodyMap& bodyMap,
+            const std::vector< std::string >& transferBodyOrder,
+            const std::string& centralBody,
+            const std::vector< double >& minimumPericenterRadii,
+            const double captureSemiMajorAxis,
+            const double captureEccentricity,
+            const bool includeDepartureDeltaV = false,
+            const int maximumNumberOfRevolutions = 0 );
+
+    //! Function to compute the total Delta V of a single trajectory
+    double evaluateTrajectory( const Eigen::VectorXd& decisionVector ) const;
+
+    //! Function to compute the total Delta V of all trajectories in a population
+    /*!
+     * Function to compute the total Delta V of all trajectories in a population
+     * \param population Decision vectors of the population (one row per trajectory)
+     * \param numberOfThreads Number of threads over which the population is distributed
+     * \return Total Delta V per trajectory (NaN for invalid decision vectors)
+     */
+    Eigen::VectorXd evaluatePopulation( const Eigen::MatrixXd& population, const int numberOfThreads = 1 ) const;
+
+    //! Function to compute the Delta V of each maneuver of all trajectories in a population
+    /*!
+     * Function to compute the Delta V of each maneuver of all trajectories in a population
+     * \param population Decision vectors of the population (one row per trajectory)
+     * \param numberOfThreads Number of threads over which the population is distributed
+     * \return Maneuver Delta Vs (one row per trajectory), with columns: departure excess velocity, DSM of each leg, capture
+     */
+    Eigen::MatrixXd computeManeuverDeltaVs( const Eigen::MatrixXd& population, const int numberOfThreads = 1 ) const;
+
+    //! Function to retrieve the number of legs
+    int getNumberOfLegs( ) const
+    {
+        return numberOfLegs_;
+    }
+
+    //! Function to retrieve the size of the decision vector
+    int getDecisionVectorSize( ) const
+    {
+        return 4 * numberOfLegs_ + 2;
+    }
+
+private:
+
+    //! Function to compute the maneuver Delta Vs for a contiguous block of the population
+    /*!
+     * Function to compute the maneuver Delta Vs for a contiguous block of the population
+     * \param population Decision vectors of the full population (one row per trajectory)
+     * \param bodyStates States of the visited bodies at the epochs of the full population (one entry per body)
+     * \param startIndex Index of first trajectory in block
+     * \param blockSize Number of trajectories in block
+     * \param maneuverDeltaVs Maneuver Delta Vs of the full population, of which the rows of the current block are set
+     */
+    void computeManeuverDeltaVsOfBlock(
+            const Eigen::MatrixXd& population,
+            const std::vector< BatchCartesianStates >& bodyStates,
+            const int startIndex,
+            const int blockSize,
+            Eigen::MatrixXd& maneuverDeltaVs ) const;
+
+    //! Number of legs of the trajectory
+    int numberOfLegs_;
+
+    //! Ephemerides of visited bodies
+    std::vector< std::shared_ptr< tudat::ephemerides::Ephemeris > > bodyEphemerides_;
+
+    //! Ephemeris of central body
+    std::shared_ptr< tudat::ephemerides::Ephemeris > centralBodyEphemeris_;
+
+    //! Gravitational parameters of the visited bodies
+    std::vector< double > bodyGravitationalParameters_;
+
+    //! Minimum pericenter radii of the visited bodies
+    std::vector< double > minimumPericenterRadii_;
+
+    //! Gravitational parameter of the central body
+    double centralBodyGravitationalParameter_;
+
+    //! Semi-major axis of the capture orbit at the final planet
+    double captureSemiMajorAxis_;
+
+    //! Eccentricity of the capture orbit at the final planet
+    double captureEccentricity_;
+
+    //! Boolean denoting whether the departure excess velocity is included in the total Delta V
+    bool includeDepartureDeltaV_;
+
+    //! Maximum number of revolutions of the Lambert arcs
+    int maximumNumberOfRevolutions_;
+};
+
+} // namespace tudat_applications
+
+#endif // TUDAT_MGA1DSMTRAJECTORY_H
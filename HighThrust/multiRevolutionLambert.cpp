@@ -0,0 +1,446 @@
+/*    Copyright (c) 2010-2018, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include <Tudat/Mathematics/BasicMathematics/mathematicalConstants.h>
+
+#include "multiRevolutionLambert.h"
+
+namespace tudat_applications
+{
+
+//! Typedef for arrays containing one entry per multi-revolution branch
+typedef Eigen::Array< double, Eigen::Dynamic, 1 > BranchArray;
+
+//! Function to compute the Gaussian hypergeometric function 2F1(3, 1, 5/2, z), used in Battin's series
+static double computeHypergeometricFunction( const double z, const double tolerance = 1.0E-11 )
+{
+    double sum = 1.0;
+    double term = 1.0;
+    int j = 0;
+    while( std::fabs( term ) > tolerance )
+    {
+        term = term * ( 3.0 + j ) * ( 1.0 + j ) / ( 2.5 + j ) * z / ( j + 1.0 );
+        sum += term;
+        j++;
+    }
+    return sum;
+}
+
+//! Function to compute the non-dimensional time of flight as a function of x (Izzo, 2015)
+/*!
+ *  Function to compute the non-dimensional time of flight as a function of x (Izzo, 2015). Depending on the distance of x to
+ *  1 (parabolic transfer), Battin's series, Lagrange's equation or Lancaster's equation is used.
+ */
+static double computeTimeOfFlight( const double x, const double lambda, const int numberOfRevolutions )
+{
+    const double distanceToParabolic = std::fabs( x - 1.0 );
+    const double pi = tudat::mathematical_constants::PI;
+
+    if( distanceToParabolic < 0.2 && distanceToParabolic > 0.01 )
+    {
+        // Lagrange's equation
+        const double a = 1.0 / ( 1.0 - x * x );
+        if( a > 0.0 )
+        {
+            const double alpha = 2.0 * std::acos( x );
+            double beta = 2.0 * std::asin( std::sqrt( lambda * lambda / a ) );
+            if( lambda < 0.0 )
+            {
+                beta = -beta;
+            }
+            return a * std::sqrt( a ) * ( ( alpha - std::sin( alpha ) ) - ( beta - std::sin( beta ) ) +
+                                          2.0 * pi * numberOfRevolutions ) / 2.0;
+        }
+        else
+        {
+            const double alpha = 2.0 * std::acosh( x );
+            double beta = 2.0 * std::asinh( std::sqrt( -lambda * lambda / a ) );
+            if( lambda < 0.0 )
+            {
+                beta = -beta;
+            }
+            return -a * std::sqrt( -a ) * ( ( beta - std::sinh( beta ) ) - ( alpha - std::sinh( alpha ) ) ) / 2.0;
+        }
+    }
+
+    const double energy = x * x - 1.0;
+    const double rho = std::fabs( energy );
+    const double z = std::sqrt( 1.0 + lambda * lambda * energy );
+
+    if( distanceToParabolic < 0.01 )
+    {
+        // Battin's series
+        const double eta = z - lambda * x;
+        const double s1 = 0.5 * ( 1.0 - lambda - x * eta );
+        const double q = 4.0 / 3.0 * computeHypergeometricFunction( s1 );
+        return ( eta * eta * eta * q + 4.0 * lambda * eta ) / 2.0 + numberOfRevolutions * pi / std::pow( rho, 1.5 );
+    }
+    else
+    {
+        // Lancaster's equation
+        const double y = std::sqrt( rho );
+        const double g = x * z - lambda * energy;
+        double d;
+        if( energy < 0.0 )
+        {
+            d = numberOfRevolutions * pi + std::acos( g );
+        }
+        else
+        {
+            d = std::log( y * ( z - lambda * x ) + g );
+        }
+        return ( x - lambda * z - d / y ) / energy;
+    }
+}
+
+//! Function to compute the first three derivatives of the non-dimensional time of flight w.r.t. x (Izzo, 2015)
+static void computeTimeOfFlightDerivatives(
+        const double x, const double timeOfFlight, const double lambda,
+        double& firstDerivative, double& secondDerivative, double& thirdDerivative )
+{
+    const double lambda2 = lambda * lambda;
+    const double lambda3 = lambda2 * lambda;
+    const double oneMinusX2 = 1.0 - x * x;
+    const double y = std::sqrt( 1.0 - lambda2 * oneMinusX2 );
+    const double y2 = y * y;
+    const double y3 = y2 * y;
+
+    firstDerivative = ( 3.0 * timeOfFlight * x - 2.0 + 2.0 * lambda3 * x / y ) / oneMinusX2;
+    secondDerivative = ( 3.0 * timeOfFlight + 5.0 * x * firstDerivative + 2.0 * ( 1.0 - lambda2 ) * lambda3 / y3 ) /
+            oneMinusX2;
+    thirdDerivative = ( 7.0 * x * secondDerivative + 8.0 * firstDerivative -
+                        6.0 * ( 1.0 - lambda2 ) * lambda2 * lambda3 * x / y3 / y2 ) / oneMinusX2;
+}
+
+//! Function to compute the first three derivatives of the non-dimensional time of flight w.r.t. x, for all branches at once
+static void computeTimeOfFlightDerivatives(
+        const BranchArray& x, const BranchArray& timeOfFlight, const double lambda,
+        BranchArray& firstDerivative, BranchArray& secondDerivative, BranchArray& thirdDerivative )
+{
+    const double lambda2 = lambda * lambda;
+    const double lambda3 = lambda2 * lambda;
+    const BranchArray inverseOneMinusX2 = 1.0 / ( 1.0 - x.square( ) );
+    const BranchArray y = ( 1.0 - lambda2 * ( 1.0 - x.square( ) ) ).sqrt( );
+    const BranchArray y3 = y.cube( );
+
+    firstDerivative = ( 3.0 * timeOfFlight * x - 2.0 + 2.0 * lambda3 * x / y ) * inverseOneMinusX2;
+    secondDerivative = ( 3.0 * timeOfFlight + 5.0 * x * firstDerivative + 2.0 * ( 1.0 - lambda2 ) * lambda3 / y3 ) *
+            inverseOneMinusX2;
+    thirdDerivative = ( 7.0 * x * secondDerivative + 8.0 * firstDerivative -
+                        6.0 * ( 1.0 - lambda2 ) * lambda2 * lambda3 * x / ( y3 * y.square( ) ) ) * inverseOneMinusX2;
+}
+
+//! Function to compute the non-dimensional time of flight of all multi-revolution branches at once
+/*!
+ *  Function to compute the non-dimensional time of flight of all multi-revolution branches at once. Since all
+ *  multi-revolution solutions are elliptical, Lancaster's equation is used as array expression. The (rare) entries that are
+ *  too close to the parabolic case for Lancaster's equation to be accurate are recomputed using the scalar function.
+ */
+static BranchArray computeTimeOfFlight(
+        const BranchArray& x, const double lambda, const BranchArray& numberOfRevolutions )
+{
+    const BranchArray energy = x.square( ) - 1.0;
+    const BranchArray z = ( 1.0 + lambda * lambda * energy ).sqrt( );
+    const BranchArray y = ( -energy ).sqrt( );
+    const BranchArray d = numberOfRevolutions * tudat::mathematical_constants::PI +
+            ( x * z - lambda * energy ).max( -1.0 ).min( 1.0 ).acos( );
+    BranchArray timeOfFlight = ( x - lambda * z - d / y ) / energy;
+
+    for( int i = 0; i < x.rows( ); i++ )
+    {
+        if( std::fabs( x( i ) - 1.0 ) < 0.01 )
+        {
+            timeOfFlight( i ) = computeTimeOfFlight( x( i ), lambda, static_cast< int >( numberOfRevolutions( i ) ) );
+        }
+    }
+    return timeOfFlight;
+}
+
+//! Function to solve the non-dimensional time of flight equation for x, using Householder iterations
+static int solveTimeOfFlightEquation(
+        const double timeOfFlight, const double lambda, const int numberOfRevolutions,
+        const double tolerance, const int maximumNumberOfIterations, double& x )
+{
+    int numberOfIterations = 0;
+    double error = 1.0;
+    double firstDerivative, secondDerivative, thirdDerivative;
+    while( error > tolerance && numberOfIterations < maximumNumberOfIterations )
+    {
+        const double currentTimeOfFlight = computeTimeOfFlight( x, lambda, numberOfRevolutions );
+        computeTimeOfFlightDerivatives( x, currentTimeOfFlight, lambda,
+                                        firstDerivative, secondDerivative, thirdDerivative );
+        const double delta = currentTimeOfFlight - timeOfFlight;
+        const double firstDerivative2 = firstDerivative * firstDerivative;
+        const double newX = x - delta * ( firstDerivative2 - delta * secondDerivative / 2.0 ) /
+                ( firstDerivative * ( firstDerivative2 - delta * secondDerivative ) +
+                  thirdDerivative * delta * delta / 6.0 );
+        error = std::fabs( x - newX );
+        x = newX;
+        numberOfIterations++;
+    }
+    return numberOfIterations;
+}
+
+//! Function to solve the non-dimensional time of flight equation for x, for all multi-revolution branches in lock-step
+/*!
+ *  Function to solve the non-dimensional time of flight equation for x, for all multi-revolution branches in lock-step. The
+ *  Householder iterations are performed on arrays containing all branches, until all branches have converged. Converged
+ *  branches are no longer updated, and the number of iterations at which each branch converged is returned by reference.
+ */
+static void solveTimeOfFlightEquations(
+        const double timeOfFlight, const double lambda, const BranchArray& numberOfRevolutions,
+        const double tolerance, const int maximumNumberOfIterations,
+        BranchArray& x, Eigen::ArrayXi& numberOfIterations )
+{
+    numberOfIterations = Eigen::ArrayXi::Zero( x.rows( ) );
+    Eigen::Array< bool, Eigen::Dynamic, 1 > isConverged = Eigen::Array< bool, Eigen::Dynamic, 1 >::Constant(
+                x.rows( ), false );
+
+    BranchArray firstDerivative, secondDerivative, thirdDerivative;
+    for( int iteration = 0; iteration < maximumNumberOfIterations && !isConverged.all( ); iteration++ )
+    {
+        const BranchArray currentTimeOfFlight = computeTimeOfFlight( x, lambda, numberOfRevolutions );
+        computeTimeOfFlightDerivatives( x, currentTimeOfFlight, lambda,
+                                        firstDerivative, secondDerivative, thirdDerivative );
+        const BranchArray delta = currentTimeOfFlight - timeOfFlight;
+        const BranchArray firstDerivative2 = firstDerivative.square( );
+        const BranchArray newX = x - delta * ( firstDerivative2 - delta * secondDerivative / 2.0 ) /
+                ( firstDerivative * ( firstDerivative2 - delta * secondDerivative ) +
+                  thirdDerivative * delta.square( ) / 6.0 );
+
+        const Eigen::Array< bool, Eigen::Dynamic, 1 > isConvergedAfterUpdate = ( x - newX ).abs( ) <= tolerance;
+        x = isConverged.select( x, newX );
+        numberOfIterations += ( !isConverged ).cast< int >( );
+        isConverged = isConverged || isConvergedAfterUpdate;
+    }
+}
+
+//! Function to solve a Lambert problem for all feasible numbers of revolutions and branches
+std::vector< LambertBranchSolution > solveLambertProblemForAllBranches(
+        const Eigen::Vector3d& departurePosition,
+        const Eigen::Vector3d& arrivalPosition,
+        const double timeOfFlight,
+        const double gravitationalParameter,
+        const int maximumNumberOfRevolutions,
+        const bool isRetrograde,
+        const std::vector< double >& initialGuesses )
+{
+    if( !( timeOfFlight > 0.0 ) )
+    {
+        throw std::runtime_error( "Error when solving Lambert problem, time of flight must be positive" );
+    }
+    if( !departurePosition.allFinite( ) || !arrivalPosition.allFinite( ) || !std::isfinite( timeOfFlight ) )
+    {
+        throw std::runtime_error( "Error when solving Lambert problem, input is not finite" );
+    }
+
+    const double pi = tudat::mathematical_constants::PI;
+
+    // Compute geometry of transfer
+    const double chord = ( arrivalPosition - departurePosition ).norm( );
+    const double departureRadius = departurePosition.norm( );
+    const double arrivalRadius = arrivalPosition.norm( );
+    const double semiPerimeter = ( chord + departureRadius + arrivalRadius ) / 2.0;
+
+    const Eigen::Vector3d departureRadialUnitVector = departurePosition / departureRadius;
+    const Eigen::Vector3d arrivalRadialUnitVector = arrivalPosition / arrivalRadius;
+    const Eigen::Vector3d angularMomentumUnitVector =
+            departureRadialUnitVector.cross( arrivalRadialUnitVector ).normalized( );
+
+    double lambda = std::sqrt( 1.0 - chord / semiPerimeter );
+    Eigen::Vector3d departureTangentialUnitVector, arrivalTangentialUnitVector;
+    if( angularMomentumUnitVector.z( ) < 0.0 )
+    {
+        lambda = -lambda;
+        departureTangentialUnitVector = departureRadialUnitVector.cross( angularMomentumUnitVector ).normalized( );
+        arrivalTangentialUnitVector = arrivalRadialUnitVector.cross( angularMomentumUnitVector ).normalized( );
+    }
+    else
+    {
+        departureTangentialUnitVector = angularMomentumUnitVector.cross( departureRadialUnitVector ).normalized( );
+        arrivalTangentialUnitVector = angularMomentumUnitVector.cross( arrivalRadialUnitVector ).normalized( );
+    }
+
+    if( isRetrograde )
+    {
+        lambda = -lambda;
+        departureTangentialUnitVector = -departureTangentialUnitVector;
+        arrivalTangentialUnitVector = -arrivalTangentialUnitVector;
+    }
+
+    const double lambda2 = lambda * lambda;
+    const double lambda3 = lambda2 * lambda;
+
+    // Compute non-dimensional time of flight, and determine number of feasible revolutions
+    const double nonDimensionalTimeOfFlight =
+            std::sqrt( 2.0 * gravitationalParameter / ( semiPerimeter * semiPerimeter * semiPerimeter ) ) * timeOfFlight;
+
+    int numberOfRevolutions = static_cast< int >( nonDimensionalTimeOfFlight / pi );
+    const double zeroRevolutionMinimumEnergyTimeOfFlight = std::acos( lambda ) + lambda * std::sqrt( 1.0 - lambda2 );
+    const double minimumEnergyTimeOfFlight = zeroRevolutionMinimumEnergyTimeOfFlight + numberOfRevolutions * pi;
+    const double parabolicTimeOfFlight = 2.0 / 3.0 * ( 1.0 - lambda3 );
+
+    if( numberOfRevolutions > 0 && nonDimensionalTimeOfFlight < minimumEnergyTimeOfFlight )
+    {
+        // Find minimum time of flight for current number of revolutions, using Halley iterations
+        double minimumTimeOfFlight = minimumEnergyTimeOfFlight;
+        double oldX = 0.0;
+        double newX = 0.0;
+        double firstDerivative, secondDerivative, thirdDerivative;
+        for( int iteration = 0; iteration < 12; iteration++ )
+        {
+            computeTimeOfFlightDerivatives( oldX, minimumTimeOfFlight, lambda,
+                                            firstDerivative, secondDerivative, thirdDerivative );
+            if( firstDerivative != 0.0 )
+            {
+                newX = oldX - firstDerivative * secondDerivative /
+                        ( secondDerivative * secondDerivative - firstDerivative * thirdDerivative / 2.0 );
+            }
+            if( std::fabs( oldX - newX ) < 1.0E-13 )
+            {
+                break;
+            }
+            minimumTimeOfFlight = computeTimeOfFlight( newX, lambda, numberOfRevolutions );
+            oldX = newX;
+        }
+
+        if( minimumTimeOfFlight > nonDimensionalTimeOfFlight )
+        {
+            numberOfRevolutions--;
+        }
+    }
+    numberOfRevolutions = std::min( numberOfRevolutions, std::max( maximumNumberOfRevolutions, 0 ) );
+
+    // Compute zero-revolution solution
+    double zeroRevolutionX;
+    if( nonDimensionalTimeOfFlight >= zeroRevolutionMinimumEnergyTimeOfFlight )
+    {
+        zeroRevolutionX = -( nonDimensionalTimeOfFlight - zeroRevolutionMinimumEnergyTimeOfFlight ) /
+                ( nonDimensionalTimeOfFlight - zeroRevolutionMinimumEnergyTimeOfFlight + 4.0 );
+    }
+    else if( nonDimensionalTimeOfFlight <= parabolicTimeOfFlight )
+    {
+        zeroRevolutionX = parabolicTimeOfFlight * ( parabolicTimeOfFlight - nonDimensionalTimeOfFlight ) /
+                ( 2.0 / 5.0 * ( 1.0 - lambda2 * lambda3 ) * nonDimensionalTimeOfFlight ) + 1.0;
+    }
+    else
+    {
+        zeroRevolutionX = std::pow( nonDimensionalTimeOfFlight / zeroRevolutionMinimumEnergyTimeOfFlight,
+                                    std::log( 2.0 ) / std::log( parabolicTimeOfFlight /
+                                                                zeroRevolutionMinimumEnergyTimeOfFlight ) ) - 1.0;
+    }
+    if( initialGuesses.size( ) > 0 )
+    {
+        zeroRevolutionX = initialGuesses.at( 0 );
+    }
+    const int zeroRevolutionNumberOfIterations = solveTimeOfFlightEquation(
+                nonDimensionalTimeOfFlight, lambda, 0, 1.0E-5, 15, zeroRevolutionX );
+
+    // Compute all multi-revolution solutions simultaneously (left and right branch of each number of revolutions)
+    const int numberOfSolutions = 2 * numberOfRevolutions + 1;
+    BranchArray x( numberOfSolutions );
+    Eigen::ArrayXi numberOfIterations( numberOfSolutions );
+    x( 0 ) = zeroRevolutionX;
+    numberOfIterations( 0 ) = zeroRevolutionNumberOfIterations;
+
+    if( numberOfRevolutions > 0 )
+    {
+        BranchArray branchRevolutions( 2 * numberOfRevolutions );
+        BranchArray branchX( 2 * numberOfRevolutions );
+        for( int i = 1; i <= numberOfRevolutions; i++ )
+        {
+            branchRevolutions( 2 * i - 2 ) = i;
+            branchRevolutions( 2 * i - 1 ) = i;
+
+            // Left branch
+            double temp = std::pow( ( i * pi + pi ) / ( 8.0 * nonDimensionalTimeOfFlight ), 2.0 / 3.0 );
+            branchX( 2 * i - 2 ) = ( temp - 1.0 ) / ( temp + 1.0 );
+
+            // Right branch
+            temp = std::pow( ( 8.0 * nonDimensionalTimeOfFlight ) / ( i * pi ), 2.0 / 3.0 );
+            branchX( 2 * i - 1 ) = ( temp - 1.0 ) / ( temp + 1.0 );
+        }
+
+        // Override default initial guesses by user-defined values
+        for( int i = 0; i < 2 * numberOfRevolutions && i + 1 < static_cast< int >( initialGuesses.size( ) ); i++ )
+        {
+            branchX( i ) = initialGuesses.at( i + 1 );
+        }
+
+        Eigen::ArrayXi branchNumberOfIterations;
+        solveTimeOfFlightEquations( nonDimensionalTimeOfFlight, lambda, branchRevolutions, 1.0E-8, 15,
+                                    branchX, branchNumberOfIterations );
+        x.segment( 1, 2 * numberOfRevolutions ) = branchX;
+        numberOfIterations.segment( 1, 2 * numberOfRevolutions ) = branchNumberOfIterations;
+    }
+
+    // Reconstruct velocities for all solutions
+    const double gamma = std::sqrt( gravitationalParameter * semiPerimeter / 2.0 );
+    const double rho = ( departureRadius - arrivalRadius ) / chord;
+    const double sigma = std::sqrt( 1.0 - rho * rho );
+
+    const BranchArray y = ( 1.0 - lambda2 + lambda2 * x.square( ) ).sqrt( );
+    const BranchArray departureRadialVelocity =
+            gamma * ( ( lambda * y - x ) - rho * ( lambda * y + x ) ) / departureRadius;
+    const BranchArray arrivalRadialVelocity =
+            -gamma * ( ( lambda * y - x ) + rho * ( lambda * y + x ) ) / arrivalRadius;
+    const BranchArray tangentialVelocityTimesRadius = gamma * sigma * ( y + lambda * x );
+
+    std::vector< LambertBranchSolution > branchSolutions( numberOfSolutions );
+    for( int i = 0; i < numberOfSolutions; i++ )
+    {
+        branchSolutions[ i ].numberOfRevolutions = ( i + 1 ) / 2;
+        branchSolutions[ i ].isRightBranch = ( i > 0 ) && ( i % 2 == 0 );
+        branchSolutions[ i ].departureVelocity =
+                departureRadialVelocity( i ) * departureRadialUnitVector +
+                tangentialVelocityTimesRadius( i ) / departureRadius * departureTangentialUnitVector;
+        branchSolutions[ i ].arrivalVelocity =
+                arrivalRadialVelocity( i ) * arrivalRadialUnitVector +
+                tangentialVelocityTimesRadius( i ) / arrivalRadius * arrivalTangentialUnitVector;
+        branchSolutions[ i ].independentVariable = x( i );
+        branchSolutions[ i ].numberOfIterations = numberOfIterations( i );
+    }
+    return branchSolutions;
+}
+
+//! Function to retrieve the branch with the lowest (weighted) velocity change w.r.t. reference velocities
+int getBestLambertBranch(
+        const std::vector< LambertBranchSolution >& branchSolutions,
+        const Eigen::Vector3d& referenceDepartureVelocity,
+        const Eigen::Vector3d& referenceArrivalVelocity,
+        const double departureWeight,
+        const double arrivalWeight )
+{
+    int bestBranch = -1;
+    double lowestCost = std::numeric_limits< double >::infinity( );
+    for( unsigned int i = 0; i < branchSolutions.size( ); i++ )
+    {
+        const double cost =
+                departureWeight * ( branchSolutions.at( i ).departureVelocity - referenceDepartureVelocity ).norm( ) +
+                arrivalWeight * ( branchSolutions.at( i ).arrivalVelocity - referenceArrivalVelocity ).norm( );
+        if( cost < lowestCost )
+        {
+            lowestCost = cost;
+            bestBranch = i;
+        }
+    }
+
+    if( bestBranch < 0 )
+    {
+        throw std::runtime_error( "Error when selecting Lambert branch, no valid solution found" );
+    }
+    return bestBranch;
+}
+
+} // namespace tudat_applications
@@ -0,0 +1,93 @@
+/*    Copyright (c) 2010-2018, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_MULTIREVOLUTIONLAMBERT_H
+#define TUDAT_MULTIREVOLUTIONLAMBERT_H
+
+#include <vector>
+
+#include <Tudat/Basics/basicTypedefs.h>
+
+namespace tudat_applications
+{
+
+//! Struct containing a single solution (number of revolutions and branch) of a Lambert problem
+struct LambertBranchSolution
+{
+    //! Number of complete revolutions of the transfer
+    int numberOfRevolutions;
+
+    //! Boolean denoting whether the solution is on the right branch (only relevant for multi-revolution solutions)
+    bool isRightBranch;
+
+    //! Inertial velocity at departure
+    Eigen::Vector3d departureVelocity;
+
+    //! Inertial velocity at arrival
+    Eigen::Vector3d arrivalVelocity;
+
+    //! Converged value of the independent variable x of the solver (Izzo, 2015)
+    double independentVariable;
+
+    //! Number of Householder iterations required for convergence
+    int numberOfIterations;
+};
+
+//! Function to solve a Lambert problem for all feasible numbers of revolutions and branches
+/*!
+ *  Function to solve a Lambert problem for all feasible numbers of revolutions and branches, using the algorithm of Izzo
+ *  (2015). The zero-revolution solution is always computed. For each number of revolutions N > 0 for which the time of flight
+ *  exceeds the minimum time of flight of N revolutions (up to the user-defined maximum), a left and right branch solution
+ *  exists. All multi-revolution branches are iterated simultaneously: the Householder iterations are performed in lock-step
+ *  on arrays containing all branches, so that no serial loop over the solutions is required.
+ *  \param departurePosition Position at departure
+ *  \param arrivalPosition Position at arrival
+ *  \param timeOfFlight Time of flight of the transfer
+ *  \param gravitationalParameter Gravitational parameter of the central body
+ *  \param maximumNumberOfRevolutions Maximum number of revolutions for which solutions are to be computed
+ *  \param isRetrograde Boolean denoting whether the transfer is retrograde (w.r.t. the z-axis)
+ *  \param initialGuesses Initial guesses for the independent variable x of each solution (in the order of the returned
+ *  solutions), e.g. the converged values of a neighbouring Lambert problem. Solutions for which no initial guess is provided
+ *  use the default initial guess of Izzo (2015).
+ *  \return Solutions for all branches, ordered as: zero-revolution solution, followed by the left and right branch of each
+ *  number of revolutions (in increasing order)
+ */
+std::vector< LambertBranchSolution > solveLambertProblemForAllBranches(
+        const Eigen::Vector3d& departurePosition,
+        const Eigen::Vector3d& arrivalPosition,
+        const double timeOfFlight,
+        const double gravitationalParameter,
+        const int maximumNumberOfRevolutions,
+        const bool isRetrograde = false,
+        const std::vector< double >& initialGuesses = std::vector< double >( ) );
+
+//! Function to retrieve the branch with the lowest (weighted) velocity change w.r.t. reference velocities
+/*!
+ *  Function to retrieve the branch with the lowest (weighted) velocity change w.r.t. reference velocities. When using the
+ *  planet velocities as reference, the cost is the (weighted) sum of the excess speeds at departure and arrival. When using
+ *  the spacecraft velocity before a maneuver as departure reference (and a zero arrival weight), the cost is the maneuver
+ *  Delta V.
+ *  \param branchSolutions Solutions of the Lambert problem, as computed by solveLambertProblemForAllBranches
+ *  \param referenceDepartureVelocity Velocity w.r.t. which the departure velocity change is computed
+ *  \param referenceArrivalVelocity Velocity w.r.t. which the arrival velocity change is computed
+ *  \param departureWeight Weight of departure velocity change in cost
+ *  \param arrivalWeight Weight of arrival velocity change in cost
+ *  \return Index of the solution with the lowest cost in branchSolutions
+ */
+int getBestLambertBranch(
+        const std::vector< LambertBranchSolution >& branchSolutions,
+        const Eigen::Vector3d& referenceDepartureVelocity,
+        const Eigen::Vector3d& referenceArrivalVelocity,
+        const double departureWeight = 1.0,
+        const double arrivalWeight = 1.0 );
+
+} // namespace tudat_applications
+
+#endif // TUDAT_MULTIREVOLUTIONLAMBERT_H
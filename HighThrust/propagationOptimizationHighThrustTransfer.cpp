@@ -9,6 +9,9 @@
  */
 
 #include <chrono>
+#include <random>
+
+#include <boost/filesystem.hpp>
 
 #include <Tudat/SimulationSetup/tudatSimulationHeader.h>
 #include <Tudat/Astrodynamics/TrajectoryDesign/trajectory.h>
@@ -16,6 +19,16 @@
 #include <Tudat/SimulationSetup/PropagationSetup/propagationLambertTargeterFullProblem.h>
 
 #include "../applicationOutput.h"
+#include "../continuousTrajectory.h"
+#include "../parallelExecution.h"
+#include "../sundmanPropagation.h"
+#include "analyticPlanetEphemeris.h"
+#include "centralBodySwitching.h"
+#include "lambertGridSweep.h"
+#include "mga1DsmTrajectory.h"
+#include "multiRevolutionLambert.h"
+#include "simsFlanaganTrajectory.h"
+#include "trajectoryArchive.h"
 
 using namespace tudat;
 using namespace tudat::simulation_setup;
@@ -26,6 +39,7 @@ using namespace tudat::basic_mathematics;
 using namespace tudat::gravitation;
 using namespace tudat::numerical_integrators;
 using namespace tudat::transfer_trajectories;
+using namespace tudat_applications;
 
 //! Function to directly setup a vector of acceleration maps for a patched conics trajectory.
 std::vector < basic_astrodynamics::AccelerationMap > getAccelerationModelsPerturbedPatchedConicsTrajectory(
@@ -63,6 +77,41 @@ std::vector < basic_astrodynamics::AccelerationMap > getAccelerationModelsPertur
 
 }
 
+//! Function to create the point mass gravity model of a single leg of a patched conics trajectory (consistent with the
+//! acceleration models of getAccelerationModelsPerturbedPatchedConicsTrajectory), for use in regularized propagation.
+PointMassGravityModel getPointMassGravityModelPatchedConicsTrajectoryLeg(
+        const int legIndex,
+        const int numberOfLegs,
+        const std::string& nameCentralBody,
+        const simulation_setup::NamedBodyMap& bodyMap,
+        const std::vector< std::string >& transferBodyOrder )
+{
+    std::vector< std::string > perturbingBodies = { transferBodyOrder.at( legIndex ) };
+    if( legIndex != numberOfLegs - 1 && transferBodyOrder.at( legIndex ) != transferBodyOrder.at( legIndex + 1 ) )
+    {
+        perturbingBodies.push_back( transferBodyOrder.at( legIndex + 1 ) );
+    }
+
+    std::shared_ptr< ephemerides::Ephemeris > centralBodyEphemeris = bodyMap.at( nameCentralBody )->getEphemeris( );
+    std::vector< std::function< Eigen::Vector3d( const double ) > > perturbingBodyPositionFunctions;
+    std::vector< double > perturbingBodyGravitationalParameters;
+    for( const auto& bodyName : perturbingBodies )
+    {
+        std::shared_ptr< ephemerides::Ephemeris > bodyEphemeris = bodyMap.at( bodyName )->getEphemeris( );
+        perturbingBodyPositionFunctions.push_back( [ = ]( const double time )
+        {
+            return Eigen::Vector3d( ( bodyEphemeris->getCartesianState( time ) -
+                                      centralBodyEphemeris->getCartesianState( time ) ).segment( 0, 3 ) );
+        } );
+        perturbingBodyGravitationalParameters.push_back(
+                    bodyMap.at( bodyName )->getGravityFieldModel( )->getGravitationalParameter( ) );
+    }
+
+    return PointMassGravityModel(
+                bodyMap.at( nameCentralBody )->getGravityFieldModel( )->getGravitationalParameter( ),
+                perturbingBodyPositionFunctions, perturbingBodyGravitationalParameters );
+}
+
 /*!
  *   This function computes a patched conic trajectory with a given set of flyby bodies, minimum periapsis distances. The
  *   order of bodies is defined as Earth-Venus-X-Y-Jupiter, with X and Y user-defined. A Trajectory object is created that
@@ -82,11 +131,27 @@ std::vector < basic_astrodynamics::AccelerationMap > getAccelerationModelsPertur
  *   patched conic method. In addition to the point mass gravity attraction by the Sun (Sun fixed at the origin), the perturbations
  *   of the arrival and departure planet are also taken into account (as point-mass gravities)
  *
+ *   Optionally (computePorkchop), the Lambert problem of the first leg is solved over a grid of departure epochs and times of
+ *   flight around the current first leg (porkchop plot), both from generic initial guesses and in sweep order with
+ *   warm-started Lambert iterations, and the average number of iterations of both is reported.
+ *
+ *   Optionally (evaluateMga1DsmPopulation), a random population of MGA-1DSM trajectories (one deep-space maneuver per leg)
+ *   around the current trajectory is evaluated concurrently, with single-revolution and with up to two-revolution Lambert
+ *   arcs. The evaluated population is stored in a trajectory archive, which is written to file and read back to retrieve the
+ *   best archived solution near a given point.
+ *
+ *   Optionally (propagateFirstFlyby), the first flyby is reconstructed from the excess velocities of the Lambert arcs of the
+ *   first two legs, and propagated from its pericenter (forward and backward), both w.r.t. the Sun and with the central body
+ *   switched inside the spheres of influence of the transfer bodies.
+ *
  *   Key outputs (per leg):
  *
  *   lambertTargeterResultForEachLeg: a list of the state history of the spacecraft (per leg) according to the patched conic
  *      method
  *   fullProblemResultForEachLeg: a list of the state history of the spacecraft (per leg) as produced by the numerical propagation
+ *   flybyResultHeliocentric/flybyResultSwitching: state history of the first flyby, w.r.t. the Sun and with central body
+ *      switching (if propagated)
+ *   mga1DsmArchive: binary archive of the evaluated MGA-1DSM population, with total and per-maneuver Delta V (if computed)
  *
  *   Input parameters:
  *
@@ -97,8 +162,15 @@ std::vector < basic_astrodynamics::AccelerationMap > getAccelerationModelsPertur
  */
 int main( )
 {
+    // Set whether analytic planet ephemerides (mean elements with secular rates) are used, instead of Spice ephemerides. The
+    // analytic ephemerides are less accurate, but require no kernels, and are much faster (e.g. for coarse screening)
+    bool useAnalyticEphemerides = false;
+
     // Load Spice kernels.
-    spice_interface::loadStandardSpiceKernels( );
+    if( !useAnalyticEphemerides )
+    {
+        spice_interface::loadStandardSpiceKernels( );
+    }
 
     std::string outputPath = tudat_applications::getOutputPath( "HighThrust" );
 
@@ -128,13 +200,35 @@ int main( )
     double captureEccentricity = 0.98;
     std::vector< double > departureCaptureSemiMajorAxes = { TUDAT_NAN, captureSemiMajorAxis };
     std::vector< double > departureCaptureEccentricities = { TUDAT_NAN, captureEccentricity };
+
+    // Set whether the Lambert problem of the first leg is solved over a grid of departure epochs and times of flight
+    // (porkchop plot), both from generic and from warm-started initial guesses
+    bool computePorkchop = false;
+
+    // Set whether a random population of MGA-1DSM trajectories (one deep-space maneuver per leg) around the current
+    // trajectory is evaluated, with single- and multi-revolution Lambert arcs, and stored in a trajectory archive
+    bool evaluateMga1DsmPopulation = false;
+
+    // Set whether the first flyby is propagated (from its pericenter, forward and backward), both w.r.t. the Sun and with the
+    // central body switched inside spheres of influence
+    bool propagateFirstFlyby = false;
+
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     ///////////////////////        SETUP SOLAR SYSTEM BODIES            ///////////////////////////////////////////////////
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
     // Create body map
-    NamedBodyMap bodyMapForPatchedConic = setupBodyMapFromEphemeridesForPatchedConicsTrajectory(
-                "Sun", "Spacecraft", transferBodyOrder );
+    NamedBodyMap bodyMapForPatchedConic;
+    if( useAnalyticEphemerides )
+    {
+        bodyMapForPatchedConic = setupBodyMapFromAnalyticEphemeridesForPatchedConicsTrajectory(
+                    "Sun", "Spacecraft", transferBodyOrder );
+    }
+    else
+    {
+        bodyMapForPatchedConic = setupBodyMapFromEphemeridesForPatchedConicsTrajectory(
+                    "Sun", "Spacecraft", transferBodyOrder );
+    }
 
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     ///////////////////////             CREATE SPACECRAFT            //////////////////////////////////////////////////////
@@ -185,6 +279,153 @@ int main( )
     std::vector < double > deltaVVector;
     trajectory.maneuvers( positionVector, timeVector, deltaVVector );
 
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ////////////////             SWEEP LAMBERT GRID FOR FIRST LEG (PORKCHOP PLOT)            //////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    if( computePorkchop )
+    {
+        // Define grid of departure epochs and times of flight around current first leg
+        int numberOfGridPoints = 121;
+        Eigen::VectorXd porkchopDepartureEpochs = Eigen::VectorXd::LinSpaced(
+                    numberOfGridPoints, trajectoryIndependentVariables.at( 0 ) - 30.0 * physical_constants::JULIAN_DAY,
+                    trajectoryIndependentVariables.at( 0 ) + 30.0 * physical_constants::JULIAN_DAY );
+        Eigen::VectorXd porkchopTimesOfFlight = Eigen::VectorXd::LinSpaced(
+                    numberOfGridPoints, 0.7 * trajectoryIndependentVariables.at( 1 ),
+                    1.3 * trajectoryIndependentVariables.at( 1 ) );
+
+        // Solve grid from generic initial guesses, and in sweep order with warm-started Lambert iterations
+        LambertGridSweepResults coldStartPorkchop = sweepLambertGrid(
+                    bodyMapForPatchedConic.at( transferBodyOrder.at( 0 ) )->getEphemeris( ),
+                    bodyMapForPatchedConic.at( transferBodyOrder.at( 1 ) )->getEphemeris( ),
+                    porkchopDepartureEpochs, porkchopTimesOfFlight,
+                    bodyMapForPatchedConic.at( "Sun" )->getGravityFieldModel( )->getGravitationalParameter( ),
+                    false, getDefaultNumberOfThreads( ) );
+        LambertGridSweepResults warmStartPorkchop = sweepLambertGrid(
+                    bodyMapForPatchedConic.at( transferBodyOrder.at( 0 ) )->getEphemeris( ),
+                    bodyMapForPatchedConic.at( transferBodyOrder.at( 1 ) )->getEphemeris( ),
+                    porkchopDepartureEpochs, porkchopTimesOfFlight,
+                    bodyMapForPatchedConic.at( "Sun" )->getGravityFieldModel( )->getGravitationalParameter( ),
+                    true, getDefaultNumberOfThreads( ) );
+
+        std::cout<<"Porkchop minimum departure excess velocity: "<<warmStartPorkchop.departureExcessVelocities.minCoeff( )<<
+                   ", average Lambert iterations (generic/warm-started initial guess): "<<
+                   coldStartPorkchop.getAverageNumberOfIterations( )<<" "<<
+                   warmStartPorkchop.getAverageNumberOfIterations( )<<std::endl;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ////////////////             CREATE SIMS-FLANAGAN LOW-THRUST TRAJECTORY            ////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // Define low-thrust spacecraft settings
+    double lowThrustMaximumThrust = 0.5;
+    double lowThrustSpecificImpulse = 3000.0;
+    double maximumDepartureExcessVelocity = 5.0E3;
+    int numberOfSegmentsPerLeg = 20;
+
+    // Create low-thrust trajectory for same body order and leg durations (Sims-Flanagan legs)
+    SimsFlanaganTrajectory lowThrustTrajectory(
+                bodyMapForPatchedConic, transferBodyOrder, "Sun", transferLegTypes, trajectoryIndependentVariables,
+                minimumPericenterRadii, 400.0, lowThrustMaximumThrust, lowThrustSpecificImpulse, numberOfSegmentsPerLeg,
+                maximumDepartureExcessVelocity );
+
+    // Evaluate ballistic initial guess (to be used as starting point for optimization of low-thrust trajectory)
+    Eigen::VectorXd lowThrustDecisionVector = lowThrustTrajectory.getBallisticInitialGuess( );
+    Eigen::VectorXd lowThrustEqualityConstraints, lowThrustInequalityConstraints;
+    double lowThrustFinalMass = lowThrustTrajectory.evaluateTrajectory(
+                lowThrustDecisionVector, lowThrustEqualityConstraints, lowThrustInequalityConstraints );
+
+    std::cout<<"Low-thrust final mass/mismatch norm (ballistic guess): "<<lowThrustFinalMass<<" "<<
+               lowThrustEqualityConstraints.norm( )<<std::endl;
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ////////////////             EVALUATE MGA-1DSM TRAJECTORY POPULATION            ///////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    if( evaluateMga1DsmPopulation )
+    {
+        // Create MGA-1DSM trajectory (one deep-space maneuver per leg) for same body order
+        Mga1DsmTrajectory mga1DsmTrajectory(
+                    bodyMapForPatchedConic, transferBodyOrder, "Sun", minimumPericenterRadii,
+                    captureSemiMajorAxis, captureEccentricity );
+
+        // Generate random population around current departure date and leg durations (e.g. initial population of optimizer)
+        int populationSize = 1000;
+        std::mt19937 randomNumberGenerator( 42 );
+        std::uniform_real_distribution< double > unitDistribution( 0.0, 1.0 );
+        Eigen::MatrixXd mga1DsmPopulation( populationSize, mga1DsmTrajectory.getDecisionVectorSize( ) );
+        for( int i = 0; i < populationSize; i++ )
+        {
+            for( int j = 0; j < mga1DsmPopulation.cols( ); j++ )
+            {
+                mga1DsmPopulation( i, j ) = unitDistribution( randomNumberGenerator );
+            }
+
+            mga1DsmPopulation( i, 0 ) = trajectoryIndependentVariables.at( 0 ) +
+                    ( mga1DsmPopulation( i, 0 ) - 0.5 ) * 60.0 * physical_constants::JULIAN_DAY;
+            mga1DsmPopulation( i, 1 ) *= 5.0E3;
+            mga1DsmPopulation( i, 4 ) = 0.01 + 0.98 * mga1DsmPopulation( i, 4 );
+            mga1DsmPopulation( i, 5 ) = trajectoryIndependentVariables.at( 1 ) * ( 0.8 + 0.4 * mga1DsmPopulation( i, 5 ) );
+            for( int j = 1; j < mga1DsmTrajectory.getNumberOfLegs( ); j++ )
+            {
+                mga1DsmPopulation( i, 6 + 4 * ( j - 1 ) ) = 1.0 + 4.0 * mga1DsmPopulation( i, 6 + 4 * ( j - 1 ) );
+                mga1DsmPopulation( i, 7 + 4 * ( j - 1 ) ) *= 2.0 * mathematical_constants::PI;
+                mga1DsmPopulation( i, 8 + 4 * ( j - 1 ) ) = 0.01 + 0.98 * mga1DsmPopulation( i, 8 + 4 * ( j - 1 ) );
+                mga1DsmPopulation( i, 9 + 4 * ( j - 1 ) ) = trajectoryIndependentVariables.at( j + 1 ) *
+                        ( 0.8 + 0.4 * mga1DsmPopulation( i, 9 + 4 * ( j - 1 ) ) );
+            }
+        }
+
+        // Evaluate full population at once
+        std::chrono::steady_clock::time_point populationEvaluationStart = std::chrono::steady_clock::now( );
+        Eigen::VectorXd mga1DsmPopulationDeltaV = mga1DsmTrajectory.evaluatePopulation(
+                    mga1DsmPopulation, getDefaultNumberOfThreads( ) );
+        double populationEvaluationTime = std::chrono::duration< double >(
+                    std::chrono::steady_clock::now( ) - populationEvaluationStart ).count( );
+
+        int bestIndividual;
+        mga1DsmPopulationDeltaV.minCoeff( &bestIndividual );
+        std::cout<<"MGA-1DSM best Delta V in population: "<<mga1DsmPopulationDeltaV( bestIndividual )<<
+                   ", evaluation time per trajectory: "<<populationEvaluationTime / populationSize<<" s"<<std::endl;
+
+        // Re-evaluate population, allowing multi-revolution Lambert arcs (lowest-DSM branch selected for each leg)
+        Mga1DsmTrajectory multiRevolutionMga1DsmTrajectory(
+                    bodyMapForPatchedConic, transferBodyOrder, "Sun", minimumPericenterRadii,
+                    captureSemiMajorAxis, captureEccentricity, false, 2 );
+        Eigen::VectorXd multiRevolutionPopulationDeltaV = multiRevolutionMga1DsmTrajectory.evaluatePopulation(
+                    mga1DsmPopulation, getDefaultNumberOfThreads( ) );
+        multiRevolutionPopulationDeltaV.minCoeff( &bestIndividual );
+        std::cout<<"MGA-1DSM best Delta V in population (up to 2 revolutions per leg): "<<
+                   multiRevolutionPopulationDeltaV( bestIndividual )<<std::endl;
+
+        // Store evaluated population in archive (with maneuver Delta Vs as auxiliary values), and write to file
+        TrajectoryArchive mga1DsmArchive(
+                    mga1DsmPopulation.colwise( ).minCoeff( ).transpose( ),
+                    mga1DsmPopulation.colwise( ).maxCoeff( ).transpose( ),
+                    mga1DsmTrajectory.getNumberOfLegs( ) + 2 );
+        mga1DsmArchive.addEntries( mga1DsmPopulation, mga1DsmPopulationDeltaV, mga1DsmTrajectory.computeManeuverDeltaVs(
+                                       mga1DsmPopulation, getDefaultNumberOfThreads( ) ) );
+        boost::filesystem::create_directories( outputPath );
+        mga1DsmArchive.writeToFile( outputPath + "mga1DsmArchive.dat" );
+
+        // Retrieve best archived solution close to a given point (e.g. to initialize a local optimization)
+        TrajectoryArchive storedMga1DsmArchive( outputPath + "mga1DsmArchive.dat" );
+        Eigen::VectorXd localSearchCenter = mga1DsmPopulation.row( populationSize / 2 ).transpose( );
+        Eigen::VectorXd localSearchHalfWidth = 0.25 * ( mga1DsmPopulation.colwise( ).maxCoeff( ) -
+                                                        mga1DsmPopulation.colwise( ).minCoeff( ) ).transpose( );
+        int bestNearbyEntry = storedMga1DsmArchive.getBestEntryInRegion(
+                    localSearchCenter - localSearchHalfWidth, localSearchCenter + localSearchHalfWidth );
+        if( bestNearbyEntry >= 0 )
+        {
+            std::cout<<"Best archived MGA-1DSM Delta V near local search center: "<<
+                       storedMga1DsmArchive.getDeltaV( bestNearbyEntry )<<", nearest archived Delta V: "<<
+                       storedMga1DsmArchive.getDeltaV(
+                           storedMga1DsmArchive.getNearestEntries( localSearchCenter, 1 ).at( 0 ) )<<
+                       std::endl;
+        }
+    }
+
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     ////////////////             NUMERICALLY PROPAGATE DYNAMICS            ////////////////////////////////////////////////
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -202,6 +443,13 @@ int main( )
             std::make_shared< numerical_integrators::IntegratorSettings < > > (
                 numerical_integrators::rungeKutta4, TUDAT_NAN, 1000.0 );
 
+    // Set whether the forward/backward propagations from the leg midpoints use Sundman-regularized time (fixed steps in
+    // regularized time, with physical steps proportional to the local orbital time scale w.r.t. the nearest massive body),
+    // instead of the fixed physical time step of the integrator settings
+    bool useRegularizedPropagation = false;
+    double regularizedStepSize = 0.25 * physical_constants::JULIAN_DAY;
+    double regularizationExponent = 1.5;
+
     // Create list of relevant bodies
     std::vector< std::string > bodyList;
     for( unsigned int i = 0; i < transferBodyOrder.size( ); i++ )
@@ -222,6 +470,11 @@ int main( )
                                              relative_distance_dependent_variable, "Spacecraft", bodyList.at( i ) ) );
     }
 
+    // Add total acceleration (used for interpolation of numerical results)
+    int totalAccelerationIndex = bodyList.size( );
+    dependentVariableList.push_back( std::make_shared< SingleDependentVariableSaveSettings >(
+                                         total_acceleration_dependent_variable, "Spacecraft" ) );
+
     // Save dependent variables for each propagation leg
     std::vector< std::shared_ptr< DependentVariableSaveSettings > > dependentVariablesToSave;
     for( unsigned int j = 0; j < transferBodyOrder.size( ); j++ )
@@ -269,21 +522,25 @@ int main( )
     std::cout<<"Operation took: "<<runTimeInSeconds<<" seconds"<<std::endl;
 
     double currentArcMiddleTime = trajectoryParameters.at( 0 ) + trajectoryParameters.at( 1 ) / 2.0;
-    for( auto resultIterator : fullProblemResultForEachLeg )
+    for( const auto& resultIterator : fullProblemResultForEachLeg )
     {
         int currentArc = resultIterator.first;
 
         // Retrieve state history for current arc
-        std::map< double, Eigen::Vector6d > fullProblemSolution = resultIterator.second;
+        const std::map< double, Eigen::Vector6d >& fullProblemSolution = resultIterator.second;
 
         // Retrieve numerical state at middle of arc.
-        Eigen::Vector6d currentArcMiddleState = interpolators::createOneDimensionalInterpolator(
-                    fullProblemSolution, std::make_shared< interpolators::LagrangeInterpolatorSettings >(
-                        8 ) )->interpolate( currentArcMiddleTime * 86400.0 );
+        ContinuousTrajectory fullProblemTrajectory(
+                    fullProblemSolution, dependentVariableResultForEachLeg.at( currentArc ), totalAccelerationIndex );
+        Eigen::Vector6d currentArcMiddleState = fullProblemTrajectory.getState( currentArcMiddleTime * 86400.0 );
 
         // Reset integrator initial time
         integratorSettings->initialTime_ = currentArcMiddleTime * 86400.0;
 
+        // Create point mass gravity model of current leg (for regularized propagation)
+        PointMassGravityModel legGravityModel = getPointMassGravityModelPatchedConicsTrajectoryLeg(
+                    currentArc, transferLegTypes.size( ), "Sun", bodyMapForPropagation, transferBodyOrder );
+
         // Retrieve propagation settings for forward propagation, and reset initial state/final time
         std::shared_ptr< propagators::TranslationalStatePropagatorSettings< double > > forwardPropagatorSettings =
                 propagatorSettings.at( resultIterator.first ).second;
@@ -295,11 +552,23 @@ int main( )
         integratorSettings->initialTimeStep_ = std::fabs( integratorSettings->initialTimeStep_ );
 
         // Propagate dynamics forward and print results to file
-        SingleArcDynamicsSimulator< > forwardDynamicsSimulator(
-                    bodyMapForPropagation, integratorSettings, forwardPropagatorSettings );
-        input_output::writeDataMapToTextFile(
-                    forwardDynamicsSimulator.getEquationsOfMotionNumericalSolution( ), "numericalResultForward" +
-                    std::to_string( resultIterator.first ) + ".dat", outputPath );
+        if( useRegularizedPropagation )
+        {
+            input_output::writeDataMapToTextFile(
+                        propagateWithSundmanRegularization(
+                            legGravityModel, currentArcMiddleTime * 86400.0, currentArcMiddleState,
+                            fullProblemSolution.rbegin( )->first, physical_constants::ASTRONOMICAL_UNIT,
+                            regularizedStepSize, regularizationExponent ), "numericalResultForward" +
+                        std::to_string( resultIterator.first ) + ".dat", outputPath );
+        }
+        else
+        {
+            SingleArcDynamicsSimulator< > forwardDynamicsSimulator(
+                        bodyMapForPropagation, integratorSettings, forwardPropagatorSettings );
+            input_output::writeDataMapToTextFile(
+                        forwardDynamicsSimulator.getEquationsOfMotionNumericalSolution( ), "numericalResultForward" +
+                        std::to_string( resultIterator.first ) + ".dat", outputPath );
+        }
 
 
         // Retrieve propagation settings for backward propagation, and reset initial state/final time
@@ -313,11 +582,23 @@ int main( )
         integratorSettings->initialTimeStep_ *= -1.0;
 
         // Propagate dynamics backward and print results to file
-        SingleArcDynamicsSimulator< > backwardDynamicsSimulator(
-                    bodyMapForPropagation, integratorSettings, backwardPropagatorSettings );
-        input_output::writeDataMapToTextFile(
-                    backwardDynamicsSimulator.getEquationsOfMotionNumericalSolution( ), "numericalResultBackward" +
-                    std::to_string( resultIterator.first ) + ".dat", outputPath );
+        if( useRegularizedPropagation )
+        {
+            input_output::writeDataMapToTextFile(
+                        propagateWithSundmanRegularization(
+                            legGravityModel, currentArcMiddleTime * 86400.0, currentArcMiddleState,
+                            fullProblemSolution.begin( )->first, physical_constants::ASTRONOMICAL_UNIT,
+                            regularizedStepSize, regularizationExponent ), "numericalResultBackward" +
+                        std::to_string( resultIterator.first ) + ".dat", outputPath );
+        }
+        else
+        {
+            SingleArcDynamicsSimulator< > backwardDynamicsSimulator(
+                        bodyMapForPropagation, integratorSettings, backwardPropagatorSettings );
+            input_output::writeDataMapToTextFile(
+                        backwardDynamicsSimulator.getEquationsOfMotionNumericalSolution( ), "numericalResultBackward" +
+                        std::to_string( resultIterator.first ) + ".dat", outputPath );
+        }
 
         // Update arc middle time for next arc.
         if( currentArc < fullProblemResultForEachLeg.size( ) - 1 )
@@ -328,7 +609,7 @@ int main( )
     }
 
     // Write patched conic results to file for each leg
-    for( auto resultIterator : lambertTargeterResultForEachLeg )
+    for( const auto& resultIterator : lambertTargeterResultForEachLeg )
     {
         input_output::writeDataMapToTextFile(
                     resultIterator.second, "lambertResult" +
@@ -336,7 +617,7 @@ int main( )
     }
 
     // Write numerical propagation results to file for each leg
-    for( auto resultIterator : fullProblemResultForEachLeg )
+    for( const auto& resultIterator : fullProblemResultForEachLeg )
     {
 
         input_output::writeDataMapToTextFile(
@@ -345,7 +626,7 @@ int main( )
     }
 
     // Write numerical propagation results to file for each leg
-    for( auto resultIterator : dependentVariableResultForEachLeg )
+    for( const auto& resultIterator : dependentVariableResultForEachLeg )
     {
 
         input_output::writeDataMapToTextFile(
@@ -353,6 +634,87 @@ int main( )
                     std::to_string( resultIterator.first ) + ".dat", outputPath );
     }
 
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ////////////////             PROPAGATE FIRST FLYBY WITH CENTRAL BODY SWITCHING            /////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    if( propagateFirstFlyby )
+    {
+        // Retrieve excess velocities at first flyby from Lambert arcs of first two legs
+        double flybyTime = trajectoryIndependentVariables.at( 0 ) + trajectoryIndependentVariables.at( 1 );
+        std::vector< Eigen::Vector6d > flybyLegBodyStates;
+        for( unsigned int i = 0; i < 3; i++ )
+        {
+            double currentBodyTime = trajectoryIndependentVariables.at( 0 );
+            for( unsigned int j = 0; j < i; j++ )
+            {
+                currentBodyTime += trajectoryIndependentVariables.at( j + 1 );
+            }
+            flybyLegBodyStates.push_back(
+                        bodyMapForPropagation.at( transferBodyOrder.at( i ) )->getEphemeris( )->getCartesianState(
+                            currentBodyTime ) -
+                        bodyMapForPropagation.at( "Sun" )->getEphemeris( )->getCartesianState( currentBodyTime ) );
+        }
+        double sunGravitationalParameter =
+                bodyMapForPropagation.at( "Sun" )->getGravityFieldModel( )->getGravitationalParameter( );
+        Eigen::Vector3d incomingExcessVelocity = solveLambertProblemForAllBranches(
+                    flybyLegBodyStates.at( 0 ).segment( 0, 3 ), flybyLegBodyStates.at( 1 ).segment( 0, 3 ),
+                    trajectoryIndependentVariables.at( 1 ), sunGravitationalParameter, 0 ).at( 0 ).arrivalVelocity -
+                flybyLegBodyStates.at( 1 ).segment( 3, 3 );
+        Eigen::Vector3d outgoingExcessVelocity = solveLambertProblemForAllBranches(
+                    flybyLegBodyStates.at( 1 ).segment( 0, 3 ), flybyLegBodyStates.at( 2 ).segment( 0, 3 ),
+                    trajectoryIndependentVariables.at( 2 ), sunGravitationalParameter, 0 ).at( 0 ).departureVelocity -
+                flybyLegBodyStates.at( 1 ).segment( 3, 3 );
+
+        // Reconstruct flyby hyperbola at pericenter
+        Eigen::Vector6d flybyPericenterState = flybyLegBodyStates.at( 1 ) + computeFlybyPericenterState(
+                    incomingExcessVelocity, outgoingExcessVelocity,
+                    bodyMapForPropagation.at( transferBodyOrder.at( 1 ) )->getGravityFieldModel( )->
+                    getGravitationalParameter( ) );
+
+        // Define accelerations (point masses of Sun and all transfer bodies) and variable step size integrator
+        SelectedAccelerationMap flybyAccelerationSettings;
+        std::vector< std::string > switchingBodies;
+        for( const auto& bodyName : bodyList )
+        {
+            flybyAccelerationSettings[ "Spacecraft" ][ bodyName ].push_back(
+                        std::make_shared< AccelerationSettings >( basic_astrodynamics::point_mass_gravity ) );
+            if( bodyName != "Sun" )
+            {
+                switchingBodies.push_back( bodyName );
+            }
+        }
+        std::shared_ptr< IntegratorSettings< > > flybyIntegratorSettings =
+                std::make_shared< RungeKuttaVariableStepSizeSettings< > >(
+                    rungeKuttaVariableStepSize, flybyTime, 10.0, RungeKuttaCoefficients::rungeKuttaFehlberg78,
+                    1.0E-3, 1.0E6, 1.0E-10, 1.0E-10 );
+
+        // Propagate from pericenter, forward and backward, with and without central body switching
+        for( unsigned int i = 0; i < 2; i++ )
+        {
+            std::vector< std::string > currentSwitchingBodies =
+                    ( i == 0 ) ? std::vector< std::string >( ) : switchingBodies;
+            std::vector< std::pair< double, std::string > > forwardSegments, backwardSegments;
+            std::map< double, Eigen::Vector6d > flybyStateHistory = propagateWithCentralBodySwitching(
+                        bodyMapForPropagation, flybyAccelerationSettings, "Spacecraft", "Sun", currentSwitchingBodies,
+                        flybyPericenterState, flybyTime + 20.0 * physical_constants::JULIAN_DAY, flybyIntegratorSettings,
+                        forwardSegments );
+            std::map< double, Eigen::Vector6d > backwardFlybyStateHistory = propagateWithCentralBodySwitching(
+                        bodyMapForPropagation, flybyAccelerationSettings, "Spacecraft", "Sun", currentSwitchingBodies,
+                        flybyPericenterState, flybyTime - 20.0 * physical_constants::JULIAN_DAY, flybyIntegratorSettings,
+                        backwardSegments );
+            flybyStateHistory.insert( backwardFlybyStateHistory.begin( ), backwardFlybyStateHistory.end( ) );
+
+            std::cout<<"First flyby propagation "<<( ( i == 0 ) ? "w.r.t. Sun" : "with central body switching" )<<
+                       ": number of steps "<<flybyStateHistory.size( ) - 1<<", number of segments "<<
+                       forwardSegments.size( ) + backwardSegments.size( )<<std::endl;
+
+            input_output::writeDataMapToTextFile(
+                        flybyStateHistory, ( i == 0 ) ? "flybyResultHeliocentric.dat" : "flybyResultSwitching.dat",
+                        outputPath );
+        }
+    }
+
     // The exit code EXIT_SUCCESS indicates that the program was successfully executed.
     return EXIT_SUCCESS;
 }
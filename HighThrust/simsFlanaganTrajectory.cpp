@@ -0,0 +1,394 @@
+/*    Copyright (c) 2010-2018, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#include <cmath>
+#include <stdexcept>
+
+#include <Tudat/Astrodynamics/BasicAstrodynamics/physicalConstants.h>
+#include <Tudat/Astrodynamics/MissionSegments/lambertRoutines.h>
+#include <Tudat/Mathematics/BasicMathematics/mathematicalConstants.h>
+
+#include "highThrustTransfer.h"
+#include "simsFlanaganTrajectory.h"
+
+namespace tudat_applications
+{
+
+//! Constructor
+SimsFlanaganLeg::SimsFlanaganLeg(
+        const double timeOfFlight,
+        const double centralBodyGravitationalParameter,
+        const double maximumThrust,
+        const double specificImpulse,
+        const int numberOfSegments,
+        const int numberOfForwardSegments ):
+    timeOfFlight_( timeOfFlight ),
+    centralBodyGravitationalParameter_( centralBodyGravitationalParameter ),
+    maximumThrust_( maximumThrust ),
+    exhaustVelocity_( specificImpulse * tudat::physical_constants::SEA_LEVEL_GRAVITATIONAL_ACCELERATION ),
+    numberOfSegments_( numberOfSegments ),
+    numberOfForwardSegments_( numberOfForwardSegments )
+{
+    if( numberOfSegments_ < 1 )
+    {
+        throw std::runtime_error( "Error when creating Sims-Flanagan leg, at least one segment is required" );
+    }
+
+    if( numberOfForwardSegments_ < 0 )
+    {
+        numberOfForwardSegments_ = ( numberOfSegments_ + 1 ) / 2;
+    }
+    else if( numberOfForwardSegments_ > numberOfSegments_ )
+    {
+        throw std::runtime_error( "Error when creating Sims-Flanagan leg, number of forward segments exceeds number of segments" );
+    }
+
+    segmentDuration_ = timeOfFlight_ / static_cast< double >( numberOfSegments_ );
+}
+
+//! Function to propagate the state and mass through a single segment
+void SimsFlanaganLeg::propagateSegment(
+        Eigen::Vector6d& currentState,
+        double& currentMass,
+        const Eigen::Vector3d& currentThrottle,
+        const bool propagateBackwards,
+        std::map< double, Eigen::Vector6d >* stateHistory,
+        const double segmentStartTime ) const
+{
+    double directionSign = propagateBackwards ? -1.0 : 1.0;
+
+    // Coast to impulse in middle of segment
+    currentState = propagateKeplerOrbitWithUniversalVariables(
+                currentState, directionSign * segmentDuration_ / 2.0, centralBodyGravitationalParameter_ );
+
+    // Apply impulse, with magnitude bounded by maximum thrust over segment duration, and update mass (Tsiolkovsky)
+    Eigen::Vector3d impulse = currentThrottle * maximumThrust_ / currentMass * segmentDuration_;
+    currentState.segment( 3, 3 ) += directionSign * impulse;
+    currentMass *= std::exp( -directionSign * impulse.norm( ) / exhaustVelocity_ );
+
+    if( stateHistory != NULL )
+    {
+        ( *stateHistory )[ segmentStartTime + directionSign * segmentDuration_ / 2.0 ] = currentState;
+    }
+
+    // Coast to end of segment
+    currentState = propagateKeplerOrbitWithUniversalVariables(
+                currentState, directionSign * segmentDuration_ / 2.0, centralBodyGravitationalParameter_ );
+
+    if( stateHistory != NULL )
+    {
+        ( *stateHistory )[ segmentStartTime + directionSign * segmentDuration_ ] = currentState;
+    }
+}
+
+//! Function to compute the mismatch in state and mass between forward and backward branch at the match point
+Eigen::Matrix< double, 7, 1 > SimsFlanaganLeg::computeMatchPointMismatch(
+        const Eigen::Vector6d& departureState,
+        const double departureMass,
+        const Eigen::Vector6d& arrivalState,
+        const double arrivalMass,
+        const Eigen::VectorXd& throttles ) const
+{
+    if( throttles.rows( ) != 3 * numberOfSegments_ )
+    {
+        throw std::runtime_error( "Error in Sims-Flanagan leg, throttle vector size is inconsistent with number of segments" );
+    }
+
+    // Propagate forward branch from departure
+    Eigen::Vector6d forwardState = departureState;
+    double forwardMass = departureMass;
+    for( int i = 0; i < numberOfForwardSegments_; i++ )
+    {
+        propagateSegment( forwardState, forwardMass, throttles.segment( 3 * i, 3 ), false );
+    }
+
+    // Propagate backward branch from arrival
+    Eigen::Vector6d backwardState = arrivalState;
+    double backwardMass = arrivalMass;
+    for( int i = numberOfSegments_ - 1; i >= numberOfForwardSegments_; i-- )
+    {
+        propagateSegment( backwardState, backwardMass, throttles.segment( 3 * i, 3 ), true );
+    }
+
+    Eigen::Matrix< double, 7, 1 > mismatch;
+    mismatch.segment( 0, 6 ) = backwardState - forwardState;
+    mismatch( 6 ) = backwardMass - forwardMass;
+    return mismatch;
+}
+
+//! Function to compute the throttle constraints (squared norm of throttle vector per segment minus one; feasible if <= 0)
+Eigen::VectorXd SimsFlanaganLeg::computeThrottleConstraints( const Eigen::VectorXd& throttles ) const
+{
+    Eigen::VectorXd throttleConstraints = Eigen::VectorXd::Zero( numberOfSegments_ );
+    for( int i = 0; i < numberOfSegments_; i++ )
+    {
+        throttleConstraints( i ) = throttles.segment( 3 * i, 3 ).squaredNorm( ) - 1.0;
+    }
+    return throttleConstraints;
+}
+
+//! Function to retrieve the state at the segment boundaries and impulses of the forward and backward branch
+std::map< double, Eigen::Vector6d > SimsFlanaganLeg::getSegmentStateHistory(
+        const Eigen::Vector6d& departureState,
+        const double departureMass,
+        const Eigen::Vector6d& arrivalState,
+        const double arrivalMass,
+        const Eigen::VectorXd& throttles ) const
+{
+    std::map< double, Eigen::Vector6d > stateHistory;
+
+    Eigen::Vector6d currentState = departureState;
+    double currentMass = departureMass;
+    stateHistory[ 0.0 ] = currentState;
+    for( int i = 0; i < numberOfForwardSegments_; i++ )
+    {
+        propagateSegment( currentState, currentMass, throttles.segment( 3 * i, 3 ), false,
+                          &stateHistory, static_cast< double >( i ) * segmentDuration_ );
+    }
+
+    // Backward branch is stored up to (not including) the match point, which is already set by forward branch
+    currentState = arrivalState;
+    currentMass = arrivalMass;
+    std::map< double, Eigen::Vector6d > backwardStateHistory;
+    backwardStateHistory[ timeOfFlight_ ] = currentState;
+    for( int i = numberOfSegments_ - 1; i >= numberOfForwardSegments_; i-- )
+    {
+        propagateSegment( currentState, currentMass, throttles.segment( 3 * i, 3 ), true,
+                          &backwardStateHistory, static_cast< double >( i + 1 ) * segmentDuration_ );
+    }
+    stateHistory.insert( backwardStateHistory.begin( ), backwardStateHistory.end( ) );
+
+    return stateHistory;
+}
+
+//! Constructor
+SimsFlanaganTrajectory::SimsFlanaganTrajectory(
+        const tudat::simulation_setup::NamedBodyMap& bodyMap,
+        const std::vector< std::string >& transferBodyOrder,
+        const std::string& centralBody,
+        const std::vector< tudat::transfer_trajectories::TransferLegType >& transferLegTypes,
+        const std::vector< double >& trajectoryIndependentVariables,
+        const std::vector< double >& minimumPericenterRadii,
+        const double initialMass,
+        const double maximumThrust,
+        const double specificImpulse,
+        const int numberOfSegmentsPerLeg,
+        const double maximumDepartureExcessVelocity ):
+    numberOfLegs_( static_cast< int >( transferBodyOrder.size( ) ) - 1 ),
+    numberOfParametersPerLeg_( 7 + 3 * numberOfSegmentsPerLeg ),
+    minimumPericenterRadii_( minimumPericenterRadii ),
+    initialMass_( initialMass ),
+    maximumDepartureExcessVelocity_( maximumDepartureExcessVelocity )
+{
+    using namespace tudat::transfer_trajectories;
+
+    // Check input consistency
+    if( numberOfLegs_ < 1 )
+    {
+        throw std::runtime_error( "Error when creating Sims-Flanagan trajectory, at least two bodies are required" );
+    }
+    if( transferLegTypes.size( ) != transferBodyOrder.size( ) ||
+            minimumPericenterRadii.size( ) != transferBodyOrder.size( ) )
+    {
+        throw std::runtime_error( "Error when creating Sims-Flanagan trajectory, input sizes are inconsistent with body order" );
+    }
+    if( trajectoryIndependentVariables.size( ) < transferBodyOrder.size( ) )
+    {
+        throw std::runtime_error( "Error when creating Sims-Flanagan trajectory, insufficient independent variables" );
+    }
+    for( unsigned int i = 0; i < transferLegTypes.size( ); i++ )
+    {
+        TransferLegType expectedLegType = mga_Swingby;
+        if( i == 0 )
+        {
+            expectedLegType = mga_Departure;
+        }
+        else if( i == transferLegTypes.size( ) - 1 )
+        {
+            expectedLegType = capture;
+        }
+
+        if( transferLegTypes.at( i ) != expectedLegType )
+        {
+            throw std::runtime_error( "Error when creating Sims-Flanagan trajectory, only mga_Departure, mga_Swingby and "
+                                      "capture legs (in that order) can be modelled as Sims-Flanagan legs" );
+        }
+    }
+
+    // Retrieve epochs, planet states and gravitational parameters of visited bodies
+    centralBodyGravitationalParameter_ =
+            bodyMap.at( centralBody )->getGravityFieldModel( )->getGravitationalParameter( );
+
+    double currentEpoch = trajectoryIndependentVariables.at( 0 );
+    for( unsigned int i = 0; i < transferBodyOrder.size( ); i++ )
+    {
+        if( i > 0 )
+        {
+            currentEpoch += trajectoryIndependentVariables.at( i );
+        }
+        bodyEpochs_.push_back( currentEpoch );
+        bodyStates_.push_back(
+                    bodyMap.at( transferBodyOrder.at( i ) )->getEphemeris( )->getCartesianState( currentEpoch ) -
+                    bodyMap.at( centralBody )->getEphemeris( )->getCartesianState( currentEpoch ) );
+        bodyGravitationalParameters_.push_back(
+                    bodyMap.at( transferBodyOrder.at( i ) )->getGravityFieldModel( )->getGravitationalParameter( ) );
+    }
+
+    // Create leg objects
+    for( int i = 0; i < numberOfLegs_; i++ )
+    {
+        legs_.push_back( SimsFlanaganLeg(
+                             bodyEpochs_.at( i + 1 ) - bodyEpochs_.at( i ), centralBodyGravitationalParameter_,
+                             maximumThrust, specificImpulse, numberOfSegmentsPerLeg ) );
+    }
+}
+
+//! Function to evaluate the trajectory for a given decision vector
+double SimsFlanaganTrajectory::evaluateTrajectory(
+        const Eigen::VectorXd& decisionVector,
+        Eigen::VectorXd& equalityConstraints,
+        Eigen::VectorXd& inequalityConstraints ) const
+{
+    if( decisionVector.rows( ) != getDecisionVectorSize( ) )
+    {
+        throw std::runtime_error( "Error when evaluating Sims-Flanagan trajectory, decision vector has incorrect size" );
+    }
+
+    // Define normalization of constraints
+    const double positionScale = tudat::physical_constants::ASTRONOMICAL_UNIT;
+    const double velocityScale = std::sqrt( centralBodyGravitationalParameter_ / positionScale );
+
+    const int numberOfSegments = legs_.at( 0 ).getNumberOfSegments( );
+    equalityConstraints.setZero( 7 * numberOfLegs_ + ( numberOfLegs_ - 1 ) );
+    inequalityConstraints.setZero( numberOfSegments * numberOfLegs_ + 1 + ( numberOfLegs_ - 1 ) );
+
+    double currentDepartureMass = initialMass_;
+    for( int i = 0; i < numberOfLegs_; i++ )
+    {
+        const int startIndex = i * numberOfParametersPerLeg_;
+        const Eigen::Vector3d departureExcessVelocity = decisionVector.segment( startIndex, 3 );
+        const Eigen::Vector3d arrivalExcessVelocity = decisionVector.segment( startIndex + 3, 3 );
+        const double arrivalMass = decisionVector( startIndex + 6 );
+        const Eigen::VectorXd throttles = decisionVector.segment( startIndex + 7, 3 * numberOfSegments );
+
+        // Set leg boundary states from planet states and excess velocities
+        Eigen::Vector6d departureState = bodyStates_.at( i );
+        departureState.segment( 3, 3 ) += departureExcessVelocity;
+        Eigen::Vector6d arrivalState = bodyStates_.at( i + 1 );
+        arrivalState.segment( 3, 3 ) += arrivalExcessVelocity;
+
+        // Compute match point mismatch, and throttle constraints
+        Eigen::Matrix< double, 7, 1 > mismatch = legs_.at( i ).computeMatchPointMismatch(
+                    departureState, currentDepartureMass, arrivalState, arrivalMass, throttles );
+        equalityConstraints.segment( 7 * i, 3 ) = mismatch.segment( 0, 3 ) / positionScale;
+        equalityConstraints.segment( 7 * i + 3, 3 ) = mismatch.segment( 3, 3 ) / velocityScale;
+        equalityConstraints( 7 * i + 6 ) = mismatch( 6 ) / initialMass_;
+
+        inequalityConstraints.segment( numberOfSegments * i, numberOfSegments ) =
+                legs_.at( i ).computeThrottleConstraints( throttles );
+
+        // Compute unpowered flyby constraints at start of leg (magnitude equality and maximum turn angle)
+        if( i > 0 )
+        {
+            const Eigen::Vector3d incomingExcessVelocity =
+                    decisionVector.segment( ( i - 1 ) * numberOfParametersPerLeg_ + 3, 3 );
+            const double incomingSpeed = incomingExcessVelocity.norm( );
+            const double outgoingSpeed = departureExcessVelocity.norm( );
+
+            equalityConstraints( 7 * numberOfLegs_ + i - 1 ) = ( outgoingSpeed - incomingSpeed ) / velocityScale;
+
+            double turnAngle = std::acos( std::max( -1.0, std::min( 1.0, incomingExcessVelocity.dot(
+                                                                      departureExcessVelocity ) /
+                                                                  ( incomingSpeed * outgoingSpeed ) ) ) );
+            double maximumTurnAngle = 2.0 * std::asin(
+                        1.0 / ( 1.0 + minimumPericenterRadii_.at( i ) * incomingSpeed * incomingSpeed /
+                                bodyGravitationalParameters_.at( i ) ) );
+            inequalityConstraints( numberOfSegments * numberOfLegs_ + i ) =
+                    ( turnAngle - maximumTurnAngle ) / tudat::mathematical_constants::PI;
+        }
+        currentDepartureMass = arrivalMass;
+    }
+
+    // Compute launcher excess velocity constraint
+    inequalityConstraints( numberOfSegments * numberOfLegs_ ) =
+            ( decisionVector.segment( 0, 3 ).norm( ) - maximumDepartureExcessVelocity_ ) / velocityScale;
+
+    return currentDepartureMass;
+}
+
+//! Function to compute a ballistic initial guess for the decision vector
+Eigen::VectorXd SimsFlanaganTrajectory::getBallisticInitialGuess( ) const
+{
+    Eigen::VectorXd decisionVector = Eigen::VectorXd::Zero( getDecisionVectorSize( ) );
+
+    Eigen::Vector3d departureVelocity, arrivalVelocity;
+    for( int i = 0; i < numberOfLegs_; i++ )
+    {
+        tudat::mission_segments::solveLambertProblemIzzo(
+                    bodyStates_.at( i ).segment( 0, 3 ), bodyStates_.at( i + 1 ).segment( 0, 3 ),
+                    legs_.at( i ).getTimeOfFlight( ), centralBodyGravitationalParameter_,
+                    departureVelocity, arrivalVelocity );
+
+        const int startIndex = i * numberOfParametersPerLeg_;
+        decisionVector.segment( startIndex, 3 ) = departureVelocity - bodyStates_.at( i ).segment( 3, 3 );
+        decisionVector.segment( startIndex + 3, 3 ) = arrivalVelocity - bodyStates_.at( i + 1 ).segment( 3, 3 );
+        decisionVector( startIndex + 6 ) = initialMass_;
+    }
+
+    return decisionVector;
+}
+
+//! Function to compute the (impulsive) capture Delta V at the final body, for a given decision vector
+double SimsFlanaganTrajectory::getCaptureDeltaV(
+        const Eigen::VectorXd& decisionVector,
+        const double captureSemiMajorAxis,
+        const double captureEccentricity ) const
+{
+    const double arrivalSpeed = decisionVector.segment( ( numberOfLegs_ - 1 ) * numberOfParametersPerLeg_ + 3, 3 ).norm( );
+    const double gravitationalParameter = bodyGravitationalParameters_.at( numberOfLegs_ );
+    const double pericenterRadius = captureSemiMajorAxis * ( 1.0 - captureEccentricity );
+
+    return std::sqrt( arrivalSpeed * arrivalSpeed + 2.0 * gravitationalParameter / pericenterRadius ) -
+            std::sqrt( gravitationalParameter * ( 1.0 + captureEccentricity ) / pericenterRadius );
+}
+
+//! Function to retrieve the state at the segment boundaries of each leg, for a given decision vector
+std::map< int, std::map< double, Eigen::Vector6d > > SimsFlanaganTrajectory::getStateHistoryPerLeg(
+        const Eigen::VectorXd& decisionVector ) const
+{
+    std::map< int, std::map< double, Eigen::Vector6d > > stateHistoryPerLeg;
+
+    const int numberOfSegments = legs_.at( 0 ).getNumberOfSegments( );
+    double currentDepartureMass = initialMass_;
+    for( int i = 0; i < numberOfLegs_; i++ )
+    {
+        const int startIndex = i * numberOfParametersPerLeg_;
+        Eigen::Vector6d departureState = bodyStates_.at( i );
+        departureState.segment( 3, 3 ) += decisionVector.segment( startIndex, 3 );
+        Eigen::Vector6d arrivalState = bodyStates_.at( i + 1 );
+        arrivalState.segment( 3, 3 ) += decisionVector.segment( startIndex + 3, 3 );
+
+        std::map< double, Eigen::Vector6d > legStateHistory = legs_.at( i ).getSegmentStateHistory(
+                    departureState, currentDepartureMass, arrivalState, decisionVector( startIndex + 6 ),
+                    decisionVector.segment( startIndex + 7, 3 * numberOfSegments ) );
+
+        // Convert time since leg departure to epoch
+        for( std::map< double, Eigen::Vector6d >::const_iterator stateIterator = legStateHistory.begin( );
+             stateIterator != legStateHistory.end( ); stateIterator++ )
+        {
+            stateHistoryPerLeg[ i ][ bodyEpochs_.at( i ) + stateIterator->first ] = stateIterator->second;
+        }
+        currentDepartureMass = decisionVector( startIndex + 6 );
+    }
+
+    return stateHistoryPerLeg;
+}
+
+} // namespace tudat_applications
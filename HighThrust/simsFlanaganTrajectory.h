@@ -0,0 +1,264 @@
+/*    Copyright (c) 2010-2018, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_SIMSFLANAGANTRAJECTORY_H
+#define TUDAT_SIMSFLANAGANTRAJECTORY_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <Tudat/SimulationSetup/tudatSimulationHeader.h>
+#include <Tudat/Astrodynamics/TrajectoryDesign/trajectory.h>
+
+namespace tudat_applications
+{
+
+//! Class for a single low-thrust leg, modelled using the Sims-Flanagan transcription
+/*!
+ *  Class for a single low-thrust leg, modelled using the Sims-Flanagan transcription (Sims and Flanagan, 1999). The leg is
+ *  split into segments of equal duration. In the middle of each segment, an impulsive Delta V is applied, with a magnitude
+ *  bounded by the Delta V that the engine can deliver (at maximum thrust) over the duration of the segment. Between the
+ *  impulses, the spacecraft follows a Keplerian orbit. The first part of the segments is propagated forward from the departure
+ *  state, the remaining segments backward from the arrival state. The leg is feasible if the state and mass of both branches
+ *  match at the match point, and the norm of the throttle vector of each segment is at most one.
+ */
+class SimsFlanaganLeg
+{
+public:
+
+    //! Constructor
+    /*!
+     * Constructor
+     * \param timeOfFlight Duration of the leg
+     * \param centralBodyGravitationalParameter Gravitational parameter of the central body of the Keplerian coasts
+     * \param maximumThrust Maximum thrust magnitude of the engine
+     * \param specificImpulse Constant specific impulse of the engine
+     * \param numberOfSegments Number of segments (and impulses) into which the leg is split
+     * \param numberOfForwardSegments Number of segments propagated forward from departure (default: half of the segments)
+     */
+    SimsFlanaganLeg(
+            const double timeOfFlight,
+            const double centralBodyGravitationalParameter,
+            const double maximumThrust,
+            const double specificImpulse,
+            const int numberOfSegments,
+            const int numberOfForwardSegments = -1 );
+
+    //! Function to compute the mismatch in state and mass between forward and backward branch at the match point
+    /*!
+     * Function to compute the mismatch in state and mass between forward and backward branch at the match point
+     * \param departureState Cartesian state at departure (w.r.t. central body)
+     * \param departureMass Spacecraft mass at departure
+     * \param arrivalState Cartesian state at arrival (w.r.t. central body)
+     * \param arrivalMass Spacecraft mass at arrival
+     * \param throttles Throttle vectors of all segments, concatenated (size 3 x number of segments, each component in [-1,1])
+     * \return Mismatch at match point (backward minus forward branch): position, velocity and mass
+     */
+    Eigen::Matrix< double, 7, 1 > computeMatchPointMismatch(
+            const Eigen::Vector6d& departureState,
+            const double departureMass,
+            const Eigen::Vector6d& arrivalState,
+            const double arrivalMass,
+            const Eigen::VectorXd& throttles ) const;
+
+    //! Function to compute the throttle constraints (squared norm of throttle vector per segment minus one; feasible if <= 0)
+    Eigen::VectorXd computeThrottleConstraints( const Eigen::VectorXd& throttles ) const;
+
+    //! Function to retrieve the state at the segment boundaries and impulses of the forward and backward branch
+    /*!
+     * Function to retrieve the state at the segment boundaries and impulses of the forward and backward branch, for output
+     * purposes. Input is as for computeMatchPointMismatch. For the impulse epochs of the forward branch, the state after the
+     * impulse is stored; for those of the backward branch (which is propagated backwards in time, and removes the impulse),
+     * the state before the impulse (in forward time) is stored. At the match point, the state of the forward branch is
+     * stored. The time in the output map is the time since departure.
+     */
+    std::map< double, Eigen::Vector6d > getSegmentStateHistory(
+            const Eigen::Vector6d& departureState,
+            const double departureMass,
+            const Eigen::Vector6d& arrivalState,
+            const double arrivalMass,
+            const Eigen::VectorXd& throttles ) const;
+
+    //! Function to retrieve the number of segments
+    int getNumberOfSegments( ) const
+    {
+        return numberOfSegments_;
+    }
+
+    //! Function to retrieve the duration of the leg
+    double getTimeOfFlight( ) const
+    {
+        return timeOfFlight_;
+    }
+
+private:
+
+    //! Function to propagate the state and mass through a single segment
+    void propagateSegment(
+            Eigen::Vector6d& currentState,
+            double& currentMass,
+            const Eigen::Vector3d& currentThrottle,
+            const bool propagateBackwards,
+            std::map< double, Eigen::Vector6d >* stateHistory = NULL,
+            const double segmentStartTime = 0.0 ) const;
+
+    //! Duration of the leg
+    double timeOfFlight_;
+
+    //! Gravitational parameter of the central body
+    double centralBodyGravitationalParameter_;
+
+    //! Maximum thrust magnitude of the engine
+    double maximumThrust_;
+
+    //! Exhaust velocity of the engine (specific impulse times g0)
+    double exhaustVelocity_;
+
+    //! Number of segments into which the leg is split
+    int numberOfSegments_;
+
+    //! Number of segments propagated forward from departure
+    int numberOfForwardSegments_;
+
+    //! Duration of a single segment
+    double segmentDuration_;
+};
+
+//! Class to evaluate a multiple-flyby low-thrust trajectory, modelled using Sims-Flanagan legs
+/*!
+ *  Class to evaluate a multiple-flyby low-thrust trajectory, modelled using Sims-Flanagan legs. The class uses the same
+ *  body order, leg types and independent variables (departure time, and time of flight per leg) as the patched conic
+ *  Trajectory object, so that low-thrust candidates can be screened for exactly the same transfer cases. Each leg starts and
+ *  ends at the position of the respective planets, with a free hyperbolic excess velocity at departure and arrival.
+ *  The flybys are unpowered: the incoming and outgoing excess velocity must be of equal magnitude, and the turn angle must
+ *  be achievable with a pericenter radius above the minimum.
+ *
+ *  The decision vector consists of the following entries per leg (in order of the legs):
+ *
+ *  - Entry 0-2: Departure hyperbolic excess velocity
+ *  - Entry 3-5: Arrival hyperbolic excess velocity
+ *  - Entry 6: Spacecraft mass at arrival
+ *  - Entry 7-(6+3N): Throttle vectors (3 entries per segment, for N segments)
+ *
+ *  The equality constraints (normalized) contain the match point mismatch of each leg (7 per leg), and the difference in
+ *  excess velocity magnitude at each flyby. The inequality constraints (feasible if <= 0) contain the throttle norm
+ *  constraints of each leg, the departure excess velocity magnitude constraint, and the turn angle constraint at each flyby.
+ */
+class SimsFlanaganTrajectory
+{
+public:
+
+    //! Constructor
+    /*!
+     * Constructor
+     * \param bodyMap List of body objects, from which planet ephemerides and gravitational parameters are retrieved
+     * \param transferBodyOrder Names of bodies visited by the trajectory (departure, flybys, arrival)
+     * \param centralBody Name of central body of the transfer
+     * \param transferLegTypes Leg types, per body in transferBodyOrder (mga_Departure, mga_Swingby..., capture)
+     * \param trajectoryIndependentVariables Departure time, followed by time of flight of each leg (as for the Trajectory
+     * object; any further entries are ignored)
+     * \param minimumPericenterRadii Minimum pericenter radius, per body in transferBodyOrder
+     * \param initialMass Spacecraft mass at departure
+     * \param maximumThrust Maximum thrust magnitude of the engine
+     * \param specificImpulse Constant specific impulse of the engine
+     * \param numberOfSegmentsPerLeg Number of Sims-Flanagan segments into which each leg is split
+     * \param maximumDepartureExcessVelocity Maximum hyperbolic excess velocity provided by the launcher
+     */
+    SimsFlanaganTrajectory(
+            const tudat::simulation_setup::NamedBodyMap& bodyMap,
+            const std::vector< std::string >& transferBodyOrder,
+            const std::string& centralBody,
+            const std::vector< tudat::transfer_trajectories::TransferLegType >& transferLegTypes,
+            const std::vector< double >& trajectoryIndependentVariables,
+            const std::vector< double >& minimumPericenterRadii,
+            const double initialMass,
+            const double maximumThrust,
+            const double specificImpulse,
+            const int numberOfSegmentsPerLeg,
+            const double maximumDepartureExcessVelocity );
+
+    //! Function to evaluate the trajectory for a given decision vector
+    /*!
+     * Function to evaluate the trajectory for a given decision vector
+     * \param decisionVector Decision vector (see class description)
+     * \param equalityConstraints Normalized equality constraints (returned by reference)
+     * \param inequalityConstraints Normalized inequality constraints (returned by reference)
+     * \return Spacecraft mass at arrival at the final body
+     */
+    double evaluateTrajectory(
+            const Eigen::VectorXd& decisionVector,
+            Eigen::VectorXd& equalityConstraints,
+            Eigen::VectorXd& inequalityConstraints ) const;
+
+    //! Function to compute a ballistic initial guess for the decision vector
+    /*!
+     * Function to compute a ballistic initial guess for the decision vector, from the zero-revolution Lambert solution of each
+     * leg, with all throttles set to zero and no mass consumption.
+     */
+    Eigen::VectorXd getBallisticInitialGuess( ) const;
+
+    //! Function to compute the (impulsive) capture Delta V at the final body, for a given decision vector
+    double getCaptureDeltaV(
+            const Eigen::VectorXd& decisionVector,
+            const double captureSemiMajorAxis,
+            const double captureEccentricity ) const;
+
+    //! Function to retrieve the state at the segment boundaries of each leg, for a given decision vector
+    std::map< int, std::map< double, Eigen::Vector6d > > getStateHistoryPerLeg( const Eigen::VectorXd& decisionVector ) const;
+
+    //! Function to retrieve the size of the decision vector
+    int getDecisionVectorSize( ) const
+    {
+        return numberOfLegs_ * numberOfParametersPerLeg_;
+    }
+
+    //! Function to retrieve the number of legs
+    int getNumberOfLegs( ) const
+    {
+        return numberOfLegs_;
+    }
+
+private:
+
+    //! Number of legs of the trajectory
+    int numberOfLegs_;
+
+    //! Number of entries of the decision vector per leg
+    int numberOfParametersPerLeg_;
+
+    //! Sims-Flanagan leg objects
+    std::vector< SimsFlanaganLeg > legs_;
+
+    //! Epochs of departure, flybys and arrival
+    std::vector< double > bodyEpochs_;
+
+    //! Planet states (w.r.t. central body) at departure, flybys and arrival
+    std::vector< Eigen::Vector6d > bodyStates_;
+
+    //! Gravitational parameters of the visited bodies
+    std::vector< double > bodyGravitationalParameters_;
+
+    //! Minimum pericenter radii of the visited bodies
+    std::vector< double > minimumPericenterRadii_;
+
+    //! Gravitational parameter of the central body
+    double centralBodyGravitationalParameter_;
+
+    //! Spacecraft mass at departure
+    double initialMass_;
+
+    //! Maximum hyperbolic excess velocity provided by the launcher
+    double maximumDepartureExcessVelocity_;
+};
+
+} // namespace tudat_applications
+
+#endif // TUDAT_SIMSFLANAGANTRAJECTORY_H
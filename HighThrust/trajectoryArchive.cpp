@@ -0,0 +1,326 @@
+/*    Copyright (c) 2010-2018, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+#include <boost/interprocess/file_mapping.hpp>
+
+#include "../kdTree.h"
+#include "trajectoryArchive.h"
+
+namespace tudat_applications
+{
+
+//! Identifier at the start of archive files
+static const std::int64_t archiveFileIdentifier = 0x3130564843524154; // "TARCHV01"
+
+//! Constructor for an empty archive
+TrajectoryArchive::TrajectoryArchive( const Eigen::VectorXd& parameterLowerBounds,
+                                      const Eigen::VectorXd& parameterUpperBounds,
+                                      const int numberOfAuxiliaryValues ):
+    numberOfParameters_( static_cast< int >( parameterLowerBounds.rows( ) ) ),
+    numberOfAuxiliaryValues_( numberOfAuxiliaryValues ),
+    entrySize_( numberOfParameters_ + 1 + numberOfAuxiliaryValues ),
+    numberOfEntries_( 0 ),
+    numberOfIndexedEntries_( 0 ),
+    parameterLowerBounds_( parameterLowerBounds ),
+    parameterUpperBounds_( parameterUpperBounds ),
+    entries_( nullptr ), permutation_( nullptr ), splitDimensions_( nullptr ), subtreeMinimumDeltaVs_( nullptr )
+{
+    if( parameterUpperBounds.rows( ) != numberOfParameters_ || numberOfParameters_ < 1 )
+    {
+        throw std::runtime_error( "Error when creating trajectory archive, parameter bounds are inconsistent" );
+    }
+    if( numberOfAuxiliaryValues < 0 )
+    {
+        throw std::runtime_error( "Error when creating trajectory archive, number of auxiliary values is negative" );
+    }
+    setParameterWeights( );
+}
+
+//! Constructor, to open an archive from a file (by memory mapping)
+TrajectoryArchive::TrajectoryArchive( const std::string& fileName ):
+    numberOfIndexedEntries_( 0 ),
+    entries_( nullptr ), permutation_( nullptr ), splitDimensions_( nullptr ), subtreeMinimumDeltaVs_( nullptr )
+{
+    using namespace boost::interprocess;
+
+    // Map complete file into memory
+    try
+    {
+        file_mapping archiveFile( fileName.c_str( ), read_only );
+        mappedRegion_ = std::make_shared< mapped_region >( archiveFile, read_only );
+    }
+    catch( interprocess_exception& caughtException )
+    {
+        throw std::runtime_error( "Error when opening trajectory archive " + fileName + ": " + caughtException.what( ) );
+    }
+
+    // Read header
+    const std::size_t fileSize = mappedRegion_->get_size( );
+    const char* fileData = static_cast< const char* >( mappedRegion_->get_address( ) );
+    if( fileSize < 4 * sizeof( std::int64_t ) )
+    {
+        throw std::runtime_error( "Error when opening trajectory archive " + fileName + ", file is too small" );
+    }
+
+    const std::int64_t* header = reinterpret_cast< const std::int64_t* >( fileData );
+    if( header[ 0 ] != archiveFileIdentifier )
+    {
+        throw std::runtime_error( "Error when opening trajectory archive " + fileName + ", file is not an archive" );
+    }
+    numberOfParameters_ = static_cast< int >( header[ 1 ] );
+    numberOfAuxiliaryValues_ = static_cast< int >( header[ 2 ] );
+    numberOfEntries_ = static_cast< int >( header[ 3 ] );
+    entrySize_ = numberOfParameters_ + 1 + numberOfAuxiliaryValues_;
+
+    const std::size_t expectedFileSize = 4 * sizeof( std::int64_t ) +
+            ( 2 * numberOfParameters_ + static_cast< std::size_t >( numberOfEntries_ ) * ( entrySize_ + 1 ) ) *
+            sizeof( double ) + 2 * static_cast< std::size_t >( numberOfEntries_ ) * sizeof( std::int32_t );
+    if( fileSize != expectedFileSize )
+    {
+        throw std::runtime_error( "Error when opening trajectory archive " + fileName + ", file size is inconsistent" );
+    }
+
+    // Set pointers to data in mapped file
+    const double* bounds = reinterpret_cast< const double* >( fileData + 4 * sizeof( std::int64_t ) );
+    parameterLowerBounds_ = Eigen::Map< const Eigen::VectorXd >( bounds, numberOfParameters_ );
+    parameterUpperBounds_ = Eigen::Map< const Eigen::VectorXd >( bounds + numberOfParameters_, numberOfParameters_ );
+    setParameterWeights( );
+
+    entries_ = bounds + 2 * numberOfParameters_;
+    subtreeMinimumDeltaVs_ = entries_ + static_cast< long >( numberOfEntries_ ) * entrySize_;
+    permutation_ = reinterpret_cast< const int* >( subtreeMinimumDeltaVs_ + numberOfEntries_ );
+    splitDimensions_ = permutation_ + numberOfEntries_;
+    numberOfIndexedEntries_ = numberOfEntries_;
+}
+
+//! Function to add an evaluated trajectory to the archive
+void TrajectoryArchive::addEntry( const Eigen::VectorXd& parameters, const double deltaV,
+                                  const Eigen::VectorXd& auxiliaryValues )
+{
+    if( parameters.rows( ) != numberOfParameters_ || auxiliaryValues.rows( ) != numberOfAuxiliaryValues_ )
+    {
+        throw std::runtime_error( "Error when adding entry to trajectory archive, input size is inconsistent" );
+    }
+
+    if( mappedRegion_ != nullptr )
+    {
+        copyMappedDataToMemory( );
+    }
+
+    entryBuffer_.insert( entryBuffer_.end( ), parameters.data( ), parameters.data( ) + numberOfParameters_ );
+    entryBuffer_.push_back( deltaV );
+    entryBuffer_.insert( entryBuffer_.end( ), auxiliaryValues.data( ), auxiliaryValues.data( ) + numberOfAuxiliaryValues_ );
+    entries_ = entryBuffer_.data( );
+    numberOfEntries_++;
+}
+
+//! Function to add a set of evaluated trajectories to the archive (one row per trajectory)
+void TrajectoryArchive::addEntries( const Eigen::MatrixXd& parameters, const Eigen::VectorXd& deltaVs,
+                                    const Eigen::MatrixXd& auxiliaryValues )
+{
+    if( deltaVs.rows( ) != parameters.rows( ) || auxiliaryValues.rows( ) != parameters.rows( ) )
+    {
+        throw std::runtime_error( "Error when adding entries to trajectory archive, input size is inconsistent" );
+    }
+
+    entryBuffer_.reserve( entryBuffer_.size( ) + parameters.rows( ) * entrySize_ );
+    for( int i = 0; i < parameters.rows( ); i++ )
+    {
+        addEntry( parameters.row( i ).transpose( ), deltaVs( i ), auxiliaryValues.row( i ).transpose( ) );
+    }
+}
+
+//! Function to (re)build the spatial index, so that it includes all entries
+void TrajectoryArchive::updateIndex( )
+{
+    if( numberOfIndexedEntries_ == numberOfEntries_ )
+    {
+        return;
+    }
+
+    KdTree tree( entries_, numberOfEntries_, numberOfParameters_, entrySize_, parameterWeights_,
+                 entries_ + numberOfParameters_, entrySize_ );
+
+    permutationBuffer_.assign( tree.getPermutation( ), tree.getPermutation( ) + numberOfEntries_ );
+    splitDimensionBuffer_.assign( tree.getSplitDimensions( ), tree.getSplitDimensions( ) + numberOfEntries_ );
+    subtreeMinimumBuffer_.assign( tree.getSubtreeMinimumValues( ), tree.getSubtreeMinimumValues( ) + numberOfEntries_ );
+
+    permutation_ = permutationBuffer_.data( );
+    splitDimensions_ = splitDimensionBuffer_.data( );
+    subtreeMinimumDeltaVs_ = subtreeMinimumBuffer_.data( );
+    numberOfIndexedEntries_ = numberOfEntries_;
+}
+
+//! Function to retrieve the indices of the entries nearest to a parameter vector (sorted by increasing distance)
+std::vector< int > TrajectoryArchive::getNearestEntries( const Eigen::VectorXd& parameters,
+                                                         const int numberOfEntries ) const
+{
+    if( parameters.rows( ) != numberOfParameters_ )
+    {
+        throw std::runtime_error( "Error in trajectory archive query, parameter vector size is inconsistent" );
+    }
+
+    // Retrieve nearest indexed entries, and all entries that are not yet indexed
+    std::vector< int > candidateEntries;
+    if( numberOfIndexedEntries_ > 0 )
+    {
+        KdTree tree( entries_, numberOfIndexedEntries_, numberOfParameters_, entrySize_, parameterWeights_,
+                     permutation_, splitDimensions_ );
+        candidateEntries = tree.findNearestNeighbours( parameters, numberOfEntries );
+    }
+    for( int i = numberOfIndexedEntries_; i < numberOfEntries_; i++ )
+    {
+        candidateEntries.push_back( i );
+    }
+
+    // Sort candidates by normalized distance
+    std::vector< std::pair< double, int > > candidateDistances;
+    for( unsigned int i = 0; i < candidateEntries.size( ); i++ )
+    {
+        Eigen::Map< const Eigen::VectorXd > entryParameters( getEntryData( candidateEntries.at( i ) ), numberOfParameters_ );
+        candidateDistances.push_back(
+                    std::make_pair( ( parameterWeights_.array( ) * ( entryParameters - parameters ).array( ).square( ) ).sum( ),
+                                    candidateEntries.at( i ) ) );
+    }
+    std::sort( candidateDistances.begin( ), candidateDistances.end( ) );
+
+    std::vector< int > nearestEntries;
+    for( unsigned int i = 0; i < candidateDistances.size( ) && static_cast< int >( i ) < numberOfEntries; i++ )
+    {
+        nearestEntries.push_back( candidateDistances.at( i ).second );
+    }
+    return nearestEntries;
+}
+
+//! Function to retrieve the index of the entry with the lowest Delta V in a box in parameter space
+int TrajectoryArchive::getBestEntryInRegion( const Eigen::VectorXd& lowerBounds, const Eigen::VectorXd& upperBounds ) const
+{
+    if( lowerBounds.rows( ) != numberOfParameters_ || upperBounds.rows( ) != numberOfParameters_ )
+    {
+        throw std::runtime_error( "Error in trajectory archive query, region bounds size is inconsistent" );
+    }
+
+    int bestEntry = -1;
+    if( numberOfIndexedEntries_ > 0 )
+    {
+        KdTree tree( entries_, numberOfIndexedEntries_, numberOfParameters_, entrySize_, parameterWeights_,
+                     permutation_, splitDimensions_, entries_ + numberOfParameters_, entrySize_, subtreeMinimumDeltaVs_ );
+        bestEntry = tree.findMinimumValueInBox( lowerBounds, upperBounds );
+    }
+
+    // Check entries that are not yet indexed
+    for( int i = numberOfIndexedEntries_; i < numberOfEntries_; i++ )
+    {
+        Eigen::Map< const Eigen::VectorXd > entryParameters( getEntryData( i ), numberOfParameters_ );
+        if( ( entryParameters.array( ) >= lowerBounds.array( ) ).all( ) &&
+                ( entryParameters.array( ) <= upperBounds.array( ) ).all( ) &&
+                ( bestEntry < 0 || getDeltaV( i ) < getDeltaV( bestEntry ) ) && getDeltaV( i ) == getDeltaV( i ) )
+        {
+            bestEntry = i;
+        }
+    }
+    return bestEntry;
+}
+
+//! Function to write the archive (including the spatial index) to a binary file
+void TrajectoryArchive::writeToFile( const std::string& fileName )
+{
+    updateIndex( );
+
+    std::ofstream archiveFile( fileName.c_str( ), std::ios::binary | std::ios::trunc );
+    if( !archiveFile.good( ) )
+    {
+        throw std::runtime_error( "Error when writing trajectory archive, could not open " + fileName );
+    }
+
+    std::int64_t header[ 4 ] = { archiveFileIdentifier, numberOfParameters_, numberOfAuxiliaryValues_, numberOfEntries_ };
+    std::vector< std::int32_t > permutation( permutation_, permutation_ + numberOfEntries_ );
+    std::vector< std::int32_t > splitDimensions( splitDimensions_, splitDimensions_ + numberOfEntries_ );
+
+    archiveFile.write( reinterpret_cast< const char* >( header ), sizeof( header ) );
+    archiveFile.write( reinterpret_cast< const char* >( parameterLowerBounds_.data( ) ),
+                       numberOfParameters_ * sizeof( double ) );
+    archiveFile.write( reinterpret_cast< const char* >( parameterUpperBounds_.data( ) ),
+                       numberOfParameters_ * sizeof( double ) );
+    archiveFile.write( reinterpret_cast< const char* >( entries_ ),
+                       static_cast< std::size_t >( numberOfEntries_ ) * entrySize_ * sizeof( double ) );
+    archiveFile.write( reinterpret_cast< const char* >( subtreeMinimumDeltaVs_ ), numberOfEntries_ * sizeof( double ) );
+    archiveFile.write( reinterpret_cast< const char* >( permutation.data( ) ), numberOfEntries_ * sizeof( std::int32_t ) );
+    archiveFile.write( reinterpret_cast< const char* >( splitDimensions.data( ) ),
+                       numberOfEntries_ * sizeof( std::int32_t ) );
+
+    if( !archiveFile.good( ) )
+    {
+        throw std::runtime_error( "Error when writing trajectory archive " + fileName );
+    }
+}
+
+//! Function to retrieve the parameter vector of an entry
+Eigen::VectorXd TrajectoryArchive::getParameters( const int index ) const
+{
+    checkIndex( index );
+    return Eigen::Map< const Eigen::VectorXd >( getEntryData( index ), numberOfParameters_ );
+}
+
+//! Function to retrieve the total Delta V of an entry
+double TrajectoryArchive::getDeltaV( const int index ) const
+{
+    checkIndex( index );
+    return getEntryData( index )[ numberOfParameters_ ];
+}
+
+//! Function to retrieve the auxiliary values of an entry
+Eigen::VectorXd TrajectoryArchive::getAuxiliaryValues( const int index ) const
+{
+    checkIndex( index );
+    return Eigen::Map< const Eigen::VectorXd >( getEntryData( index ) + numberOfParameters_ + 1, numberOfAuxiliaryValues_ );
+}
+
+//! Function to copy the data of an archive opened from file to memory (before entries can be added)
+void TrajectoryArchive::copyMappedDataToMemory( )
+{
+    entryBuffer_.assign( entries_, entries_ + static_cast< long >( numberOfEntries_ ) * entrySize_ );
+    permutationBuffer_.assign( permutation_, permutation_ + numberOfIndexedEntries_ );
+    splitDimensionBuffer_.assign( splitDimensions_, splitDimensions_ + numberOfIndexedEntries_ );
+    subtreeMinimumBuffer_.assign( subtreeMinimumDeltaVs_, subtreeMinimumDeltaVs_ + numberOfIndexedEntries_ );
+
+    entries_ = entryBuffer_.data( );
+    permutation_ = permutationBuffer_.data( );
+    splitDimensions_ = splitDimensionBuffer_.data( );
+    subtreeMinimumDeltaVs_ = subtreeMinimumBuffer_.data( );
+    mappedRegion_.reset( );
+}
+
+//! Function to set the weights of the parameters in the distance computation from the parameter bounds
+void TrajectoryArchive::setParameterWeights( )
+{
+    if( !( parameterUpperBounds_.array( ) > parameterLowerBounds_.array( ) ).all( ) )
+    {
+        throw std::runtime_error( "Error in trajectory archive, upper bounds must exceed lower bounds" );
+    }
+    parameterWeights_ = ( parameterUpperBounds_ - parameterLowerBounds_ ).array( ).square( ).inverse( ).matrix( );
+}
+
+//! Function to check the index of an entry
+void TrajectoryArchive::checkIndex( const int index ) const
+{
+    if( index < 0 || index >= numberOfEntries_ )
+    {
+        throw std::runtime_error( "Error in trajectory archive, entry index out of range" );
+    }
+}
+
+} // namespace tudat_applications
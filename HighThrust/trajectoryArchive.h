@@ -0,0 +1,189 @@
+/*    Copyright (c) 2010-2018, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_TRAJECTORYARCHIVE_H
+#define TUDAT_TRAJECTORYARCHIVE_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <Tudat/Basics/basicTypedefs.h>
+
+namespace tudat_applications
+{
+
+//! Class to store evaluated trajectories, with a spatial index for nearest-neighbour and best-in-region queries
+/*!
+ *  Class to store evaluated trajectories (parameter vector, total Delta V and a number of auxiliary values, such as the
+ *  excess velocities of each leg), with a k-d tree index over the normalized parameter space. The parameters are normalized
+ *  using user-defined bounds, so that all parameters have equal weight in the distance computation. The archive can be used
+ *  to initialize local optimizations from the best known solutions close to a given point.
+ *
+ *  The archive can be written to a binary file, from which it can later be opened by memory mapping: the entries and the
+ *  tree index are used directly from the mapped file, without reading or rebuilding. Entries can be added to an archive opened
+ *  from file, in which case the data is first copied to memory. Entries that are added after the last index update are
+ *  included in all queries (by linear search) until updateIndex is called.
+ */
+class TrajectoryArchive
+{
+public:
+
+    //! Constructor for an empty archive
+    /*!
+     * Constructor for an empty archive
+     * \param parameterLowerBounds Lower bounds of the parameters, used for normalization
+     * \param parameterUpperBounds Upper bounds of the parameters, used for normalization
+     * \param numberOfAuxiliaryValues Number of auxiliary values stored for each entry
+     */
+    TrajectoryArchive( const Eigen::VectorXd& parameterLowerBounds,
+                       const Eigen::VectorXd& parameterUpperBounds,
+                       const int numberOfAuxiliaryValues );
+
+    //! Constructor, to open an archive from a file (by memory mapping)
+    /*!
+     * Constructor, to open an archive from a file (by memory mapping)
+     * \param fileName Name of the archive file, as written by writeToFile
+     */
+    TrajectoryArchive( const std::string& fileName );
+
+    //! Function to add an evaluated trajectory to the archive
+    /*!
+     * Function to add an evaluated trajectory to the archive
+     * \param parameters Parameter vector of the trajectory
+     * \param deltaV Total Delta V of the trajectory (NaN for invalid trajectories, which are never returned as best entry)
+     * \param auxiliaryValues Auxiliary values of the trajectory (e.g. excess velocities of each leg)
+     */
+    void addEntry( const Eigen::VectorXd& parameters, const double deltaV, const Eigen::VectorXd& auxiliaryValues );
+
+    //! Function to add a set of evaluated trajectories to the archive (one row per trajectory)
+    void addEntries( const Eigen::MatrixXd& parameters, const Eigen::VectorXd& deltaVs,
+                     const Eigen::MatrixXd& auxiliaryValues );
+
+    //! Function to (re)build the spatial index, so that it includes all entries
+    void updateIndex( );
+
+    //! Function to retrieve the indices of the entries nearest to a parameter vector (sorted by increasing distance)
+    /*!
+     * Function to retrieve the indices of the entries nearest to a parameter vector (sorted by increasing distance), where
+     * the distance is computed in the normalized parameter space.
+     * \param parameters Parameter vector for which the nearest entries are to be found
+     * \param numberOfEntries Number of entries that is to be returned (at most)
+     * \return Indices of nearest entries
+     */
+    std::vector< int > getNearestEntries( const Eigen::VectorXd& parameters, const int numberOfEntries ) const;
+
+    //! Function to retrieve the index of the entry with the lowest Delta V in a box in parameter space
+    /*!
+     * Function to retrieve the index of the entry with the lowest Delta V in a box in parameter space
+     * \param lowerBounds Lower bounds of the box
+     * \param upperBounds Upper bounds of the box
+     * \return Index of the entry with the lowest Delta V (-1 if the box contains no valid entries)
+     */
+    int getBestEntryInRegion( const Eigen::VectorXd& lowerBounds, const Eigen::VectorXd& upperBounds ) const;
+
+    //! Function to write the archive (including the spatial index) to a binary file
+    void writeToFile( const std::string& fileName );
+
+    //! Function to retrieve the parameter vector of an entry
+    Eigen::VectorXd getParameters( const int index ) const;
+
+    //! Function to retrieve the total Delta V of an entry
+    double getDeltaV( const int index ) const;
+
+    //! Function to retrieve the auxiliary values of an entry
+    Eigen::VectorXd getAuxiliaryValues( const int index ) const;
+
+    //! Function to retrieve the number of entries in the archive
+    int getNumberOfEntries( ) const
+    {
+        return numberOfEntries_;
+    }
+
+    //! Function to retrieve the number of parameters per entry
+    int getNumberOfParameters( ) const
+    {
+        return numberOfParameters_;
+    }
+
+private:
+
+    //! Function to retrieve pointer to the data of an entry (parameters, Delta V, auxiliary values)
+    const double* getEntryData( const int index ) const
+    {
+        return entries_ + static_cast< long >( index ) * entrySize_;
+    }
+
+    //! Function to copy the data of an archive opened from file to memory (before entries can be added)
+    void copyMappedDataToMemory( );
+
+    //! Function to set the weights of the parameters in the distance computation from the parameter bounds
+    void setParameterWeights( );
+
+    //! Function to check the index of an entry
+    void checkIndex( const int index ) const;
+
+    //! Number of parameters per entry
+    int numberOfParameters_;
+
+    //! Number of auxiliary values per entry
+    int numberOfAuxiliaryValues_;
+
+    //! Number of values per entry (parameters, Delta V and auxiliary values)
+    int entrySize_;
+
+    //! Number of entries
+    int numberOfEntries_;
+
+    //! Number of entries included in the spatial index
+    int numberOfIndexedEntries_;
+
+    //! Lower bounds of the parameters
+    Eigen::VectorXd parameterLowerBounds_;
+
+    //! Upper bounds of the parameters
+    Eigen::VectorXd parameterUpperBounds_;
+
+    //! Weights of the parameters in the distance computation
+    Eigen::VectorXd parameterWeights_;
+
+    //! Pointer to the data of the first entry (in entryBuffer_ or in mapped file)
+    const double* entries_;
+
+    //! Pointer to the permutation of the k-d tree index (in permutationBuffer_ or in mapped file)
+    const int* permutation_;
+
+    //! Pointer to the splitting dimensions of the k-d tree index (in splitDimensionBuffer_ or in mapped file)
+    const int* splitDimensions_;
+
+    //! Pointer to the minimum Delta V in each subtree of the k-d tree index (in subtreeMinimumBuffer_ or in mapped file)
+    const double* subtreeMinimumDeltaVs_;
+
+    //! Data of the entries, if stored in memory
+    std::vector< double > entryBuffer_;
+
+    //! Permutation of the k-d tree index, if stored in memory
+    std::vector< int > permutationBuffer_;
+
+    //! Splitting dimensions of the k-d tree index, if stored in memory
+    std::vector< int > splitDimensionBuffer_;
+
+    //! Minimum Delta V in each subtree of the k-d tree index, if stored in memory
+    std::vector< double > subtreeMinimumBuffer_;
+
+    //! Mapped region of archive file (nullptr if archive is stored in memory)
+    std::shared_ptr< boost::interprocess::mapped_region > mappedRegion_;
+};
+
+} // namespace tudat_applications
+
+#endif // TUDAT_TRAJECTORYARCHIVE_H
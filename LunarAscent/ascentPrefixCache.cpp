@@ -0,0 +1,229 @@
+/*    Copyright (c) 2010-2018, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#include <stdexcept>
+
+#include "../guidanceAdapters.h"
+#include "ascentPrefixCache.h"
+
+namespace tudat_applications
+{
+
+//! Function to add a checkpoint (not modified if a checkpoint with the same key exists)
+void AscentPrefixCache::addCheckpoint( const std::vector< double >& key, const double time, const Eigen::VectorXd& state )
+{
+    if( maximumNumberOfCheckpoints_ == 0 )
+    {
+        return;
+    }
+
+    std::pair< std::map< std::vector< double >, std::pair< double, Eigen::VectorXd > >::iterator, bool > insertionResult =
+            checkpoints_.insert( std::make_pair( key, std::make_pair( time, state ) ) );
+    if( insertionResult.second )
+    {
+        insertionOrder_.push_back( insertionResult.first );
+
+        // Remove oldest checkpoint if maximum size is exceeded
+        if( checkpoints_.size( ) > maximumNumberOfCheckpoints_ )
+        {
+            checkpoints_.erase( insertionOrder_.front( ) );
+            insertionOrder_.pop_front( );
+        }
+    }
+}
+
+//! Function to retrieve a checkpoint
+bool AscentPrefixCache::findCheckpoint( const std::vector< double >& key, double& time, Eigen::VectorXd& state ) const
+{
+    std::map< std::vector< double >, std::pair< double, Eigen::VectorXd > >::const_iterator checkpointIterator =
+            checkpoints_.find( key );
+    if( checkpointIterator == checkpoints_.end( ) )
+    {
+        return false;
+    }
+
+    time = checkpointIterator->second.first;
+    state = checkpointIterator->second.second;
+    return true;
+}
+
+//! Constructor
+PrefixCachedAscentPropagator::PrefixCachedAscentPropagator(
+        const tudat::simulation_setup::NamedBodyMap& bodyMap,
+        const std::string& vehicleName,
+        const std::string& centralBodyName,
+        const double specificImpulse,
+        const double maximumDuration,
+        const std::vector< std::shared_ptr< tudat::propagators::PropagationTerminationSettings > >& terminationSettings,
+        const tudat::propagators::TranslationalPropagatorType propagatorType,
+        const double stepSize,
+        const unsigned int maximumNumberOfCheckpoints ):
+    bodyMap_( bodyMap ), bodiesToPropagate_( { vehicleName } ), centralBodies_( { centralBodyName } ),
+    maximumDuration_( maximumDuration ), terminationSettings_( terminationSettings ), propagatorType_( propagatorType ),
+    stepSize_( stepSize ),
+    cache_( maximumNumberOfCheckpoints ), finalTime_( TUDAT_NAN ), isTerminationSuccessful_( false ),
+    numberOfPropagatedSegments_( 0 ), numberOfResumedSegments_( 0 )
+{
+    using namespace tudat::simulation_setup;
+
+    // Create thrust guidance (parameters are reset for each candidate)
+    thrustGuidance_ = std::make_shared< LunarAscentThrustGuidance >(
+                bodyMap_.at( vehicleName ), 0.0, std::vector< double >{ 0.0, 1.0, 0.0, 0.0 } );
+
+    // Create acceleration models and mass rate model
+    SelectedAccelerationMap accelerationMap;
+    accelerationMap[ vehicleName ][ centralBodyName ].push_back(
+                std::make_shared< AccelerationSettings >( tudat::basic_astrodynamics::central_gravity ) );
+    accelerationMap[ vehicleName ][ vehicleName ].push_back(
+                std::make_shared< ThrustAccelerationSettings >(
+                    std::make_shared< CustomThrustDirectionSettings >( createThrustDirectionFunction( thrustGuidance_ ) ),
+                    std::make_shared< FromFunctionThrustMagnitudeSettings >(
+                        createThrustMagnitudeFunction( thrustGuidance_ ),
+                        [ = ]( const double ){ return specificImpulse; } ) ) );
+    accelerationModelMap_ = createAccelerationModelsMap( bodyMap_, accelerationMap, bodiesToPropagate_, centralBodies_ );
+    massRateModels_[ vehicleName ] = createMassRateModel(
+                vehicleName, std::make_shared< FromThrustMassModelSettings >( 1 ), bodyMap_, accelerationModelMap_ );
+}
+
+//! Function to propagate the ascent of a single candidate
+Eigen::VectorXd PrefixCachedAscentPropagator::propagate(
+        const Eigen::Vector6d& initialState, const double initialMass, const double initialTime,
+        const std::vector< double >& thrustParameters )
+{
+    if( thrustParameters.size( ) < 4 || !( thrustParameters.at( 1 ) > 0.0 ) )
+    {
+        throw std::runtime_error( "Error when propagating prefix-cached ascent, at least two nodes with positive spacing "
+                                  "required" );
+    }
+    const int numberOfNodes = thrustParameters.size( ) - 2;
+
+    thrustGuidance_->resetParameters( initialTime, thrustParameters );
+    maximumDurationTerminationSettings_ = std::make_shared< tudat::propagators::PropagationTimeTerminationSettings >(
+                initialTime + maximumDuration_ );
+    isTerminationSuccessful_ = false;
+    wasConditionMetWhenStopping_.clear( );
+
+    // Compute node times (in the same manner as in the thrust guidance, so that segments end exactly on the nodes)
+    std::vector< double > nodeTimes;
+    double nodeTime = initialTime;
+    for( int i = 0; i < numberOfNodes; i++ )
+    {
+        nodeTimes.push_back( nodeTime );
+        nodeTime += thrustParameters.at( 1 );
+    }
+
+    // Key of checkpoint at node 0: initial conditions, thrust magnitude, node spacing and first thrust angle
+    std::vector< double > checkpointKey = { initialTime };
+    checkpointKey.insert( checkpointKey.end( ), initialState.data( ), initialState.data( ) + 6 );
+    checkpointKey.push_back( initialMass );
+    checkpointKey.insert( checkpointKey.end( ), thrustParameters.begin( ), thrustParameters.begin( ) + 3 );
+
+    // Find deepest checkpoint (state at node i depends on thrust angles at nodes 0 to i)
+    double currentTime = initialTime;
+    Eigen::VectorXd currentState = ( Eigen::VectorXd( 7 ) << initialState, initialMass ).finished( );
+    int currentNode = 0;
+    for( int i = numberOfNodes - 1; i > 0; i-- )
+    {
+        std::vector< double > nodeCheckpointKey = checkpointKey;
+        nodeCheckpointKey.insert( nodeCheckpointKey.end( ), thrustParameters.begin( ) + 3,
+                                  thrustParameters.begin( ) + i + 3 );
+        if( cache_.findCheckpoint( nodeCheckpointKey, currentTime, currentState ) )
+        {
+            checkpointKey = nodeCheckpointKey;
+            currentNode = i;
+            break;
+        }
+    }
+    numberOfResumedSegments_ += currentNode;
+
+    // Propagate segments between remaining nodes, storing the state at each node
+    bool isNodeReached = true;
+    while( isNodeReached && currentNode < numberOfNodes - 1 )
+    {
+        isNodeReached = propagateSegment( currentTime, currentState, true, nodeTimes.at( currentNode + 1 ) );
+        if( isNodeReached )
+        {
+            currentNode++;
+            checkpointKey.push_back( thrustParameters.at( currentNode + 2 ) );
+            cache_.addCheckpoint( checkpointKey, currentTime, currentState );
+        }
+    }
+
+    // Propagate beyond last node, until termination
+    if( isNodeReached )
+    {
+        propagateSegment( currentTime, currentState, false, TUDAT_NAN );
+    }
+
+    finalTime_ = currentTime;
+    return currentState;
+}
+
+//! Function to propagate a single segment (up to the next node, if any), returns true if the segment ended on the node
+bool PrefixCachedAscentPropagator::propagateSegment(
+        double& currentTime, Eigen::VectorXd& currentState, const bool endsAtNode, const double segmentFinalTime )
+{
+    using namespace tudat::propagators;
+
+    // Terminate at node time (exactly), or on maximum duration or any of the termination conditions
+    std::vector< std::shared_ptr< PropagationTerminationSettings > > terminationSettingsList;
+    if( endsAtNode )
+    {
+        terminationSettingsList.push_back( std::make_shared< PropagationTimeTerminationSettings >( segmentFinalTime, true ) );
+    }
+    terminationSettingsList.push_back( maximumDurationTerminationSettings_ );
+    terminationSettingsList.insert( terminationSettingsList.end( ), terminationSettings_.begin( ),
+                                    terminationSettings_.end( ) );
+    std::shared_ptr< PropagationTerminationSettings > segmentTerminationSettings =
+            std::make_shared< PropagationHybridTerminationSettings >( terminationSettingsList, true );
+
+    std::vector< std::shared_ptr< SingleArcPropagatorSettings< double > > > propagatorSettingsVector =
+    { std::make_shared< TranslationalStatePropagatorSettings< double > >(
+      centralBodies_, accelerationModelMap_, bodiesToPropagate_, Eigen::VectorXd( currentState.segment( 0, 6 ) ),
+      segmentTerminationSettings, propagatorType_ ),
+      std::make_shared< MassPropagatorSettings< double > >(
+      bodiesToPropagate_, massRateModels_, Eigen::VectorXd( currentState.segment( 6, 1 ) ), segmentTerminationSettings ) };
+    SingleArcDynamicsSimulator< > dynamicsSimulator(
+                bodyMap_, std::make_shared< tudat::numerical_integrators::IntegratorSettings< > >(
+                    tudat::numerical_integrators::rungeKutta4, currentTime, stepSize_ ),
+                std::make_shared< MultiTypePropagatorSettings< double > >(
+                    propagatorSettingsVector, segmentTerminationSettings ) );
+    numberOfPropagatedSegments_++;
+
+    const std::map< double, Eigen::VectorXd >& segmentStateHistory = dynamicsSimulator.getEquationsOfMotionNumericalSolution( );
+    currentTime = segmentStateHistory.rbegin( )->first;
+    currentState = segmentStateHistory.rbegin( )->second;
+
+    std::shared_ptr< PropagationTerminationDetails > terminationDetails = dynamicsSimulator.getPropagationTerminationReason( );
+    if( terminationDetails->getPropagationTerminationReason( ) != termination_condition_reached )
+    {
+        return false;
+    }
+
+    // Continue with next segment only if no termination condition was met
+    std::vector< bool > wasConditionMet = std::dynamic_pointer_cast< PropagationTerminationDetailsFromHybridCondition >(
+                terminationDetails )->getWasConditionMetWhenStopping( );
+    if( endsAtNode )
+    {
+        wasConditionMet.erase( wasConditionMet.begin( ) );
+    }
+    for( unsigned int i = 0; i < wasConditionMet.size( ); i++ )
+    {
+        if( wasConditionMet.at( i ) )
+        {
+            isTerminationSuccessful_ = true;
+            wasConditionMetWhenStopping_ = wasConditionMet;
+            return false;
+        }
+    }
+    return endsAtNode;
+}
+
+} // namespace tudat_applications
@@ -0,0 +1,242 @@
+/*    Copyright (c) 2010-2018, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_ASCENTPREFIXCACHE_H
+#define TUDAT_ASCENTPREFIXCACHE_H
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <Tudat/SimulationSetup/tudatSimulationHeader.h>
+
+#include "lunarAscent.h"
+
+namespace tudat_applications
+{
+
+//! Class to store checkpointed states of ascent trajectories, keyed by the quantities that fully determine them
+/*!
+ *  Class to store checkpointed states (time, and Cartesian state and mass) of ascent trajectories, keyed by a vector with the
+ *  quantities that fully determine the trajectory up to the checkpoint (initial conditions, and the parameters governing the
+ *  segments before the checkpoint). Keys are compared exactly (lexicographically), so they should not contain NaN values.
+ *  When the maximum number of checkpoints is reached, the oldest checkpoint is removed.
+ */
+class AscentPrefixCache
+{
+public:
+
+    //! Constructor
+    /*!
+     *  Constructor
+     *  \param maximumNumberOfCheckpoints Maximum number of stored checkpoints (no checkpoints are stored if zero)
+     */
+    AscentPrefixCache( const unsigned int maximumNumberOfCheckpoints = 100000 ):
+        maximumNumberOfCheckpoints_( maximumNumberOfCheckpoints ){ }
+
+    //! Function to add a checkpoint (not modified if a checkpoint with the same key exists)
+    /*!
+     *  Function to add a checkpoint (not modified if a checkpoint with the same key exists)
+     *  \param key Quantities that fully determine the trajectory up to the checkpoint
+     *  \param time Time of the checkpoint
+     *  \param state Cartesian state and mass at the checkpoint
+     */
+    void addCheckpoint( const std::vector< double >& key, const double time, const Eigen::VectorXd& state );
+
+    //! Function to retrieve a checkpoint
+    /*!
+     *  Function to retrieve a checkpoint
+     *  \param key Quantities that fully determine the trajectory up to the checkpoint
+     *  \param time Time of the checkpoint (returned by reference, if found)
+     *  \param state Cartesian state and mass at the checkpoint (returned by reference, if found)
+     *  \return True if a checkpoint with the given key is stored
+     */
+    bool findCheckpoint( const std::vector< double >& key, double& time, Eigen::VectorXd& state ) const;
+
+    //! Function to remove all checkpoints
+    void clear( )
+    {
+        checkpoints_.clear( );
+        insertionOrder_.clear( );
+    }
+
+    //! Function to retrieve the number of stored checkpoints
+    unsigned int getNumberOfCheckpoints( ) const
+    {
+        return checkpoints_.size( );
+    }
+
+private:
+
+    //! Maximum number of stored checkpoints
+    unsigned int maximumNumberOfCheckpoints_;
+
+    //! Stored checkpoints: time, and Cartesian state and mass (value) for each key (key)
+    std::map< std::vector< double >, std::pair< double, Eigen::VectorXd > > checkpoints_;
+
+    //! Iterators to the stored checkpoints, in order of insertion
+    std::deque< std::map< std::vector< double >, std::pair< double, Eigen::VectorXd > >::iterator > insertionOrder_;
+};
+
+//! Class for the propagation of lunar ascent candidates, resuming from checkpoints of earlier candidates with the same prefix
+/*!
+ *  Class for the propagation of lunar ascent candidates (thrust parameters of LunarAscentThrustGuidance), which resumes from
+ *  checkpoints of earlier candidates where possible. The state at thrust angle node i depends only on the initial conditions,
+ *  the thrust magnitude, the node spacing and the thrust angles at nodes 0 to i. Candidates that are identical in these
+ *  quantities (e.g. in a coordinate-wise search, or when refining late nodes) therefore have identical trajectories up to
+ *  node i. The ascent is propagated segment by segment, terminating exactly at each node, and the state at each node is stored
+ *  in a cache, keyed by the quantities it depends on. A new candidate starts from the deepest node for which the cache
+ *  contains its checkpoint, so that only the remaining segments are propagated.
+ *
+ *  Since each candidate is propagated in segments between the nodes (independently of the contents of the cache), the
+ *  results of a candidate do not depend on the candidates evaluated before it. The acceleration models and mass rate model
+ *  (central gravity and thrust, with constant specific impulse) are created once, in the constructor. Only the final state of
+ *  each candidate is retained.
+ */
+class PrefixCachedAscentPropagator
+{
+public:
+
+    //! Constructor
+    /*!
+     *  Constructor
+     *  \param bodyMap List of body objects
+     *  \param vehicleName Name of the ascent vehicle
+     *  \param centralBodyName Name of central body of propagation
+     *  \param specificImpulse Constant specific impulse of the vehicle
+     *  \param maximumDuration Maximum duration of the ascent (w.r.t. initial time of each propagation)
+     *  \param terminationSettings Conditions (other than maximum duration) on which the ascent is terminated
+     *  \param propagatorType Type of translational state propagator
+     *  \param stepSize Step size of RK4 integrator
+     *  \param maximumNumberOfCheckpoints Maximum number of checkpoints in the cache (no caching if zero)
+     */
+    PrefixCachedAscentPropagator(
+            const tudat::simulation_setup::NamedBodyMap& bodyMap,
+            const std::string& vehicleName,
+            const std::string& centralBodyName,
+            const double specificImpulse,
+            const double maximumDuration,
+            const std::vector< std::shared_ptr< tudat::propagators::PropagationTerminationSettings > >& terminationSettings,
+            const tudat::propagators::TranslationalPropagatorType propagatorType,
+            const double stepSize = 1.0,
+            const unsigned int maximumNumberOfCheckpoints = 100000 );
+
+    //! Function to propagate the ascent of a single candidate
+    /*!
+     *  Function to propagate the ascent of a single candidate, starting from the deepest stored checkpoint
+     *  \param initialState Initial Cartesian state of the vehicle, in the global (inertial) frame
+     *  \param initialMass Initial mass of the vehicle
+     *  \param initialTime Initial time of the propagation (and time of the first thrust angle node)
+     *  \param thrustParameters Thrust parameters of LunarAscentThrustGuidance
+     *  \return Final Cartesian state and mass
+     */
+    Eigen::VectorXd propagate( const Eigen::Vector6d& initialState, const double initialMass, const double initialTime,
+                               const std::vector< double >& thrustParameters );
+
+    //! Function to retrieve the final time of the last propagation
+    double getFinalTime( ) const
+    {
+        return finalTime_;
+    }
+
+    //! Function to retrieve whether the ascent of the last propagation terminated successfully
+    bool getIsTerminationSuccessful( ) const
+    {
+        return isTerminationSuccessful_;
+    }
+
+    //! Function to retrieve which conditions were met when the last propagation stopped (maximum duration first)
+    const std::vector< bool >& getWasConditionMetWhenStopping( ) const
+    {
+        return wasConditionMetWhenStopping_;
+    }
+
+    //! Function to retrieve the total number of propagated segments, over all propagations
+    int getNumberOfPropagatedSegments( ) const
+    {
+        return numberOfPropagatedSegments_;
+    }
+
+    //! Function to retrieve the total number of segments that was retrieved from the cache, over all propagations
+    int getNumberOfResumedSegments( ) const
+    {
+        return numberOfResumedSegments_;
+    }
+
+    //! Function to retrieve the cache of checkpoints
+    AscentPrefixCache& getCache( )
+    {
+        return cache_;
+    }
+
+private:
+
+    //! Function to propagate a single segment (up to the next node, if any), returns true if the segment ended on the node
+    bool propagateSegment( double& currentTime, Eigen::VectorXd& currentState, const bool endsAtNode,
+                           const double segmentFinalTime );
+
+    //! List of body objects
+    tudat::simulation_setup::NamedBodyMap bodyMap_;
+
+    //! Name of the ascent vehicle, in list of bodies to propagate
+    std::vector< std::string > bodiesToPropagate_;
+
+    //! Name of central body of propagation, in list of central bodies
+    std::vector< std::string > centralBodies_;
+
+    //! Thrust guidance used by the acceleration models (reset for each candidate)
+    std::shared_ptr< LunarAscentThrustGuidance > thrustGuidance_;
+
+    //! Acceleration models acting on the vehicle
+    tudat::basic_astrodynamics::AccelerationMap accelerationModelMap_;
+
+    //! Mass rate model of the vehicle
+    std::map< std::string, std::shared_ptr< tudat::basic_astrodynamics::MassRateModel > > massRateModels_;
+
+    //! Maximum duration of the ascent
+    double maximumDuration_;
+
+    //! Conditions (other than maximum duration) on which the ascent is terminated
+    std::vector< std::shared_ptr< tudat::propagators::PropagationTerminationSettings > > terminationSettings_;
+
+    //! Type of translational state propagator
+    tudat::propagators::TranslationalPropagatorType propagatorType_;
+
+    //! Step size of RK4 integrator
+    double stepSize_;
+
+    //! Termination settings of the maximum duration of the current propagation
+    std::shared_ptr< tudat::propagators::PropagationTerminationSettings > maximumDurationTerminationSettings_;
+
+    //! Cache of checkpoints at thrust angle nodes
+    AscentPrefixCache cache_;
+
+    //! Final time of the last propagation
+    double finalTime_;
+
+    //! Boolean denoting whether the ascent of the last propagation terminated successfully
+    bool isTerminationSuccessful_;
+
+    //! Conditions that were met when the last propagation stopped (maximum duration first)
+    std::vector< bool > wasConditionMetWhenStopping_;
+
+    //! Total number of propagated segments
+    int numberOfPropagatedSegments_;
+
+    //! Total number of segments retrieved from the cache
+    int numberOfResumedSegments_;
+};
+
+} // namespace tudat_applications
+
+#endif // TUDAT_ASCENTPREFIXCACHE_H
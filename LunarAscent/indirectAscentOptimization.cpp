@@ -0,0 +1,361 @@
+/*    Copyright (c) 2010-2018, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+#include <Eigen/LU>
+
+#include <Tudat/Astrodynamics/BasicAstrodynamics/physicalConstants.h>
+
+#include "../parallelExecution.h"
+#include "indirectAscentOptimization.h"
+
+namespace tudat_applications
+{
+
+//! Constructor
+IndirectAscentOptimizer::IndirectAscentOptimizer(
+        const double gravitationalParameter,
+        const Eigen::Vector6d& initialState,
+        const Eigen::Vector3d& downrangeDirection,
+        const double initialMass,
+        const double dryMass,
+        const double thrustMagnitude,
+        const double specificImpulse,
+        const double targetRadius,
+        const int numberOfIntegrationSteps ):
+    initialMass_( initialMass ), dryMass_( dryMass ), numberOfIntegrationSteps_( numberOfIntegrationSteps )
+{
+    if( !( gravitationalParameter > 0.0 ) || !( initialMass > 0.0 ) || !( thrustMagnitude > 0.0 ) ||
+            !( specificImpulse > 0.0 ) || !( targetRadius > 0.0 ) || numberOfIntegrationSteps < 1 )
+    {
+        throw std::runtime_error( "Error when creating indirect ascent optimizer, input must be positive" );
+    }
+
+    // Set canonical units
+    distanceUnit_ = targetRadius;
+    velocityUnit_ = std::sqrt( gravitationalParameter / targetRadius );
+    timeUnit_ = distanceUnit_ / velocityUnit_;
+
+    // Determine ascent plane, and initial state in this plane
+    radialUnitVector_ = initialState.segment( 0, 3 ).normalized( );
+    downrangeUnitVector_ = downrangeDirection - downrangeDirection.dot( radialUnitVector_ ) * radialUnitVector_;
+    if( !( downrangeUnitVector_.norm( ) > 0.0 ) )
+    {
+        throw std::runtime_error( "Error when creating indirect ascent optimizer, downrange direction is radial" );
+    }
+    downrangeUnitVector_.normalize( );
+
+    initialRadius_ = initialState.segment( 0, 3 ).norm( ) / distanceUnit_;
+    initialPlanarState_ << initialRadius_, 0.0,
+            initialState.segment( 3, 3 ).dot( radialUnitVector_ ) / velocityUnit_,
+            initialState.segment( 3, 3 ).dot( downrangeUnitVector_ ) / velocityUnit_;
+
+    normalizedThrustAcceleration_ = thrustMagnitude / initialMass / ( velocityUnit_ / timeUnit_ );
+    normalizedMassRate_ = thrustMagnitude / (
+                specificImpulse * tudat::physical_constants::SEA_LEVEL_GRAVITATIONAL_ACCELERATION ) / initialMass *
+            timeUnit_;
+}
+
+//! Function to solve the ascent problem from a single initial guess, using homotopy on the dynamics
+IndirectAscentSolution IndirectAscentOptimizer::solveFromInitialGuess(
+        const Eigen::Vector4d& initialCostatesGuess,
+        const double finalTimeGuess,
+        const double initialHomotopyStep,
+        const double minimumHomotopyStep ) const
+{
+    IndirectAscentSolution solution;
+    solution.numberOfIterations = 0;
+    solution.residualNorm = std::numeric_limits< double >::quiet_NaN( );
+
+    Eigen::Matrix< double, 5, 1 > unknowns;
+    unknowns << initialCostatesGuess.normalized( ), finalTimeGuess / timeUnit_;
+
+    // Solve in uniform gravity field, and deform to point mass field
+    bool isSolutionFound = solveShootingProblem(
+                unknowns, 0.0, solution.numberOfIterations, solution.residualNorm );
+    double homotopyParameter = 0.0;
+    double homotopyStep = initialHomotopyStep;
+    while( isSolutionFound && homotopyParameter < 1.0 )
+    {
+        const double nextHomotopyParameter = std::min( 1.0, homotopyParameter + homotopyStep );
+        Eigen::Matrix< double, 5, 1 > trialUnknowns = unknowns;
+        if( solveShootingProblem( trialUnknowns, nextHomotopyParameter, solution.numberOfIterations,
+                                  solution.residualNorm ) )
+        {
+            unknowns = trialUnknowns;
+            homotopyParameter = nextHomotopyParameter;
+        }
+        else
+        {
+            homotopyStep /= 2.0;
+            isSolutionFound = ( homotopyStep >= minimumHomotopyStep );
+        }
+    }
+
+    solution.initialCostates = unknowns.segment( 0, 4 );
+    solution.finalTime = unknowns( 4 ) * timeUnit_;
+    solution.finalMass = std::numeric_limits< double >::quiet_NaN( );
+    solution.isConverged = false;
+    if( isSolutionFound )
+    {
+        // Check that the cost multiplier (from zero Hamiltonian at final time) is positive, so that the solution is a
+        // minimum-time (and not a maximum-time) solution, and that the propellant is not exceeded
+        const StateAndCostates finalStateAndCostates =
+                propagateStateAndCostates( unknowns.segment( 0, 4 ), unknowns( 4 ), 1.0 );
+        const Eigen::Vector2d finalPosition = finalStateAndCostates.segment( 0, 2 );
+        const Eigen::Vector2d finalVelocityCostates = finalStateAndCostates.segment( 7, 2 );
+        const double finalRadius = finalPosition.norm( );
+        const double costMultiplier =
+                -finalStateAndCostates.segment( 5, 2 ).dot( finalStateAndCostates.segment( 2, 2 ) ) +
+                finalVelocityCostates.dot( finalPosition ) / ( finalRadius * finalRadius * finalRadius ) +
+                normalizedThrustAcceleration_ / finalStateAndCostates( 4 ) * finalVelocityCostates.norm( );
+
+        solution.finalMass = finalStateAndCostates( 4 ) * initialMass_;
+        solution.isConverged = ( costMultiplier > 0.0 && solution.finalMass >= dryMass_ );
+    }
+
+    return solution;
+}
+
+//! Function to solve the ascent problem from a set of random initial guesses, distributed over a number of threads
+std::vector< IndirectAscentSolution > IndirectAscentOptimizer::solveFromMultipleStarts(
+        const int numberOfStarts,
+        const double minimumFinalTimeGuess,
+        const double maximumFinalTimeGuess,
+        const unsigned int randomSeed,
+        const int numberOfThreads ) const
+{
+    // Generate initial guesses (direction of normally distributed vector is uniformly distributed)
+    std::mt19937 randomNumberGenerator( randomSeed );
+    std::normal_distribution< double > costateDistribution( 0.0, 1.0 );
+    std::uniform_real_distribution< double > finalTimeDistribution( minimumFinalTimeGuess, maximumFinalTimeGuess );
+    std::vector< Eigen::Vector4d > initialCostatesGuesses( numberOfStarts );
+    std::vector< double > finalTimeGuesses( numberOfStarts );
+    for( int i = 0; i < numberOfStarts; i++ )
+    {
+        for( int j = 0; j < 4; j++ )
+        {
+            initialCostatesGuesses[ i ]( j ) = costateDistribution( randomNumberGenerator );
+        }
+        finalTimeGuesses[ i ] = finalTimeDistribution( randomNumberGenerator );
+    }
+
+    std::vector< IndirectAscentSolution > solutions( numberOfStarts );
+    parallelForEachIndex( numberOfStarts, [ & ]( const int startIndex, const int )
+    {
+        solutions[ startIndex ] = solveFromInitialGuess(
+                    initialCostatesGuesses[ startIndex ], finalTimeGuesses[ startIndex ] );
+    }, numberOfThreads );
+
+    return solutions;
+}
+
+//! Function to propagate a solution, and retrieve the trajectory and thrust angle history
+std::map< double, Eigen::VectorXd > IndirectAscentOptimizer::propagateSolution(
+        const IndirectAscentSolution& solution, const double initialTime ) const
+{
+    std::vector< StateAndCostates > stateAndCostateHistory;
+    propagateStateAndCostates( solution.initialCostates, solution.finalTime / timeUnit_, 1.0, &stateAndCostateHistory );
+
+    std::map< double, Eigen::VectorXd > solutionHistory;
+    const double timeStep = solution.finalTime / static_cast< double >( numberOfIntegrationSteps_ );
+    for( unsigned int i = 0; i < stateAndCostateHistory.size( ); i++ )
+    {
+        const StateAndCostates& stateAndCostates = stateAndCostateHistory.at( i );
+
+        // Compute thrust angle w.r.t. local vertical, positive towards local downrange direction
+        const Eigen::Vector2d localRadialDirection = stateAndCostates.segment( 0, 2 ).normalized( );
+        const Eigen::Vector2d thrustDirection = -stateAndCostates.segment( 7, 2 );
+        const double thrustAngle = std::atan2(
+                    thrustDirection( 1 ) * localRadialDirection( 0 ) - thrustDirection( 0 ) * localRadialDirection( 1 ),
+                    thrustDirection.dot( localRadialDirection ) );
+
+        Eigen::VectorXd currentSolution( 8 );
+        currentSolution.segment( 0, 3 ) = distanceUnit_ *
+                ( stateAndCostates( 0 ) * radialUnitVector_ + stateAndCostates( 1 ) * downrangeUnitVector_ );
+        currentSolution.segment( 3, 3 ) = velocityUnit_ *
+                ( stateAndCostates( 2 ) * radialUnitVector_ + stateAndCostates( 3 ) * downrangeUnitVector_ );
+        currentSolution( 6 ) = stateAndCostates( 4 ) * initialMass_;
+        currentSolution( 7 ) = thrustAngle;
+        solutionHistory[ initialTime + static_cast< double >( i ) * timeStep ] = currentSolution;
+    }
+
+    return solutionHistory;
+}
+
+//! Function to compute the derivative of the state and costates, for a given value of the homotopy parameter
+IndirectAscentOptimizer::StateAndCostates IndirectAscentOptimizer::computeStateAndCostateDerivative(
+        const StateAndCostates& stateAndCostates, const double homotopyParameter ) const
+{
+    const Eigen::Vector2d position = stateAndCostates.segment( 0, 2 );
+    const Eigen::Vector2d velocityCostates = stateAndCostates.segment( 7, 2 );
+    const double radius = position.norm( );
+    const double radiusCubed = radius * radius * radius;
+
+    // Gravity, deformed from uniform field (at launch site) to point mass field
+    const Eigen::Vector2d gravitationalAcceleration =
+            ( 1.0 - homotopyParameter ) * Eigen::Vector2d( -1.0 / ( initialRadius_ * initialRadius_ ), 0.0 ) -
+            homotopyParameter / radiusCubed * position;
+    const Eigen::Matrix2d gravityGradient = homotopyParameter / radiusCubed * (
+                3.0 / ( radius * radius ) * position * position.transpose( ) - Eigen::Matrix2d::Identity( ) );
+
+    // Thrust along primer vector
+    const double velocityCostateNorm = velocityCostates.norm( );
+    const Eigen::Vector2d thrustDirection = ( velocityCostateNorm > 0.0 ) ?
+                Eigen::Vector2d( -velocityCostates / velocityCostateNorm ) : Eigen::Vector2d::Zero( );
+
+    StateAndCostates derivative;
+    derivative.segment( 0, 2 ) = stateAndCostates.segment( 2, 2 );
+    derivative.segment( 2, 2 ) = gravitationalAcceleration +
+            normalizedThrustAcceleration_ / stateAndCostates( 4 ) * thrustDirection;
+    derivative( 4 ) = -normalizedMassRate_;
+    derivative.segment( 5, 2 ) = -gravityGradient * velocityCostates;
+    derivative.segment( 7, 2 ) = -stateAndCostates.segment( 5, 2 );
+    return derivative;
+}
+
+//! Function to propagate the state and costates over the time of flight (empty history pointer if not required)
+IndirectAscentOptimizer::StateAndCostates IndirectAscentOptimizer::propagateStateAndCostates(
+        const Eigen::Vector4d& initialCostates, const double normalizedFinalTime, const double homotopyParameter,
+        std::vector< StateAndCostates >* stateAndCostateHistory ) const
+{
+    StateAndCostates stateAndCostates;
+    stateAndCostates << initialPlanarState_, 1.0, initialCostates;
+    if( stateAndCostateHistory != nullptr )
+    {
+        stateAndCostateHistory->push_back( stateAndCostates );
+    }
+
+    const double stepSize = normalizedFinalTime / static_cast< double >( numberOfIntegrationSteps_ );
+    for( int i = 0; i < numberOfIntegrationSteps_; i++ )
+    {
+        const StateAndCostates k1 = computeStateAndCostateDerivative( stateAndCostates, homotopyParameter );
+        const StateAndCostates k2 = computeStateAndCostateDerivative(
+                    stateAndCostates + stepSize / 2.0 * k1, homotopyParameter );
+        const StateAndCostates k3 = computeStateAndCostateDerivative(
+                    stateAndCostates + stepSize / 2.0 * k2, homotopyParameter );
+        const StateAndCostates k4 = computeStateAndCostateDerivative(
+                    stateAndCostates + stepSize * k3, homotopyParameter );
+        stateAndCostates += stepSize / 6.0 * ( k1 + 2.0 * k2 + 2.0 * k3 + k4 );
+        if( stateAndCostateHistory != nullptr )
+        {
+            stateAndCostateHistory->push_back( stateAndCostates );
+        }
+    }
+    return stateAndCostates;
+}
+
+//! Function to compute the shooting residual for a vector of unknowns (initial costates and final time)
+Eigen::Matrix< double, 5, 1 > IndirectAscentOptimizer::computeShootingResidual(
+        const Eigen::Matrix< double, 5, 1 >& unknowns, const double homotopyParameter ) const
+{
+    Eigen::Matrix< double, 5, 1 > residual;
+    if( !( unknowns( 4 ) > 0.0 ) )
+    {
+        residual.setConstant( std::numeric_limits< double >::quiet_NaN( ) );
+        return residual;
+    }
+
+    const StateAndCostates finalStateAndCostates =
+            propagateStateAndCostates( unknowns.segment( 0, 4 ), unknowns( 4 ), homotopyParameter );
+    const Eigen::Vector2d position = finalStateAndCostates.segment( 0, 2 );
+    const Eigen::Vector2d velocity = finalStateAndCostates.segment( 2, 2 );
+    const Eigen::Vector2d positionCostates = finalStateAndCostates.segment( 5, 2 );
+    const Eigen::Vector2d velocityCostates = finalStateAndCostates.segment( 7, 2 );
+
+    // Circular orbit at target radius, free position along orbit, and normalized costates
+    residual( 0 ) = position.norm( ) - 1.0;
+    residual( 1 ) = position.dot( velocity );
+    residual( 2 ) = velocity.norm( ) - 1.0;
+    residual( 3 ) = position( 0 ) * positionCostates( 1 ) - position( 1 ) * positionCostates( 0 ) +
+            velocity( 0 ) * velocityCostates( 1 ) - velocity( 1 ) * velocityCostates( 0 );
+    residual( 4 ) = unknowns.segment( 0, 4 ).norm( ) - 1.0;
+    return residual;
+}
+
+//! Function to solve the shooting problem by damped Newton iterations, for a given value of the homotopy parameter
+bool IndirectAscentOptimizer::solveShootingProblem(
+        Eigen::Matrix< double, 5, 1 >& unknowns, const double homotopyParameter,
+        int& numberOfIterations, double& residualNorm ) const
+{
+    const int maximumNumberOfIterations = 30;
+    const double residualTolerance = 1.0E-10;
+
+    Eigen::Matrix< double, 5, 1 > residual = computeShootingResidual( unknowns, homotopyParameter );
+    residualNorm = residual.norm( );
+    for( int i = 0; i < maximumNumberOfIterations && std::isfinite( residualNorm ); i++ )
+    {
+        if( residualNorm < residualTolerance )
+        {
+            return true;
+        }
+        numberOfIterations++;
+
+        // Compute Jacobian by forward differences
+        Eigen::Matrix< double, 5, 5 > residualPartials;
+        for( int j = 0; j < 5; j++ )
+        {
+            const double perturbationSize = 1.0E-7 * ( 1.0 + std::fabs( unknowns( j ) ) );
+            Eigen::Matrix< double, 5, 1 > perturbedUnknowns = unknowns;
+            perturbedUnknowns( j ) += perturbationSize;
+            residualPartials.col( j ) =
+                    ( computeShootingResidual( perturbedUnknowns, homotopyParameter ) - residual ) / perturbationSize;
+        }
+        const Eigen::Matrix< double, 5, 1 > correction = -residualPartials.fullPivLu( ).solve( residual );
+
+        // Halve correction until residual decreases
+        bool isResidualDecreased = false;
+        for( double stepFactor = 1.0; stepFactor > 1.0E-3 && !isResidualDecreased; stepFactor /= 2.0 )
+        {
+            const Eigen::Matrix< double, 5, 1 > trialUnknowns = unknowns + stepFactor * correction;
+            const Eigen::Matrix< double, 5, 1 > trialResidual = computeShootingResidual( trialUnknowns, homotopyParameter );
+            if( trialResidual.norm( ) < residualNorm )
+            {
+                unknowns = trialUnknowns;
+                residual = trialResidual;
+                residualNorm = trialResidual.norm( );
+                isResidualDecreased = true;
+            }
+        }
+        if( !isResidualDecreased )
+        {
+            return false;
+        }
+    }
+
+    return ( residualNorm < residualTolerance );
+}
+
+//! Function to retrieve the index of the converged solution with the shortest ascent (throws if none converged)
+int getBestIndirectAscentSolutionIndex( const std::vector< IndirectAscentSolution >& solutions )
+{
+    int bestSolutionIndex = -1;
+    for( unsigned int i = 0; i < solutions.size( ); i++ )
+    {
+        if( solutions.at( i ).isConverged &&
+                ( bestSolutionIndex < 0 || solutions.at( i ).finalTime < solutions.at( bestSolutionIndex ).finalTime ) )
+        {
+            bestSolutionIndex = i;
+        }
+    }
+
+    if( bestSolutionIndex < 0 )
+    {
+        throw std::runtime_error( "Error when retrieving best indirect ascent solution, no solution converged" );
+    }
+    return bestSolutionIndex;
+}
+
+} // namespace tudat_applications
@@ -0,0 +1,207 @@
+/*    Copyright (c) 2010-2018, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_INDIRECTASCENTOPTIMIZATION_H
+#define TUDAT_INDIRECTASCENTOPTIMIZATION_H
+
+#include <map>
+#include <vector>
+
+#include <Tudat/Basics/basicTypedefs.h>
+
+namespace tudat_applications
+{
+
+//! Struct containing a (converged or failed) solution of the indirect minimum-time ascent problem
+struct IndirectAscentSolution
+{
+    //! Boolean denoting whether the shooting converged to a valid (minimum-time) solution
+    bool isConverged;
+
+    //! Initial costates of position and velocity in the ascent plane (canonical units, normalized to unit norm)
+    Eigen::Vector4d initialCostates;
+
+    //! Duration of the ascent
+    double finalTime;
+
+    //! Mass of the vehicle at the end of the ascent
+    double finalMass;
+
+    //! Norm of the final shooting residual (terminal conditions and transversality condition, canonical units)
+    double residualNorm;
+
+    //! Total number of Newton iterations, over all homotopy steps
+    int numberOfIterations;
+};
+
+//! Class for the computation of minimum-time ascent trajectories to a circular orbit by an indirect (costate) method
+/*!
+ *  Class for the computation of minimum-time ascent trajectories to a circular orbit by an indirect (costate) method, to serve
+ *  as a reference for parameterized thrust guidance. The vehicle flies at constant thrust magnitude and specific impulse
+ *  (so that minimum time is equivalent to maximum final mass), in the plane through the initial position and the downrange
+ *  direction, under point mass gravity of the central body. The out-of-plane component of the initial velocity (due to the
+ *  rotation of the central body) is neglected.
+ *
+ *  The state is propagated together with the costates of position and velocity, with the thrust direction along the primer
+ *  vector (minus the velocity costate). The unknowns are the initial costates (normalized to unit norm, which fixes the scale
+ *  of the cost) and the final time; these are found by Newton iterations (finite-difference Jacobian, damped by step
+ *  halving) on the terminal conditions (radius, zero radial velocity and circular speed), the transversality condition for
+ *  the free position along the target orbit, and the costate normalization. Since the convergence basin is small, the
+ *  shooting is embedded in a homotopy on the dynamics: the gravity field is continuously deformed from a uniform field
+ *  (magnitude and direction at the launch site), for which the problem is close to the linear tangent steering problem, to
+ *  the point mass field. In addition, many initial guesses can be solved concurrently, of which the fastest converged
+ *  ascent is the reference solution.
+ *
+ *  All computations are performed in canonical units (target radius, circular velocity at target radius and initial mass),
+ *  using a fixed-step RK4 integrator over the normalized time of flight.
+ */
+class IndirectAscentOptimizer
+{
+public:
+
+    //! Constructor
+    /*!
+     *  Constructor
+     *  \param gravitationalParameter Gravitational parameter of the central body
+     *  \param initialState Initial Cartesian state of the vehicle, w.r.t. the central body (inertial frame)
+     *  \param downrangeDirection Inertial direction of the ascent (e.g. horizontal direction of the launch azimuth), which
+     *  defines the ascent plane together with the initial position
+     *  \param initialMass Initial mass of the vehicle
+     *  \param dryMass Dry mass of the vehicle (solutions in which the propellant is exceeded are not valid)
+     *  \param thrustMagnitude Constant thrust magnitude
+     *  \param specificImpulse Constant specific impulse
+     *  \param targetRadius Radius of the target circular orbit
+     *  \param numberOfIntegrationSteps Number of RK4 steps over the time of flight
+     */
+    IndirectAscentOptimizer( const double gravitationalParameter,
+                             const Eigen::Vector6d& initialState,
+                             const Eigen::Vector3d& downrangeDirection,
+                             const double initialMass,
+                             const double dryMass,
+                             const double thrustMagnitude,
+                             const double specificImpulse,
+                             const double targetRadius,
+                             const int numberOfIntegrationSteps = 1000 );
+
+    //! Function to solve the ascent problem from a single initial guess, using homotopy on the dynamics
+    /*!
+     *  Function to solve the ascent problem from a single initial guess, using homotopy on the dynamics. The problem is first
+     *  solved in the uniform gravity field, after which the gravity field is deformed to the point mass field in steps, each
+     *  solved starting from the solution of the previous step. If a step fails, it is halved.
+     *  \param initialCostatesGuess Initial guess of the initial costates of position and velocity in the ascent plane
+     *  (canonical units, first component of each along the initial radial direction, second along the downrange direction)
+     *  \param finalTimeGuess Initial guess of the duration of the ascent
+     *  \param initialHomotopyStep Initial step in the homotopy parameter (between 0, uniform, and 1, point mass gravity)
+     *  \param minimumHomotopyStep Step in the homotopy parameter below which the solution is considered failed
+     *  \return Solution of the ascent problem
+     */
+    IndirectAscentSolution solveFromInitialGuess(
+            const Eigen::Vector4d& initialCostatesGuess,
+            const double finalTimeGuess,
+            const double initialHomotopyStep = 0.25,
+            const double minimumHomotopyStep = 1.0 / 64.0 ) const;
+
+    //! Function to solve the ascent problem from a set of random initial guesses, distributed over a number of threads
+    /*!
+     *  Function to solve the ascent problem from a set of random initial guesses (initial costates uniformly distributed in
+     *  direction, final time uniformly distributed in a given range), distributed over a number of threads. The initial guesses
+     *  are generated in the calling thread, so that the results do not depend on the number of threads.
+     *  \param numberOfStarts Number of initial guesses
+     *  \param minimumFinalTimeGuess Lower bound of the final time guesses
+     *  \param maximumFinalTimeGuess Upper bound of the final time guesses
+     *  \param randomSeed Seed of the random number generator
+     *  \param numberOfThreads Number of threads to use (if smaller than 1, the default number of threads is used)
+     *  \return Solutions of all initial guesses (in the order in which the guesses were generated)
+     */
+    std::vector< IndirectAscentSolution > solveFromMultipleStarts(
+            const int numberOfStarts,
+            const double minimumFinalTimeGuess,
+            const double maximumFinalTimeGuess,
+            const unsigned int randomSeed = 0,
+            const int numberOfThreads = 0 ) const;
+
+    //! Function to propagate a solution, and retrieve the trajectory and thrust angle history
+    /*!
+     *  Function to propagate a solution, and retrieve the trajectory and thrust angle history, in the same form as the
+     *  parameterized guidance (for comparison).
+     *  \param solution Solution that is to be propagated
+     *  \param initialTime Time at the start of the ascent
+     *  \return History (key: time) of the inertial Cartesian state (w.r.t. the central body), mass and thrust angle (angle
+     *  between the thrust direction and the local vertical, positive in downrange direction, as used by
+     *  LunarAscentThrustGuidance)
+     */
+    std::map< double, Eigen::VectorXd > propagateSolution(
+            const IndirectAscentSolution& solution, const double initialTime ) const;
+
+private:
+
+    //! Typedef for the combined state (position, velocity and mass) and costates (position and velocity), canonical units
+    typedef Eigen::Matrix< double, 9, 1 > StateAndCostates;
+
+    //! Function to compute the derivative of the state and costates, for a given value of the homotopy parameter
+    StateAndCostates computeStateAndCostateDerivative(
+            const StateAndCostates& stateAndCostates, const double homotopyParameter ) const;
+
+    //! Function to propagate the state and costates over the time of flight (empty history pointer if not required)
+    StateAndCostates propagateStateAndCostates(
+            const Eigen::Vector4d& initialCostates, const double normalizedFinalTime, const double homotopyParameter,
+            std::vector< StateAndCostates >* stateAndCostateHistory = nullptr ) const;
+
+    //! Function to compute the shooting residual for a vector of unknowns (initial costates and final time)
+    Eigen::Matrix< double, 5, 1 > computeShootingResidual(
+            const Eigen::Matrix< double, 5, 1 >& unknowns, const double homotopyParameter ) const;
+
+    //! Function to solve the shooting problem by damped Newton iterations, for a given value of the homotopy parameter
+    bool solveShootingProblem( Eigen::Matrix< double, 5, 1 >& unknowns, const double homotopyParameter,
+                               int& numberOfIterations, double& residualNorm ) const;
+
+    //! Initial radial distance, canonical units
+    double initialRadius_;
+
+    //! Initial position and velocity in the ascent plane, canonical units
+    Eigen::Vector4d initialPlanarState_;
+
+    //! Unit vector along the initial radial direction in the ascent plane
+    Eigen::Vector3d radialUnitVector_;
+
+    //! Unit vector along the downrange direction in the ascent plane
+    Eigen::Vector3d downrangeUnitVector_;
+
+    //! Initial mass of the vehicle
+    double initialMass_;
+
+    //! Dry mass of the vehicle
+    double dryMass_;
+
+    //! Thrust acceleration at initial mass, canonical units
+    double normalizedThrustAcceleration_;
+
+    //! Mass flow rate, in initial masses per canonical time unit
+    double normalizedMassRate_;
+
+    //! Canonical unit of length (target radius)
+    double distanceUnit_;
+
+    //! Canonical unit of velocity (circular velocity at target radius)
+    double velocityUnit_;
+
+    //! Canonical unit of time
+    double timeUnit_;
+
+    //! Number of RK4 steps over the time of flight
+    int numberOfIntegrationSteps_;
+};
+
+//! Function to retrieve the index of the converged solution with the shortest ascent (throws if none converged)
+int getBestIndirectAscentSolutionIndex( const std::vector< IndirectAscentSolution >& solutions );
+
+} // namespace tudat_applications
+
+#endif // TUDAT_INDIRECTASCENTOPTIMIZATION_H
@@ -0,0 +1,207 @@
+/*    Copyright (c) 2010-2018, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+#include "../parallelExecution.h"
+#include "launchSiteAvailability.h"
+
+namespace tudat_applications
+{
+
+//! Identifier at the start of a launch site availability raster file
+static const std::int64_t rasterFileIdentifier = 0x3150414D5641534C; // "LSAVMAP1"
+
+//! Function to check whether a performance is better than another (infeasible performances, NaN, are worst)
+static bool isBetterPerformance( const double performance, const double referencePerformance )
+{
+    return std::isfinite( performance ) && ( !std::isfinite( referencePerformance ) || performance > referencePerformance );
+}
+
+//! Function to maximize the performance of an ascent from a launch site, by a pattern search on the guidance parameters
+/*!
+ *  Function to maximize the performance of an ascent from a launch site, by a pattern (compass) search on the guidance
+ *  parameters. In each iteration, each parameter is stepped in positive and negative direction, and the first improving step
+ *  is accepted. If no step improves the performance, the step sizes are halved.
+ *  \param guidanceParameters Initial guess of the guidance parameters (returned by reference as the best parameters found)
+ *  \param initialStepSizeFactor Factor w.r.t. the initial step sizes of the settings at which the search starts
+ *  \param numberOfEvaluations Number of performance evaluations (incremented by reference)
+ *  \return Best performance found
+ */
+static double searchGuidanceParameters(
+        const LaunchSitePerformanceFunction& performanceFunction,
+        const double latitude,
+        const double longitude,
+        const double launchEpoch,
+        std::vector< double >& guidanceParameters,
+        const double initialStepSizeFactor,
+        const LaunchSiteOptimizationSettings& optimizationSettings,
+        const int threadIndex,
+        int& numberOfEvaluations )
+{
+    const std::vector< double >& stepSizes = optimizationSettings.initialStepSizes;
+    const int maximumNumberOfEvaluations = numberOfEvaluations + optimizationSettings.maximumNumberOfEvaluations;
+
+    double bestPerformance = performanceFunction( latitude, longitude, launchEpoch, guidanceParameters, threadIndex );
+    numberOfEvaluations++;
+
+    double stepSizeFactor = initialStepSizeFactor;
+    std::vector< double > trialParameters;
+    while( numberOfEvaluations < maximumNumberOfEvaluations &&
+           stepSizeFactor >= optimizationSettings.minimumStepSizeFactor )
+    {
+        bool isPerformanceImproved = false;
+        for( unsigned int i = 0; i < stepSizes.size( ) && numberOfEvaluations < maximumNumberOfEvaluations; i++ )
+        {
+            if( stepSizes.at( i ) == 0.0 )
+            {
+                continue;
+            }
+
+            for( int direction = 1; direction >= -1 && numberOfEvaluations < maximumNumberOfEvaluations; direction -= 2 )
+            {
+                trialParameters = guidanceParameters;
+                trialParameters.at( i ) += direction * stepSizeFactor * stepSizes.at( i );
+                const double trialPerformance = performanceFunction(
+                            latitude, longitude, launchEpoch, trialParameters, threadIndex );
+                numberOfEvaluations++;
+                if( isBetterPerformance( trialPerformance, bestPerformance ) )
+                {
+                    guidanceParameters = trialParameters;
+                    bestPerformance = trialPerformance;
+                    isPerformanceImproved = true;
+                    break;
+                }
+            }
+        }
+
+        if( !isPerformanceImproved )
+        {
+            stepSizeFactor /= 2.0;
+        }
+    }
+
+    return bestPerformance;
+}
+
+//! Function to compute the map of achievable ascent performance over a grid of launch sites and epochs
+LaunchSiteAvailabilityMap computeLaunchSiteAvailabilityMap(
+        const LaunchSitePerformanceFunction& performanceFunction,
+        const Eigen::VectorXd& latitudes,
+        const Eigen::VectorXd& longitudes,
+        const Eigen::VectorXd& launchEpochs,
+        const std::vector< double >& nominalGuidanceParameters,
+        const LaunchSiteOptimizationSettings& optimizationSettings,
+        const int numberOfThreads )
+{
+    const int numberOfLatitudes = latitudes.rows( );
+    const int numberOfLongitudes = longitudes.rows( );
+    const int numberOfEpochs = launchEpochs.rows( );
+    if( numberOfLatitudes == 0 || numberOfLongitudes == 0 || numberOfEpochs == 0 )
+    {
+        throw std::runtime_error( "Error when computing launch site availability map, grid is empty" );
+    }
+    if( optimizationSettings.initialStepSizes.size( ) != nominalGuidanceParameters.size( ) )
+    {
+        throw std::runtime_error( "Error when computing launch site availability map, number of step sizes is inconsistent "
+                                  "with number of guidance parameters" );
+    }
+    if( optimizationSettings.maximumNumberOfEvaluations < 1 )
+    {
+        throw std::runtime_error( "Error when computing launch site availability map, maximum number of evaluations must be "
+                                  "positive" );
+    }
+
+    LaunchSiteAvailabilityMap availabilityMap;
+    availabilityMap.latitudes = latitudes;
+    availabilityMap.longitudes = longitudes;
+    availabilityMap.launchEpochs = launchEpochs;
+    const int numberOfCells = numberOfEpochs * numberOfLatitudes * numberOfLongitudes;
+    availabilityMap.performances.resize( numberOfCells, std::numeric_limits< double >::quiet_NaN( ) );
+    availabilityMap.guidanceParameters.resize( numberOfCells );
+    availabilityMap.numberOfEvaluations.resize( numberOfCells, 0 );
+
+    // Sweep each row (constant epoch and latitude) in order of increasing longitude
+    parallelForEachIndex( numberOfEpochs * numberOfLatitudes, [ & ]( const int rowIndex, const int threadIndex )
+    {
+        const int epochIndex = rowIndex / numberOfLatitudes;
+        const int latitudeIndex = rowIndex % numberOfLatitudes;
+
+        std::vector< double > previousGuidanceParameters;
+        bool isPreviousCellFeasible = false;
+        for( int longitudeIndex = 0; longitudeIndex < numberOfLongitudes; longitudeIndex++ )
+        {
+            const int cellIndex = availabilityMap.getCellIndex( epochIndex, latitudeIndex, longitudeIndex );
+            std::vector< double >& guidanceParameters = availabilityMap.guidanceParameters[ cellIndex ];
+            int& numberOfEvaluations = availabilityMap.numberOfEvaluations[ cellIndex ];
+
+            // Search from optimum of previous cell, if it was feasible
+            double performance = std::numeric_limits< double >::quiet_NaN( );
+            if( isPreviousCellFeasible )
+            {
+                guidanceParameters = previousGuidanceParameters;
+                performance = searchGuidanceParameters(
+                            performanceFunction, latitudes( latitudeIndex ), longitudes( longitudeIndex ),
+                            launchEpochs( epochIndex ), guidanceParameters, optimizationSettings.warmStartStepSizeFactor,
+                            optimizationSettings, threadIndex, numberOfEvaluations );
+            }
+
+            // Search from nominal guidance parameters if there is no (feasible) warm start
+            if( !std::isfinite( performance ) )
+            {
+                guidanceParameters = nominalGuidanceParameters;
+                performance = searchGuidanceParameters(
+                            performanceFunction, latitudes( latitudeIndex ), longitudes( longitudeIndex ),
+                            launchEpochs( epochIndex ), guidanceParameters, 1.0,
+                            optimizationSettings, threadIndex, numberOfEvaluations );
+            }
+
+            availabilityMap.performances[ cellIndex ] = performance;
+            isPreviousCellFeasible = std::isfinite( performance );
+            previousGuidanceParameters = guidanceParameters;
+        }
+    }, numberOfThreads );
+
+    return availabilityMap;
+}
+
+//! Function to write the performance of a launch site availability map to a binary raster file
+void writeLaunchSiteAvailabilityRaster(
+        const LaunchSiteAvailabilityMap& availabilityMap,
+        const std::string& fileName )
+{
+    std::ofstream rasterFile( fileName.c_str( ), std::ios::binary | std::ios::trunc );
+    if( !rasterFile.good( ) )
+    {
+        throw std::runtime_error( "Error when writing launch site availability raster, could not open " + fileName );
+    }
+
+    const std::int64_t header[ 4 ] = { rasterFileIdentifier, availabilityMap.launchEpochs.rows( ),
+                                       availabilityMap.latitudes.rows( ), availabilityMap.longitudes.rows( ) };
+    rasterFile.write( reinterpret_cast< const char* >( header ), sizeof( header ) );
+    rasterFile.write( reinterpret_cast< const char* >( availabilityMap.launchEpochs.data( ) ),
+                      availabilityMap.launchEpochs.rows( ) * sizeof( double ) );
+    rasterFile.write( reinterpret_cast< const char* >( availabilityMap.latitudes.data( ) ),
+                      availabilityMap.latitudes.rows( ) * sizeof( double ) );
+    rasterFile.write( reinterpret_cast< const char* >( availabilityMap.longitudes.data( ) ),
+                      availabilityMap.longitudes.rows( ) * sizeof( double ) );
+    rasterFile.write( reinterpret_cast< const char* >( availabilityMap.performances.data( ) ),
+                      availabilityMap.performances.size( ) * sizeof( double ) );
+    if( !rasterFile.good( ) )
+    {
+        throw std::runtime_error( "Error when writing launch site availability raster, could not write " + fileName );
+    }
+}
+
+} // namespace tudat_applications
@@ -0,0 +1,149 @@
+/*    Copyright (c) 2010-2018, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_LAUNCHSITEAVAILABILITY_H
+#define TUDAT_LAUNCHSITEAVAILABILITY_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <Tudat/Basics/basicTypedefs.h>
+
+namespace tudat_applications
+{
+
+//! Function type to evaluate the performance of an ascent from a launch site
+/*!
+ *  Function type to evaluate the performance of an ascent from a launch site (higher is better). It is called as
+ *  function( latitude, longitude, launchEpoch, guidanceParameters, threadIndex ), and should return NaN if the ascent is not
+ *  feasible (e.g. if the target orbit is not reached). The thread index is in [0, numberOfThreads), and is to be used to
+ *  access per-thread resources (body maps, which may not be shared between concurrent propagations).
+ */
+typedef std::function< double( const double, const double, const double, const std::vector< double >&, const int ) >
+LaunchSitePerformanceFunction;
+
+//! Struct containing the settings of the local optimization of the guidance parameters in each cell of the map
+struct LaunchSiteOptimizationSettings
+{
+    //! Constructor
+    /*!
+     *  Constructor
+     *  \param initialStepSizes Initial step size of each guidance parameter in the pattern search (parameters with zero step
+     *  size are kept fixed)
+     *  \param maximumNumberOfEvaluations Maximum number of performance evaluations per cell (1 to only evaluate the initial
+     *  guess)
+     *  \param minimumStepSizeFactor Factor w.r.t. the initial step sizes at which the pattern search is terminated
+     *  \param warmStartStepSizeFactor Factor w.r.t. the initial step sizes at which the pattern search starts, if the initial
+     *  guess is the solution of a neighbouring cell
+     */
+    LaunchSiteOptimizationSettings(
+            const std::vector< double >& initialStepSizes,
+            const int maximumNumberOfEvaluations = 100,
+            const double minimumStepSizeFactor = 1.0E-3,
+            const double warmStartStepSizeFactor = 0.25 ):
+        initialStepSizes( initialStepSizes ), maximumNumberOfEvaluations( maximumNumberOfEvaluations ),
+        minimumStepSizeFactor( minimumStepSizeFactor ), warmStartStepSizeFactor( warmStartStepSizeFactor ){ }
+
+    //! Initial step size of each guidance parameter in the pattern search
+    std::vector< double > initialStepSizes;
+
+    //! Maximum number of performance evaluations per cell
+    int maximumNumberOfEvaluations;
+
+    //! Factor w.r.t. the initial step sizes at which the pattern search is terminated
+    double minimumStepSizeFactor;
+
+    //! Factor w.r.t. the initial step sizes at which the pattern search starts, if the initial guess is warm-started
+    double warmStartStepSizeFactor;
+};
+
+//! Struct containing a map of the achievable ascent performance as a function of launch site and epoch
+/*!
+ *  Struct containing a map of the achievable ascent performance as a function of launch site and epoch. All per-cell values
+ *  are stored with index ( epochIndex * numberOfLatitudes + latitudeIndex ) * numberOfLongitudes + longitudeIndex.
+ */
+struct LaunchSiteAvailabilityMap
+{
+    //! Latitudes of the grid
+    Eigen::VectorXd latitudes;
+
+    //! Longitudes of the grid
+    Eigen::VectorXd longitudes;
+
+    //! Launch epochs of the grid
+    Eigen::VectorXd launchEpochs;
+
+    //! Best performance found in each cell (NaN if no feasible ascent was found)
+    std::vector< double > performances;
+
+    //! Guidance parameters of the best performance in each cell
+    std::vector< std::vector< double > > guidanceParameters;
+
+    //! Number of performance evaluations in each cell
+    std::vector< int > numberOfEvaluations;
+
+    //! Function to retrieve the index of a cell in the per-cell values
+    int getCellIndex( const int epochIndex, const int latitudeIndex, const int longitudeIndex ) const
+    {
+        return ( epochIndex * latitudes.rows( ) + latitudeIndex ) * longitudes.rows( ) + longitudeIndex;
+    }
+
+    //! Function to retrieve the performance in a cell
+    double getPerformance( const int epochIndex, const int latitudeIndex, const int longitudeIndex ) const
+    {
+        return performances.at( getCellIndex( epochIndex, latitudeIndex, longitudeIndex ) );
+    }
+};
+
+//! Function to compute the map of achievable ascent performance over a grid of launch sites and epochs
+/*!
+ *  Function to compute the map of achievable ascent performance over a grid of launch latitudes, longitudes and epochs. In
+ *  each cell, the guidance parameters are optimized locally by a pattern (compass) search, which maximizes the performance.
+ *
+ *  Since neighbouring cells have nearly identical optimal guidance parameters, the cells are evaluated in sweep order: each
+ *  row of constant latitude and epoch is one task, distributed dynamically over the threads, in which the cells are traversed
+ *  in order of increasing longitude. The optimum of the previous (feasible) cell in the row is then used as initial guess,
+ *  with a reduced initial step size, so that most cells converge in a fraction of the evaluations of a cold start. The first
+ *  cell of each row starts from the nominal guidance parameters. If a warm-started search ends infeasible, the cell is
+ *  searched again from the nominal guidance parameters.
+ *  \param performanceFunction Function to evaluate the performance of an ascent (see LaunchSitePerformanceFunction)
+ *  \param latitudes Launch latitudes of the grid
+ *  \param longitudes Launch longitudes of the grid
+ *  \param launchEpochs Launch epochs of the grid
+ *  \param nominalGuidanceParameters Guidance parameters used as initial guess in cells without a warm start
+ *  \param optimizationSettings Settings of the local optimization in each cell
+ *  \param numberOfThreads Number of threads to use (if smaller than 1, the default number of threads is used)
+ *  \return Map of the achievable performance
+ */
+LaunchSiteAvailabilityMap computeLaunchSiteAvailabilityMap(
+        const LaunchSitePerformanceFunction& performanceFunction,
+        const Eigen::VectorXd& latitudes,
+        const Eigen::VectorXd& longitudes,
+        const Eigen::VectorXd& launchEpochs,
+        const std::vector< double >& nominalGuidanceParameters,
+        const LaunchSiteOptimizationSettings& optimizationSettings,
+        const int numberOfThreads = 0 );
+
+//! Function to write the performance of a launch site availability map to a binary raster file
+/*!
+ *  Function to write the performance of a launch site availability map to a binary raster file. The file contains a header
+ *  (file identifier, and numbers of epochs, latitudes and longitudes as 64-bit integers), followed by the epochs, latitudes
+ *  and longitudes of the grid, and the performance in each cell (in the order of LaunchSiteAvailabilityMap), all as doubles.
+ *  \param availabilityMap Map of which the performance is written
+ *  \param fileName Name (including directory) of the raster file
+ */
+void writeLaunchSiteAvailabilityRaster(
+        const LaunchSiteAvailabilityMap& availabilityMap,
+        const std::string& fileName );
+
+} // namespace tudat_applications
+
+#endif // TUDAT_LAUNCHSITEAVAILABILITY_H
@@ -0,0 +1,49 @@
+/*    Copyright (c) 2010-2018, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#include "lunarAscent.h"
+
+namespace tudat_applications
+{
+
+//! Contructor
+LunarAscentThrustGuidance::LunarAscentThrustGuidance(
+        const std::shared_ptr< tudat::simulation_setup::Body > vehicleBody,
+        const double initialTime,
+        const std::vector< double > parameterVector ):
+    vehicleBody_( vehicleBody )
+{
+    resetParameters( initialTime, parameterVector );
+}
+
+//! Function to reset the thrust parameters, so that the guidance can be reused for a different candidate
+void LunarAscentThrustGuidance::resetParameters( const double initialTime, const std::vector< double >& parameterVector )
+{
+    parameterVector_ = parameterVector;
+
+    // Retrieve parameters of thrust profile
+    thrustMagnitude_ = parameterVector_.at( 0 );
+    timeInterval_ = parameterVector_.at( 1 );
+
+    // Create interpolator for thrust angle
+    thrustAngleMap_.clear( );
+    double currentTime = initialTime;
+    for( unsigned int i = 0; i < parameterVector_.size( ) - 2; i++ )
+    {
+        thrustAngleMap_[ currentTime ] = parameterVector_.at( i + 2 );
+        currentTime += timeInterval_;
+    }
+    thrustAngleInterpolator_ = tudat::interpolators::createOneDimensionalInterpolator(
+                thrustAngleMap_, std::make_shared< tudat::interpolators::InterpolatorSettings >(
+                    tudat::interpolators::linear_interpolator, tudat::interpolators::huntingAlgorithm, false,
+                    tudat::interpolators::use_boundary_value ) );
+}
+
+} // namespace tudat_applications
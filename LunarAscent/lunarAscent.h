@@ -0,0 +1,106 @@
+/*    Copyright (c) 2010-2018, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_LUNARASCENT_H
+#define TUDAT_LUNARASCENT_H
+
+#include <cmath>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <Tudat/SimulationSetup/tudatSimulationHeader.h>
+
+namespace tudat_applications
+{
+
+/*!
+ *  Class to compute the thrust direction and magnitude for the lunar ascent vehicle. The current inputs set a
+ *  constant thrust magnitude, and a thrust direction in y-(-z) plane of the vertical frame define linearly in time using
+ *  equispaced nodes. These settings are to be modified for the assignment.
+ */
+class LunarAscentThrustGuidance
+{
+public:
+
+    //! Contructor
+    /*!
+     * Contructor
+     * \param vehicleBody Body object for the ascent vehicle
+     * \param initialTime Start time of the propagatiin
+     * \param parameterVector Vector of independent variables to be used for thrust parameterization:
+     *   - Entry 0: Constant thrust magnitude
+     *   - Entry 1: Constant spacing in time between nodes
+     *   - Entry 2-6: Thrust angle theta, at five nodes
+     */
+    LunarAscentThrustGuidance(
+            const std::shared_ptr< tudat::simulation_setup::Body > vehicleBody,
+            const double initialTime,
+            const std::vector< double > parameterVector );
+
+    //! Function to reset the thrust parameters, so that the guidance can be reused for a different candidate
+    /*!
+     * Function to reset the thrust parameters, so that the guidance (and acceleration models using it) can be reused for a
+     * different candidate
+     * \param initialTime Time of the first thrust angle node
+     * \param parameterVector Vector of independent variables to be used for thrust parameterization (see constructor)
+     */
+    void resetParameters( const double initialTime, const std::vector< double >& parameterVector );
+
+    //! Function that computes the inertial thrust direction for each state derivative function evaluation
+    Eigen::Vector3d getCurrentThrustDirection( const double currentTime )
+    {
+        // Retrieve thrust angle
+        double currentThrustAngle = thrustAngleInterpolator_->interpolate( currentTime );
+
+        // Set thrust in V-frame
+        Eigen::Vector3d thrustDirectionInVerticalFrame =
+                ( Eigen::Vector3d( ) << 0.0, std::sin( currentThrustAngle ), -std::cos( currentThrustAngle ) ).finished( );
+
+        // Retrieve rotation from V-frame to inertial frame
+        Eigen::Quaterniond verticalToInertialFrame =
+                vehicleBody_->getFlightConditions( )->getAerodynamicAngleCalculator( )->getRotationQuaternionBetweenFrames(
+                    tudat::reference_frames::vertical_frame, tudat::reference_frames::inertial_frame );
+
+        // Return thrust direction
+        return verticalToInertialFrame * thrustDirectionInVerticalFrame;
+    }
+
+    //! Function that computes the thrust magnitude for each state derivative function evaluation
+    double getCurrentThrustMagnitude( const double currentTime )
+    {
+        return thrustMagnitude_;
+    }
+
+private:
+
+    //! Object containing properties of the vehicle
+    std::shared_ptr< tudat::simulation_setup::Body > vehicleBody_;
+
+    //! Parameter containing the solution parameter vector
+    std::vector< double > parameterVector_;
+
+    //! Map containing the thrust (value) as a function of time (key)
+    std::map< double, double > thrustAngleMap_;
+
+    //! Object that interpolates the thrust as a function of time
+    std::shared_ptr< tudat::interpolators::OneDimensionalInterpolator< double, double > > thrustAngleInterpolator_;
+
+    //! Constant time between thrust angle nodes
+    double timeInterval_;
+
+    //! Constant magnitude of the thrust
+    double thrustMagnitude_;
+
+};
+
+} // namespace tudat_applications
+
+#endif // TUDAT_LUNARASCENT_H
@@ -0,0 +1,111 @@
+/*    Copyright (c) 2010-2018, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#include <stdexcept>
+
+#include <Tudat/Astrodynamics/BasicAstrodynamics/physicalConstants.h>
+
+#include "lunarAscentEnsemble.h"
+
+namespace tudat_applications
+{
+
+//! Typedef for the values of a single state or parameter entry for a block of samples
+typedef Eigen::Array< double, 1, Eigen::Dynamic > EnsembleRowArray;
+
+//! Constructor
+LunarAscentEnsembleModel::LunarAscentEnsembleModel(
+        const double gravitationalParameter,
+        const double moonRadius,
+        const Eigen::Vector3d& rotationAxis,
+        const double initialTime,
+        const int numberOfThrustAngleNodes,
+        const double terminationAltitude,
+        const double dryMass,
+        const double maximumDuration ):
+    gravitationalParameter_( gravitationalParameter ), moonRadius_( moonRadius ), rotationAxis_( rotationAxis.normalized( ) ),
+    initialTime_( initialTime ), numberOfThrustAngleNodes_( numberOfThrustAngleNodes ),
+    terminationAltitude_( terminationAltitude ), dryMass_( dryMass ), maximumDuration_( maximumDuration )
+{
+    if( numberOfThrustAngleNodes_ < 2 )
+    {
+        throw std::runtime_error( "Error when creating lunar ascent ensemble model, at least two thrust angle nodes required" );
+    }
+}
+
+//! Function to compute the state derivatives of a block of samples
+void LunarAscentEnsembleModel::computeStateDerivatives(
+        const double time,
+        const Eigen::Ref< const EnsembleMatrix >& states,
+        const Eigen::Ref< const EnsembleMatrix >& parameters,
+        Eigen::Ref< EnsembleMatrix > stateDerivatives ) const
+{
+    // Compute radial (up) unit vector and point mass gravity
+    const EnsembleRowArray radius = ( states.row( 0 ).array( ).square( ) + states.row( 1 ).array( ).square( ) +
+                                      states.row( 2 ).array( ).square( ) ).sqrt( );
+    const EnsembleRowArray upX = states.row( 0 ).array( ) / radius;
+    const EnsembleRowArray upY = states.row( 1 ).array( ) / radius;
+    const EnsembleRowArray upZ = states.row( 2 ).array( ) / radius;
+    const EnsembleRowArray gravityFactor = -gravitationalParameter_ / ( radius * radius );
+
+    // Compute east unit vector (rotation axis x up)
+    EnsembleRowArray eastX = rotationAxis_( 1 ) * upZ - rotationAxis_( 2 ) * upY;
+    EnsembleRowArray eastY = rotationAxis_( 2 ) * upX - rotationAxis_( 0 ) * upZ;
+    EnsembleRowArray eastZ = rotationAxis_( 0 ) * upY - rotationAxis_( 1 ) * upX;
+    const EnsembleRowArray inverseEastNorm = ( eastX * eastX + eastY * eastY + eastZ * eastZ ).rsqrt( );
+    eastX *= inverseEastNorm;
+    eastY *= inverseEastNorm;
+    eastZ *= inverseEastNorm;
+
+    // Interpolate thrust angle linearly between nodes (as sum of hat functions, boundary value outside of nodes)
+    const EnsembleRowArray nodePosition =
+            ( ( time - initialTime_ ) / parameters.row( 1 ).array( ) ).max( 0.0 ).min( numberOfThrustAngleNodes_ - 1 );
+    EnsembleRowArray thrustAngle = EnsembleRowArray::Zero( states.cols( ) );
+    for( int i = 0; i < numberOfThrustAngleNodes_; i++ )
+    {
+        thrustAngle += parameters.row( i + 2 ).array( ) *
+                ( 1.0 - ( nodePosition - static_cast< double >( i ) ).abs( ) ).max( 0.0 );
+    }
+
+    // Thrust in vertical frame: angle w.r.t. up direction, towards east
+    const EnsembleRowArray thrustAcceleration = parameters.row( 0 ).array( ) / states.row( 6 ).array( );
+    const EnsembleRowArray horizontalThrustAcceleration = thrustAcceleration * thrustAngle.sin( );
+    const EnsembleRowArray verticalThrustAcceleration = thrustAcceleration * thrustAngle.cos( ) + gravityFactor;
+
+    stateDerivatives.topRows( 3 ) = states.middleRows( 3, 3 );
+    stateDerivatives.row( 3 ).array( ) = verticalThrustAcceleration * upX + horizontalThrustAcceleration * eastX;
+    stateDerivatives.row( 4 ).array( ) = verticalThrustAcceleration * upY + horizontalThrustAcceleration * eastY;
+    stateDerivatives.row( 5 ).array( ) = verticalThrustAcceleration * upZ + horizontalThrustAcceleration * eastZ;
+    stateDerivatives.row( 6 ).array( ) = -parameters.row( 0 ).array( ) / (
+                parameters.row( numberOfThrustAngleNodes_ + 2 ).array( ) *
+                tudat::physical_constants::SEA_LEVEL_GRAVITATIONAL_ACCELERATION );
+}
+
+//! Function to determine which samples of a block meet a termination condition
+void LunarAscentEnsembleModel::computeTerminationFlags(
+        const double time,
+        const Eigen::Ref< const EnsembleMatrix >& states,
+        const Eigen::Ref< const EnsembleMatrix >&,
+        Eigen::Array< bool, Eigen::Dynamic, 1 >& isTerminated ) const
+{
+    const EnsembleRowArray altitude = ( states.row( 0 ).array( ).square( ) + states.row( 1 ).array( ).square( ) +
+                                        states.row( 2 ).array( ).square( ) ).sqrt( ) - moonRadius_;
+    if( time >= initialTime_ + maximumDuration_ )
+    {
+        isTerminated.setConstant( states.cols( ), true );
+    }
+    else
+    {
+        isTerminated = ( ( altitude > terminationAltitude_ ) || ( altitude < 0.0 ) ||
+                         ( states.row( 6 ).array( ) < dryMass_ ) ).transpose( );
+    }
+}
+
+} // namespace tudat_applications
@@ -0,0 +1,127 @@
+/*    Copyright (c) 2010-2018, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_LUNARASCENTENSEMBLE_H
+#define TUDAT_LUNARASCENTENSEMBLE_H
+
+#include <Tudat/Basics/basicTypedefs.h>
+
+#include "../ensemblePropagation.h"
+
+namespace tudat_applications
+{
+
+//! Model of the lunar ascent dynamics, for the lockstep propagation of an ensemble of samples (e.g. Monte Carlo analysis)
+/*!
+ *  Model of the lunar ascent dynamics, for the lockstep propagation of an ensemble of samples by an EnsemblePropagator. The
+ *  dynamics are the same as those of the nominal ascent: point mass gravity of the Moon, and the thrust defined by the thrust
+ *  parameters of LunarAscentThrustGuidance (constant thrust magnitude, and thrust angle in the vertical frame interpolated
+ *  linearly between equispaced nodes, with the boundary value beyond the nodes) at a constant specific impulse. The vertical
+ *  frame is defined by the rotation axis of the Moon, which is taken constant in the inertial frame over the ascent. The
+ *  termination conditions are those of the nominal ascent (termination altitude, zero altitude, dry mass and maximum
+ *  duration), checked after each step.
+ *
+ *  The state of each sample consists of the inertial Cartesian state w.r.t. the Moon, and the vehicle mass. The parameters
+ *  of each sample are the thrust parameters of LunarAscentThrustGuidance (thrust magnitude, node spacing and thrust angles),
+ *  followed by the specific impulse.
+ */
+class LunarAscentEnsembleModel
+{
+public:
+
+    //! Constructor
+    /*!
+     *  Constructor
+     *  \param gravitationalParameter Gravitational parameter of the Moon
+     *  \param moonRadius Radius of the Moon (w.r.t. which the altitude is computed)
+     *  \param rotationAxis Direction of the rotation axis of the Moon, in the inertial frame
+     *  \param initialTime Time of the first thrust angle node
+     *  \param numberOfThrustAngleNodes Number of thrust angle nodes
+     *  \param terminationAltitude Altitude at which a sample is terminated
+     *  \param dryMass Mass below which a sample is terminated
+     *  \param maximumDuration Duration (w.r.t. initial time) after which a sample is terminated
+     */
+    LunarAscentEnsembleModel( const double gravitationalParameter,
+                              const double moonRadius,
+                              const Eigen::Vector3d& rotationAxis,
+                              const double initialTime,
+                              const int numberOfThrustAngleNodes,
+                              const double terminationAltitude,
+                              const double dryMass,
+                              const double maximumDuration );
+
+    //! Function to retrieve the number of state entries per sample (Cartesian state and mass)
+    int getStateSize( ) const
+    {
+        return 7;
+    }
+
+    //! Function to retrieve the number of parameters per sample (thrust parameters and specific impulse)
+    int getNumberOfParameters( ) const
+    {
+        return numberOfThrustAngleNodes_ + 3;
+    }
+
+    //! Function to compute the state derivatives of a block of samples
+    /*!
+     *  Function to compute the state derivatives of a block of samples
+     *  \param time Current time
+     *  \param states Current states of the samples (one column per sample)
+     *  \param parameters Parameters of the samples (one column per sample)
+     *  \param stateDerivatives State derivatives of the samples (returned by reference)
+     */
+    void computeStateDerivatives( const double time,
+                                  const Eigen::Ref< const EnsembleMatrix >& states,
+                                  const Eigen::Ref< const EnsembleMatrix >& parameters,
+                                  Eigen::Ref< EnsembleMatrix > stateDerivatives ) const;
+
+    //! Function to determine which samples of a block meet a termination condition
+    /*!
+     *  Function to determine which samples of a block meet a termination condition
+     *  \param time Current time
+     *  \param states Current states of the samples (one column per sample)
+     *  \param parameters Parameters of the samples (one column per sample)
+     *  \param isTerminated Boolean for each sample denoting whether it meets a termination condition (returned by reference)
+     */
+    void computeTerminationFlags( const double time,
+                                  const Eigen::Ref< const EnsembleMatrix >& states,
+                                  const Eigen::Ref< const EnsembleMatrix >& parameters,
+                                  Eigen::Array< bool, Eigen::Dynamic, 1 >& isTerminated ) const;
+
+private:
+
+    //! Gravitational parameter of the Moon
+    double gravitationalParameter_;
+
+    //! Radius of the Moon
+    double moonRadius_;
+
+    //! Unit vector along rotation axis of the Moon, in the inertial frame
+    Eigen::Vector3d rotationAxis_;
+
+    //! Time of the first thrust angle node
+    double initialTime_;
+
+    //! Number of thrust angle nodes
+    int numberOfThrustAngleNodes_;
+
+    //! Altitude at which a sample is terminated
+    double terminationAltitude_;
+
+    //! Mass below which a sample is terminated
+    double dryMass_;
+
+    //! Duration (w.r.t. initial time) after which a sample is terminated
+    double maximumDuration_;
+};
+
+} // namespace tudat_applications
+
+#endif // TUDAT_LUNARASCENTENSEMBLE_H
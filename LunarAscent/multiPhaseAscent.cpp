@@ -0,0 +1,150 @@
+/*    Copyright (c) 2010-2018, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#include <stdexcept>
+
+#include "multiPhaseAscent.h"
+
+namespace tudat_applications
+{
+
+//! Constructor
+MultiPhaseAscentPropagator::MultiPhaseAscentPropagator(
+        const tudat::simulation_setup::NamedBodyMap& bodyMap,
+        const std::string& vehicleName,
+        const std::string& centralBodyName,
+        const std::vector< AscentPhaseSettings >& phaseSettings,
+        const std::vector< std::shared_ptr< tudat::propagators::PropagationTerminationSettings > >&
+        sequenceTerminationSettings,
+        const std::shared_ptr< tudat::propagators::DependentVariableSaveSettings > dependentVariablesToSave ):
+    bodyMap_( bodyMap ), phaseSettings_( phaseSettings )
+{
+    using namespace tudat::propagators;
+    using namespace tudat::simulation_setup;
+
+    if( phaseSettings_.size( ) == 0 )
+    {
+        throw std::runtime_error( "Error when creating multi-phase ascent, no phases provided" );
+    }
+
+    std::vector< std::string > bodiesToPropagate = { vehicleName };
+    std::vector< std::string > centralBodies = { centralBodyName };
+    for( unsigned int i = 0; i < phaseSettings_.size( ); i++ )
+    {
+        // Create acceleration models of phase
+        SelectedAccelerationMap accelerationMap;
+        accelerationMap[ vehicleName ] = phaseSettings_.at( i ).accelerationSettings;
+        tudat::basic_astrodynamics::AccelerationMap accelerationModelMap = createAccelerationModelsMap(
+                    bodyMap_, accelerationMap, bodiesToPropagate, centralBodies );
+
+        // Create mass rate model of phase (from thrust if engine is on, zero otherwise)
+        bool isEngineOn = false;
+        for( const auto& accelerationIterator : phaseSettings_.at( i ).accelerationSettings )
+        {
+            for( unsigned int j = 0; j < accelerationIterator.second.size( ); j++ )
+            {
+                if( accelerationIterator.second.at( j )->accelerationType_ == tudat::basic_astrodynamics::thrust_acceleration )
+                {
+                    isEngineOn = true;
+                }
+            }
+        }
+        std::shared_ptr< MassRateModelSettings > massRateModelSettings;
+        if( isEngineOn )
+        {
+            massRateModelSettings = std::make_shared< FromThrustMassModelSettings >( 1 );
+        }
+        else
+        {
+            massRateModelSettings = std::make_shared< CustomMassRateModelSettings >( [ ]( const double ){ return 0.0; } );
+        }
+        std::map< std::string, std::shared_ptr< tudat::basic_astrodynamics::MassRateModel > > massRateModels;
+        massRateModels[ vehicleName ] = createMassRateModel(
+                    vehicleName, massRateModelSettings, bodyMap_, accelerationModelMap );
+
+        // Terminate phase on its own event (first condition), or on any of the sequence termination conditions
+        std::vector< std::shared_ptr< PropagationTerminationSettings > > terminationSettingsList =
+        { phaseSettings_.at( i ).phaseTerminationSettings };
+        terminationSettingsList.insert( terminationSettingsList.end( ), sequenceTerminationSettings.begin( ),
+                                        sequenceTerminationSettings.end( ) );
+        std::shared_ptr< PropagationTerminationSettings > terminationSettings =
+                std::make_shared< PropagationHybridTerminationSettings >( terminationSettingsList, true );
+
+        // Create propagator settings of phase (initial state is reset at the start of each phase)
+        std::vector< std::shared_ptr< SingleArcPropagatorSettings< double > > > propagatorSettingsVector =
+        { std::make_shared< TranslationalStatePropagatorSettings< double > >(
+          centralBodies, accelerationModelMap, bodiesToPropagate, Eigen::VectorXd::Zero( 6 ), terminationSettings, cowell ),
+          std::make_shared< MassPropagatorSettings< double > >(
+          bodiesToPropagate, massRateModels, Eigen::VectorXd::Zero( 1 ), terminationSettings ) };
+        phasePropagatorSettings_.push_back( std::make_shared< MultiTypePropagatorSettings< double > >(
+                                                propagatorSettingsVector, terminationSettings, dependentVariablesToSave ) );
+    }
+}
+
+//! Function to propagate the sequence of phases
+int MultiPhaseAscentPropagator::propagate(
+        const Eigen::Vector6d& initialState, const double initialMass, const double initialTime )
+{
+    using namespace tudat::propagators;
+
+    stateHistory_.clear( );
+    dependentVariableHistory_.clear( );
+    phaseStartTimes_.clear( );
+
+    double currentTime = initialTime;
+    Eigen::VectorXd currentState = ( Eigen::VectorXd( 7 ) << initialState, initialMass ).finished( );
+    for( unsigned int i = 0; i < phaseSettings_.size( ); i++ )
+    {
+        phaseStartTimes_.push_back( std::make_pair( currentTime, phaseSettings_.at( i ).phaseName ) );
+
+        // Propagate phase from end of previous phase
+        std::shared_ptr< tudat::numerical_integrators::IntegratorSettings< > > integratorSettings =
+                phaseSettings_.at( i ).integratorSettings;
+        integratorSettings->initialTime_ = currentTime;
+        phasePropagatorSettings_.at( i )->resetInitialStates( currentState );
+        SingleArcDynamicsSimulator< > dynamicsSimulator( bodyMap_, integratorSettings, phasePropagatorSettings_.at( i ) );
+
+        // Add phase results to history (at the phase boundary, the start of the next phase takes precedence)
+        const std::map< double, Eigen::VectorXd >& phaseStateHistory =
+                dynamicsSimulator.getEquationsOfMotionNumericalSolution( );
+        const std::map< double, Eigen::VectorXd >& phaseDependentVariableHistory =
+                dynamicsSimulator.getDependentVariableHistory( );
+        stateHistory_.insert( phaseStateHistory.begin( ), phaseStateHistory.end( ) );
+        stateHistory_[ phaseStateHistory.begin( )->first ] = phaseStateHistory.begin( )->second;
+        for( const auto& dependentVariableIterator : phaseDependentVariableHistory )
+        {
+            dependentVariableHistory_[ dependentVariableIterator.first ] = dependentVariableIterator.second;
+        }
+        currentTime = phaseStateHistory.rbegin( )->first;
+        currentState = phaseStateHistory.rbegin( )->second;
+
+        // Continue with next phase only if the phase ended on its own event, and not on a sequence termination condition
+        std::shared_ptr< PropagationTerminationDetails > terminationDetails =
+                dynamicsSimulator.getPropagationTerminationReason( );
+        if( terminationDetails->getPropagationTerminationReason( ) != termination_condition_reached )
+        {
+            throw std::runtime_error( "Error when propagating multi-phase ascent, propagation of phase " +
+                                      phaseSettings_.at( i ).phaseName + " failed" );
+        }
+        std::vector< bool > wasConditionMet = std::dynamic_pointer_cast< PropagationTerminationDetailsFromHybridCondition >(
+                    terminationDetails )->getWasConditionMetWhenStopping( );
+        for( unsigned int j = 1; j < wasConditionMet.size( ); j++ )
+        {
+            if( wasConditionMet.at( j ) )
+            {
+                return i + 1;
+            }
+        }
+    }
+
+    return phaseSettings_.size( );
+}
+
+} // namespace tudat_applications
@@ -0,0 +1,160 @@
+/*    Copyright (c) 2010-2018, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_MULTIPHASEASCENT_H
+#define TUDAT_MULTIPHASEASCENT_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <Tudat/SimulationSetup/tudatSimulationHeader.h>
+
+namespace tudat_applications
+{
+
+//! Struct defining a single phase of a multi-phase ascent (e.g. vertical rise, pitch-over, coast, circularization)
+struct AscentPhaseSettings
+{
+    //! Constructor
+    /*!
+     *  Constructor
+     *  \param phaseName Name of the phase
+     *  \param accelerationSettings Accelerations acting on the vehicle during the phase (including the thrust acceleration,
+     *  with the guidance of the phase, if the engine is on; the vehicle mass is kept constant if there is none)
+     *  \param integratorSettings Integrator settings of the phase (initial time is set at the start of the phase)
+     *  \param phaseTerminationSettings Event at which the phase ends, and the next phase starts (should be set to terminate
+     *  exactly on the final condition, so that the event is located by the root finder)
+     */
+    AscentPhaseSettings(
+            const std::string& phaseName,
+            const std::map< std::string, std::vector< std::shared_ptr< tudat::simulation_setup::AccelerationSettings > > >&
+            accelerationSettings,
+            const std::shared_ptr< tudat::numerical_integrators::IntegratorSettings< > > integratorSettings,
+            const std::shared_ptr< tudat::propagators::PropagationTerminationSettings > phaseTerminationSettings ):
+        phaseName( phaseName ), accelerationSettings( accelerationSettings ), integratorSettings( integratorSettings ),
+        phaseTerminationSettings( phaseTerminationSettings ){ }
+
+    //! Name of the phase
+    std::string phaseName;
+
+    //! Accelerations acting on the vehicle during the phase (key: body exerting acceleration)
+    std::map< std::string, std::vector< std::shared_ptr< tudat::simulation_setup::AccelerationSettings > > >
+    accelerationSettings;
+
+    //! Integrator settings of the phase
+    std::shared_ptr< tudat::numerical_integrators::IntegratorSettings< > > integratorSettings;
+
+    //! Event at which the phase ends
+    std::shared_ptr< tudat::propagators::PropagationTerminationSettings > phaseTerminationSettings;
+};
+
+//! Class for the propagation of an ascent trajectory as a sequence of phases, switched at events
+/*!
+ *  Class for the propagation of an ascent trajectory (translational state and mass of the vehicle) as a sequence of phases,
+ *  each with its own accelerations (and thrust guidance), integrator settings and terminating event. Each phase starts from
+ *  the state at the (located) terminating event of the previous phase, so that coast phases can be propagated with much larger
+ *  time steps than the thrust phases. In addition to its own event, each phase is terminated by a set of conditions common to
+ *  all phases (e.g. maximum time, impact, dry mass), on which the propagation of the full sequence stops.
+ *
+ *  The acceleration models, mass rate models and propagator settings of all phases are created once, in the constructor, and
+ *  reused in each call to propagate (e.g. for different initial states, or for different guidance parameters, when the
+ *  guidance objects used in the acceleration settings are modified between calls).
+ */
+class MultiPhaseAscentPropagator
+{
+public:
+
+    //! Constructor
+    /*!
+     *  Constructor
+     *  \param bodyMap List of body objects
+     *  \param vehicleName Name of the ascent vehicle
+     *  \param centralBodyName Name of central body of propagation
+     *  \param phaseSettings Settings of the phases, in order of propagation
+     *  \param sequenceTerminationSettings Conditions on which the propagation of the full sequence stops
+     *  \param dependentVariablesToSave Dependent variables that are saved during the propagation
+     */
+    MultiPhaseAscentPropagator(
+            const tudat::simulation_setup::NamedBodyMap& bodyMap,
+            const std::string& vehicleName,
+            const std::string& centralBodyName,
+            const std::vector< AscentPhaseSettings >& phaseSettings,
+            const std::vector< std::shared_ptr< tudat::propagators::PropagationTerminationSettings > >&
+            sequenceTerminationSettings,
+            const std::shared_ptr< tudat::propagators::DependentVariableSaveSettings > dependentVariablesToSave = nullptr );
+
+    //! Function to propagate the sequence of phases
+    /*!
+     *  Function to propagate the sequence of phases, until the terminating event of the last phase, or until one of the
+     *  sequence termination conditions is met.
+     *  \param initialState Initial Cartesian state of the vehicle, in the global (inertial) frame
+     *  \param initialMass Initial mass of the vehicle
+     *  \param initialTime Initial time of the propagation
+     *  \return Number of phases that was (fully or partially) propagated
+     */
+    int propagate( const Eigen::Vector6d& initialState, const double initialMass, const double initialTime );
+
+    //! Function to retrieve the state history (Cartesian state and mass) of the last propagation
+    const std::map< double, Eigen::VectorXd >& getStateHistory( ) const
+    {
+        return stateHistory_;
+    }
+
+    //! Function to retrieve the dependent variable history of the last propagation
+    const std::map< double, Eigen::VectorXd >& getDependentVariableHistory( ) const
+    {
+        return dependentVariableHistory_;
+    }
+
+    //! Function to retrieve the start time and name of each propagated phase of the last propagation
+    const std::vector< std::pair< double, std::string > >& getPhaseStartTimes( ) const
+    {
+        return phaseStartTimes_;
+    }
+
+    //! Function to move the state history of the last propagation out of the propagator (which is left empty)
+    std::map< double, Eigen::VectorXd > releaseStateHistory( )
+    {
+        return std::move( stateHistory_ );
+    }
+
+    //! Function to move the dependent variable history of the last propagation out of the propagator (which is left empty)
+    std::map< double, Eigen::VectorXd > releaseDependentVariableHistory( )
+    {
+        return std::move( dependentVariableHistory_ );
+    }
+
+private:
+
+    //! List of body objects
+    tudat::simulation_setup::NamedBodyMap bodyMap_;
+
+    //! Settings of the phases
+    std::vector< AscentPhaseSettings > phaseSettings_;
+
+    //! Propagator settings (translational state and mass) of each phase
+    std::vector< std::shared_ptr< tudat::propagators::MultiTypePropagatorSettings< double > > > phasePropagatorSettings_;
+
+    //! State history (Cartesian state and mass) of the last propagation
+    std::map< double, Eigen::VectorXd > stateHistory_;
+
+    //! Dependent variable history of the last propagation
+    std::map< double, Eigen::VectorXd > dependentVariableHistory_;
+
+    //! Start time and name of each propagated phase of the last propagation
+    std::vector< std::pair< double, std::string > > phaseStartTimes_;
+};
+
+} // namespace tudat_applications
+
+#endif // TUDAT_MULTIPHASEASCENT_H
@@ -8,12 +8,24 @@
  *    http://tudat.tudelft.nl/LICENSE.
  */
 
+#include <chrono>
+#include <random>
+
 #include <Tudat/Astrodynamics/Aerodynamics/hypersonicLocalInclinationAnalysis.h>
 #include <Tudat/Mathematics/GeometricShapes/capsule.h>
 #include <Tudat/Mathematics/Statistics/randomVariableGenerator.h>
 #include <Tudat/SimulationSetup/tudatSimulationHeader.h>
 
 #include "../applicationOutput.h"
+#include "../guidanceAdapters.h"
+#include "../parallelExecution.h"
+#include "ascentPrefixCache.h"
+#include "indirectAscentOptimization.h"
+#include "launchSiteAvailability.h"
+#include "lunarAscent.h"
+#include "lunarAscentEnsemble.h"
+#include "multiPhaseAscent.h"
+#include "tiledDigitalElevationModel.h"
 
 using namespace tudat::ephemerides;
 using namespace tudat::interpolators;
@@ -30,95 +42,39 @@ using namespace tudat::mathematical_constants;
 using namespace tudat::reference_frames;
 using namespace tudat;
 
+//! Create body map for the lunar ascent, which can be used in a propagation that runs concurrently with others
 /*!
- *  Class to compute the thrust direction and magnitude for the lunar ascent vehicle. The current inputs set a
- *  constant thrust magnitude, and a thrust direction in y-(-z) plane of the vertical frame define linearly in time using
- *  equispaced nodes. These settings are to be modified for the assignment.
+ *  Create body map for the lunar ascent (Moon and vehicle), which can be used in a propagation that runs concurrently with
+ *  others. The ephemeris of the Moon is replaced by a constant state, and its rotation model by a uniform rotation that is
+ *  initialized from Spice when the body map is created, so that the body map does not use Spice during the propagation
+ *  (Spice is not thread-safe).
  */
-class LunarAscentThrustGuidance
+NamedBodyMap getConcurrentLunarAscentBodyMap(
+        const double initialTime,
+        const double vehicleMass,
+        const std::shared_ptr< BodyShapeModel > moonShapeModel = nullptr )
 {
-public:
-
-    //! Contructor
-    /*!
-     * Contructor
-     * \param vehicleBody Body object for the ascent vehicle
-     * \param initialTime Start time of the propagatiin
-     * \param parameterVector Vector of independent variables to be used for thrust parameterization:
-     *   - Entry 0: Constant thrust magnitude
-     *   - Entry 1: Constant spacing in time between nodes
-     *   - Entry 2-6: Thrust angle theta, at five nodes
-     */
-    LunarAscentThrustGuidance(
-            const std::shared_ptr< Body > vehicleBody,
-            const double initialTime,
-            const std::vector< double > parameterVector ):
-        vehicleBody_( vehicleBody ),
-        parameterVector_( parameterVector )
-    {
-        // Retrieve parameters of thrust profile
-        thrustMagnitude_ = parameterVector_.at( 0 );
-        timeInterval_ = parameterVector_.at( 1 );
-
-        // Create interpolator for thrust angle
-        double currentTime = initialTime;
-        for( unsigned int i = 0; i < parameterVector_.size( ) - 2; i++ )
-        {
-            thrustAngleMap_[ currentTime ] = parameterVector_.at( i + 2 );
-            currentTime += timeInterval_;
-        }
-        thrustAngleInterpolator_ = createOneDimensionalInterpolator(
-                    thrustAngleMap_, std::make_shared< InterpolatorSettings >(
-                        linear_interpolator, huntingAlgorithm, false, use_boundary_value ) );
-    }
-
-    //! Function that computes the inertial thrust direction for each state derivative function evaluation
-    Eigen::Vector3d getCurrentThrustDirection( const double currentTime )
-    {
-        // Retrieve thrust angle
-        double currentThrustAngle = thrustAngleInterpolator_->interpolate( currentTime );
-
-        // Set thrust in V-frame
-        Eigen::Vector3d thrustDirectionInVerticalFrame =
-                ( Eigen::Vector3d( ) << 0.0, std::sin( currentThrustAngle ), -std::cos( currentThrustAngle ) ).finished( );
-
-        // Retrieve rotation from V-frame to inertial frame
-        Eigen::Quaterniond verticalToInertialFrame =
-                vehicleBody_->getFlightConditions( )->getAerodynamicAngleCalculator( )->getRotationQuaternionBetweenFrames(
-                    vertical_frame, inertial_frame );
-
-        // Return thrust direction
-        return verticalToInertialFrame * thrustDirectionInVerticalFrame;
-
-    }
+    std::map< std::string, std::shared_ptr< BodySettings > > bodySettings =
+            getDefaultBodySettings( std::vector< std::string >{ "Moon" } );
+    bodySettings[ "Moon" ]->ephemerisSettings = std::make_shared< ConstantEphemerisSettings >(
+                Eigen::Vector6d::Zero( ), "SSB", "ECLIPJ2000" );
+    bodySettings[ "Moon" ]->rotationModelSettings = std::make_shared< SimpleRotationModelSettings >(
+                "ECLIPJ2000", "IAU_Moon",
+                spice_interface::computeRotationQuaternionBetweenFrames( "ECLIPJ2000", "IAU_Moon", initialTime ),
+                initialTime, spice_interface::getAngularVelocityVectorOfFrameInOriginalFrame(
+                    "ECLIPJ2000", "IAU_Moon", initialTime ).norm( ) );
 
-    //! Function that computes the thrust magnitude for each state derivative function evaluation
-    double getCurrentThrustMagnitude( const double currentTime )
+    NamedBodyMap bodyMap = createBodies( bodySettings );
+    if( moonShapeModel != nullptr )
     {
-        return thrustMagnitude_;
+        bodyMap.at( "Moon" )->setShapeModel( moonShapeModel );
     }
+    bodyMap[ "Vehicle" ] = std::make_shared< simulation_setup::Body >( );
+    bodyMap[ "Vehicle" ]->setConstantBodyMass( vehicleMass );
+    setGlobalFrameBodyEphemerides( bodyMap, "Moon", "ECLIPJ2000" );
 
-private:
-
-    //! Object containing properties of the vehicle
-    std::shared_ptr< Body > vehicleBody_;
-
-    //! Parameter containing the solution parameter vector
-    std::vector< double > parameterVector_;
-
-    //! Map containing the thrust (value) as a function of time (key)
-    std::map< double, double > thrustAngleMap_;
-
-    //! Object that interpolates the thrust as a function of time
-    std::shared_ptr< OneDimensionalInterpolator< double, double > > thrustAngleInterpolator_;
-
-    //! Constant time between thrust angle nodes
-    double timeInterval_;
-
-    //! Constant magnitude of the thrust
-    double thrustMagnitude_;
-
-};
+    return bodyMap;
+}
 
 /*!
  *   This function computes the dynamics of a lunar ascent vehicle, starting at zero velocity on the Moon's surface. The only
@@ -137,10 +93,43 @@ private:
  *   - Propagation time > 3600 s
  *   - Vehicle mass < 1000 kg
  *
+ *   Optionally (useMultiPhaseAscent), the ascent is also propagated as a sequence of phases: a vertical rise, the pitch-over
+ *   using the thrust angle nodes, a coast to apolune (using a variable step size integrator), and a circularization burn. Each
+ *   phase has its own thrust guidance and integrator settings, and ends at an event that is located exactly (by a root
+ *   finder), from which the next phase starts. The acceleration models of all phases are created once.
+ *
+ *   Optionally (useDigitalElevationModel), the altitude is computed w.r.t. a tiled digital elevation model of the lunar
+ *   surface, so that the termination on zero altitude checks the clearance w.r.t. the terrain.
+ *
+ *   Optionally (propagateMonteCarloEnsemble), an ensemble of samples with dispersed thrust parameters and specific impulse is
+ *   propagated in lockstep (all samples advanced together, with vectorized evaluation of the dynamics on structure-of-arrays
+ *   storage, and terminated samples removed from the active set), using the same dynamics and termination conditions.
+ *
+ *   Optionally (computeIndirectAscentReference), the minimum-time ascent to a circular orbit at the termination altitude is
+ *   computed by an indirect method (shooting on the initial costates, with homotopy from uniform to point mass gravity), from
+ *   many random initial guesses solved concurrently. Its thrust angle history is the reference for the thrust angle nodes.
+ *
+ *   Optionally (computeLaunchSiteAvailability), a map of the achievable performance (propellant margin when reaching the
+ *   termination altitude on an orbit with periapsis above the surface) is computed over a grid of launch latitudes,
+ *   longitudes and epochs. In each cell, the thrust angles are optimized locally, starting from the optimum of the
+ *   neighbouring cell. The cells are distributed over all threads, each with its own body map. The ascents are propagated
+ *   in segments between the thrust angle nodes, and the states at the nodes are cached, so that candidates that share the
+ *   thrust magnitude and first thrust angles with an earlier candidate resume from the deepest shared node.
+ *
+ *   Optionally (benchmarkGuidanceCalls), the cost per call of the thrust guidance functions is measured. The thrust guidance
+ *   is passed to the thrust acceleration through templated adapters (guidanceAdapters.h), which call the guidance member
+ *   functions directly, so that they can be inlined; the benchmark compares these to the std::bind functions they replace.
+ *
  *   Key outputs:
  *
  *   propagatedStateHistory Numerically propagated Cartesian state
  *   dependentVariableHistory Dependent variables saved during the state propagation of the ascent *
+ *   multiPhaseStateHistory/multiPhaseDependentVariables Same as above, for the multi-phase ascent (if used)
+ *   ascentPhaseStartTimes Start time of each phase of the multi-phase ascent (if used)
+ *   monteCarloEnsembleFinalStates Final time, state and mass of each sample of the ensemble (if propagated)
+ *   indirectAscentReference State, mass and thrust angle of the indirect minimum-time ascent (if computed)
+ *   launchSiteAvailability Binary raster of the achievable performance per launch site and epoch (if computed)
+ *   launchSiteGuidanceParameters Optimized thrust parameters per launch site and epoch (if computed)
  *
  *   Input parameters:
  *
@@ -171,6 +160,63 @@ int main( )
     double maximumDuration = 86400.0;
     double terminationAltitude = 100.0E3;
 
+    // Set whether the ascent is also propagated as a sequence of phases (vertical rise, pitch-over using the thrust angle
+    // nodes, coast to apolune and circularization burn), each with its own guidance and integrator settings, where each phase
+    // ends at a located event: vertical rise altitude reached, semi-major axis of transfer orbit (from insertion altitude to
+    // termination altitude) reached, apolune (flight path angle zero), and circular orbit (eccentricity below threshold)
+    bool useMultiPhaseAscent = false;
+    double verticalRiseAltitude = 500.0;
+    double insertionAltitude = 15.0E3;
+    double circularizationEccentricity = 1.0E-3;
+
+    // Set whether the altitude (and termination on altitude) is computed w.r.t. a digital elevation model of the lunar
+    // surface instead of the mean-radius sphere. The heights are read from tiles (numberOfLatitudeTiles in latitude, twice as
+    // many in longitude), as written by writeDigitalElevationModelTiles, of which only those under the trajectory are mapped
+    bool useDigitalElevationModel = false;
+    std::string digitalElevationModelDirectory = std::string( __FILE__ ).substr(
+                0, std::string( __FILE__ ).find_last_of( "/\\" ) + 1 ) + "DigitalElevationModel/";
+    int numberOfLatitudeTiles = 180;
+    std::shared_ptr< tudat_applications::TiledDigitalElevationModel > digitalElevationModel;
+    if( useDigitalElevationModel )
+    {
+        digitalElevationModel = std::make_shared< tudat_applications::TiledDigitalElevationModel >(
+                    digitalElevationModelDirectory, spice_interface::getAverageRadius( "Moon" ), numberOfLatitudeTiles );
+    }
+
+    // Set whether an ensemble of samples is propagated, with normally distributed relative errors in thrust magnitude and
+    // specific impulse, and absolute errors in the thrust angles (standard deviations given below)
+    bool propagateMonteCarloEnsemble = false;
+    int numberOfEnsembleSamples = 10000;
+    double thrustMagnitudeDispersion = 0.01;
+    double specificImpulseDispersion = 0.01;
+    double thrustAngleDispersion = unit_conversions::convertDegreesToRadians( 1.0 );
+
+    // Set whether the minimum-time ascent (same thrust and specific impulse as the thrust parameters) to a circular orbit at
+    // the termination altitude is computed by an indirect method, from the given number of random initial guesses
+    bool computeIndirectAscentReference = false;
+    int numberOfIndirectAscentStarts = 64;
+
+    // Set whether the map of achievable performance is computed over a grid of launch sites (latitudes and longitudes over
+    // the full surface, with latitudes at the centres of equal latitude bands so that the poles, at which all longitudes
+    // coincide, are not evaluated repeatedly) and launch epochs (at a given spacing from the initial time), with at most the
+    // given number of propagations to optimize the thrust angles of each launch site
+    bool computeLaunchSiteAvailability = false;
+    int numberOfLaunchLatitudes = 36;
+    int numberOfLaunchLongitudes = 72;
+    int numberOfLaunchEpochs = 1;
+    double launchEpochSpacing = 7.0 * physical_constants::JULIAN_DAY;
+    int maximumNumberOfEvaluationsPerLaunchSite = 50;
+
+    // Set maximum number of states at thrust angle nodes that is stored (per thread) when evaluating many candidates, so that
+    // candidates that differ only in later nodes (e.g. in a coordinate-wise search) are resumed from the deepest stored node
+    // instead of being propagated from the start (no states are stored if zero)
+    unsigned int maximumNumberOfAscentCheckpoints = 100000;
+
+    // Set whether the cost per call of the thrust guidance functions is measured (after the propagation), both through a
+    // std::bind to the guidance member functions and through the guidance adapters (used for the propagation)
+    bool benchmarkGuidanceCalls = false;
+    int numberOfBenchmarkGuidanceCalls = 10000000;
+
     // Define initial spherical elements for vehicle.
     Eigen::Vector6d ascentVehicleSphericalEntryState;
     ascentVehicleSphericalEntryState( SphericalOrbitalStateElementIndices::radiusIndex ) =
@@ -179,6 +225,13 @@ int main( )
             unit_conversions::convertDegreesToRadians( 0.6875 );
     ascentVehicleSphericalEntryState( SphericalOrbitalStateElementIndices::longitudeIndex ) =
             unit_conversions::convertDegreesToRadians( 23.4333 );
+    if( digitalElevationModel != nullptr )
+    {
+        ascentVehicleSphericalEntryState( SphericalOrbitalStateElementIndices::radiusIndex ) +=
+                digitalElevationModel->getTerrainHeight(
+                    ascentVehicleSphericalEntryState( SphericalOrbitalStateElementIndices::latitudeIndex ),
+                    ascentVehicleSphericalEntryState( SphericalOrbitalStateElementIndices::longitudeIndex ) );
+    }
     ascentVehicleSphericalEntryState( SphericalOrbitalStateElementIndices::speedIndex ) = 0.0;
     ascentVehicleSphericalEntryState( SphericalOrbitalStateElementIndices::flightPathIndex ) =
             unit_conversions::convertDegreesToRadians( 90.0 );
@@ -204,6 +257,10 @@ int main( )
     std::map< std::string, std::shared_ptr< BodySettings > > bodySettings =
             getDefaultBodySettings( bodiesToCreate );
     NamedBodyMap bodyMap = createBodies( bodySettings );
+    if( digitalElevationModel != nullptr )
+    {
+        bodyMap.at( "Moon" )->setShapeModel( digitalElevationModel );
+    }
 
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     ///////////////////////             CREATE VEHICLE            /////////////////////////////////////////////////////////
@@ -222,13 +279,13 @@ int main( )
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
     // Define thrust functions
-    std::shared_ptr< LunarAscentThrustGuidance > thrustGuidance =
-            std::make_shared< LunarAscentThrustGuidance >(
+    std::shared_ptr< tudat_applications::LunarAscentThrustGuidance > thrustGuidance =
+            std::make_shared< tudat_applications::LunarAscentThrustGuidance >(
                 bodyMap.at( "Vehicle" ), initialTime, thrustParameters );
     std::function< Eigen::Vector3d( const double ) > thrustDirectionFunction =
-            std::bind( &LunarAscentThrustGuidance::getCurrentThrustDirection, thrustGuidance, std::placeholders::_1 );
+            tudat_applications::createThrustDirectionFunction( thrustGuidance );
     std::function< double( const double ) > thrustMagnitudeFunction =
-            std::bind( &LunarAscentThrustGuidance::getCurrentThrustMagnitude, thrustGuidance, std::placeholders::_1 );
+            tudat_applications::createThrustMagnitudeFunction( thrustGuidance );
 
     std::shared_ptr< ThrustDirectionGuidanceSettings > thrustDirectionGuidanceSettings =
             std::make_shared< CustomThrustDirectionSettings >( thrustDirectionFunction );
@@ -334,14 +391,360 @@ int main( )
     SingleArcDynamicsSimulator< > dynamicsSimulator(
                 bodyMap, integratorSettings, propagatorSettings );
 
-    std::map< double, Eigen::VectorXd > propagatedStateHistory = dynamicsSimulator.getEquationsOfMotionNumericalSolution( );
-    std::map< double, Eigen::VectorXd > dependentVariableHistory = dynamicsSimulator.getDependentVariableHistory( );
+    const std::map< double, Eigen::VectorXd >& propagatedStateHistory =
+            dynamicsSimulator.getEquationsOfMotionNumericalSolution( );
+    const std::map< double, Eigen::VectorXd >& dependentVariableHistory = dynamicsSimulator.getDependentVariableHistory( );
 
     input_output::writeDataMapToTextFile( propagatedStateHistory, "stateHistory.dat", outputPath );
     input_output::writeDataMapToTextFile( dependentVariableHistory, "dependentVariables.dat", outputPath );
     input_output::writeMatrixToFile( utilities::convertStlVectorToEigenVector(
                                          thrustParameters ), "thrustParameters.dat", 16, outputPath );
 
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ///////////////////////             BENCHMARK GUIDANCE CALLS            ///////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    if( benchmarkGuidanceCalls )
+    {
+        // Create guidance functions in the same manner as before the guidance adapters were used
+        std::function< Eigen::Vector3d( const double ) > boundThrustDirectionFunction =
+                std::bind( &tudat_applications::LunarAscentThrustGuidance::getCurrentThrustDirection, thrustGuidance,
+                           std::placeholders::_1 );
+        std::function< double( const double ) > boundThrustMagnitudeFunction =
+                std::bind( &tudat_applications::LunarAscentThrustGuidance::getCurrentThrustMagnitude, thrustGuidance,
+                           std::placeholders::_1 );
+
+        // Call guidance functions over the propagated time interval (environment is at the final propagated state)
+        double benchmarkTimeStep = ( propagatedStateHistory.rbegin( )->first - initialTime ) /
+                static_cast< double >( numberOfBenchmarkGuidanceCalls );
+        Eigen::Vector3d thrustDirectionSum = Eigen::Vector3d::Zero( );
+        double thrustMagnitudeSum = 0.0;
+        std::map< std::string, double > averageCallTimes;
+        averageCallTimes[ "Thrust direction (bind)" ] = tudat_applications::computeAverageCallTime(
+                    [ & ]( const double time ){ thrustDirectionSum += boundThrustDirectionFunction( time ); },
+                    numberOfBenchmarkGuidanceCalls, initialTime, benchmarkTimeStep );
+        averageCallTimes[ "Thrust direction (adapter)" ] = tudat_applications::computeAverageCallTime(
+                    [ & ]( const double time ){ thrustDirectionSum += thrustDirectionFunction( time ); },
+                    numberOfBenchmarkGuidanceCalls, initialTime, benchmarkTimeStep );
+        averageCallTimes[ "Thrust magnitude (bind)" ] = tudat_applications::computeAverageCallTime(
+                    [ & ]( const double time ){ thrustMagnitudeSum += boundThrustMagnitudeFunction( time ); },
+                    numberOfBenchmarkGuidanceCalls, initialTime, benchmarkTimeStep );
+        averageCallTimes[ "Thrust magnitude (adapter)" ] = tudat_applications::computeAverageCallTime(
+                    [ & ]( const double time ){ thrustMagnitudeSum += thrustMagnitudeFunction( time ); },
+                    numberOfBenchmarkGuidanceCalls, initialTime, benchmarkTimeStep );
+
+        for( const auto& callTimeIterator : averageCallTimes )
+        {
+            std::cout << callTimeIterator.first << ": " << callTimeIterator.second << " ns per call" << std::endl;
+        }
+        std::cout << "(checksum " << thrustDirectionSum.norm( ) + thrustMagnitudeSum << ")" << std::endl;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ///////////////////////             PROPAGATE MULTI-PHASE ASCENT            ///////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    if( useMultiPhaseAscent )
+    {
+        double moonRadius = spice_interface::getAverageRadius( "Moon" );
+        std::shared_ptr< root_finders::RootFinderSettings > eventRootFinderSettings =
+                std::make_shared< root_finders::RootFinderSettings >( root_finders::bisection_root_finder, 1.0E-6, 100 );
+        std::shared_ptr< SingleDependentVariableSaveSettings > semiMajorAxisSettings =
+                std::make_shared< SingleDependentVariableSaveSettings >(
+                    keplerian_state_dependent_variable, "Vehicle", "Moon", 0 );
+        std::shared_ptr< SingleDependentVariableSaveSettings > eccentricitySettings =
+                std::make_shared< SingleDependentVariableSaveSettings >(
+                    keplerian_state_dependent_variable, "Vehicle", "Moon", 1 );
+
+        std::vector< tudat_applications::AscentPhaseSettings > phaseSettings;
+
+        // Vertical rise: thrust along radial direction, until vertical rise altitude is reached
+        std::map< std::string, std::vector< std::shared_ptr< AccelerationSettings > > > verticalRiseAccelerations;
+        verticalRiseAccelerations[ "Moon" ].push_back( std::make_shared< AccelerationSettings >(
+                                                           basic_astrodynamics::central_gravity ) );
+        verticalRiseAccelerations[ "Vehicle" ].push_back( std::make_shared< ThrustAccelerationSettings >(
+                                                              std::make_shared< ThrustDirectionFromStateGuidanceSettings >(
+                                                                  "Moon", false, false ),
+                                                              std::make_shared< ConstantThrustMagnitudeSettings >(
+                                                                  thrustParameters.at( 0 ), constantSpecificImpulse ) ) );
+        phaseSettings.push_back( tudat_applications::AscentPhaseSettings(
+                                     "VerticalRise", verticalRiseAccelerations,
+                                     std::make_shared< IntegratorSettings< > >( rungeKutta4, initialTime, 1.0 ),
+                                     std::make_shared< PropagationDependentVariableTerminationSettings >(
+                                         std::make_shared< SingleDependentVariableSaveSettings >(
+                                             altitude_dependent_variable, "Vehicle", "Moon" ),
+                                         verticalRiseAltitude, false, true, eventRootFinderSettings ) ) );
+
+        // Pitch-over: thrust angle nodes, until semi-major axis of transfer orbit is reached
+        phaseSettings.push_back( tudat_applications::AscentPhaseSettings(
+                                     "PitchOver", accelerationsOfVehicle,
+                                     std::make_shared< IntegratorSettings< > >( rungeKutta4, initialTime, 1.0 ),
+                                     std::make_shared< PropagationDependentVariableTerminationSettings >(
+                                         semiMajorAxisSettings,
+                                         moonRadius + ( insertionAltitude + terminationAltitude ) / 2.0,
+                                         false, true, eventRootFinderSettings ) ) );
+
+        // Coast: no thrust (variable step size), until apolune is reached
+        std::map< std::string, std::vector< std::shared_ptr< AccelerationSettings > > > coastAccelerations;
+        coastAccelerations[ "Moon" ].push_back( std::make_shared< AccelerationSettings >(
+                                                    basic_astrodynamics::central_gravity ) );
+        phaseSettings.push_back( tudat_applications::AscentPhaseSettings(
+                                     "Coast", coastAccelerations,
+                                     std::make_shared< RungeKuttaVariableStepSizeSettings< > >(
+                                         rungeKuttaVariableStepSize, initialTime, 10.0,
+                                         RungeKuttaCoefficients::rungeKuttaFehlberg78, 1.0E-3, 1.0E3, 1.0E-12, 1.0E-12 ),
+                                     std::make_shared< PropagationDependentVariableTerminationSettings >(
+                                         std::make_shared< BodyAerodynamicAngleVariableSaveSettings >(
+                                             "Vehicle", flight_path_angle ), 0.0, true, true, eventRootFinderSettings ) ) );
+
+        // Circularization: thrust along velocity, until orbit is circular
+        std::map< std::string, std::vector< std::shared_ptr< AccelerationSettings > > > circularizationAccelerations;
+        circularizationAccelerations[ "Moon" ].push_back( std::make_shared< AccelerationSettings >(
+                                                              basic_astrodynamics::central_gravity ) );
+        circularizationAccelerations[ "Vehicle" ].push_back( std::make_shared< ThrustAccelerationSettings >(
+                                                                 std::make_shared< ThrustDirectionFromStateGuidanceSettings >(
+                                                                     "Moon", true, false ),
+                                                                 std::make_shared< ConstantThrustMagnitudeSettings >(
+                                                                     thrustParameters.at( 0 ), constantSpecificImpulse ) ) );
+        phaseSettings.push_back( tudat_applications::AscentPhaseSettings(
+                                     "Circularization", circularizationAccelerations,
+                                     std::make_shared< IntegratorSettings< > >( rungeKutta4, initialTime, 1.0 ),
+                                     std::make_shared< PropagationDependentVariableTerminationSettings >(
+                                         eccentricitySettings, circularizationEccentricity, true, true,
+                                         eventRootFinderSettings ) ) );
+
+        // Propagate phases, terminating on maximum duration, impact or dry mass
+        tudat_applications::MultiPhaseAscentPropagator multiPhaseAscentPropagator(
+                    bodyMap, "Vehicle", "Moon", phaseSettings,
+                    { terminationSettingsList.at( 0 ), terminationSettingsList.at( 2 ), terminationSettingsList.at( 3 ) },
+                    dependentVariablesToSave );
+        multiPhaseAscentPropagator.propagate( systemInitialState, vehicleMass, initialTime );
+
+        std::map< double, double > phaseStartTimes;
+        for( unsigned int i = 0; i < multiPhaseAscentPropagator.getPhaseStartTimes( ).size( ); i++ )
+        {
+            phaseStartTimes[ multiPhaseAscentPropagator.getPhaseStartTimes( ).at( i ).first ] = i;
+        }
+
+        // Take over histories from the propagator (which is not used anymore), instead of copying them
+        std::map< double, Eigen::VectorXd > multiPhaseStateHistory = multiPhaseAscentPropagator.releaseStateHistory( );
+        std::map< double, Eigen::VectorXd > multiPhaseDependentVariableHistory =
+                multiPhaseAscentPropagator.releaseDependentVariableHistory( );
+        input_output::writeDataMapToTextFile( multiPhaseStateHistory, "multiPhaseStateHistory.dat", outputPath );
+        input_output::writeDataMapToTextFile( multiPhaseDependentVariableHistory,
+                                              "multiPhaseDependentVariables.dat", outputPath );
+        input_output::writeDataMapToTextFile( phaseStartTimes, "ascentPhaseStartTimes.dat", outputPath );
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ///////////////////////             PROPAGATE MONTE CARLO ENSEMBLE            /////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    if( propagateMonteCarloEnsemble )
+    {
+        // Create ensemble model, with Moon rotation axis at initial time
+        int numberOfThrustAngleNodes = thrustParameters.size( ) - 2;
+        std::shared_ptr< tudat_applications::LunarAscentEnsembleModel > ensembleModel =
+                std::make_shared< tudat_applications::LunarAscentEnsembleModel >(
+                    bodyMap.at( "Moon" )->getGravityFieldModel( )->getGravitationalParameter( ),
+                    spice_interface::getAverageRadius( "Moon" ),
+                    moonRotationalEphemeris->getRotationToBaseFrame( initialTime ) * Eigen::Vector3d::UnitZ( ),
+                    initialTime, numberOfThrustAngleNodes, terminationAltitude, vehicleDryMass, maximumDuration );
+
+        // Generate dispersed samples
+        std::mt19937 randomNumberGenerator( 0 );
+        std::normal_distribution< double > normalDistribution( 0.0, 1.0 );
+        tudat_applications::EnsembleMatrix ensembleInitialStates( 7, numberOfEnsembleSamples );
+        tudat_applications::EnsembleMatrix ensembleParameters(
+                    ensembleModel->getNumberOfParameters( ), numberOfEnsembleSamples );
+        for( int i = 0; i < numberOfEnsembleSamples; i++ )
+        {
+            ensembleInitialStates.col( i ) << systemInitialState, vehicleMass;
+            ensembleParameters( 0, i ) = thrustParameters.at( 0 ) *
+                    ( 1.0 + thrustMagnitudeDispersion * normalDistribution( randomNumberGenerator ) );
+            ensembleParameters( 1, i ) = thrustParameters.at( 1 );
+            for( int j = 0; j < numberOfThrustAngleNodes; j++ )
+            {
+                ensembleParameters( j + 2, i ) = thrustParameters.at( j + 2 ) +
+                        thrustAngleDispersion * normalDistribution( randomNumberGenerator );
+            }
+            ensembleParameters( numberOfThrustAngleNodes + 2, i ) = constantSpecificImpulse *
+                    ( 1.0 + specificImpulseDispersion * normalDistribution( randomNumberGenerator ) );
+        }
+
+        // Propagate ensemble in lockstep, with same step size as nominal propagation
+        tudat_applications::EnsemblePropagator< tudat_applications::LunarAscentEnsembleModel > ensemblePropagator(
+                    ensembleModel, integratorSettings->initialTimeStep_ );
+        std::chrono::steady_clock::time_point ensembleStartTime = std::chrono::steady_clock::now( );
+        ensemblePropagator.propagate( ensembleInitialStates, ensembleParameters, initialTime );
+        double ensembleDuration = std::chrono::duration< double >(
+                    std::chrono::steady_clock::now( ) - ensembleStartTime ).count( );
+        std::cout << "Propagated " << numberOfEnsembleSamples << " ensemble samples in " << ensembleDuration << " s ("
+                  << ensemblePropagator.getNumberOfActiveSampleSteps( ) / ensembleDuration << " sample steps per second)"
+                  << std::endl;
+
+        Eigen::MatrixXd ensembleFinalStates( numberOfEnsembleSamples, 8 );
+        ensembleFinalStates.col( 0 ) = ensemblePropagator.getFinalTimes( );
+        ensembleFinalStates.rightCols( 7 ) = ensemblePropagator.getFinalStates( ).transpose( );
+        input_output::writeMatrixToFile( ensembleFinalStates, "monteCarloEnsembleFinalStates.dat", 16, outputPath );
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ///////////////////////             COMPUTE INDIRECT REFERENCE ASCENT            //////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    if( computeIndirectAscentReference )
+    {
+        // Determine horizontal direction of launch heading (from north, towards east) in inertial frame
+        double launchLatitude = ascentVehicleSphericalEntryState( SphericalOrbitalStateElementIndices::latitudeIndex );
+        double launchLongitude = ascentVehicleSphericalEntryState( SphericalOrbitalStateElementIndices::longitudeIndex );
+        double launchHeading = ascentVehicleSphericalEntryState( SphericalOrbitalStateElementIndices::headingAngleIndex );
+        Eigen::Vector3d bodyFixedNorthDirection(
+                    -std::sin( launchLatitude ) * std::cos( launchLongitude ),
+                    -std::sin( launchLatitude ) * std::sin( launchLongitude ), std::cos( launchLatitude ) );
+        Eigen::Vector3d bodyFixedEastDirection( -std::sin( launchLongitude ), std::cos( launchLongitude ), 0.0 );
+        Eigen::Vector3d downrangeDirection = moonRotationalEphemeris->getRotationToBaseFrame( initialTime ) * Eigen::Vector3d(
+                    std::cos( launchHeading ) * bodyFixedNorthDirection + std::sin( launchHeading ) * bodyFixedEastDirection );
+
+        // Solve from random initial guesses (concurrently), and select fastest ascent
+        tudat_applications::IndirectAscentOptimizer indirectAscentOptimizer(
+                    bodyMap.at( "Moon" )->getGravityFieldModel( )->getGravitationalParameter( ),
+                    systemInitialState, downrangeDirection, vehicleMass, vehicleDryMass, thrustParameters.at( 0 ),
+                    constantSpecificImpulse, spice_interface::getAverageRadius( "Moon" ) + terminationAltitude );
+        std::vector< tudat_applications::IndirectAscentSolution > indirectAscentSolutions =
+                indirectAscentOptimizer.solveFromMultipleStarts(
+                    numberOfIndirectAscentStarts, 0.5 * ( vehicleMass - vehicleDryMass ) * constantSpecificImpulse *
+                    physical_constants::SEA_LEVEL_GRAVITATIONAL_ACCELERATION / thrustParameters.at( 0 ),
+                    ( vehicleMass - vehicleDryMass ) * constantSpecificImpulse *
+                    physical_constants::SEA_LEVEL_GRAVITATIONAL_ACCELERATION / thrustParameters.at( 0 ) );
+        int bestIndirectAscentSolution = tudat_applications::getBestIndirectAscentSolutionIndex( indirectAscentSolutions );
+
+        std::cout << "Indirect ascent: " << std::count_if(
+                         indirectAscentSolutions.begin( ), indirectAscentSolutions.end( ),
+                         [ ]( const tudat_applications::IndirectAscentSolution& solution ){ return solution.isConverged; } )
+                  << " of " << numberOfIndirectAscentStarts << " initial guesses converged, final mass "
+                  << indirectAscentSolutions.at( bestIndirectAscentSolution ).finalMass << " kg" << std::endl;
+        input_output::writeDataMapToTextFile(
+                    indirectAscentOptimizer.propagateSolution(
+                        indirectAscentSolutions.at( bestIndirectAscentSolution ), initialTime ),
+                    "indirectAscentReference.dat", outputPath );
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ///////////////////////             COMPUTE LAUNCH SITE AVAILABILITY MAP            ///////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    if( computeLaunchSiteAvailability )
+    {
+        double moonRadius = spice_interface::getAverageRadius( "Moon" );
+
+        // Create body map (and elevation model, which caches tiles) for each thread
+        int numberOfThreads = tudat_applications::getDefaultNumberOfThreads( );
+        std::vector< NamedBodyMap > threadBodyMaps;
+        std::vector< std::shared_ptr< tudat_applications::TiledDigitalElevationModel > > threadElevationModels;
+        for( int i = 0; i < numberOfThreads; i++ )
+        {
+            if( useDigitalElevationModel )
+            {
+                threadElevationModels.push_back( std::make_shared< tudat_applications::TiledDigitalElevationModel >(
+                                                     digitalElevationModelDirectory, moonRadius, numberOfLatitudeTiles ) );
+            }
+            threadBodyMaps.push_back( getConcurrentLunarAscentBodyMap(
+                                          initialTime, vehicleMass,
+                                          useDigitalElevationModel ? threadElevationModels.at( i ) : nullptr ) );
+        }
+
+        // Create ascent propagator for each thread, terminating on same conditions as nominal ascent (with maximum duration
+        // w.r.t. launch epoch), with cache of states at thrust angle nodes
+        std::vector< std::shared_ptr< PropagationTerminationSettings > > launchSiteTerminationSettings =
+        { terminationSettingsList.at( 1 ), terminationSettingsList.at( 2 ), terminationSettingsList.at( 3 ) };
+        std::vector< std::shared_ptr< tudat_applications::PrefixCachedAscentPropagator > > threadAscentPropagators;
+        for( int i = 0; i < numberOfThreads; i++ )
+        {
+            threadAscentPropagators.push_back( std::make_shared< tudat_applications::PrefixCachedAscentPropagator >(
+                                                   threadBodyMaps.at( i ), "Vehicle", "Moon", constantSpecificImpulse,
+                                                   maximumDuration, launchSiteTerminationSettings, propagatorType,
+                                                   integratorSettings->initialTimeStep_, maximumNumberOfAscentCheckpoints ) );
+        }
+
+        // Performance of ascent: propellant margin when reaching termination altitude, if periapsis is above the surface
+        auto computeLaunchSitePerformance = [ & ]( const double latitude, const double longitude, const double launchEpoch,
+                const std::vector< double >& guidanceParameters, const int threadIndex )
+        {
+            const NamedBodyMap& threadBodyMap = threadBodyMaps.at( threadIndex );
+
+            Eigen::Vector6d launchSiteSphericalState = ascentVehicleSphericalEntryState;
+            launchSiteSphericalState( SphericalOrbitalStateElementIndices::radiusIndex ) = moonRadius + 100.0;
+            launchSiteSphericalState( SphericalOrbitalStateElementIndices::latitudeIndex ) = latitude;
+            launchSiteSphericalState( SphericalOrbitalStateElementIndices::longitudeIndex ) = longitude;
+            if( useDigitalElevationModel )
+            {
+                launchSiteSphericalState( SphericalOrbitalStateElementIndices::radiusIndex ) +=
+                        threadElevationModels.at( threadIndex )->getTerrainHeight( latitude, longitude );
+            }
+            Eigen::VectorXd launchSiteInitialState = transformStateToGlobalFrame(
+                        convertSphericalOrbitalToCartesianState( launchSiteSphericalState ), launchEpoch,
+                        threadBodyMap.at( "Moon" )->getRotationalEphemeris( ) );
+
+            // Propagate ascent, resuming from the deepest checkpoint of earlier candidates at the same launch site
+            std::shared_ptr< tudat_applications::PrefixCachedAscentPropagator > threadAscentPropagator =
+                    threadAscentPropagators.at( threadIndex );
+            Eigen::VectorXd finalState = threadAscentPropagator->propagate(
+                        launchSiteInitialState, vehicleMass, launchEpoch, guidanceParameters );
+
+            // Check whether termination altitude was reached, on an orbit that does not intersect the surface
+            if( !threadAscentPropagator->getIsTerminationSuccessful( ) ||
+                    !threadAscentPropagator->getWasConditionMetWhenStopping( ).at( 1 ) )
+            {
+                return TUDAT_NAN;
+            }
+            Eigen::Vector6d finalKeplerianState = convertCartesianToKeplerianElements(
+                        Eigen::Vector6d( finalState.segment( 0, 6 ) ),
+                        threadBodyMap.at( "Moon" )->getGravityFieldModel( )->getGravitationalParameter( ) );
+            if( finalKeplerianState( semiMajorAxisIndex ) * ( 1.0 - finalKeplerianState( eccentricityIndex ) ) <
+                    moonRadius )
+            {
+                return TUDAT_NAN;
+            }
+            return finalState( 6 ) - vehicleDryMass;
+        };
+
+        // Optimize thrust angles (entries 2-6 of thrust parameters) at each launch site and epoch
+        tudat_applications::LaunchSiteOptimizationSettings launchSiteOptimizationSettings(
+                    { 0.0, 0.0, 0.1, 0.1, 0.1, 0.1, 0.1 }, maximumNumberOfEvaluationsPerLaunchSite );
+        tudat_applications::LaunchSiteAvailabilityMap launchSiteAvailabilityMap =
+                tudat_applications::computeLaunchSiteAvailabilityMap(
+                    computeLaunchSitePerformance,
+                    Eigen::VectorXd::LinSpaced( numberOfLaunchLatitudes,
+                                                -PI / 2.0 + PI / static_cast< double >( 2 * numberOfLaunchLatitudes ),
+                                                PI / 2.0 - PI / static_cast< double >( 2 * numberOfLaunchLatitudes ) ),
+                    Eigen::VectorXd::LinSpaced( numberOfLaunchLongitudes, -PI,
+                                                PI - 2.0 * PI / static_cast< double >( numberOfLaunchLongitudes ) ),
+                    Eigen::VectorXd::LinSpaced( numberOfLaunchEpochs, initialTime,
+                                                initialTime + ( numberOfLaunchEpochs - 1 ) * launchEpochSpacing ),
+                    thrustParameters, launchSiteOptimizationSettings, numberOfThreads );
+
+        int numberOfPropagatedSegments = 0, numberOfResumedSegments = 0;
+        for( int i = 0; i < numberOfThreads; i++ )
+        {
+            numberOfPropagatedSegments += threadAscentPropagators.at( i )->getNumberOfPropagatedSegments( );
+            numberOfResumedSegments += threadAscentPropagators.at( i )->getNumberOfResumedSegments( );
+        }
+        std::cout << "Launch site ascents: " << numberOfPropagatedSegments << " segments propagated, "
+                  << numberOfResumedSegments << " segments resumed from checkpoints" << std::endl;
+
+        tudat_applications::writeLaunchSiteAvailabilityRaster(
+                    launchSiteAvailabilityMap, outputPath + "launchSiteAvailability.dat" );
+        Eigen::MatrixXd launchSiteGuidanceParameters( launchSiteAvailabilityMap.guidanceParameters.size( ),
+                                                      thrustParameters.size( ) );
+        for( unsigned int i = 0; i < launchSiteAvailabilityMap.guidanceParameters.size( ); i++ )
+        {
+            launchSiteGuidanceParameters.row( i ) = utilities::convertStlVectorToEigenVector(
+                        launchSiteAvailabilityMap.guidanceParameters.at( i ) ).transpose( );
+        }
+        input_output::writeMatrixToFile( launchSiteGuidanceParameters, "launchSiteGuidanceParameters.dat", 16, outputPath );
+    }
+
     // The exit code EXIT_SUCCESS indicates that the program was successfully executed.
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,215 @@
+/*    Copyright (c) 2010-2018, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/interprocess/file_mapping.hpp>
+
+#include <Tudat/Mathematics/BasicMathematics/mathematicalConstants.h>
+
+#include "tiledDigitalElevationModel.h"
+
+namespace tudat_applications
+{
+
+//! Identifier at the start of each tile file
+static const std::int64_t tileFileIdentifier = 0x31454C49544D4544; // "DEMTILE1"
+
+//! Function to retrieve the name of the file of a tile
+static std::string getTileFileName( const std::string& tileDirectory, const int latitudeIndex, const int longitudeIndex )
+{
+    std::string directory = tileDirectory;
+    if( directory.size( ) > 0 && directory.at( directory.size( ) - 1 ) != '/' )
+    {
+        directory += "/";
+    }
+    return directory + "tile_" + std::to_string( latitudeIndex ) + "_" + std::to_string( longitudeIndex ) + ".dem";
+}
+
+//! Function to write a global height grid to a set of tiles, to be used by a TiledDigitalElevationModel
+void writeDigitalElevationModelTiles(
+        const std::string& tileDirectory,
+        const Eigen::MatrixXd& heightGrid,
+        const int numberOfLatitudeTiles )
+{
+    if( numberOfLatitudeTiles < 1 || ( heightGrid.rows( ) - 1 ) % numberOfLatitudeTiles != 0 ||
+            heightGrid.rows( ) < numberOfLatitudeTiles + 1 )
+    {
+        throw std::runtime_error( "Error when writing elevation model tiles, number of latitudes is inconsistent with tiles" );
+    }
+    const int numberOfTileIntervals = ( heightGrid.rows( ) - 1 ) / numberOfLatitudeTiles;
+    if( heightGrid.cols( ) != 2 * numberOfLatitudeTiles * numberOfTileIntervals + 1 )
+    {
+        throw std::runtime_error( "Error when writing elevation model tiles, number of longitudes is inconsistent with tiles" );
+    }
+
+    const int numberOfTileSamples = ( numberOfTileIntervals + 1 ) * ( numberOfTileIntervals + 1 );
+    std::vector< float > tileHeights( numberOfTileSamples );
+    for( int i = 0; i < numberOfLatitudeTiles; i++ )
+    {
+        for( int j = 0; j < 2 * numberOfLatitudeTiles; j++ )
+        {
+            // Copy heights of tile, including its edges (rows of increasing latitude)
+            for( int k = 0; k <= numberOfTileIntervals; k++ )
+            {
+                for( int l = 0; l <= numberOfTileIntervals; l++ )
+                {
+                    tileHeights.at( k * ( numberOfTileIntervals + 1 ) + l ) = static_cast< float >(
+                                heightGrid( i * numberOfTileIntervals + k, j * numberOfTileIntervals + l ) );
+                }
+            }
+
+            const std::string fileName = getTileFileName( tileDirectory, i, j );
+            std::ofstream tileFile( fileName.c_str( ), std::ios::binary | std::ios::trunc );
+            const std::int64_t header[ 2 ] = { tileFileIdentifier, numberOfTileIntervals };
+            tileFile.write( reinterpret_cast< const char* >( header ), sizeof( header ) );
+            tileFile.write( reinterpret_cast< const char* >( tileHeights.data( ) ), numberOfTileSamples * sizeof( float ) );
+            if( !tileFile.good( ) )
+            {
+                throw std::runtime_error( "Error when writing elevation model tiles, could not write " + fileName );
+            }
+        }
+    }
+}
+
+//! Constructor
+TiledDigitalElevationModel::TiledDigitalElevationModel(
+        const std::string& tileDirectory,
+        const double referenceRadius,
+        const int numberOfLatitudeTiles,
+        const int maximumNumberOfMappedTiles ):
+    tileDirectory_( tileDirectory ), referenceRadius_( referenceRadius ), numberOfLatitudeTiles_( numberOfLatitudeTiles ),
+    maximumNumberOfMappedTiles_( maximumNumberOfMappedTiles ), numberOfTileIntervals_( 0 ),
+    lastTileIndex_( -1 ), lastTile_( nullptr ), numberOfTileMappings_( 0 )
+{
+    if( numberOfLatitudeTiles_ < 1 || maximumNumberOfMappedTiles_ < 1 )
+    {
+        throw std::runtime_error( "Error when creating tiled elevation model, numbers of tiles must be positive" );
+    }
+    tileSize_ = tudat::mathematical_constants::PI / static_cast< double >( numberOfLatitudeTiles_ );
+}
+
+//! Function to compute the altitude of a point above the terrain
+double TiledDigitalElevationModel::getAltitude( const Eigen::Vector3d& bodyFixedPosition )
+{
+    const double radius = bodyFixedPosition.norm( );
+    return radius - referenceRadius_ - getTerrainHeight(
+                std::asin( bodyFixedPosition.z( ) / radius ), std::atan2( bodyFixedPosition.y( ), bodyFixedPosition.x( ) ) );
+}
+
+//! Function to compute the height of the terrain w.r.t. the reference sphere (bilinear interpolation in the grid)
+double TiledDigitalElevationModel::getTerrainHeight( const double latitude, const double longitude )
+{
+    // Determine tile, and position in tile (in units of tile size)
+    const double latitudeInTiles = ( latitude + tudat::mathematical_constants::PI / 2.0 ) / tileSize_;
+    const double longitudeInTiles = ( longitude + tudat::mathematical_constants::PI ) / tileSize_;
+    const int latitudeIndex = std::min( std::max( static_cast< int >( std::floor( latitudeInTiles ) ), 0 ),
+                                        numberOfLatitudeTiles_ - 1 );
+    const int longitudeIndex = std::min( std::max( static_cast< int >( std::floor( longitudeInTiles ) ), 0 ),
+                                         2 * numberOfLatitudeTiles_ - 1 );
+    const MappedTile& tile = getTile( latitudeIndex, longitudeIndex );
+
+    // Determine grid cell in tile, and interpolate bilinearly
+    const double rowPosition = std::min( std::max( ( latitudeInTiles - latitudeIndex ), 0.0 ), 1.0 ) *
+            numberOfTileIntervals_;
+    const double columnPosition = std::min( std::max( ( longitudeInTiles - longitudeIndex ), 0.0 ), 1.0 ) *
+            numberOfTileIntervals_;
+    const int row = std::min( static_cast< int >( rowPosition ), numberOfTileIntervals_ - 1 );
+    const int column = std::min( static_cast< int >( columnPosition ), numberOfTileIntervals_ - 1 );
+    const double rowFraction = rowPosition - row;
+    const double columnFraction = columnPosition - column;
+
+    const float* lowerRow = tile.heights + row * ( numberOfTileIntervals_ + 1 ) + column;
+    const float* upperRow = lowerRow + ( numberOfTileIntervals_ + 1 );
+    return ( 1.0 - rowFraction ) * ( ( 1.0 - columnFraction ) * lowerRow[ 0 ] + columnFraction * lowerRow[ 1 ] ) +
+            rowFraction * ( ( 1.0 - columnFraction ) * upperRow[ 0 ] + columnFraction * upperRow[ 1 ] );
+}
+
+//! Function to retrieve a tile, mapping it into memory if needed
+const TiledDigitalElevationModel::MappedTile& TiledDigitalElevationModel::getTile(
+        const int latitudeIndex, const int longitudeIndex )
+{
+    const int tileIndex = latitudeIndex * 2 * numberOfLatitudeTiles_ + longitudeIndex;
+    if( tileIndex == lastTileIndex_ )
+    {
+        return *lastTile_;
+    }
+
+    std::unordered_map< int, MappedTile >::iterator tileIterator = mappedTiles_.find( tileIndex );
+    if( tileIterator != mappedTiles_.end( ) )
+    {
+        // Move tile to front of usage list
+        tileUsageOrder_.splice( tileUsageOrder_.begin( ), tileUsageOrder_, tileIterator->second.usageIterator );
+    }
+    else
+    {
+        // Unmap least recently used tile, if maximum number of mapped tiles is reached
+        if( static_cast< int >( mappedTiles_.size( ) ) >= maximumNumberOfMappedTiles_ )
+        {
+            if( tileUsageOrder_.back( ) == lastTileIndex_ )
+            {
+                lastTileIndex_ = -1;
+                lastTile_ = nullptr;
+            }
+            mappedTiles_.erase( tileUsageOrder_.back( ) );
+            tileUsageOrder_.pop_back( );
+        }
+
+        // Map tile file into memory
+        const std::string fileName = getTileFileName( tileDirectory_, latitudeIndex, longitudeIndex );
+        MappedTile tile;
+        try
+        {
+            boost::interprocess::file_mapping tileFile( fileName.c_str( ), boost::interprocess::read_only );
+            tile.mappedRegion = std::make_shared< boost::interprocess::mapped_region >(
+                        tileFile, boost::interprocess::read_only );
+        }
+        catch( boost::interprocess::interprocess_exception& caughtException )
+        {
+            throw std::runtime_error( "Error when opening elevation model tile " + fileName + ": " + caughtException.what( ) );
+        }
+
+        // Check header, and set pointer to heights
+        const char* fileData = static_cast< const char* >( tile.mappedRegion->get_address( ) );
+        const std::int64_t* header = reinterpret_cast< const std::int64_t* >( fileData );
+        if( tile.mappedRegion->get_size( ) < 2 * sizeof( std::int64_t ) || header[ 0 ] != tileFileIdentifier )
+        {
+            throw std::runtime_error( "Error when opening elevation model tile " + fileName + ", file is not a tile" );
+        }
+        if( numberOfTileIntervals_ == 0 )
+        {
+            numberOfTileIntervals_ = static_cast< int >( header[ 1 ] );
+        }
+        if( header[ 1 ] != numberOfTileIntervals_ || numberOfTileIntervals_ < 1 ||
+                tile.mappedRegion->get_size( ) != 2 * sizeof( std::int64_t ) +
+                static_cast< std::size_t >( ( numberOfTileIntervals_ + 1 ) * ( numberOfTileIntervals_ + 1 ) ) *
+                sizeof( float ) )
+        {
+            throw std::runtime_error( "Error when opening elevation model tile " + fileName + ", tile size is inconsistent" );
+        }
+        tile.heights = reinterpret_cast< const float* >( fileData + 2 * sizeof( std::int64_t ) );
+
+        tileUsageOrder_.push_front( tileIndex );
+        tile.usageIterator = tileUsageOrder_.begin( );
+        tileIterator = mappedTiles_.insert( std::make_pair( tileIndex, tile ) ).first;
+        numberOfTileMappings_++;
+    }
+
+    lastTileIndex_ = tileIndex;
+    lastTile_ = &tileIterator->second;
+    return *lastTile_;
+}
+
+} // namespace tudat_applications
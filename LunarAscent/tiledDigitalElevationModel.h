@@ -0,0 +1,167 @@
+/*    Copyright (c) 2010-2018, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_TILEDDIGITALELEVATIONMODEL_H
+#define TUDAT_TILEDDIGITALELEVATIONMODEL_H
+
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <Tudat/Astrodynamics/BasicAstrodynamics/bodyShapeModel.h>
+#include <Tudat/Basics/basicTypedefs.h>
+
+namespace tudat_applications
+{
+
+//! Function to write a global height grid to a set of tiles, to be used by a TiledDigitalElevationModel
+/*!
+ *  Function to write a global height grid to a set of tiles, to be used by a TiledDigitalElevationModel. The tiles divide the
+ *  surface into numberOfLatitudeTiles x ( 2 * numberOfLatitudeTiles ) square tiles in latitude and longitude. Each tile file
+ *  contains the heights (single precision) at ( n + 1 ) x ( n + 1 ) grid points, including the points on its edges, so that
+ *  the heights in a tile can be interpolated without accessing neighbouring tiles.
+ *  \param tileDirectory Directory to which the tile files are written (must exist)
+ *  \param heightGrid Heights w.r.t. the reference radius on an equiangular grid, with rows from latitude -90 to 90 degrees
+ *  and columns from longitude -180 to 180 degrees (both inclusive). The number of rows must be numberOfLatitudeTiles * n + 1,
+ *  and the number of columns 2 * numberOfLatitudeTiles * n + 1, with n the number of grid intervals per tile edge
+ *  \param numberOfLatitudeTiles Number of tiles in latitude direction
+ */
+void writeDigitalElevationModelTiles(
+        const std::string& tileDirectory,
+        const Eigen::MatrixXd& heightGrid,
+        const int numberOfLatitudeTiles );
+
+//! Shape model of a body defined by a digital elevation model, stored in memory-mapped tiles
+/*!
+ *  Shape model of a body defined by a digital elevation model (heights w.r.t. a reference sphere on an equiangular
+ *  latitude-longitude grid), stored in tiles as written by writeDigitalElevationModelTiles. When set as the shape model of a
+ *  central body, the altitude dependent variable (and termination conditions on it) are computed w.r.t. the terrain.
+ *
+ *  Tiles are only memory mapped when a height in the tile is first requested, so only the tiles under the trajectory are ever
+ *  paged in. At most a given number of tiles is kept mapped; when this number is exceeded, the least recently used tile is
+ *  unmapped. Since consecutive lookups during a propagation are almost always in the same tile, the last used tile is checked
+ *  first, so that a lookup normally consists of the conversion to latitude and longitude and a bilinear interpolation. Lookups
+ *  modify the tile cache, so that an object must not be shared by concurrent propagations (separate objects using the same
+ *  tile files do share the mapped pages of the files).
+ */
+class TiledDigitalElevationModel: public tudat::basic_astrodynamics::BodyShapeModel
+{
+public:
+
+    //! Constructor
+    /*!
+     *  Constructor
+     *  \param tileDirectory Directory containing the tile files, as written by writeDigitalElevationModelTiles
+     *  \param referenceRadius Radius of the reference sphere w.r.t. which the heights are defined
+     *  \param numberOfLatitudeTiles Number of tiles in latitude direction
+     *  \param maximumNumberOfMappedTiles Maximum number of tiles that is kept memory mapped
+     */
+    TiledDigitalElevationModel( const std::string& tileDirectory,
+                                const double referenceRadius,
+                                const int numberOfLatitudeTiles,
+                                const int maximumNumberOfMappedTiles = 16 );
+
+    //! Destructor
+    ~TiledDigitalElevationModel( ){ }
+
+    //! Function to compute the altitude of a point above the terrain
+    /*!
+     *  Function to compute the altitude of a point above the terrain, as the distance to the center of the body minus the
+     *  radius of the terrain at the latitude and longitude of the point.
+     *  \param bodyFixedPosition Position of the point, in the body-fixed frame
+     *  \return Altitude above the terrain
+     */
+    double getAltitude( const Eigen::Vector3d& bodyFixedPosition );
+
+    //! Function to retrieve the radius of the reference sphere
+    double getAverageRadius( )
+    {
+        return referenceRadius_;
+    }
+
+    //! Function to compute the height of the terrain w.r.t. the reference sphere (bilinear interpolation in the grid)
+    /*!
+     *  Function to compute the height of the terrain w.r.t. the reference sphere (bilinear interpolation in the grid)
+     *  \param latitude Latitude of the point
+     *  \param longitude Longitude of the point
+     *  \return Height of the terrain w.r.t. the reference sphere
+     */
+    double getTerrainHeight( const double latitude, const double longitude );
+
+    //! Function to retrieve the number of tiles that is currently memory mapped
+    int getNumberOfMappedTiles( ) const
+    {
+        return mappedTiles_.size( );
+    }
+
+    //! Function to retrieve the total number of times a tile has been memory mapped
+    int getNumberOfTileMappings( ) const
+    {
+        return numberOfTileMappings_;
+    }
+
+private:
+
+    //! Struct containing a memory-mapped tile
+    struct MappedTile
+    {
+        //! Mapped region of the tile file
+        std::shared_ptr< boost::interprocess::mapped_region > mappedRegion;
+
+        //! Pointer to the heights in the tile (rows of increasing latitude)
+        const float* heights;
+
+        //! Iterator to the position of the tile in the list of tiles in order of use
+        std::list< int >::iterator usageIterator;
+    };
+
+    //! Function to retrieve a tile, mapping it into memory if needed
+    const MappedTile& getTile( const int latitudeIndex, const int longitudeIndex );
+
+    //! Directory containing the tile files
+    std::string tileDirectory_;
+
+    //! Radius of the reference sphere
+    double referenceRadius_;
+
+    //! Number of tiles in latitude direction
+    int numberOfLatitudeTiles_;
+
+    //! Maximum number of tiles that is kept memory mapped
+    int maximumNumberOfMappedTiles_;
+
+    //! Angular size of a tile
+    double tileSize_;
+
+    //! Number of grid intervals per tile edge (determined from the first mapped tile)
+    int numberOfTileIntervals_;
+
+    //! Tiles that are currently memory mapped (key: tile index)
+    std::unordered_map< int, MappedTile > mappedTiles_;
+
+    //! Indices of the mapped tiles, from most to least recently used
+    std::list< int > tileUsageOrder_;
+
+    //! Index of the last used tile (-1 if none)
+    int lastTileIndex_;
+
+    //! Pointer to the last used tile
+    const MappedTile* lastTile_;
+
+    //! Total number of times a tile has been memory mapped
+    int numberOfTileMappings_;
+};
+
+} // namespace tudat_applications
+
+#endif // TUDAT_TILEDDIGITALELEVATIONMODEL_H
@@ -13,6 +13,9 @@
 #include <Tudat/SimulationSetup/tudatSimulationHeader.h>
 
 #include "../applicationOutput.h"
+#include "../guidanceAdapters.h"
+#include "../parallelExecution.h"
+#include "shapeOptimization.h"
 
 using namespace tudat::ephemerides;
 using namespace tudat::interpolators;
@@ -128,40 +131,37 @@ std::shared_ptr< HypersonicLocalInclinationAnalysis > getCapsuleCoefficientInter
     return  hypersonicLocalInclinationAnalysis;
 }
 
-namespace tudat
-{
-
-//! Class to set the aerodynamic angles of the capsule (default: all angles 0)
-class CapsuleAerodynamicGuidance: public aerodynamics::AerodynamicGuidance
+//! Create body map for the entry, which can be used in a propagation that runs concurrently with others
+/*!
+ *  Create body map for the entry (Earth and capsule), which can be used in a propagation that runs concurrently with others.
+ *  The ephemeris of the Earth is replaced by a constant state, and its rotation model by a uniform rotation that is
+ *  initialized from Spice when the body map is created, so that the body map does not use Spice during the propagation
+ *  (Spice is not thread-safe). The aerodynamic coefficients of the capsule are interpolated from a tabulated database that
+ *  is shared by all body maps.
+ */
+NamedBodyMap getConcurrentEntryBodyMap(
+        const double initialTime,
+        const double capsuleMass,
+        const std::shared_ptr< const tudat_applications::CapsuleCoefficientTable > coefficientTable )
 {
-public:
-
-    //! Constructor
-    CapsuleAerodynamicGuidance(
-            const NamedBodyMap bodyMap,
-            const double fixedAngleOfAttack ):bodyMap_( bodyMap ), fixedAngleOfAttack_( fixedAngleOfAttack )
-    {
-
-    }
-
-    //! The aerodynamic angles are to be computed here
-    void updateGuidance( const double time )
-    {
-        currentAngleOfAttack_ = fixedAngleOfAttack_;
-        currentAngleOfSideslip_ = 0.0;
-        currentBankAngle_ = 0.0;
-
-    }
-
-private:
-
-    //! List of body objects that constitute the environment
-    NamedBodyMap bodyMap_;
-
-    //! Fixed angle of attack that is to be used by vehicle
-    double fixedAngleOfAttack_;
-};
+    std::map< std::string, std::shared_ptr< BodySettings > > bodySettings =
+            getDefaultBodySettings( std::vector< std::string >{ "Earth" } );
+    bodySettings[ "Earth" ]->ephemerisSettings = std::make_shared< ConstantEphemerisSettings >(
+                Eigen::Vector6d::Zero( ), "SSB", "J2000" );
+    bodySettings[ "Earth" ]->rotationModelSettings = std::make_shared< SimpleRotationModelSettings >(
+                "J2000", "IAU_Earth",
+                spice_interface::computeRotationQuaternionBetweenFrames( "J2000", "IAU_Earth", initialTime ),
+                initialTime, spice_interface::getAngularVelocityVectorOfFrameInOriginalFrame(
+                    "J2000", "IAU_Earth", initialTime ).norm( ) );
+
+    NamedBodyMap bodyMap = createBodies( bodySettings );
+    bodyMap[ "Capsule" ] = std::make_shared< simulation_setup::Body >( );
+    bodyMap[ "Capsule" ]->setConstantBodyMass( capsuleMass );
+    bodyMap[ "Capsule" ]->setAerodynamicCoefficientInterface(
+                tudat_applications::createCapsuleCoefficientInterface( coefficientTable ) );
+    setGlobalFrameBodyEphemerides( bodyMap, "Earth", "J2000" );
 
+    return bodyMap;
 }
 
 /*!
@@ -173,10 +173,44 @@ private:
  *   CapsuleAerodynamicGuidance has been provided, which is currently has no direct functionality: it sets the aerodynamic angles
  *   (attack, sideslip, bank) to 0 degrees. This can (and should) be overridden by the user in favor of something more realistic
  *
+ *   The convective (Sutton-Graves) and radiative (Tauber-Sutton) heat flux at the stagnation point are computed for the nose
+ *   radius of the capsule, and saved as dependent variables. The expensive, density and velocity dependent part of the
+ *   radiative heat flux is precomputed in a table (once per capsule shape), so that it is retrieved by a table lookup in each
+ *   time step.
+ *
+ *   Optionally (useTrimmedFlight), the capsule flies at its trim angle of attack instead of the fixed angle of attack. The stable
+ *   trim angle of attack (zero pitch moment, closest to the fixed angle of attack if there are several) is computed from the
+ *   moment coefficients of the aerodynamic database for all Mach numbers at once, and stored in a table from which the guidance
+ *   retrieves it in constant time, so that the attitude is physically meaningful without propagating the rotational dynamics.
+ *
+ *   Optionally (findEntryCorridor), the entry corridor is computed: the range of entry flight path angles for which the
+ *   capsule reaches the termination altitude without skipping out (rising above the entry altitude) or exceeding the limits
+ *   on stagnation point heat flux (convective and radiative, see above) and aerodynamic load. Both bounds of the
+ *   corridor are located by multisection, where all entries of a single iteration are propagated concurrently (each thread
+ *   using its own body map, with aerodynamic coefficients interpolated from a shared tabulated copy of the aerodynamic
+ *   database). Each entry is terminated as soon as its outcome is known. The corridor width is a measure of the robustness
+ *   of the capsule shape.
+ *
+ *   Optionally (findLandingFootprint), the landing footprint is computed: the convex hull of the landing points (downrange and
+ *   crossrange w.r.t. the entry point and heading, at the termination altitude) of entries with a set of bank angle profiles
+ *   (constant bank angles, and bank angles that are reversed once). All entries are propagated concurrently, in the same
+ *   manner as for the entry corridor.
+ *
+ *   Optionally (benchmarkGuidanceCalls), the cost per update of the aerodynamic guidance is measured. The guidance is
+ *   connected to the aerodynamic angle calculator through templated adapters (guidanceAdapters.h), which call the guidance
+ *   directly instead of through the virtual AerodynamicGuidance interface; the benchmark compares both.
+ *
  *   Key outputs:
  *
  *   propagatedStateHistory Numerically propagated Cartesian state
- *   dependentVariableHistory Dependent variables (default none) saved during the state propagation of the entry capsule
+ *   dependentVariableHistory Dependent variables (altitude, airspeed, aerodynamic force coefficients, and convective and
+ *      radiative stagnation point heat flux) saved during the state propagation of the entry capsule
+ *   trimTable Mach number, trim angle of attack and availability of a stable trim point, for each Mach number of the
+ *      aerodynamic database (if trimmed flight is used)
+ *   entryCorridor Steepest and shallowest entry flight path angle of the corridor, and its width (if computed)
+ *   landingFootprint Downrange and crossrange of the vertices of the landing footprint, in counterclockwise order (if
+ *      computed)
+ *   landingPoints Downrange and crossrange of the landing point for each bank angle profile of the footprint (if computed)
  *
  *   Input parameters:
  *
@@ -211,9 +245,43 @@ int main( )
     capsuleSphericalEntryState( SphericalOrbitalStateElementIndices::headingAngleIndex ) =
             unit_conversions::convertDegreesToRadians( 34.37 );
 
+    // Set altitude at which the entry is terminated (also used for the entry corridor and landing footprint)
+    double terminationAltitude = 25.0E3;
+
     // Vehicle properties
     double vehicleDensity = 250.0;
 
+    // Set whether the capsule flies at the trim angle of attack (as a function of Mach number) instead of the constant angle
+    // of attack of the shape parameters (which is then only used to select between multiple trim points)
+    bool useTrimmedFlight = false;
+
+    // Set whether the entry corridor is computed, with the range of entry flight path angles in which it is searched, the
+    // tolerance on its bounds, and the limits on stagnation point heat flux (W/m^2) and aerodynamic load (in g0)
+    bool findEntryCorridor = false;
+    double steepestCorridorFlightPathAngle = unit_conversions::convertDegreesToRadians( -10.0 );
+    double shallowestCorridorFlightPathAngle = unit_conversions::convertDegreesToRadians( -0.25 );
+    double entryCorridorTolerance = unit_conversions::convertDegreesToRadians( 0.01 );
+    double maximumStagnationHeatFlux = 1.0E6;
+    double maximumAerodynamicLoad = 10.0;
+
+    // Set whether the landing footprint is computed, from entries (at the nominal entry state) with constant bank angles,
+    // equispaced between plus and minus the maximum bank angle, and with each of these bank angles reversed once, at each of
+    // the equispaced reversal times
+    bool findLandingFootprint = false;
+    double maximumFootprintBankAngle = unit_conversions::convertDegreesToRadians( 80.0 );
+    int numberOfFootprintBankAngles = 17;
+    int numberOfFootprintReversalTimes = 8;
+    double footprintReversalTimeSpacing = 60.0;
+
+    // Set maximum duration of each entry of the entry corridor and landing footprint (after which the capsule is considered
+    // to skip)
+    double maximumConcurrentEntryDuration = 3600.0;
+
+    // Set whether the cost per guidance update (update and retrieval of the aerodynamic angles) is measured (after the
+    // propagation), both through the virtual guidance interface and through the guidance adapters (used for the propagation)
+    bool benchmarkGuidanceCalls = false;
+    int numberOfBenchmarkGuidanceCalls = 10000000;
+
     // DEFINE PROBLEM INDEPENDENT VARIABLES HERE:
     std::vector< double > shapeParameters =
     { 8.148730872315355, 2.720324489288032, 0.2270385167794302, -0.4037530896422072, 0.2781438040896319, 0.4559143679738996 };
@@ -266,8 +334,13 @@ int main( )
                 capsule->getVolume( ) * vehicleDensity );
 
     // Create vehicle aerodynamic coefficients
-    bodyMap[ "Capsule" ]->setAerodynamicCoefficientInterface(
-                getCapsuleCoefficientInterface( capsule, outputPath, "output_", true ) );
+    std::shared_ptr< HypersonicLocalInclinationAnalysis > capsuleCoefficientInterface =
+            getCapsuleCoefficientInterface( capsule, outputPath, "output_", true );
+    bodyMap[ "Capsule" ]->setAerodynamicCoefficientInterface( capsuleCoefficientInterface );
+
+    // Create stagnation point heating model, for nose radius of capsule
+    std::shared_ptr< const tudat_applications::StagnationPointHeatingTable > heatingTable =
+            std::make_shared< tudat_applications::StagnationPointHeatingTable >( shapeParameters.at( 0 ) );
 
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     ///////////////////////             CREATE ACCELERATIONS            ///////////////////////////////////////////////////
@@ -291,9 +364,27 @@ int main( )
     basic_astrodynamics::AccelerationMap accelerationModelMap = createAccelerationModelsMap(
                 bodyMap, accelerationMap, bodiesToPropagate, centralBodies );
 
-    std::shared_ptr< CapsuleAerodynamicGuidance > capsuleGuidance =
-            std::make_shared< CapsuleAerodynamicGuidance >( bodyMap, shapeParameters.at( 5 ) );
-    setGuidanceAnglesFunctions( capsuleGuidance, bodyMap.at( "Capsule" ) );
+    std::shared_ptr< tudat_applications::CapsuleAerodynamicGuidance > capsuleGuidance;
+    std::shared_ptr< tudat_applications::CapsuleTrimTable > trimTable;
+    if( useTrimmedFlight )
+    {
+        // Compute trim angle of attack for all Mach numbers of the aerodynamic database
+        trimTable = std::make_shared< tudat_applications::CapsuleTrimTable >(
+                    capsuleCoefficientInterface, shapeParameters.at( 5 ) );
+        capsuleGuidance = std::make_shared< tudat_applications::CapsuleAerodynamicGuidance >( bodyMap, trimTable );
+
+        Eigen::MatrixXd trimTableOutput( trimTable->getMachNumbers( ).rows( ), 3 );
+        trimTableOutput.col( 0 ) = trimTable->getMachNumbers( );
+        trimTableOutput.col( 1 ) = trimTable->getTrimAnglesOfAttack( );
+        trimTableOutput.col( 2 ) = trimTable->getIsTrimAvailable( ).cast< double >( );
+        input_output::writeMatrixToFile( trimTableOutput, "trimTable.dat", 16, outputPath );
+    }
+    else
+    {
+        capsuleGuidance = std::make_shared< tudat_applications::CapsuleAerodynamicGuidance >(
+                    bodyMap, shapeParameters.at( 5 ) );
+    }
+    tudat_applications::setInlinedGuidanceAnglesFunctions( capsuleGuidance, bodyMap.at( "Capsule" ) );
 
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     ///////////////////////             CREATE PROPAGATION SETTINGS            ////////////////////////////////////////////
@@ -313,7 +404,7 @@ int main( )
             std::make_shared< SingleDependentVariableSaveSettings >( altitude_dependent_variable, "Capsule", "Earth" );
     terminationSettingsList.push_back(
                 std::make_shared< PropagationDependentVariableTerminationSettings >(
-                    terminationDependentVariable, 25.0E3, true ) );
+                    terminationDependentVariable, terminationAltitude, true ) );
     terminationSettingsList.push_back( std::make_shared< PropagationTimeTerminationSettings >(
                                            24.0 * 3600.0 ) );
     std::shared_ptr< PropagationTerminationSettings > terminationSettings = std::make_shared<
@@ -327,6 +418,17 @@ int main( )
                                           airspeed_dependent_variable, "Capsule", "Earth" ) );
     dependentVariablesList.push_back( std::make_shared< SingleDependentVariableSaveSettings >(
                                           aerodynamic_force_coefficients_dependent_variable, "Capsule" ) );
+    std::shared_ptr< AtmosphericFlightConditions > capsuleFlightConditions =
+            std::dynamic_pointer_cast< AtmosphericFlightConditions >( bodyMap.at( "Capsule" )->getFlightConditions( ) );
+    dependentVariablesList.push_back( std::make_shared< CustomDependentVariableSaveSettings >(
+                                          [ = ]( )
+    {
+        return ( Eigen::VectorXd( 2 ) <<
+                 heatingTable->getConvectiveHeatFlux( capsuleFlightConditions->getCurrentDensity( ),
+                                                      capsuleFlightConditions->getCurrentAirspeed( ) ),
+                 heatingTable->getRadiativeHeatFlux( capsuleFlightConditions->getCurrentDensity( ),
+                                                     capsuleFlightConditions->getCurrentAirspeed( ) ) ).finished( );
+    }, 2 ) );
     std::shared_ptr< DependentVariableSaveSettings > dependentVariablesToSave =
             std::make_shared< DependentVariableSaveSettings >( dependentVariablesList );
 
@@ -349,13 +451,248 @@ int main( )
     SingleArcDynamicsSimulator< > dynamicsSimulator(
                 bodyMap, integratorSettings, propagatorSettings );
 
-    std::map< double, Eigen::VectorXd > propagatedStateHistory = dynamicsSimulator.getEquationsOfMotionNumericalSolution( );
-    std::map< double, Eigen::VectorXd > dependentVariableHistory = dynamicsSimulator.getDependentVariableHistory( );
+    const std::map< double, Eigen::VectorXd >& propagatedStateHistory =
+            dynamicsSimulator.getEquationsOfMotionNumericalSolution( );
+    const std::map< double, Eigen::VectorXd >& dependentVariableHistory = dynamicsSimulator.getDependentVariableHistory( );
 
 
     input_output::writeDataMapToTextFile( propagatedStateHistory, "stateHistory.dat", outputPath );
     input_output::writeDataMapToTextFile( dependentVariableHistory, "dependentVariables.dat", outputPath );
 
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ///////////////////////             BENCHMARK GUIDANCE CALLS            ///////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    if( benchmarkGuidanceCalls )
+    {
+        // Create guidance functions in the same manner as setGuidanceAnglesFunctions (virtual update through base class)
+        std::shared_ptr< aerodynamics::AerodynamicGuidance > baseGuidance = capsuleGuidance;
+        tudat_applications::AerodynamicGuidanceFunctions virtualGuidanceFunctions;
+        virtualGuidanceFunctions.angleOfAttackFunction =
+                std::bind( &aerodynamics::AerodynamicGuidance::getCurrentAngleOfAttack, baseGuidance );
+        virtualGuidanceFunctions.angleOfSideslipFunction =
+                std::bind( &aerodynamics::AerodynamicGuidance::getCurrentAngleOfSideslip, baseGuidance );
+        virtualGuidanceFunctions.bankAngleFunction =
+                std::bind( &aerodynamics::AerodynamicGuidance::getCurrentBankAngle, baseGuidance );
+        virtualGuidanceFunctions.angleUpdateFunction =
+                std::bind( &aerodynamics::AerodynamicGuidance::updateGuidance, baseGuidance, std::placeholders::_1 );
+        tudat_applications::AerodynamicGuidanceFunctions inlinedGuidanceFunctions =
+                tudat_applications::createAerodynamicGuidanceFunctions( capsuleGuidance );
+
+        // Update guidance and retrieve angles (as done by the aerodynamic angle calculator) over the propagated time interval
+        double benchmarkTimeStep = ( propagatedStateHistory.rbegin( )->first - simulationStartEpoch ) /
+                static_cast< double >( numberOfBenchmarkGuidanceCalls );
+        double angleSum = 0.0;
+        auto computeAverageUpdateTime = [ & ]( const tudat_applications::AerodynamicGuidanceFunctions& guidanceFunctions )
+        {
+            return tudat_applications::computeAverageCallTime(
+                        [ & ]( const double time )
+            {
+                guidanceFunctions.angleUpdateFunction( time );
+                angleSum += guidanceFunctions.angleOfAttackFunction( ) + guidanceFunctions.angleOfSideslipFunction( ) +
+                        guidanceFunctions.bankAngleFunction( );
+            }, numberOfBenchmarkGuidanceCalls, simulationStartEpoch, benchmarkTimeStep );
+        };
+        std::map< std::string, double > averageCallTimes;
+        averageCallTimes[ "Aerodynamic guidance (virtual)" ] = computeAverageUpdateTime( virtualGuidanceFunctions );
+        averageCallTimes[ "Aerodynamic guidance (adapter)" ] = computeAverageUpdateTime( inlinedGuidanceFunctions );
+
+        for( const auto& callTimeIterator : averageCallTimes )
+        {
+            std::cout << callTimeIterator.first << ": " << callTimeIterator.second << " ns per update" << std::endl;
+        }
+        std::cout << "(checksum " << angleSum << ")" << std::endl;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ///////////////////////             CREATE CONCURRENT ENTRY ENVIRONMENT            ////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // Create body map, acceleration models and guidance for each thread, with a copy of the aerodynamic database that is shared
+    // by all threads
+    int numberOfThreads = tudat_applications::getDefaultNumberOfThreads( );
+    std::vector< NamedBodyMap > threadBodyMaps;
+    std::vector< basic_astrodynamics::AccelerationMap > threadAccelerationModelMaps;
+    std::vector< std::shared_ptr< tudat_applications::CapsuleAerodynamicGuidance > > threadGuidances;
+    if( findEntryCorridor || findLandingFootprint )
+    {
+        std::shared_ptr< const tudat_applications::CapsuleCoefficientTable > coefficientTable =
+                std::make_shared< tudat_applications::CapsuleCoefficientTable >( capsuleCoefficientInterface );
+        for( int i = 0; i < numberOfThreads; i++ )
+        {
+            threadBodyMaps.push_back( getConcurrentEntryBodyMap(
+                                          simulationStartEpoch, bodyMap.at( "Capsule" )->getBodyMass( ), coefficientTable ) );
+            threadAccelerationModelMaps.push_back( createAccelerationModelsMap(
+                                                       threadBodyMaps.at( i ), accelerationMap, bodiesToPropagate,
+                                                       centralBodies ) );
+            threadGuidances.push_back(
+                        useTrimmedFlight ?
+                            std::make_shared< tudat_applications::CapsuleAerodynamicGuidance >(
+                                threadBodyMaps.at( i ), trimTable ) :
+                            std::make_shared< tudat_applications::CapsuleAerodynamicGuidance >(
+                                threadBodyMaps.at( i ), shapeParameters.at( 5 ) ) );
+            tudat_applications::setInlinedGuidanceAnglesFunctions(
+                        threadGuidances.at( i ), threadBodyMaps.at( i ).at( "Capsule" ) );
+        }
+    }
+
+    const double earthRadius = spice_interface::getAverageRadius( "Earth" );
+    const double entryAltitude = capsuleSphericalEntryState( SphericalOrbitalStateElementIndices::radiusIndex ) - earthRadius;
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ///////////////////////             COMPUTE ENTRY CORRIDOR            /////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    if( findEntryCorridor )
+    {
+        // Outcome of entry: terminated as soon as termination altitude is reached (same as nominal entry), a limit is
+        // exceeded, or the capsule skips out
+        auto computeEntryOutcome = [ & ]( const double flightPathAngle, const int threadIndex )
+        {
+            const NamedBodyMap& threadBodyMap = threadBodyMaps.at( threadIndex );
+            std::shared_ptr< AtmosphericFlightConditions > flightConditions =
+                    std::dynamic_pointer_cast< AtmosphericFlightConditions >(
+                        threadBodyMap.at( "Capsule" )->getFlightConditions( ) );
+            std::shared_ptr< AccelerationModel3d > aerodynamicAcceleration =
+                    threadAccelerationModelMaps.at( threadIndex ).at( "Capsule" ).at( "Earth" ).at( 1 );
+
+            tudat_applications::EntryOutcome entryOutcome = tudat_applications::entry_skip;
+            std::function< bool( const double ) > checkEntryTermination = [ & ]( const double currentTime )
+            {
+                if( flightConditions->getCurrentAltitude( ) < terminationAltitude )
+                {
+                    entryOutcome = tudat_applications::entry_capture;
+                    return true;
+                }
+
+                // Stagnation point heat flux (convective and radiative), and aerodynamic load
+                const double stagnationHeatFlux = heatingTable->getHeatFlux(
+                            flightConditions->getCurrentDensity( ), flightConditions->getCurrentAirspeed( ) );
+                const double aerodynamicLoad = aerodynamicAcceleration->getAcceleration( ).norm( ) /
+                        physical_constants::SEA_LEVEL_GRAVITATIONAL_ACCELERATION;
+                if( stagnationHeatFlux > maximumStagnationHeatFlux || aerodynamicLoad > maximumAerodynamicLoad )
+                {
+                    entryOutcome = tudat_applications::entry_limit_exceeded;
+                    return true;
+                }
+
+                if( flightConditions->getCurrentAltitude( ) > entryAltitude ||
+                        currentTime > simulationStartEpoch + maximumConcurrentEntryDuration )
+                {
+                    entryOutcome = tudat_applications::entry_skip;
+                    return true;
+                }
+                return false;
+            };
+
+            Eigen::Vector6d corridorSphericalEntryState = capsuleSphericalEntryState;
+            corridorSphericalEntryState( SphericalOrbitalStateElementIndices::flightPathIndex ) = flightPathAngle;
+            Eigen::Vector6d corridorInitialState = transformStateToGlobalFrame(
+                        convertSphericalOrbitalToCartesianState( corridorSphericalEntryState ), simulationStartEpoch,
+                        threadBodyMap.at( "Earth" )->getRotationalEphemeris( ) );
+
+            SingleArcDynamicsSimulator< > corridorDynamicsSimulator(
+                        threadBodyMap, std::make_shared< IntegratorSettings< > >(
+                            rungeKutta4, simulationStartEpoch, fixedStepSize ),
+                        std::make_shared< TranslationalStatePropagatorSettings< double > >(
+                            centralBodies, threadAccelerationModelMaps.at( threadIndex ), bodiesToPropagate,
+                            corridorInitialState, std::make_shared< PropagationCustomTerminationSettings >(
+                                checkEntryTermination ), propagatorType ) );
+            return entryOutcome;
+        };
+
+        tudat_applications::EntryCorridor entryCorridor = tudat_applications::computeEntryCorridor(
+                    computeEntryOutcome, steepestCorridorFlightPathAngle, shallowestCorridorFlightPathAngle,
+                    entryCorridorTolerance, 16, numberOfThreads );
+
+        std::cout << "Entry corridor: " << unit_conversions::convertRadiansToDegrees( entryCorridor.steepestFlightPathAngle )
+                  << " to " << unit_conversions::convertRadiansToDegrees( entryCorridor.shallowestFlightPathAngle )
+                  << " deg (" << entryCorridor.numberOfEvaluations << " entries in "
+                  << entryCorridor.numberOfIterations << " iterations)" << std::endl;
+        input_output::writeMatrixToFile(
+                    ( Eigen::Vector3d( ) << entryCorridor.steepestFlightPathAngle, entryCorridor.shallowestFlightPathAngle,
+                      entryCorridor.getWidth( ) ).finished( ), "entryCorridor.dat", 16, outputPath );
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ///////////////////////             COMPUTE LANDING FOOTPRINT            //////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    if( findLandingFootprint )
+    {
+        // Define bank angle profiles: constant bank angles, and all non-zero bank angles reversed once at each reversal time
+        std::vector< tudat_applications::BankAngleProfile > bankAngleProfiles;
+        for( int i = 0; i < numberOfFootprintBankAngles; i++ )
+        {
+            bankAngleProfiles.push_back( tudat_applications::BankAngleProfile(
+                                             maximumFootprintBankAngle * ( 2.0 * static_cast< double >( i ) /
+                                             static_cast< double >( numberOfFootprintBankAngles - 1 ) - 1.0 ) ) );
+        }
+        for( int j = 1; j <= numberOfFootprintReversalTimes; j++ )
+        {
+            for( int i = 0; i < numberOfFootprintBankAngles; i++ )
+            {
+                if( bankAngleProfiles.at( i ).initialBankAngle != 0.0 )
+                {
+                    bankAngleProfiles.push_back( tudat_applications::BankAngleProfile(
+                                                     bankAngleProfiles.at( i ).initialBankAngle,
+                                                     { simulationStartEpoch + static_cast< double >( j ) *
+                                                       footprintReversalTimeSpacing } ) );
+                }
+            }
+        }
+
+        // Landing point of entry: downrange and crossrange when termination altitude is reached (same as nominal entry), NaN
+        // if the capsule skips out
+        auto computeLandingPoint = [ & ]( const tudat_applications::BankAngleProfile& bankAngleProfile, const int threadIndex )
+        {
+            const NamedBodyMap& threadBodyMap = threadBodyMaps.at( threadIndex );
+            std::shared_ptr< FlightConditions > flightConditions = threadBodyMap.at( "Capsule" )->getFlightConditions( );
+            threadGuidances.at( threadIndex )->setBankAngleProfile( bankAngleProfile );
+
+            bool isLanded = false;
+            std::function< bool( const double ) > checkLandingTermination = [ & ]( const double currentTime )
+            {
+                isLanded = flightConditions->getCurrentAltitude( ) < terminationAltitude;
+                return isLanded || flightConditions->getCurrentAltitude( ) > entryAltitude ||
+                        currentTime > simulationStartEpoch + maximumConcurrentEntryDuration;
+            };
+
+            SingleArcDynamicsSimulator< > footprintDynamicsSimulator(
+                        threadBodyMap, std::make_shared< IntegratorSettings< > >(
+                            rungeKutta4, simulationStartEpoch, fixedStepSize ),
+                        std::make_shared< TranslationalStatePropagatorSettings< double > >(
+                            centralBodies, threadAccelerationModelMaps.at( threadIndex ), bodiesToPropagate,
+                            systemInitialState, std::make_shared< PropagationCustomTerminationSettings >(
+                                checkLandingTermination ), propagatorType ) );
+            if( !isLanded )
+            {
+                return Eigen::Vector2d::Constant( TUDAT_NAN ).eval( );
+            }
+
+            // Compute latitude and longitude of landing point
+            const std::map< double, Eigen::VectorXd >& footprintStateHistory =
+                    footprintDynamicsSimulator.getEquationsOfMotionNumericalSolution( );
+            Eigen::Vector3d landingPosition =
+                    threadBodyMap.at( "Earth" )->getRotationalEphemeris( )->getRotationToTargetFrame(
+                        footprintStateHistory.rbegin( )->first ) * footprintStateHistory.rbegin( )->second.segment( 0, 3 );
+            return tudat_applications::computeDownrangeAndCrossrange(
+                        capsuleSphericalEntryState( SphericalOrbitalStateElementIndices::latitudeIndex ),
+                        capsuleSphericalEntryState( SphericalOrbitalStateElementIndices::longitudeIndex ),
+                        capsuleSphericalEntryState( SphericalOrbitalStateElementIndices::headingAngleIndex ),
+                        std::asin( landingPosition.z( ) / landingPosition.norm( ) ),
+                        std::atan2( landingPosition.y( ), landingPosition.x( ) ), earthRadius );
+        };
+
+        tudat_applications::LandingFootprint landingFootprint = tudat_applications::computeLandingFootprint(
+                    computeLandingPoint, bankAngleProfiles, numberOfThreads );
+
+        std::cout << "Landing footprint: " << landingFootprint.boundary.rows( ) << " vertices, area "
+                  << landingFootprint.getArea( ) / 1.0E6 << " km^2 (" << bankAngleProfiles.size( ) << " entries)" << std::endl;
+        input_output::writeMatrixToFile( landingFootprint.boundary, "landingFootprint.dat", 16, outputPath );
+        input_output::writeMatrixToFile( landingFootprint.landingPoints, "landingPoints.dat", 16, outputPath );
+    }
+
     // The exit code EXIT_SUCCESS indicates that the program was successfully executed.
     return EXIT_SUCCESS;
 }
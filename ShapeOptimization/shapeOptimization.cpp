@@ -0,0 +1,601 @@
+/*    Copyright (c) 2010-2018, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "../parallelExecution.h"
+#include "shapeOptimization.h"
+
+namespace tudat_applications
+{
+
+//! Constructor
+CapsuleCoefficientTable::CapsuleCoefficientTable(
+        const std::shared_ptr< tudat::aerodynamics::HypersonicLocalInclinationAnalysis > coefficientInterface ):
+    referenceLength_( coefficientInterface->getReferenceLength( ) ),
+    referenceArea_( coefficientInterface->getReferenceArea( ) ),
+    lateralReferenceLength_( coefficientInterface->getLateralReferenceLength( ) ),
+    momentReferencePoint_( coefficientInterface->getMomentReferencePoint( ) ),
+    areCoefficientsInAerodynamicFrame_( coefficientInterface->getAreCoefficientsInAerodynamicFrame( ) ),
+    areCoefficientsInNegativeAxisDirection_( coefficientInterface->getAreCoefficientsInNegativeAxisDirection( ) )
+{
+    // Retrieve independent variables of database (Mach number, angle of attack, angle of sideslip)
+    independentVariablePoints_.resize( 3 );
+    for( unsigned int i = 0; i < 3; i++ )
+    {
+        for( int j = 0; j < coefficientInterface->getNumberOfValuesOfIndependentVariable( i ); j++ )
+        {
+            independentVariablePoints_[ i ].push_back( coefficientInterface->getIndependentVariablePoint( i, j ) );
+        }
+    }
+
+    // Copy coefficients at all data points
+    for( unsigned int i = 0; i < independentVariablePoints_[ 0 ].size( ); i++ )
+    {
+        for( unsigned int j = 0; j < independentVariablePoints_[ 1 ].size( ); j++ )
+        {
+            for( unsigned int k = 0; k < independentVariablePoints_[ 2 ].size( ); k++ )
+            {
+                coefficients_.push_back( coefficientInterface->getAerodynamicCoefficientsDataPoint(
+                { { static_cast< int >( i ), static_cast< int >( j ), static_cast< int >( k ) } } ) );
+            }
+        }
+    }
+}
+
+//! Function to compute the force and moment coefficients
+Eigen::Vector6d CapsuleCoefficientTable::getCoefficients( const std::vector< double >& independentVariables ) const
+{
+    // Determine lower index and interpolation weight of upper point for each independent variable
+    int lowerIndices[ 3 ];
+    double upperWeights[ 3 ];
+    for( unsigned int i = 0; i < 3; i++ )
+    {
+        const std::vector< double >& points = independentVariablePoints_[ i ];
+        if( points.size( ) == 1 || !( independentVariables.at( i ) > points.front( ) ) )
+        {
+            lowerIndices[ i ] = 0;
+            upperWeights[ i ] = 0.0;
+        }
+        else if( independentVariables.at( i ) >= points.back( ) )
+        {
+            lowerIndices[ i ] = points.size( ) - 2;
+            upperWeights[ i ] = 1.0;
+        }
+        else
+        {
+            lowerIndices[ i ] = std::upper_bound( points.begin( ), points.end( ), independentVariables.at( i ) ) -
+                    points.begin( ) - 1;
+            upperWeights[ i ] = ( independentVariables.at( i ) - points[ lowerIndices[ i ] ] ) /
+                    ( points[ lowerIndices[ i ] + 1 ] - points[ lowerIndices[ i ] ] );
+        }
+    }
+
+    // Interpolate linearly in all independent variables (sum over corners of the enclosing cell)
+    const int numberOfAnglesOfAttack = independentVariablePoints_[ 1 ].size( );
+    const int numberOfAnglesOfSideslip = independentVariablePoints_[ 2 ].size( );
+    Eigen::Vector6d coefficients = Eigen::Vector6d::Zero( );
+    for( int corner = 0; corner < 8; corner++ )
+    {
+        double weight = 1.0;
+        int offsets[ 3 ];
+        for( unsigned int i = 0; i < 3; i++ )
+        {
+            offsets[ i ] = ( corner >> i ) & 1;
+            weight *= offsets[ i ] ? upperWeights[ i ] : ( 1.0 - upperWeights[ i ] );
+        }
+        if( weight > 0.0 )
+        {
+            coefficients += weight * coefficients_[
+                    ( ( lowerIndices[ 0 ] + offsets[ 0 ] ) * numberOfAnglesOfAttack + lowerIndices[ 1 ] + offsets[ 1 ] ) *
+                    numberOfAnglesOfSideslip + lowerIndices[ 2 ] + offsets[ 2 ] ];
+        }
+    }
+    return coefficients;
+}
+
+//! Function to create a coefficient interface that interpolates in a (shared) tabulated aerodynamic database
+std::shared_ptr< tudat::aerodynamics::AerodynamicCoefficientInterface > createCapsuleCoefficientInterface(
+        const std::shared_ptr< const CapsuleCoefficientTable > coefficientTable )
+{
+    using namespace tudat::aerodynamics;
+
+    return std::make_shared< CustomAerodynamicCoefficientInterface >(
+                [ = ]( const std::vector< double >& independentVariables ) -> Eigen::Vector3d
+    {
+        return coefficientTable->getCoefficients( independentVariables ).segment( 0, 3 );
+    },
+    [ = ]( const std::vector< double >& independentVariables ) -> Eigen::Vector3d
+    {
+        return coefficientTable->getCoefficients( independentVariables ).segment( 3, 3 );
+    },
+    coefficientTable->getReferenceLength( ), coefficientTable->getReferenceArea( ),
+    coefficientTable->getLateralReferenceLength( ), coefficientTable->getMomentReferencePoint( ),
+    std::vector< AerodynamicCoefficientsIndependentVariables >{
+        mach_number_dependent, angle_of_attack_dependent, angle_of_sideslip_dependent },
+    coefficientTable->getAreCoefficientsInAerodynamicFrame( ),
+    coefficientTable->getAreCoefficientsInNegativeAxisDirection( ) );
+}
+
+//! Function to compute the stable trim angle of attack for each row of a table of pitch moment coefficients
+Eigen::VectorXd computeTrimAnglesOfAttack(
+        const Eigen::MatrixXd& pitchMomentCoefficients,
+        const Eigen::VectorXd& anglesOfAttack,
+        const double referenceAngleOfAttack,
+        Eigen::Array< bool, Eigen::Dynamic, 1 >& isTrimAvailable )
+{
+    if( pitchMomentCoefficients.cols( ) != anglesOfAttack.rows( ) || anglesOfAttack.rows( ) < 2 )
+    {
+        throw std::runtime_error( "Error when computing trim angles of attack, inconsistent table size" );
+    }
+
+    // Locate stable zero crossings in all rows, for each angle of attack interval
+    const int numberOfRows = pitchMomentCoefficients.rows( );
+    Eigen::ArrayXd trimAnglesOfAttack = Eigen::ArrayXd::Constant( numberOfRows, TUDAT_NAN );
+    Eigen::ArrayXd distanceToReference = Eigen::ArrayXd::Constant( numberOfRows, std::numeric_limits< double >::infinity( ) );
+    for( int j = 0; j < anglesOfAttack.rows( ) - 1; j++ )
+    {
+        const Eigen::ArrayXd lowerCoefficients = pitchMomentCoefficients.col( j ).array( );
+        const Eigen::ArrayXd upperCoefficients = pitchMomentCoefficients.col( j + 1 ).array( );
+        const Eigen::ArrayXd crossingAnglesOfAttack = anglesOfAttack( j ) +
+                ( anglesOfAttack( j + 1 ) - anglesOfAttack( j ) ) * lowerCoefficients /
+                ( lowerCoefficients - upperCoefficients );
+        const Eigen::ArrayXd crossingDistances = ( crossingAnglesOfAttack - referenceAngleOfAttack ).abs( );
+        const Eigen::Array< bool, Eigen::Dynamic, 1 > isCloserStableCrossing =
+                ( lowerCoefficients > 0.0 ) && ( upperCoefficients <= 0.0 ) && ( crossingDistances < distanceToReference );
+        trimAnglesOfAttack = isCloserStableCrossing.select( crossingAnglesOfAttack, trimAnglesOfAttack );
+        distanceToReference = isCloserStableCrossing.select( crossingDistances, distanceToReference );
+    }
+    isTrimAvailable = ( distanceToReference < std::numeric_limits< double >::infinity( ) );
+
+    // Use angle of attack with smallest moment where no stable trim point exists
+    for( int i = 0; i < numberOfRows; i++ )
+    {
+        if( !isTrimAvailable( i ) )
+        {
+            int minimumMomentIndex;
+            pitchMomentCoefficients.row( i ).cwiseAbs( ).minCoeff( &minimumMomentIndex );
+            trimAnglesOfAttack( i ) = anglesOfAttack( minimumMomentIndex );
+        }
+    }
+
+    return trimAnglesOfAttack.matrix( );
+}
+
+//! Constructor
+CapsuleTrimTable::CapsuleTrimTable(
+        const std::shared_ptr< tudat::aerodynamics::HypersonicLocalInclinationAnalysis > coefficientInterface,
+        const double referenceAngleOfAttack,
+        const int numberOfTablePoints )
+{
+    if( numberOfTablePoints < 2 )
+    {
+        throw std::runtime_error( "Error when creating trim table, at least two table points required" );
+    }
+
+    // Retrieve independent variables of database (Mach number, angle of attack, angle of sideslip)
+    const int numberOfMachNumbers = coefficientInterface->getNumberOfValuesOfIndependentVariable( 0 );
+    const int numberOfAnglesOfAttack = coefficientInterface->getNumberOfValuesOfIndependentVariable( 1 );
+    machNumbers_.resize( numberOfMachNumbers );
+    for( int i = 0; i < numberOfMachNumbers; i++ )
+    {
+        machNumbers_( i ) = coefficientInterface->getIndependentVariablePoint( 0, i );
+    }
+    Eigen::VectorXd anglesOfAttack( numberOfAnglesOfAttack );
+    for( int j = 0; j < numberOfAnglesOfAttack; j++ )
+    {
+        anglesOfAttack( j ) = coefficientInterface->getIndependentVariablePoint( 1, j );
+    }
+    int zeroSideslipIndex = -1;
+    for( int k = 0; k < coefficientInterface->getNumberOfValuesOfIndependentVariable( 2 ); k++ )
+    {
+        if( coefficientInterface->getIndependentVariablePoint( 2, k ) == 0.0 )
+        {
+            zeroSideslipIndex = k;
+        }
+    }
+    if( zeroSideslipIndex < 0 )
+    {
+        throw std::runtime_error( "Error when creating trim table, no data at zero angle of sideslip" );
+    }
+
+    // Retrieve pitch moment coefficients at zero sideslip, and compute trim angles of attack
+    Eigen::MatrixXd pitchMomentCoefficients( numberOfMachNumbers, numberOfAnglesOfAttack );
+    for( int i = 0; i < numberOfMachNumbers; i++ )
+    {
+        for( int j = 0; j < numberOfAnglesOfAttack; j++ )
+        {
+            pitchMomentCoefficients( i, j ) = coefficientInterface->getAerodynamicCoefficientsDataPoint(
+            { { i, j, zeroSideslipIndex } } )( 4 );
+        }
+    }
+    trimAnglesOfAttack_ = computeTrimAnglesOfAttack(
+                pitchMomentCoefficients, anglesOfAttack, referenceAngleOfAttack, isTrimAvailable_ );
+
+    // Resample to equispaced table (linear interpolation between Mach numbers of database)
+    minimumMachNumber_ = machNumbers_( 0 );
+    machNumberStep_ = ( machNumbers_( numberOfMachNumbers - 1 ) - minimumMachNumber_ ) /
+            static_cast< double >( numberOfTablePoints - 1 );
+    tableTrimAnglesOfAttack_.resize( numberOfTablePoints );
+    int lowerIndex = 0;
+    for( int i = 0; i < numberOfTablePoints; i++ )
+    {
+        const double machNumber = std::min( minimumMachNumber_ + static_cast< double >( i ) * machNumberStep_,
+                                            machNumbers_( numberOfMachNumbers - 1 ) );
+        while( lowerIndex < numberOfMachNumbers - 2 && machNumbers_( lowerIndex + 1 ) < machNumber )
+        {
+            lowerIndex++;
+        }
+        if( numberOfMachNumbers == 1 )
+        {
+            tableTrimAnglesOfAttack_( i ) = trimAnglesOfAttack_( 0 );
+        }
+        else
+        {
+            tableTrimAnglesOfAttack_( i ) = trimAnglesOfAttack_( lowerIndex ) +
+                    ( machNumber - machNumbers_( lowerIndex ) ) /
+                    ( machNumbers_( lowerIndex + 1 ) - machNumbers_( lowerIndex ) ) *
+                    ( trimAnglesOfAttack_( lowerIndex + 1 ) - trimAnglesOfAttack_( lowerIndex ) );
+        }
+    }
+    if( numberOfMachNumbers == 1 )
+    {
+        machNumberStep_ = 1.0;
+    }
+}
+
+//! Constructor for trimmed flight
+CapsuleAerodynamicGuidance::CapsuleAerodynamicGuidance(
+        const tudat::simulation_setup::NamedBodyMap bodyMap,
+        const std::shared_ptr< CapsuleTrimTable > trimTable,
+        const std::string& vehicleName ):
+    bodyMap_( bodyMap ), fixedAngleOfAttack_( TUDAT_NAN ), trimTable_( trimTable ), vehicleName_( vehicleName )
+{
+
+}
+
+//! Function to compute the entry corridor (range of flight path angles at which the vehicle is captured within the limits)
+EntryCorridor computeEntryCorridor(
+        const EntryOutcomeFunction& outcomeFunction,
+        const double steepestFlightPathAngle,
+        const double shallowestFlightPathAngle,
+        const double tolerance,
+        const int numberOfScanPoints,
+        const int numberOfThreads )
+{
+    if( !( steepestFlightPathAngle < shallowestFlightPathAngle ) || !( tolerance > 0.0 ) || numberOfScanPoints < 2 )
+    {
+        throw std::runtime_error( "Error when computing entry corridor, invalid search range, tolerance or number of points" );
+    }
+    const int numberOfUsedThreads = ( numberOfThreads < 1 ) ? getDefaultNumberOfThreads( ) : numberOfThreads;
+
+    EntryCorridor entryCorridor;
+    entryCorridor.shallowestFlightPathAngle = TUDAT_NAN;
+    entryCorridor.steepestFlightPathAngle = TUDAT_NAN;
+    entryCorridor.numberOfIterations = 0;
+    entryCorridor.numberOfEvaluations = 0;
+
+    // Function to propagate entries at a set of flight path angles concurrently
+    auto computeOutcomes = [ & ]( const std::vector< double >& flightPathAngles )
+    {
+        std::vector< EntryOutcome > outcomes( flightPathAngles.size( ) );
+        parallelForEachIndex( flightPathAngles.size( ), [ & ]( const int index, const int threadIndex )
+        {
+            outcomes[ index ] = outcomeFunction( flightPathAngles[ index ], threadIndex );
+        }, numberOfUsedThreads );
+        entryCorridor.numberOfEvaluations += flightPathAngles.size( );
+        return outcomes;
+    };
+
+    // Scan full range, and find steepest and shallowest captured points
+    std::vector< double > scanFlightPathAngles;
+    for( int i = 0; i < numberOfScanPoints; i++ )
+    {
+        scanFlightPathAngles.push_back( steepestFlightPathAngle + static_cast< double >( i ) *
+                                        ( shallowestFlightPathAngle - steepestFlightPathAngle ) /
+                                        static_cast< double >( numberOfScanPoints - 1 ) );
+    }
+    std::vector< EntryOutcome > scanOutcomes = computeOutcomes( scanFlightPathAngles );
+    int steepestCaptureIndex = -1;
+    int shallowestCaptureIndex = -1;
+    for( int i = 0; i < numberOfScanPoints; i++ )
+    {
+        if( scanOutcomes.at( i ) == entry_capture )
+        {
+            if( steepestCaptureIndex < 0 )
+            {
+                steepestCaptureIndex = i;
+            }
+            shallowestCaptureIndex = i;
+        }
+    }
+    if( steepestCaptureIndex < 0 )
+    {
+        return entryCorridor;
+    }
+
+    // Brackets of both bounds: captured end, and end with other outcome (NaN if captured at bound of search range)
+    double shallowCapturedAngle = scanFlightPathAngles.at( shallowestCaptureIndex );
+    double shallowOtherAngle = ( shallowestCaptureIndex < numberOfScanPoints - 1 ) ?
+                scanFlightPathAngles.at( shallowestCaptureIndex + 1 ) : TUDAT_NAN;
+    double steepCapturedAngle = scanFlightPathAngles.at( steepestCaptureIndex );
+    double steepOtherAngle = ( steepestCaptureIndex > 0 ) ? scanFlightPathAngles.at( steepestCaptureIndex - 1 ) : TUDAT_NAN;
+
+    // Reduce open brackets by multisection, with points of all open brackets evaluated in one batch
+    while( true )
+    {
+        const bool isShallowBracketOpen = std::fabs( shallowOtherAngle - shallowCapturedAngle ) > tolerance;
+        const bool isSteepBracketOpen = std::fabs( steepOtherAngle - steepCapturedAngle ) > tolerance;
+        if( !isShallowBracketOpen && !isSteepBracketOpen )
+        {
+            break;
+        }
+        const int numberOfPointsPerBracket = std::max(
+                    1, numberOfUsedThreads / ( ( isShallowBracketOpen && isSteepBracketOpen ) ? 2 : 1 ) );
+
+        std::vector< double > flightPathAngles;
+        for( int i = 1; i <= numberOfPointsPerBracket; i++ )
+        {
+            const double fraction = static_cast< double >( i ) / static_cast< double >( numberOfPointsPerBracket + 1 );
+            if( isShallowBracketOpen )
+            {
+                flightPathAngles.push_back( shallowCapturedAngle + fraction * ( shallowOtherAngle - shallowCapturedAngle ) );
+            }
+            if( isSteepBracketOpen )
+            {
+                flightPathAngles.push_back( steepCapturedAngle + fraction * ( steepOtherAngle - steepCapturedAngle ) );
+            }
+        }
+        std::vector< EntryOutcome > outcomes = computeOutcomes( flightPathAngles );
+
+        // Reduce each bracket to the interval of the first change of outcome, starting from the captured end
+        bool isShallowBoundLocated = !isShallowBracketOpen;
+        bool isSteepBoundLocated = !isSteepBracketOpen;
+        for( unsigned int i = 0; i < flightPathAngles.size( ); i++ )
+        {
+            const bool isShallowPoint = isShallowBracketOpen && ( !isSteepBracketOpen || i % 2 == 0 );
+            bool& isBoundLocated = isShallowPoint ? isShallowBoundLocated : isSteepBoundLocated;
+            double& capturedAngle = isShallowPoint ? shallowCapturedAngle : steepCapturedAngle;
+            double& otherAngle = isShallowPoint ? shallowOtherAngle : steepOtherAngle;
+            if( !isBoundLocated )
+            {
+                if( outcomes.at( i ) == entry_capture )
+                {
+                    capturedAngle = flightPathAngles.at( i );
+                }
+                else
+                {
+                    otherAngle = flightPathAngles.at( i );
+                    isBoundLocated = true;
+                }
+            }
+        }
+        entryCorridor.numberOfIterations++;
+    }
+
+    entryCorridor.shallowestFlightPathAngle = shallowCapturedAngle;
+    entryCorridor.steepestFlightPathAngle = steepCapturedAngle;
+    return entryCorridor;
+}
+
+//! Function to compute the downrange and crossrange of a point w.r.t. the entry point and heading
+Eigen::Vector2d computeDownrangeAndCrossrange(
+        const double entryLatitude,
+        const double entryLongitude,
+        const double entryHeadingAngle,
+        const double latitude,
+        const double longitude,
+        const double radius )
+{
+    // Compute central angle and heading angle of great circle from entry point to point
+    const double longitudeDifference = longitude - entryLongitude;
+    const double centralAngle = std::acos( std::max( -1.0, std::min( 1.0,
+            std::sin( entryLatitude ) * std::sin( latitude ) +
+            std::cos( entryLatitude ) * std::cos( latitude ) * std::cos( longitudeDifference ) ) ) );
+    const double headingAngle = std::atan2(
+                std::sin( longitudeDifference ) * std::cos( latitude ),
+                std::cos( entryLatitude ) * std::sin( latitude ) -
+                std::sin( entryLatitude ) * std::cos( latitude ) * std::cos( longitudeDifference ) );
+
+    // Decompose into components along and perpendicular to entry great circle (right spherical triangle)
+    const double headingDifference = headingAngle - entryHeadingAngle;
+    return radius * ( Eigen::Vector2d( )
+                      << std::atan2( std::sin( centralAngle ) * std::cos( headingDifference ), std::cos( centralAngle ) ),
+                      std::asin( std::sin( centralAngle ) * std::sin( headingDifference ) ) ).finished( );
+}
+
+//! Function to compute the convex hull of a set of points in the plane
+Eigen::MatrixXd computeConvexHull( const Eigen::MatrixXd& points )
+{
+    // Sort finite points lexicographically
+    std::vector< int > sortedIndices;
+    for( int i = 0; i < points.rows( ); i++ )
+    {
+        if( points.row( i ).allFinite( ) )
+        {
+            sortedIndices.push_back( i );
+        }
+    }
+    std::sort( sortedIndices.begin( ), sortedIndices.end( ), [ & ]( const int firstIndex, const int secondIndex )
+    {
+        return ( points( firstIndex, 0 ) < points( secondIndex, 0 ) ) ||
+                ( points( firstIndex, 0 ) == points( secondIndex, 0 ) && points( firstIndex, 1 ) < points( secondIndex, 1 ) );
+    } );
+
+    // Function to compute whether the turn from first to second to third point is counterclockwise
+    auto isCounterclockwiseTurn = [ & ]( const int firstIndex, const int secondIndex, const int thirdIndex )
+    {
+        return ( points( secondIndex, 0 ) - points( firstIndex, 0 ) ) * ( points( thirdIndex, 1 ) - points( firstIndex, 1 ) ) -
+                ( points( secondIndex, 1 ) - points( firstIndex, 1 ) ) * ( points( thirdIndex, 0 ) - points( firstIndex, 0 ) )
+                > 0.0;
+    };
+
+    // Construct lower hull (left to right), followed by upper hull (right to left)
+    const int numberOfPoints = sortedIndices.size( );
+    std::vector< int > hullIndices;
+    for( int i = 0; i < numberOfPoints; i++ )
+    {
+        while( hullIndices.size( ) >= 2 && !isCounterclockwiseTurn(
+                   hullIndices.at( hullIndices.size( ) - 2 ), hullIndices.back( ), sortedIndices.at( i ) ) )
+        {
+            hullIndices.pop_back( );
+        }
+        hullIndices.push_back( sortedIndices.at( i ) );
+    }
+    const unsigned int lowerHullSize = hullIndices.size( ) + 1;
+    for( int i = numberOfPoints - 2; i >= 0; i-- )
+    {
+        while( hullIndices.size( ) >= lowerHullSize && !isCounterclockwiseTurn(
+                   hullIndices.at( hullIndices.size( ) - 2 ), hullIndices.back( ), sortedIndices.at( i ) ) )
+        {
+            hullIndices.pop_back( );
+        }
+        hullIndices.push_back( sortedIndices.at( i ) );
+    }
+    if( hullIndices.size( ) > 1 )
+    {
+        // Remove first point, which is repeated at the end
+        hullIndices.pop_back( );
+    }
+
+    Eigen::MatrixXd hull( hullIndices.size( ), 2 );
+    for( unsigned int i = 0; i < hullIndices.size( ); i++ )
+    {
+        hull.row( i ) = points.row( hullIndices.at( i ) ).segment( 0, 2 );
+    }
+    return hull;
+}
+
+//! Function to compute the area of the footprint
+double LandingFootprint::getArea( ) const
+{
+    double area = 0.0;
+    for( int i = 0; i < boundary.rows( ); i++ )
+    {
+        const int nextIndex = ( i + 1 ) % boundary.rows( );
+        area += boundary( i, 0 ) * boundary( nextIndex, 1 ) - boundary( nextIndex, 0 ) * boundary( i, 1 );
+    }
+    return 0.5 * area;
+}
+
+//! Function to compute the landing footprint of a vehicle, from a set of bank angle profiles
+LandingFootprint computeLandingFootprint(
+        const LandingPointFunction& landingPointFunction,
+        const std::vector< BankAngleProfile >& bankAngleProfiles,
+        const int numberOfThreads )
+{
+    LandingFootprint landingFootprint;
+    landingFootprint.landingPoints.resize( bankAngleProfiles.size( ), 2 );
+    parallelForEachIndex( bankAngleProfiles.size( ), [ & ]( const int index, const int threadIndex )
+    {
+        landingFootprint.landingPoints.row( index ) =
+                landingPointFunction( bankAngleProfiles.at( index ), threadIndex ).transpose( );
+    }, ( numberOfThreads < 1 ) ? getDefaultNumberOfThreads( ) : numberOfThreads );
+
+    landingFootprint.boundary = computeConvexHull( landingFootprint.landingPoints );
+    return landingFootprint;
+}
+
+//! Constructor
+StagnationPointHeatingTable::StagnationPointHeatingTable(
+        const double noseRadius,
+        const double minimumDensity,
+        const double maximumDensity,
+        const double maximumVelocity,
+        const int numberOfDensityPoints,
+        const int numberOfVelocityPoints )
+{
+    if( !( noseRadius > 0.0 ) || !( minimumDensity > 0.0 ) || !( maximumDensity > minimumDensity ) ||
+            !( maximumVelocity > 0.0 ) || numberOfDensityPoints < 2 || numberOfVelocityPoints < 2 )
+    {
+        throw std::runtime_error( "Error when creating stagnation point heating table, invalid nose radius or table range" );
+    }
+
+    suttonGravesCoefficient_ = 1.7415E-4 / std::sqrt( noseRadius );
+    minimumLogarithmicDensity_ = std::log10( minimumDensity );
+    logarithmicDensityStep_ = ( std::log10( maximumDensity ) - minimumLogarithmicDensity_ ) /
+            static_cast< double >( numberOfDensityPoints - 1 );
+    velocityStep_ = maximumVelocity / static_cast< double >( numberOfVelocityPoints - 1 );
+
+    // Velocity function of radiative heat flux for Earth entry (Tauber and Sutton, 1991)
+    const std::vector< double > radiationFunctionVelocities =
+    { 9.0E3, 9.25E3, 9.5E3, 9.75E3, 10.0E3, 10.25E3, 10.5E3, 10.75E3, 11.0E3, 11.5E3,
+      12.0E3, 12.5E3, 13.0E3, 13.5E3, 14.0E3, 14.5E3, 15.0E3, 15.5E3, 16.0E3 };
+    const std::vector< double > radiationFunctionValues =
+    { 1.5, 4.3, 9.7, 19.5, 35.0, 55.0, 81.0, 115.0, 151.0, 238.0,
+      359.0, 495.0, 660.0, 850.0, 1065.0, 1313.0, 1550.0, 1780.0, 2040.0 };
+
+    // Maximum exponent of nose radius, depending on nose radius
+    const double maximumNoseRadiusExponent = ( noseRadius <= 1.0 ) ? 1.0 : ( ( noseRadius <= 2.0 ) ? 0.6 : 0.5 );
+
+    radiativeHeatFluxes_ = Eigen::MatrixXd::Zero( numberOfDensityPoints, numberOfVelocityPoints );
+    for( int j = 0; j < numberOfVelocityPoints; j++ )
+    {
+        // Interpolate velocity function linearly (zero below lowest velocity, boundary value above highest velocity)
+        const double velocity = static_cast< double >( j ) * velocityStep_;
+        if( velocity < radiationFunctionVelocities.front( ) )
+        {
+            continue;
+        }
+        double radiationFunctionValue = radiationFunctionValues.back( );
+        if( velocity < radiationFunctionVelocities.back( ) )
+        {
+            const int lowerIndex = std::upper_bound( radiationFunctionVelocities.begin( ), radiationFunctionVelocities.end( ),
+                                                     velocity ) - radiationFunctionVelocities.begin( ) - 1;
+            radiationFunctionValue = radiationFunctionValues.at( lowerIndex ) +
+                    ( velocity - radiationFunctionVelocities.at( lowerIndex ) ) /
+                    ( radiationFunctionVelocities.at( lowerIndex + 1 ) - radiationFunctionVelocities.at( lowerIndex ) ) *
+                    ( radiationFunctionValues.at( lowerIndex + 1 ) - radiationFunctionValues.at( lowerIndex ) );
+        }
+
+        for( int i = 0; i < numberOfDensityPoints; i++ )
+        {
+            // Compute radiative heat flux (converted from W/cm^2)
+            const double density = std::pow( 10.0, minimumLogarithmicDensity_ + static_cast< double >( i ) *
+                                             logarithmicDensityStep_ );
+            const double noseRadiusExponent = std::min(
+                        1.072E6 * std::pow( velocity, -1.88 ) * std::pow( density, -0.325 ), maximumNoseRadiusExponent );
+            radiativeHeatFluxes_( i, j ) = 4.736E4 * std::pow( noseRadius, noseRadiusExponent ) *
+                    std::pow( density, 1.22 ) * radiationFunctionValue * 1.0E4;
+        }
+    }
+}
+
+//! Function to compute the radiative heat flux (W/m^2), from the freestream density and velocity
+double StagnationPointHeatingTable::getRadiativeHeatFlux( const double density, const double velocity ) const
+{
+    if( !( density > 0.0 ) || !( velocity > 0.0 ) )
+    {
+        return 0.0;
+    }
+
+    // Compute position in table, limited to table range
+    const int numberOfDensityPoints = radiativeHeatFluxes_.rows( );
+    const int numberOfVelocityPoints = radiativeHeatFluxes_.cols( );
+    const double densityPosition = std::max( 0.0, std::min(
+            ( std::log10( density ) - minimumLogarithmicDensity_ ) / logarithmicDensityStep_,
+            static_cast< double >( numberOfDensityPoints - 1 ) ) );
+    const double velocityPosition = std::min( velocity / velocityStep_, static_cast< double >( numberOfVelocityPoints - 1 ) );
+    const int densityIndex = std::min( static_cast< int >( densityPosition ), numberOfDensityPoints - 2 );
+    const int velocityIndex = std::min( static_cast< int >( velocityPosition ), numberOfVelocityPoints - 2 );
+    const double densityWeight = densityPosition - static_cast< double >( densityIndex );
+    const double velocityWeight = velocityPosition - static_cast< double >( velocityIndex );
+
+    // Interpolate bilinearly
+    return ( 1.0 - densityWeight ) * ( ( 1.0 - velocityWeight ) * radiativeHeatFluxes_( densityIndex, velocityIndex ) +
+                                       velocityWeight * radiativeHeatFluxes_( densityIndex, velocityIndex + 1 ) ) +
+            densityWeight * ( ( 1.0 - velocityWeight ) * radiativeHeatFluxes_( densityIndex + 1, velocityIndex ) +
+                              velocityWeight * radiativeHeatFluxes_( densityIndex + 1, velocityIndex + 1 ) );
+}
+
+} // namespace tudat_applications
@@ -0,0 +1,545 @@
+/*    Copyright (c) 2010-2018, Delft University of Technology
+ *    All rigths reserved
+ *
+ *    This file is part of the Tudat. Redistribution and use in source and
+ *    binary forms, with or without modification, are permitted exclusively
+ *    under the terms of the Modified BSD license. You should have received
+ *    a copy of the license with this file. If not, please or visit:
+ *    http://tudat.tudelft.nl/LICENSE.
+ */
+
+#ifndef TUDAT_SHAPEOPTIMIZATION_H
+#define TUDAT_SHAPEOPTIMIZATION_H
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <Tudat/Astrodynamics/Aerodynamics/hypersonicLocalInclinationAnalysis.h>
+#include <Tudat/SimulationSetup/tudatSimulationHeader.h>
+
+namespace tudat_applications
+{
+
+//! Class containing a tabulated copy of the aerodynamic database of a capsule, which can be shared between threads
+/*!
+ *  Class containing a tabulated copy of the aerodynamic database of a capsule (force and moment coefficients as a function of
+ *  Mach number, angle of attack and angle of sideslip), which can be shared between threads. The coefficient interface of
+ *  the database stores the current coefficients, and its interpolator stores the current interval, so that it cannot be used
+ *  by concurrent propagations. This table is not modified after its creation; each concurrent propagation uses its own
+ *  (lightweight) coefficient interface, which interpolates in the shared table (see createCapsuleCoefficientInterface). The
+ *  coefficients are interpolated linearly in all independent variables, with the boundary value outside of the table.
+ */
+class CapsuleCoefficientTable
+{
+public:
+
+    //! Constructor
+    /*!
+     *  Constructor
+     *  \param coefficientInterface Aerodynamic database of the capsule (independent variables: Mach number, angle of attack
+     *  and angle of sideslip)
+     */
+    CapsuleCoefficientTable(
+            const std::shared_ptr< tudat::aerodynamics::HypersonicLocalInclinationAnalysis > coefficientInterface );
+
+    //! Function to compute the force and moment coefficients
+    /*!
+     *  Function to compute the force and moment coefficients
+     *  \param independentVariables Mach number, angle of attack and angle of sideslip
+     *  \return Force coefficients (entries 0-2) and moment coefficients (entries 3-5), in the same frame as the database
+     */
+    Eigen::Vector6d getCoefficients( const std::vector< double >& independentVariables ) const;
+
+    //! Function to retrieve the reference length of the database
+    double getReferenceLength( ) const
+    {
+        return referenceLength_;
+    }
+
+    //! Function to retrieve the reference area of the database
+    double getReferenceArea( ) const
+    {
+        return referenceArea_;
+    }
+
+    //! Function to retrieve the lateral reference length of the database
+    double getLateralReferenceLength( ) const
+    {
+        return lateralReferenceLength_;
+    }
+
+    //! Function to retrieve the moment reference point of the database
+    const Eigen::Vector3d& getMomentReferencePoint( ) const
+    {
+        return momentReferencePoint_;
+    }
+
+    //! Function to retrieve whether the coefficients are defined in the aerodynamic frame
+    bool getAreCoefficientsInAerodynamicFrame( ) const
+    {
+        return areCoefficientsInAerodynamicFrame_;
+    }
+
+    //! Function to retrieve whether the coefficients are defined in negative axis direction
+    bool getAreCoefficientsInNegativeAxisDirection( ) const
+    {
+        return areCoefficientsInNegativeAxisDirection_;
+    }
+
+private:
+
+    //! Values of the independent variables (Mach number, angle of attack, angle of sideslip), each in ascending order
+    std::vector< std::vector< double > > independentVariablePoints_;
+
+    //! Coefficients at each combination of independent variables (sideslip index varying fastest, Mach index slowest)
+    std::vector< Eigen::Vector6d > coefficients_;
+
+    //! Reference length of the database
+    double referenceLength_;
+
+    //! Reference area of the database
+    double referenceArea_;
+
+    //! Lateral reference length of the database
+    double lateralReferenceLength_;
+
+    //! Moment reference point of the database
+    Eigen::Vector3d momentReferencePoint_;
+
+    //! Boolean denoting whether the coefficients are defined in the aerodynamic frame
+    bool areCoefficientsInAerodynamicFrame_;
+
+    //! Boolean denoting whether the coefficients are defined in negative axis direction
+    bool areCoefficientsInNegativeAxisDirection_;
+};
+
+//! Function to create a coefficient interface that interpolates in a (shared) tabulated aerodynamic database
+/*!
+ *  Function to create a coefficient interface that interpolates in a (shared) tabulated aerodynamic database. Each body map
+ *  that is used in a concurrent propagation must have its own coefficient interface.
+ *  \param coefficientTable Tabulated aerodynamic database of the capsule
+ *  \return Coefficient interface, with Mach number, angle of attack and angle of sideslip as independent variables
+ */
+std::shared_ptr< tudat::aerodynamics::AerodynamicCoefficientInterface > createCapsuleCoefficientInterface(
+        const std::shared_ptr< const CapsuleCoefficientTable > coefficientTable );
+
+//! Function to compute the stable trim angle of attack for each row of a table of pitch moment coefficients
+/*!
+ *  Function to compute the stable trim angle of attack for each row (e.g. Mach number) of a table of pitch moment coefficients,
+ *  for which the moment coefficient is interpolated linearly in angle of attack. A stable trim point is a zero crossing at which
+ *  the moment coefficient decreases with angle of attack. The crossings are located in all rows simultaneously, by sweeping over
+ *  the angle of attack intervals. If a row has more than one stable trim point, the one closest to the reference angle of
+ *  attack is used. If it has none, the angle of attack with the smallest absolute moment coefficient is used.
+ *  \param pitchMomentCoefficients Pitch moment coefficients (one row per e.g. Mach number, one column per angle of attack)
+ *  \param anglesOfAttack Angles of attack of the columns (in ascending order)
+ *  \param referenceAngleOfAttack Angle of attack used to select between multiple stable trim points
+ *  \param isTrimAvailable Boolean for each row denoting whether a stable trim point was found (returned by reference)
+ *  \return Trim angle of attack of each row
+ */
+Eigen::VectorXd computeTrimAnglesOfAttack(
+        const Eigen::MatrixXd& pitchMomentCoefficients,
+        const Eigen::VectorXd& anglesOfAttack,
+        const double referenceAngleOfAttack,
+        Eigen::Array< bool, Eigen::Dynamic, 1 >& isTrimAvailable );
+
+//! Class containing the trim angle of attack of a capsule as a function of Mach number
+/*!
+ *  Class containing the trim angle of attack of a capsule as a function of Mach number (at zero sideslip), precomputed from the
+ *  pitch moment coefficients of an aerodynamic database (see computeTrimAnglesOfAttack). The trim angles at the Mach numbers
+ *  of the database are resampled to an equispaced table, so that the trim angle at any Mach number is retrieved in constant
+ *  time (linear interpolation, boundary value outside of the Mach number range of the database).
+ */
+class CapsuleTrimTable
+{
+public:
+
+    //! Constructor
+    /*!
+     *  Constructor
+     *  \param coefficientInterface Aerodynamic database of the capsule (independent variables: Mach number, angle of attack
+     *  and angle of sideslip, where the sideslip angles must include zero)
+     *  \param referenceAngleOfAttack Angle of attack used to select between multiple stable trim points
+     *  \param numberOfTablePoints Number of points of the equispaced table
+     */
+    CapsuleTrimTable(
+            const std::shared_ptr< tudat::aerodynamics::HypersonicLocalInclinationAnalysis > coefficientInterface,
+            const double referenceAngleOfAttack,
+            const int numberOfTablePoints = 1000 );
+
+    //! Function to retrieve the trim angle of attack at a given Mach number
+    double getTrimAngleOfAttack( const double machNumber ) const
+    {
+        const double tablePosition = ( machNumber - minimumMachNumber_ ) / machNumberStep_;
+        if( !( tablePosition > 0.0 ) )
+        {
+            return tableTrimAnglesOfAttack_( 0 );
+        }
+        else if( tablePosition >= static_cast< double >( tableTrimAnglesOfAttack_.rows( ) - 1 ) )
+        {
+            return tableTrimAnglesOfAttack_( tableTrimAnglesOfAttack_.rows( ) - 1 );
+        }
+
+        const int lowerIndex = static_cast< int >( tablePosition );
+        return tableTrimAnglesOfAttack_( lowerIndex ) + ( tablePosition - static_cast< double >( lowerIndex ) ) *
+                ( tableTrimAnglesOfAttack_( lowerIndex + 1 ) - tableTrimAnglesOfAttack_( lowerIndex ) );
+    }
+
+    //! Function to retrieve the Mach numbers of the aerodynamic database
+    const Eigen::VectorXd& getMachNumbers( ) const
+    {
+        return machNumbers_;
+    }
+
+    //! Function to retrieve the trim angles of attack at the Mach numbers of the aerodynamic database
+    const Eigen::VectorXd& getTrimAnglesOfAttack( ) const
+    {
+        return trimAnglesOfAttack_;
+    }
+
+    //! Function to retrieve whether a stable trim point exists at the Mach numbers of the aerodynamic database
+    const Eigen::Array< bool, Eigen::Dynamic, 1 >& getIsTrimAvailable( ) const
+    {
+        return isTrimAvailable_;
+    }
+
+private:
+
+    //! Mach numbers of the aerodynamic database
+    Eigen::VectorXd machNumbers_;
+
+    //! Trim angles of attack at the Mach numbers of the aerodynamic database
+    Eigen::VectorXd trimAnglesOfAttack_;
+
+    //! Booleans denoting whether a stable trim point exists at the Mach numbers of the aerodynamic database
+    Eigen::Array< bool, Eigen::Dynamic, 1 > isTrimAvailable_;
+
+    //! Lowest Mach number of the equispaced table
+    double minimumMachNumber_;
+
+    //! Mach number step of the equispaced table
+    double machNumberStep_;
+
+    //! Trim angles of attack of the equispaced table
+    Eigen::VectorXd tableTrimAnglesOfAttack_;
+};
+
+//! Struct defining a bank angle profile: constant bank angle magnitude, with sign reversals at given times
+struct BankAngleProfile
+{
+    //! Constructor
+    /*!
+     *  Constructor
+     *  \param initialBankAngle Bank angle before the first reversal
+     *  \param reversalTimes Times at which the sign of the bank angle is reversed (in ascending order; empty if constant)
+     */
+    BankAngleProfile( const double initialBankAngle = 0.0,
+                      const std::vector< double >& reversalTimes = std::vector< double >( ) ):
+        initialBankAngle( initialBankAngle ), reversalTimes( reversalTimes ){ }
+
+    //! Function to compute the bank angle at a given time
+    double getBankAngle( const double time ) const
+    {
+        const int numberOfReversals = std::upper_bound( reversalTimes.begin( ), reversalTimes.end( ), time ) -
+                reversalTimes.begin( );
+        return ( numberOfReversals % 2 == 0 ) ? initialBankAngle : -initialBankAngle;
+    }
+
+    //! Bank angle before the first reversal
+    double initialBankAngle;
+
+    //! Times at which the sign of the bank angle is reversed (in ascending order)
+    std::vector< double > reversalTimes;
+};
+
+//! Class to set the aerodynamic angles of the capsule (default: all angles 0)
+/*!
+ *  Class to set the aerodynamic angles of the capsule. The angle of attack is either fixed, or the trim angle of attack at the
+ *  current Mach number (trimmed flight), retrieved from a precomputed trim table. The angle of sideslip is 0, and the bank
+ *  angle follows a bank angle profile (default 0). The Mach number is retrieved from the flight conditions of the capsule.
+ */
+class CapsuleAerodynamicGuidance: public tudat::aerodynamics::AerodynamicGuidance
+{
+public:
+
+    //! Constructor for fixed angle of attack
+    /*!
+     *  Constructor for fixed angle of attack
+     *  \param bodyMap List of body objects that constitute the environment
+     *  \param fixedAngleOfAttack Fixed angle of attack that is to be used by vehicle
+     */
+    CapsuleAerodynamicGuidance(
+            const tudat::simulation_setup::NamedBodyMap bodyMap,
+            const double fixedAngleOfAttack ):bodyMap_( bodyMap ), fixedAngleOfAttack_( fixedAngleOfAttack )
+    {
+
+    }
+
+    //! Constructor for trimmed flight
+    /*!
+     *  Constructor for trimmed flight
+     *  \param bodyMap List of body objects that constitute the environment
+     *  \param trimTable Trim angle of attack as a function of Mach number
+     *  \param vehicleName Name of the capsule
+     */
+    CapsuleAerodynamicGuidance(
+            const tudat::simulation_setup::NamedBodyMap bodyMap,
+            const std::shared_ptr< CapsuleTrimTable > trimTable,
+            const std::string& vehicleName = "Capsule" );
+
+    //! The aerodynamic angles are to be computed here (defined here, so that it can be inlined by the guidance adapters)
+    void updateGuidance( const double time )
+    {
+        if( trimTable_ == nullptr )
+        {
+            currentAngleOfAttack_ = fixedAngleOfAttack_;
+        }
+        else
+        {
+            if( flightConditions_ == nullptr )
+            {
+                flightConditions_ = std::dynamic_pointer_cast< tudat::aerodynamics::AtmosphericFlightConditions >(
+                            bodyMap_.at( vehicleName_ )->getFlightConditions( ) );
+                if( flightConditions_ == nullptr )
+                {
+                    throw std::runtime_error(
+                                "Error when updating capsule guidance, no atmospheric flight conditions found" );
+                }
+            }
+
+            // Fly at trim angle of attack of current Mach number (highest Mach number of table before first update)
+            const double machNumber = flightConditions_->getCurrentMachNumber( );
+            currentAngleOfAttack_ = trimTable_->getTrimAngleOfAttack(
+                        std::isfinite( machNumber ) ? machNumber : std::numeric_limits< double >::max( ) );
+        }
+        currentAngleOfSideslip_ = 0.0;
+        currentBankAngle_ = bankAngleProfile_.getBankAngle( time );
+    }
+
+    //! Function to reset the bank angle profile
+    void setBankAngleProfile( const BankAngleProfile& bankAngleProfile )
+    {
+        bankAngleProfile_ = bankAngleProfile;
+    }
+
+private:
+
+    //! List of body objects that constitute the environment
+    tudat::simulation_setup::NamedBodyMap bodyMap_;
+
+    //! Fixed angle of attack that is to be used by vehicle
+    double fixedAngleOfAttack_;
+
+    //! Trim angle of attack as a function of Mach number (nullptr if angle of attack is fixed)
+    std::shared_ptr< CapsuleTrimTable > trimTable_;
+
+    //! Name of the capsule
+    std::string vehicleName_;
+
+    //! Flight conditions of the capsule (retrieved at first update, in trimmed flight)
+    std::shared_ptr< tudat::aerodynamics::AtmosphericFlightConditions > flightConditions_;
+
+    //! Bank angle profile of the capsule
+    BankAngleProfile bankAngleProfile_;
+};
+
+//! Outcome of an entry propagation, used to determine the entry corridor
+enum EntryOutcome
+{
+    entry_skip,
+    entry_capture,
+    entry_limit_exceeded
+};
+
+//! Typedef for the function that propagates an entry at a given flight path angle (in a given thread), returning its outcome
+typedef std::function< EntryOutcome( const double, const int ) > EntryOutcomeFunction;
+
+//! Struct containing the entry corridor of a vehicle
+struct EntryCorridor
+{
+    //! Shallowest flight path angle at which the vehicle is captured (NaN if the corridor is empty)
+    double shallowestFlightPathAngle;
+
+    //! Steepest flight path angle at which the vehicle is captured within the limits (NaN if the corridor is empty)
+    double steepestFlightPathAngle;
+
+    //! Number of multisection iterations (after the initial scan)
+    int numberOfIterations;
+
+    //! Total number of entry propagations
+    int numberOfEvaluations;
+
+    //! Function to retrieve the width of the corridor (zero if the corridor is empty)
+    double getWidth( ) const
+    {
+        return ( shallowestFlightPathAngle == shallowestFlightPathAngle ) ?
+                    ( shallowestFlightPathAngle - steepestFlightPathAngle ) : 0.0;
+    }
+};
+
+//! Function to compute the entry corridor (range of flight path angles at which the vehicle is captured within the limits)
+/*!
+ *  Function to compute the entry corridor: the range of entry flight path angles between the shallowest angle at which the
+ *  vehicle is captured (and does not skip out), and the steepest angle at which it is captured without exceeding its limits
+ *  (e.g. heat flux and load factor). The range of flight path angles is first scanned at equispaced points, after which
+ *  both bounds are bracketed by multisection: in each iteration, a number of equispaced points in each open bracket are
+ *  evaluated concurrently (with all open brackets in one batch), after which each bracket is reduced to the interval in
+ *  which the outcome changes from capture to another outcome. The returned bounds are the captured ends of the brackets.
+ *  \param outcomeFunction Function that propagates an entry at a given flight path angle, in a given thread
+ *  \param steepestFlightPathAngle Steepest flight path angle of the range that is searched
+ *  \param shallowestFlightPathAngle Shallowest flight path angle of the range that is searched
+ *  \param tolerance Width of the brackets at which the multisection is stopped
+ *  \param numberOfScanPoints Number of equispaced points of the initial scan (including the bounds of the range)
+ *  \param numberOfThreads Number of threads to use, and number of points evaluated per iteration (if smaller than 1, the
+ *  default number of threads is used)
+ *  \return Entry corridor
+ */
+EntryCorridor computeEntryCorridor(
+        const EntryOutcomeFunction& outcomeFunction,
+        const double steepestFlightPathAngle,
+        const double shallowestFlightPathAngle,
+        const double tolerance,
+        const int numberOfScanPoints = 16,
+        const int numberOfThreads = 0 );
+
+//! Function to compute the downrange and crossrange of a point w.r.t. the entry point and heading
+/*!
+ *  Function to compute the downrange and crossrange of a point on a spherical body w.r.t. the entry point, where the downrange
+ *  is measured along the great circle through the entry point in the direction of the entry heading, and the crossrange
+ *  perpendicular to it (positive to the right of the entry heading, i.e. towards increasing heading angle).
+ *  \param entryLatitude Latitude of the entry point
+ *  \param entryLongitude Longitude of the entry point
+ *  \param entryHeadingAngle Heading angle at the entry point (w.r.t. north, positive towards east)
+ *  \param latitude Latitude of the point
+ *  \param longitude Longitude of the point
+ *  \param radius Radius of the body
+ *  \return Downrange and crossrange of the point
+ */
+Eigen::Vector2d computeDownrangeAndCrossrange(
+        const double entryLatitude,
+        const double entryLongitude,
+        const double entryHeadingAngle,
+        const double latitude,
+        const double longitude,
+        const double radius );
+
+//! Function to compute the convex hull of a set of points in the plane
+/*!
+ *  Function to compute the convex hull of a set of points in the plane (monotone chain algorithm). Points with non-finite
+ *  coordinates are ignored.
+ *  \param points Points of which the convex hull is computed (one point per row)
+ *  \return Vertices of the convex hull, in counterclockwise order, without collinear points (one vertex per row)
+ */
+Eigen::MatrixXd computeConvexHull( const Eigen::MatrixXd& points );
+
+//! Typedef for the function that propagates an entry with a given bank angle profile (in a given thread), returning the
+//! downrange and crossrange of the landing point (NaN if the vehicle does not land)
+typedef std::function< Eigen::Vector2d( const BankAngleProfile&, const int ) > LandingPointFunction;
+
+//! Struct containing the landing footprint of a vehicle
+struct LandingFootprint
+{
+    //! Downrange and crossrange of landing point, for each bank angle profile (NaN if the vehicle does not land)
+    Eigen::MatrixXd landingPoints;
+
+    //! Vertices of the footprint (convex hull of the landing points), in counterclockwise order
+    Eigen::MatrixXd boundary;
+
+    //! Function to compute the area of the footprint
+    double getArea( ) const;
+};
+
+//! Function to compute the landing footprint of a vehicle, from a set of bank angle profiles
+/*!
+ *  Function to compute the landing footprint of a vehicle (convex hull of the downrange and crossrange of the landing points),
+ *  for which the entries with all bank angle profiles are propagated concurrently.
+ *  \param landingPointFunction Function that propagates an entry with a given bank angle profile, in a given thread
+ *  \param bankAngleProfiles Bank angle profiles for which an entry is propagated
+ *  \param numberOfThreads Number of threads to use (if smaller than 1, the default number of threads is used)
+ *  \return Landing footprint
+ */
+LandingFootprint computeLandingFootprint(
+        const LandingPointFunction& landingPointFunction,
+        const std::vector< BankAngleProfile >& bankAngleProfiles,
+        const int numberOfThreads = 0 );
+
+//! Class to compute the stagnation point heat flux of a capsule, with the gas-property dependent terms precomputed in a table
+/*!
+ *  Class to compute the convective and radiative heat flux at the stagnation point of a capsule (Earth entry), for a given
+ *  nose radius. The convective heat flux is computed from the Sutton-Graves relation (a fit of the stagnation point heat
+ *  flux of Fay and Riddell, for air), which only requires a square root and a cube. The radiative heat flux is computed
+ *  from the relation of Tauber and Sutton (1991), in which the exponent of the nose radius depends on density and velocity,
+ *  and which uses a tabulated function of velocity (zero below 9 km/s). Since this is expensive to evaluate, the radiative
+ *  heat flux is precomputed in a table, with equispaced points in the logarithm of density and in velocity, from which it
+ *  is retrieved by bilinear interpolation (boundary value outside of the table). The table is not modified after its
+ *  creation, so that it can be shared by concurrent propagations.
+ */
+class StagnationPointHeatingTable
+{
+public:
+
+    //! Constructor
+    /*!
+     *  Constructor
+     *  \param noseRadius Nose radius of the capsule
+     *  \param minimumDensity Minimum density of the table
+     *  \param maximumDensity Maximum density of the table
+     *  \param maximumVelocity Maximum velocity of the table (minimum velocity is 0)
+     *  \param numberOfDensityPoints Number of (logarithmically equispaced) densities of the table
+     *  \param numberOfVelocityPoints Number of (equispaced) velocities of the table
+     */
+    StagnationPointHeatingTable(
+            const double noseRadius,
+            const double minimumDensity = 1.0E-10,
+            const double maximumDensity = 10.0,
+            const double maximumVelocity = 16.0E3,
+            const int numberOfDensityPoints = 221,
+            const int numberOfVelocityPoints = 321 );
+
+    //! Function to compute the convective heat flux (W/m^2), from the freestream density and velocity
+    double getConvectiveHeatFlux( const double density, const double velocity ) const
+    {
+        return suttonGravesCoefficient_ * std::sqrt( density ) * velocity * velocity * velocity;
+    }
+
+    //! Function to compute the radiative heat flux (W/m^2), from the freestream density and velocity
+    double getRadiativeHeatFlux( const double density, const double velocity ) const;
+
+    //! Function to compute the total (convective and radiative) heat flux (W/m^2), from the freestream density and velocity
+    double getHeatFlux( const double density, const double velocity ) const
+    {
+        return getConvectiveHeatFlux( density, velocity ) + getRadiativeHeatFlux( density, velocity );
+    }
+
+    //! Function to retrieve the table of radiative heat flux (density per row, velocity per column)
+    const Eigen::MatrixXd& getRadiativeHeatFluxes( ) const
+    {
+        return radiativeHeatFluxes_;
+    }
+
+private:
+
+    //! Coefficient of Sutton-Graves relation, divided by square root of nose radius
+    double suttonGravesCoefficient_;
+
+    //! Logarithm (base 10) of minimum density of the table
+    double minimumLogarithmicDensity_;
+
+    //! Step in logarithm (base 10) of density of the table
+    double logarithmicDensityStep_;
+
+    //! Step in velocity of the table
+    double velocityStep_;
+
+    //! Radiative heat flux (W/m^2), for each density (row) and velocity (column) of the table
+    Eigen::MatrixXd radiativeHeatFluxes_;
+};
+
+} // namespace tudat_applications
+
+#endif // TUDAT_SHAPEOPTIMIZATION_H
@@ -0,0 +1,246 @@
+#ifndef TUDAT_CONTINUOUSTRAJECTORY_H
+#define TUDAT_CONTINUOUSTRAJECTORY_H
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+#include <Eigen/Core>
+
+namespace tudat_applications
+{
+
+//! Continuous representation of a numerically propagated Cartesian trajectory, for state queries at arbitrary epochs.
+/*!
+ *  Continuous representation of a numerically propagated Cartesian trajectory, for state queries at arbitrary epochs. On each
+ *  integration step, the position is represented by a quintic Hermite polynomial (using position, velocity and acceleration
+ *  at the step boundaries), and the velocity by a cubic Hermite polynomial (using velocity and acceleration), so that the
+ *  representation is continuous and smooth over the entire trajectory. Accelerations are preferably taken from the total
+ *  acceleration dependent variable of the propagation; if these are not available, they are estimated by finite differences
+ *  of the velocity.
+ *
+ *  The data is converted once, on construction, to contiguous storage. For a constant step size (e.g. fixed-step
+ *  integrators), the step containing a query epoch is found directly (O(1)); otherwise a binary search is used (O(log n)).
+ *  For batch queries at sorted epochs, the step is found by a forward search from the previous epoch.
+ */
+class ContinuousTrajectory
+{
+public:
+
+    //! Constructor from state history and total acceleration (dependent variable) history.
+    /*!
+     *  Constructor from state history and total acceleration (dependent variable) history.
+     *  \param stateHistory Cartesian state history, as returned by the dynamics simulator (at least two epochs)
+     *  \param dependentVariableHistory Dependent variable history, at the same epochs as the state history
+     *  \param accelerationIndex Index of the (first entry of the) total acceleration in the dependent variable vector
+     */
+    ContinuousTrajectory( const std::map< double, Eigen::Matrix< double, 6, 1 > >& stateHistory,
+                          const std::map< double, Eigen::VectorXd >& dependentVariableHistory,
+                          const int accelerationIndex )
+    {
+        setStateHistory( stateHistory );
+
+        if( dependentVariableHistory.size( ) != stateHistory.size( ) )
+        {
+            throw std::runtime_error( "Error when creating continuous trajectory, inconsistent dependent variable history" );
+        }
+
+        int i = 0;
+        for( auto dependentVariableIterator = dependentVariableHistory.begin( );
+             dependentVariableIterator != dependentVariableHistory.end( ); dependentVariableIterator++, i++ )
+        {
+            if( dependentVariableIterator->first != times_.at( i ) )
+            {
+                throw std::runtime_error( "Error when creating continuous trajectory, inconsistent dependent variable epochs" );
+            }
+            accelerations_.col( i ) = dependentVariableIterator->second.segment( accelerationIndex, 3 );
+        }
+    }
+
+    //! Constructor from state history only (accelerations estimated by finite differences of the velocity).
+    /*!
+     *  Constructor from state history only (accelerations estimated by finite differences of the velocity, which strongly
+     *  reduces the accuracy of the interpolation for large time steps).
+     *  \param stateHistory Cartesian state history, as returned by the dynamics simulator (at least two epochs)
+     */
+    ContinuousTrajectory( const std::map< double, Eigen::Matrix< double, 6, 1 > >& stateHistory )
+    {
+        setStateHistory( stateHistory );
+
+        const int numberOfEpochs = static_cast< int >( times_.size( ) );
+        for( int i = 0; i < numberOfEpochs; i++ )
+        {
+            int previousIndex = std::max( i - 1, 0 );
+            int nextIndex = std::min( i + 1, numberOfEpochs - 1 );
+            accelerations_.col( i ) =
+                    ( states_.block( 3, nextIndex, 3, 1 ) - states_.block( 3, previousIndex, 3, 1 ) ) /
+                    ( times_.at( nextIndex ) - times_.at( previousIndex ) );
+        }
+    }
+
+    //! Get the Cartesian state at a given epoch (must be within the propagated interval).
+    Eigen::Matrix< double, 6, 1 > getState( const double time ) const
+    {
+        return interpolateOnStep( findStep( time ), time );
+    }
+
+    //! Get the Cartesian states at a list of epochs (one row per epoch; epochs must be within the propagated interval).
+    Eigen::Matrix< double, Eigen::Dynamic, 6 > getStates( const Eigen::VectorXd& times ) const
+    {
+        Eigen::Matrix< double, Eigen::Dynamic, 6 > stateList( times.rows( ), 6 );
+        int currentStep = -1;
+        for( int i = 0; i < times.rows( ); i++ )
+        {
+            // Search forward from previous step for sorted epochs, otherwise perform a full search
+            if( currentStep >= 0 && times( i ) >= times_.at( currentStep ) )
+            {
+                while( currentStep < static_cast< int >( times_.size( ) ) - 2 &&
+                       times( i ) > times_.at( currentStep + 1 ) )
+                {
+                    currentStep++;
+                }
+                checkTime( times( i ) );
+            }
+            else
+            {
+                currentStep = findStep( times( i ) );
+            }
+            stateList.row( i ) = interpolateOnStep( currentStep, times( i ) ).transpose( );
+        }
+        return stateList;
+    }
+
+    //! Get the first epoch of the trajectory.
+    double getStartTime( ) const
+    {
+        return times_.front( );
+    }
+
+    //! Get the final epoch of the trajectory.
+    double getEndTime( ) const
+    {
+        return times_.back( );
+    }
+
+private:
+
+    //! Convert the state history to contiguous storage, and determine whether the step size is constant.
+    void setStateHistory( const std::map< double, Eigen::Matrix< double, 6, 1 > >& stateHistory )
+    {
+        if( stateHistory.size( ) < 2 )
+        {
+            throw std::runtime_error( "Error when creating continuous trajectory, at least two epochs are required" );
+        }
+
+        times_.reserve( stateHistory.size( ) );
+        states_.resize( 6, stateHistory.size( ) );
+        accelerations_.resize( 3, stateHistory.size( ) );
+        int i = 0;
+        for( auto stateIterator = stateHistory.begin( ); stateIterator != stateHistory.end( ); stateIterator++, i++ )
+        {
+            times_.push_back( stateIterator->first );
+            states_.col( i ) = stateIterator->second;
+        }
+
+        // Check whether all steps are equal (to within rounding errors in the epochs)
+        timeStep_ = ( times_.back( ) - times_.front( ) ) / static_cast< double >( times_.size( ) - 1 );
+        hasConstantTimeStep_ = true;
+        for( unsigned int j = 1; j < times_.size( ); j++ )
+        {
+            if( std::fabs( times_.at( j ) - times_.at( j - 1 ) - timeStep_ ) > 1.0E-8 * std::fabs( timeStep_ ) )
+            {
+                hasConstantTimeStep_ = false;
+                break;
+            }
+        }
+    }
+
+    //! Check whether an epoch is within the propagated interval.
+    void checkTime( const double time ) const
+    {
+        if( !( time >= times_.front( ) && time <= times_.back( ) ) )
+        {
+            throw std::runtime_error( "Error in continuous trajectory, requested epoch is outside propagated interval" );
+        }
+    }
+
+    //! Find the index of the step [t_i, t_i+1] containing a given epoch.
+    int findStep( const double time ) const
+    {
+        checkTime( time );
+
+        const int numberOfSteps = static_cast< int >( times_.size( ) ) - 1;
+        int stepIndex;
+        if( hasConstantTimeStep_ )
+        {
+            stepIndex = static_cast< int >( ( time - times_.front( ) ) / timeStep_ );
+            stepIndex = std::max( 0, std::min( stepIndex, numberOfSteps - 1 ) );
+
+            // Correct for rounding errors in the epochs
+            if( time < times_.at( stepIndex ) && stepIndex > 0 )
+            {
+                stepIndex--;
+            }
+            else if( time > times_.at( stepIndex + 1 ) && stepIndex < numberOfSteps - 1 )
+            {
+                stepIndex++;
+            }
+        }
+        else
+        {
+            stepIndex = static_cast< int >( std::upper_bound( times_.begin( ), times_.end( ), time ) - times_.begin( ) ) - 1;
+            stepIndex = std::max( 0, std::min( stepIndex, numberOfSteps - 1 ) );
+        }
+        return stepIndex;
+    }
+
+    //! Evaluate the Hermite polynomials of a step at a given epoch.
+    Eigen::Matrix< double, 6, 1 > interpolateOnStep( const int stepIndex, const double time ) const
+    {
+        const double stepSize = times_.at( stepIndex + 1 ) - times_.at( stepIndex );
+        const double s = ( time - times_.at( stepIndex ) ) / stepSize;
+        const double s2 = s * s;
+        const double s3 = s2 * s;
+        const double s4 = s3 * s;
+        const double s5 = s4 * s;
+
+        // Interpolate position using quintic Hermite polynomials (position, velocity and acceleration at step boundaries)
+        Eigen::Matrix< double, 6, 1 > interpolatedState;
+        interpolatedState.segment( 0, 3 ) =
+                ( 1.0 - 10.0 * s3 + 15.0 * s4 - 6.0 * s5 ) * states_.block( 0, stepIndex, 3, 1 ) +
+                ( s - 6.0 * s3 + 8.0 * s4 - 3.0 * s5 ) * stepSize * states_.block( 3, stepIndex, 3, 1 ) +
+                0.5 * ( s2 - 3.0 * s3 + 3.0 * s4 - s5 ) * stepSize * stepSize * accelerations_.col( stepIndex ) +
+                0.5 * ( s3 - 2.0 * s4 + s5 ) * stepSize * stepSize * accelerations_.col( stepIndex + 1 ) +
+                ( -4.0 * s3 + 7.0 * s4 - 3.0 * s5 ) * stepSize * states_.block( 3, stepIndex + 1, 3, 1 ) +
+                ( 10.0 * s3 - 15.0 * s4 + 6.0 * s5 ) * states_.block( 0, stepIndex + 1, 3, 1 );
+
+        // Interpolate velocity using cubic Hermite polynomials (velocity and acceleration at step boundaries)
+        interpolatedState.segment( 3, 3 ) =
+                ( 2.0 * s3 - 3.0 * s2 + 1.0 ) * states_.block( 3, stepIndex, 3, 1 ) +
+                ( s3 - 2.0 * s2 + s ) * stepSize * accelerations_.col( stepIndex ) +
+                ( -2.0 * s3 + 3.0 * s2 ) * states_.block( 3, stepIndex + 1, 3, 1 ) +
+                ( s3 - s2 ) * stepSize * accelerations_.col( stepIndex + 1 );
+        return interpolatedState;
+    }
+
+    //! Epochs of the state history.
+    std::vector< double > times_;
+
+    //! Cartesian states at the epochs (one column per epoch).
+    Eigen::Matrix< double, 6, Eigen::Dynamic > states_;
+
+    //! Accelerations at the epochs (one column per epoch).
+    Eigen::Matrix< double, 3, Eigen::Dynamic > accelerations_;
+
+    //! Boolean denoting whether the epochs are equally spaced.
+    bool hasConstantTimeStep_;
+
+    //! Time step (average time step if not constant).
+    double timeStep_;
+};
+
+}
+
+#endif // TUDAT_CONTINUOUSTRAJECTORY_H
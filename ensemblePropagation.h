@@ -0,0 +1,204 @@
+#ifndef TUDAT_ENSEMBLEPROPAGATION_H
+#define TUDAT_ENSEMBLEPROPAGATION_H
+
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include <Eigen/Core>
+
+namespace tudat_applications
+{
+
+//! Matrix type for ensemble (structure-of-arrays) storage: one row per state or parameter entry, one column per sample.
+/*!
+ *  Matrix type for ensemble (structure-of-arrays) storage: one row per state or parameter entry, one column per sample. Since
+ *  the storage is row-major, the values of a single entry for all samples are contiguous, so that the leading block of
+ *  active samples of each row can be processed as an Eigen array expression (which is vectorized by the compiler).
+ */
+typedef Eigen::Matrix< double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor > EnsembleMatrix;
+
+//! Propagate an ensemble of samples of the same dynamical model in lockstep, with a fixed-step RK4 integrator.
+/*!
+ *  Propagate an ensemble of samples of the same dynamical model in lockstep, with a fixed-step RK4 integrator (e.g. for Monte
+ *  Carlo analyses, in which samples differ only in their initial state and parameters). Instead of evaluating the dynamics
+ *  of each sample separately, the model evaluates the state derivatives of all active samples at once, on structure-of-arrays
+ *  storage, so that the evaluation of each term is a single loop over the samples that is vectorized.
+ *
+ *  The termination conditions are checked for all active samples after each step. Terminated samples are masked out, and the
+ *  active samples are compacted (by swapping the state and parameters of each terminated sample with those of the last active
+ *  sample), so that the active samples always form the leading columns of the storage, and the cost of a step is
+ *  proportional to the number of active samples.
+ *
+ *  The model type must provide the following functions:
+ *
+ *  - int getStateSize( ) const: number of state entries per sample
+ *  - void computeStateDerivatives( const double time, const Eigen::Ref< const EnsembleMatrix >& states,
+ *    const Eigen::Ref< const EnsembleMatrix >& parameters, Eigen::Ref< EnsembleMatrix > stateDerivatives ) const: compute the
+ *    state derivatives of a block of samples (one column per sample)
+ *  - void computeTerminationFlags( const double time, const Eigen::Ref< const EnsembleMatrix >& states,
+ *    const Eigen::Ref< const EnsembleMatrix >& parameters, Eigen::Array< bool, Eigen::Dynamic, 1 >& isTerminated ) const:
+ *    determine which samples of a block meet a termination condition
+ */
+template< typename EnsembleModelType >
+class EnsemblePropagator
+{
+public:
+
+    //! Constructor.
+    /*!
+     *  Constructor.
+     *  \param ensembleModel Model of which the samples are propagated
+     *  \param stepSize Fixed step size of the integrator
+     *  \param maximumNumberOfSteps Number of steps after which all remaining samples are terminated
+     */
+    EnsemblePropagator( const std::shared_ptr< EnsembleModelType > ensembleModel,
+                        const double stepSize,
+                        const int maximumNumberOfSteps = 1000000 ):
+        ensembleModel_( ensembleModel ), stepSize_( stepSize ), maximumNumberOfSteps_( maximumNumberOfSteps )
+    {
+        if( !( stepSize != 0.0 ) || maximumNumberOfSteps < 1 )
+        {
+            throw std::runtime_error( "Error when creating ensemble propagator, step size and number of steps must be nonzero" );
+        }
+    }
+
+    //! Propagate all samples from a common initial time, until each sample meets a termination condition.
+    /*!
+     *  Propagate all samples from a common initial time, until each sample meets a termination condition. The final states and
+     *  times are stored in the original order of the samples.
+     *  \param initialStates Initial states of the samples (one column per sample)
+     *  \param parameters Parameters of the samples (one column per sample)
+     *  \param initialTime Initial time of all samples
+     */
+    void propagate( const EnsembleMatrix& initialStates, const EnsembleMatrix& parameters, const double initialTime )
+    {
+        const int numberOfSamples = initialStates.cols( );
+        if( initialStates.rows( ) != ensembleModel_->getStateSize( ) || parameters.cols( ) != numberOfSamples )
+        {
+            throw std::runtime_error( "Error when propagating ensemble, sizes of states and parameters are inconsistent" );
+        }
+
+        // Working copies, of which the leading columns are the active samples
+        states_ = initialStates;
+        parameters_ = parameters;
+        sampleIndices_.resize( numberOfSamples );
+        for( int i = 0; i < numberOfSamples; i++ )
+        {
+            sampleIndices_( i ) = i;
+        }
+        finalStates_.resize( initialStates.rows( ), numberOfSamples );
+        finalTimes_.setConstant( numberOfSamples, std::numeric_limits< double >::quiet_NaN( ) );
+        numberOfActiveSampleSteps_ = 0;
+
+        const int stateSize = initialStates.rows( );
+        EnsembleMatrix k1( stateSize, numberOfSamples ), k2( stateSize, numberOfSamples ),
+                k3( stateSize, numberOfSamples ), k4( stateSize, numberOfSamples ),
+                intermediateStates( stateSize, numberOfSamples );
+        Eigen::Array< bool, Eigen::Dynamic, 1 > isTerminated;
+
+        int numberOfActiveSamples = numberOfSamples;
+        double currentTime = initialTime;
+        for( int step = 0; step < maximumNumberOfSteps_ && numberOfActiveSamples > 0; step++ )
+        {
+            const int n = numberOfActiveSamples;
+            const Eigen::Ref< const EnsembleMatrix > activeParameters = parameters_.leftCols( n );
+
+            // Perform RK4 step for all active samples
+            ensembleModel_->computeStateDerivatives( currentTime, states_.leftCols( n ), activeParameters, k1.leftCols( n ) );
+            intermediateStates.leftCols( n ) = states_.leftCols( n ) + stepSize_ / 2.0 * k1.leftCols( n );
+            ensembleModel_->computeStateDerivatives( currentTime + stepSize_ / 2.0, intermediateStates.leftCols( n ),
+                                                     activeParameters, k2.leftCols( n ) );
+            intermediateStates.leftCols( n ) = states_.leftCols( n ) + stepSize_ / 2.0 * k2.leftCols( n );
+            ensembleModel_->computeStateDerivatives( currentTime + stepSize_ / 2.0, intermediateStates.leftCols( n ),
+                                                     activeParameters, k3.leftCols( n ) );
+            intermediateStates.leftCols( n ) = states_.leftCols( n ) + stepSize_ * k3.leftCols( n );
+            ensembleModel_->computeStateDerivatives( currentTime + stepSize_, intermediateStates.leftCols( n ),
+                                                     activeParameters, k4.leftCols( n ) );
+            states_.leftCols( n ) += stepSize_ / 6.0 * (
+                        k1.leftCols( n ) + 2.0 * k2.leftCols( n ) + 2.0 * k3.leftCols( n ) + k4.leftCols( n ) );
+            currentTime += stepSize_;
+            numberOfActiveSampleSteps_ += n;
+
+            // Store and compact terminated samples (all remaining samples are terminated after the last step)
+            if( step == maximumNumberOfSteps_ - 1 )
+            {
+                isTerminated.setConstant( n, true );
+            }
+            else
+            {
+                ensembleModel_->computeTerminationFlags(
+                            currentTime, states_.leftCols( n ), parameters_.leftCols( n ), isTerminated );
+            }
+            for( int i = n - 1; i >= 0; i-- )
+            {
+                if( isTerminated( i ) )
+                {
+                    finalStates_.col( sampleIndices_( i ) ) = states_.col( i );
+                    finalTimes_( sampleIndices_( i ) ) = currentTime;
+
+                    const int lastActiveIndex = numberOfActiveSamples - 1;
+                    if( i != lastActiveIndex )
+                    {
+                        states_.col( i ).swap( states_.col( lastActiveIndex ) );
+                        parameters_.col( i ).swap( parameters_.col( lastActiveIndex ) );
+                        std::swap( sampleIndices_( i ), sampleIndices_( lastActiveIndex ) );
+                    }
+                    numberOfActiveSamples--;
+                }
+            }
+        }
+    }
+
+    //! Retrieve the final states of all samples (one column per sample, in original order).
+    const EnsembleMatrix& getFinalStates( ) const
+    {
+        return finalStates_;
+    }
+
+    //! Retrieve the final times of all samples (in original order).
+    const Eigen::VectorXd& getFinalTimes( ) const
+    {
+        return finalTimes_;
+    }
+
+    //! Retrieve the total number of sample steps of the last propagation (sum over all steps of number of active samples).
+    long getNumberOfActiveSampleSteps( ) const
+    {
+        return numberOfActiveSampleSteps_;
+    }
+
+private:
+
+    //! Model of which the samples are propagated.
+    std::shared_ptr< EnsembleModelType > ensembleModel_;
+
+    //! Fixed step size of the integrator.
+    double stepSize_;
+
+    //! Number of steps after which all remaining samples are terminated.
+    int maximumNumberOfSteps_;
+
+    //! Current states of the samples (active samples in leading columns).
+    EnsembleMatrix states_;
+
+    //! Parameters of the samples (in same column order as states).
+    EnsembleMatrix parameters_;
+
+    //! Original index of the sample in each column.
+    Eigen::VectorXi sampleIndices_;
+
+    //! Final states of the samples, in original order.
+    EnsembleMatrix finalStates_;
+
+    //! Final times of the samples, in original order.
+    Eigen::VectorXd finalTimes_;
+
+    //! Total number of sample steps of the last propagation.
+    long numberOfActiveSampleSteps_;
+};
+
+}
+
+#endif // TUDAT_ENSEMBLEPROPAGATION_H
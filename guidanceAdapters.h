@@ -0,0 +1,145 @@
+#ifndef TUDAT_GUIDANCEADAPTERS_H
+#define TUDAT_GUIDANCEADAPTERS_H
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+
+#include <Tudat/SimulationSetup/tudatSimulationHeader.h>
+
+namespace tudat_applications
+{
+
+//! Create the thrust direction function of a thrust guidance object, with the guidance called directly.
+/*!
+ *  Create the thrust direction function of a thrust guidance object, for use in CustomThrustDirectionSettings. Unlike a
+ *  std::bind to the member function, the guidance type is known when the function is compiled, and its member function is
+ *  called with a qualified (non-virtual) call, so that the compiler can inline the guidance into the function that is called
+ *  by the thrust acceleration model. Only the type erasure of the std::function used by the acceleration model remains.
+ *  \param guidance Thrust guidance object, with member function Eigen::Vector3d getCurrentThrustDirection( const double )
+ *  \return Function returning the inertial thrust direction as a function of time
+ */
+template< typename GuidanceType >
+std::function< Eigen::Vector3d( const double ) > createThrustDirectionFunction(
+        const std::shared_ptr< GuidanceType > guidance )
+{
+    return [ guidance ]( const double currentTime )
+    {
+        return guidance->GuidanceType::getCurrentThrustDirection( currentTime );
+    };
+}
+
+//! Create the thrust magnitude function of a thrust guidance object, with the guidance called directly.
+/*!
+ *  Create the thrust magnitude function of a thrust guidance object, for use in FromFunctionThrustMagnitudeSettings (see
+ *  createThrustDirectionFunction).
+ *  \param guidance Thrust guidance object, with member function double getCurrentThrustMagnitude( const double )
+ *  \return Function returning the thrust magnitude as a function of time
+ */
+template< typename GuidanceType >
+std::function< double( const double ) > createThrustMagnitudeFunction( const std::shared_ptr< GuidanceType > guidance )
+{
+    return [ guidance ]( const double currentTime )
+    {
+        return guidance->GuidanceType::getCurrentThrustMagnitude( currentTime );
+    };
+}
+
+//! Functions to update and retrieve the aerodynamic angles of a guidance object, as used by the aerodynamic angle calculator.
+struct AerodynamicGuidanceFunctions
+{
+    //! Function returning the current angle of attack.
+    std::function< double( ) > angleOfAttackFunction;
+
+    //! Function returning the current angle of sideslip.
+    std::function< double( ) > angleOfSideslipFunction;
+
+    //! Function returning the current bank angle.
+    std::function< double( ) > bankAngleFunction;
+
+    //! Function updating the guidance to the current time.
+    std::function< void( const double ) > angleUpdateFunction;
+};
+
+//! Create the aerodynamic angle functions of an aerodynamic guidance object, with the guidance called directly.
+/*!
+ *  Create the aerodynamic angle functions of an aerodynamic guidance object. The update of the guidance is called with a
+ *  qualified call to GuidanceType::updateGuidance, instead of through the virtual function of the AerodynamicGuidance base
+ *  class, so that the compiler can inline it (when its definition is visible) into the function called by the aerodynamic
+ *  angle calculator.
+ *  \param guidance Aerodynamic guidance object (derived from AerodynamicGuidance)
+ *  \return Functions to update and retrieve the aerodynamic angles
+ */
+template< typename GuidanceType >
+AerodynamicGuidanceFunctions createAerodynamicGuidanceFunctions( const std::shared_ptr< GuidanceType > guidance )
+{
+    AerodynamicGuidanceFunctions guidanceFunctions;
+    guidanceFunctions.angleOfAttackFunction = [ guidance ]( )
+    {
+        return guidance->GuidanceType::getCurrentAngleOfAttack( );
+    };
+    guidanceFunctions.angleOfSideslipFunction = [ guidance ]( )
+    {
+        return guidance->GuidanceType::getCurrentAngleOfSideslip( );
+    };
+    guidanceFunctions.bankAngleFunction = [ guidance ]( )
+    {
+        return guidance->GuidanceType::getCurrentBankAngle( );
+    };
+    guidanceFunctions.angleUpdateFunction = [ guidance ]( const double currentTime )
+    {
+        guidance->GuidanceType::updateGuidance( currentTime );
+    };
+    return guidanceFunctions;
+}
+
+//! Set the aerodynamic angle functions of a body from an aerodynamic guidance object, with the guidance called directly.
+/*!
+ *  Set the aerodynamic angle functions of a body from an aerodynamic guidance object (replaces setGuidanceAnglesFunctions,
+ *  using the functions of createAerodynamicGuidanceFunctions). The flight conditions of the body must have been created
+ *  (i.e. the acceleration models must have been created) before calling this function.
+ *  \param guidance Aerodynamic guidance object (derived from AerodynamicGuidance)
+ *  \param body Body for which the aerodynamic angles are to be set by the guidance
+ */
+template< typename GuidanceType >
+void setInlinedGuidanceAnglesFunctions( const std::shared_ptr< GuidanceType > guidance,
+                                        const std::shared_ptr< tudat::simulation_setup::Body > body )
+{
+    if( body->getFlightConditions( ) == nullptr )
+    {
+        throw std::runtime_error( "Error when setting guidance angle functions, body has no flight conditions" );
+    }
+
+    AerodynamicGuidanceFunctions guidanceFunctions = createAerodynamicGuidanceFunctions( guidance );
+    body->getFlightConditions( )->getAerodynamicAngleCalculator( )->setOrientationAngleFunctions(
+                guidanceFunctions.angleOfAttackFunction, guidanceFunctions.angleOfSideslipFunction,
+                guidanceFunctions.bankAngleFunction, guidanceFunctions.angleUpdateFunction );
+}
+
+//! Compute the average wall-clock time (in nanoseconds) per call of a function of time.
+/*!
+ *  Compute the average wall-clock time (in nanoseconds) per call of a function of time, called at equispaced times (so that
+ *  the result cannot be reused between calls). Used to compare the cost of calling guidance through different adapters.
+ *  \param function Function to call, as function( time )
+ *  \param numberOfCalls Number of calls
+ *  \param initialTime Time of the first call
+ *  \param timeStep Difference in time between subsequent calls
+ *  \return Average time per call, in nanoseconds
+ */
+template< typename FunctionType >
+double computeAverageCallTime( const FunctionType& function, const int numberOfCalls, const double initialTime,
+                               const double timeStep )
+{
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now( );
+    for( int i = 0; i < numberOfCalls; i++ )
+    {
+        function( initialTime + static_cast< double >( i ) * timeStep );
+    }
+    return std::chrono::duration< double, std::nano >( std::chrono::steady_clock::now( ) - startTime ).count( ) /
+            static_cast< double >( numberOfCalls );
+}
+
+}
+
+#endif // TUDAT_GUIDANCEADAPTERS_H
@@ -0,0 +1,451 @@
+#ifndef TUDAT_KDTREE_H
+#define TUDAT_KDTREE_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Core>
+
+namespace tudat_applications
+{
+
+//! Static k-d tree for nearest-neighbour and range queries on a set of points in contiguous (external) storage.
+/*!
+ *  Static k-d tree for nearest-neighbour and range queries on a set of points in contiguous (external) storage. The tree is
+ *  stored implicitly, as a permutation of the point indices: the node of a range [begin, end) of the permutation is the point
+ *  at its middle, and its children are the ranges before and after the middle. Per node, only the splitting dimension is
+ *  stored. Since the tree contains no pointers, it can be written to, and used directly from, a (memory-mapped) file.
+ *
+ *  Distances are weighted Euclidean distances, so that points can be used in their original units while the search is
+ *  performed in a normalized space. Optionally, a value can be associated with each point (e.g. a cost function), in which
+ *  case the minimum value in each subtree is stored, which is used to efficiently find the lowest value in a region.
+ *
+ *  The points (and index arrays) are not copied, and must remain valid for the lifetime of the tree.
+ */
+class KdTree
+{
+public:
+
+    //! Constructor, builds the tree for a given set of points.
+    /*!
+     *  Constructor, builds the tree for a given set of points.
+     *  \param points Pointer to the first point (coordinates of each point contiguous in memory)
+     *  \param numberOfPoints Number of points
+     *  \param dimension Number of coordinates per point
+     *  \param pointStride Distance (in doubles) between the start of two consecutive points
+     *  \param weights Weights of each coordinate in the distance (equal to one if empty)
+     *  \param values Pointer to the value associated with the first point (nullptr if no values are used)
+     *  \param valueStride Distance (in doubles) between the values of two consecutive points
+     */
+    KdTree( const double* points, const int numberOfPoints, const int dimension, const int pointStride,
+            const Eigen::VectorXd& weights = Eigen::VectorXd( ),
+            const double* values = nullptr, const int valueStride = 1 ):
+        points_( points ), numberOfPoints_( numberOfPoints ), dimension_( dimension ), pointStride_( pointStride ),
+        values_( values ), valueStride_( valueStride )
+    {
+        setWeights( weights );
+
+        permutationBuffer_.resize( numberOfPoints_ );
+        splitDimensionBuffer_.resize( numberOfPoints_ );
+        for( int i = 0; i < numberOfPoints_; i++ )
+        {
+            permutationBuffer_[ i ] = i;
+        }
+        buildSubtree( 0, numberOfPoints_ );
+
+        permutation_ = permutationBuffer_.data( );
+        splitDimensions_ = splitDimensionBuffer_.data( );
+
+        if( values_ != nullptr )
+        {
+            subtreeMinimumBuffer_.resize( numberOfPoints_ );
+            computeSubtreeMinimum( 0, numberOfPoints_ );
+            subtreeMinimumValues_ = subtreeMinimumBuffer_.data( );
+        }
+        else
+        {
+            subtreeMinimumValues_ = nullptr;
+        }
+    }
+
+    //! Constructor, for a tree of which the index arrays have been previously computed (e.g. read from a mapped file).
+    /*!
+     *  Constructor, for a tree of which the index arrays have been previously computed (e.g. read from a mapped file).
+     *  \param points Pointer to the first point (coordinates of each point contiguous in memory)
+     *  \param numberOfPoints Number of points
+     *  \param dimension Number of coordinates per point
+     *  \param pointStride Distance (in doubles) between the start of two consecutive points
+     *  \param weights Weights of each coordinate in the distance (equal to one if empty)
+     *  \param permutation Permutation of the point indices defining the tree (see getPermutation)
+     *  \param splitDimensions Splitting dimension of each node (see getSplitDimensions)
+     *  \param values Pointer to the value associated with the first point (nullptr if no values are used)
+     *  \param valueStride Distance (in doubles) between the values of two consecutive points
+     *  \param subtreeMinimumValues Minimum value in the subtree of each node (see getSubtreeMinimumValues)
+     */
+    KdTree( const double* points, const int numberOfPoints, const int dimension, const int pointStride,
+            const Eigen::VectorXd& weights, const int* permutation, const int* splitDimensions,
+            const double* values = nullptr, const int valueStride = 1, const double* subtreeMinimumValues = nullptr ):
+        points_( points ), numberOfPoints_( numberOfPoints ), dimension_( dimension ), pointStride_( pointStride ),
+        values_( values ), valueStride_( valueStride ), permutation_( permutation ), splitDimensions_( splitDimensions ),
+        subtreeMinimumValues_( subtreeMinimumValues )
+    {
+        setWeights( weights );
+        if( ( values_ == nullptr ) != ( subtreeMinimumValues_ == nullptr ) )
+        {
+            throw std::runtime_error( "Error when creating k-d tree, values and subtree minima must be provided together" );
+        }
+    }
+
+    //! Copying is disabled, since the index arrays may refer to storage owned by the tree.
+    KdTree( const KdTree& ) = delete;
+
+    //! Assignment is disabled, since the index arrays may refer to storage owned by the tree.
+    KdTree& operator=( const KdTree& ) = delete;
+
+    //! Find the indices of the k nearest points to a query point (sorted by increasing distance).
+    std::vector< int > findNearestNeighbours( const Eigen::VectorXd& queryPoint, const int numberOfNeighbours ) const
+    {
+        checkDimension( queryPoint );
+
+        std::priority_queue< std::pair< double, int > > nearestPoints;
+        if( numberOfNeighbours > 0 )
+        {
+            searchNearestNeighbours( 0, numberOfPoints_, queryPoint, numberOfNeighbours, nearestPoints );
+        }
+
+        std::vector< int > nearestIndices( nearestPoints.size( ) );
+        for( int i = static_cast< int >( nearestIndices.size( ) ) - 1; i >= 0; i-- )
+        {
+            nearestIndices[ i ] = nearestPoints.top( ).second;
+            nearestPoints.pop( );
+        }
+        return nearestIndices;
+    }
+
+    //! Find the indices of all points inside an axis-aligned box (bounds inclusive).
+    std::vector< int > findPointsInBox( const Eigen::VectorXd& lowerBounds, const Eigen::VectorXd& upperBounds ) const
+    {
+        checkDimension( lowerBounds );
+        checkDimension( upperBounds );
+
+        std::vector< int > pointIndices;
+        searchBox( 0, numberOfPoints_, lowerBounds, upperBounds, pointIndices );
+        return pointIndices;
+    }
+
+    //! Find the index of the point with the lowest value inside an axis-aligned box (-1 if no valid point is found).
+    int findMinimumValueInBox( const Eigen::VectorXd& lowerBounds, const Eigen::VectorXd& upperBounds ) const
+    {
+        checkDimension( lowerBounds );
+        checkDimension( upperBounds );
+        if( values_ == nullptr )
+        {
+            throw std::runtime_error( "Error in k-d tree, no values are associated with the points" );
+        }
+
+        int bestIndex = -1;
+        double bestValue = std::numeric_limits< double >::infinity( );
+        searchMinimumInBox( 0, numberOfPoints_, lowerBounds, upperBounds, bestIndex, bestValue );
+        return bestIndex;
+    }
+
+    //! Get the number of points in the tree.
+    int getNumberOfPoints( ) const
+    {
+        return numberOfPoints_;
+    }
+
+    //! Get the permutation of the point indices defining the tree (numberOfPoints entries).
+    const int* getPermutation( ) const
+    {
+        return permutation_;
+    }
+
+    //! Get the splitting dimension of each node (numberOfPoints entries).
+    const int* getSplitDimensions( ) const
+    {
+        return splitDimensions_;
+    }
+
+    //! Get the minimum value in the subtree of each node (numberOfPoints entries; nullptr if no values are used).
+    const double* getSubtreeMinimumValues( ) const
+    {
+        return subtreeMinimumValues_;
+    }
+
+private:
+
+    //! Set the coordinate weights (unit weights if empty).
+    void setWeights( const Eigen::VectorXd& weights )
+    {
+        if( weights.rows( ) == 0 )
+        {
+            weights_ = Eigen::VectorXd::Ones( dimension_ );
+        }
+        else if( weights.rows( ) == dimension_ )
+        {
+            weights_ = weights;
+        }
+        else
+        {
+            throw std::runtime_error( "Error when creating k-d tree, weights are inconsistent with dimension" );
+        }
+    }
+
+    //! Check the size of a query vector.
+    void checkDimension( const Eigen::VectorXd& vector ) const
+    {
+        if( vector.rows( ) != dimension_ )
+        {
+            throw std::runtime_error( "Error in k-d tree query, input is inconsistent with dimension" );
+        }
+    }
+
+    //! Get a coordinate of a point.
+    double getCoordinate( const int pointIndex, const int coordinateIndex ) const
+    {
+        return points_[ static_cast< long >( pointIndex ) * pointStride_ + coordinateIndex ];
+    }
+
+    //! Get the value associated with a point.
+    double getValue( const int pointIndex ) const
+    {
+        return values_[ static_cast< long >( pointIndex ) * valueStride_ ];
+    }
+
+    //! Compute the weighted squared distance between a point and a query point.
+    double computeSquaredDistance( const int pointIndex, const Eigen::VectorXd& queryPoint ) const
+    {
+        double squaredDistance = 0.0;
+        for( int i = 0; i < dimension_; i++ )
+        {
+            double difference = getCoordinate( pointIndex, i ) - queryPoint( i );
+            squaredDistance += weights_( i ) * difference * difference;
+        }
+        return squaredDistance;
+    }
+
+    //! Build the subtree of the range [begin, end) of the permutation, splitting along the dimension of largest extent.
+    void buildSubtree( const int begin, const int end )
+    {
+        if( end - begin < 1 )
+        {
+            return;
+        }
+        const int middle = begin + ( end - begin ) / 2;
+
+        // Determine dimension with largest (weighted) extent
+        int splitDimension = 0;
+        double largestExtent = -1.0;
+        for( int j = 0; j < dimension_; j++ )
+        {
+            double minimum = std::numeric_limits< double >::infinity( );
+            double maximum = -std::numeric_limits< double >::infinity( );
+            for( int i = begin; i < end; i++ )
+            {
+                minimum = std::min( minimum, getCoordinate( permutationBuffer_[ i ], j ) );
+                maximum = std::max( maximum, getCoordinate( permutationBuffer_[ i ], j ) );
+            }
+            double extent = ( maximum - minimum ) * std::sqrt( weights_( j ) );
+            if( extent > largestExtent )
+            {
+                largestExtent = extent;
+                splitDimension = j;
+            }
+        }
+
+        // Partition range around median along splitting dimension
+        std::nth_element( permutationBuffer_.begin( ) + begin, permutationBuffer_.begin( ) + middle,
+                          permutationBuffer_.begin( ) + end, [ & ]( const int first, const int second )
+        {
+            return getCoordinate( first, splitDimension ) < getCoordinate( second, splitDimension );
+        } );
+        splitDimensionBuffer_[ middle ] = splitDimension;
+
+        buildSubtree( begin, middle );
+        buildSubtree( middle + 1, end );
+    }
+
+    //! Compute the minimum value in the subtree of the range [begin, end) of the permutation.
+    double computeSubtreeMinimum( const int begin, const int end )
+    {
+        if( end - begin < 1 )
+        {
+            return std::numeric_limits< double >::infinity( );
+        }
+        const int middle = begin + ( end - begin ) / 2;
+
+        // Values that are NaN (e.g. invalid evaluations) are never selected as minimum
+        double minimumValue = getValue( permutationBuffer_[ middle ] );
+        if( !( minimumValue == minimumValue ) )
+        {
+            minimumValue = std::numeric_limits< double >::infinity( );
+        }
+        minimumValue = std::min( minimumValue, computeSubtreeMinimum( begin, middle ) );
+        minimumValue = std::min( minimumValue, computeSubtreeMinimum( middle + 1, end ) );
+        subtreeMinimumBuffer_[ middle ] = minimumValue;
+        return minimumValue;
+    }
+
+    //! Recursively search the k nearest neighbours in the subtree of the range [begin, end) of the permutation.
+    void searchNearestNeighbours( const int begin, const int end, const Eigen::VectorXd& queryPoint,
+                                  const int numberOfNeighbours,
+                                  std::priority_queue< std::pair< double, int > >& nearestPoints ) const
+    {
+        if( end - begin < 1 )
+        {
+            return;
+        }
+        const int middle = begin + ( end - begin ) / 2;
+        const int pointIndex = permutation_[ middle ];
+        const int splitDimension = splitDimensions_[ middle ];
+
+        double squaredDistance = computeSquaredDistance( pointIndex, queryPoint );
+        if( static_cast< int >( nearestPoints.size( ) ) < numberOfNeighbours )
+        {
+            nearestPoints.push( std::make_pair( squaredDistance, pointIndex ) );
+        }
+        else if( squaredDistance < nearestPoints.top( ).first )
+        {
+            nearestPoints.pop( );
+            nearestPoints.push( std::make_pair( squaredDistance, pointIndex ) );
+        }
+
+        // Search side of splitting plane containing query point first, and other side only if it can contain closer points
+        double splitDifference = queryPoint( splitDimension ) - getCoordinate( pointIndex, splitDimension );
+        bool isQueryOnLeftSide = ( splitDifference < 0.0 );
+        searchNearestNeighbours( isQueryOnLeftSide ? begin : middle + 1, isQueryOnLeftSide ? middle : end,
+                                 queryPoint, numberOfNeighbours, nearestPoints );
+        if( static_cast< int >( nearestPoints.size( ) ) < numberOfNeighbours ||
+                weights_( splitDimension ) * splitDifference * splitDifference < nearestPoints.top( ).first )
+        {
+            searchNearestNeighbours( isQueryOnLeftSide ? middle + 1 : begin, isQueryOnLeftSide ? end : middle,
+                                     queryPoint, numberOfNeighbours, nearestPoints );
+        }
+    }
+
+    //! Check whether a point is inside an axis-aligned box.
+    bool isPointInBox( const int pointIndex, const Eigen::VectorXd& lowerBounds, const Eigen::VectorXd& upperBounds ) const
+    {
+        for( int i = 0; i < dimension_; i++ )
+        {
+            double coordinate = getCoordinate( pointIndex, i );
+            if( coordinate < lowerBounds( i ) || coordinate > upperBounds( i ) )
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    //! Recursively search the points inside an axis-aligned box, in the subtree of the range [begin, end).
+    void searchBox( const int begin, const int end, const Eigen::VectorXd& lowerBounds, const Eigen::VectorXd& upperBounds,
+                    std::vector< int >& pointIndices ) const
+    {
+        if( end - begin < 1 )
+        {
+            return;
+        }
+        const int middle = begin + ( end - begin ) / 2;
+        const int pointIndex = permutation_[ middle ];
+        const int splitDimension = splitDimensions_[ middle ];
+        const double splitValue = getCoordinate( pointIndex, splitDimension );
+
+        if( isPointInBox( pointIndex, lowerBounds, upperBounds ) )
+        {
+            pointIndices.push_back( pointIndex );
+        }
+        if( lowerBounds( splitDimension ) <= splitValue )
+        {
+            searchBox( begin, middle, lowerBounds, upperBounds, pointIndices );
+        }
+        if( upperBounds( splitDimension ) >= splitValue )
+        {
+            searchBox( middle + 1, end, lowerBounds, upperBounds, pointIndices );
+        }
+    }
+
+    //! Recursively search the lowest value inside an axis-aligned box, in the subtree of the range [begin, end).
+    void searchMinimumInBox( const int begin, const int end,
+                             const Eigen::VectorXd& lowerBounds, const Eigen::VectorXd& upperBounds,
+                             int& bestIndex, double& bestValue ) const
+    {
+        if( end - begin < 1 )
+        {
+            return;
+        }
+        const int middle = begin + ( end - begin ) / 2;
+
+        // Skip subtree if it cannot contain a lower value
+        if( !( subtreeMinimumValues_[ middle ] < bestValue ) )
+        {
+            return;
+        }
+
+        const int pointIndex = permutation_[ middle ];
+        const int splitDimension = splitDimensions_[ middle ];
+        const double splitValue = getCoordinate( pointIndex, splitDimension );
+
+        if( getValue( pointIndex ) < bestValue && isPointInBox( pointIndex, lowerBounds, upperBounds ) )
+        {
+            bestValue = getValue( pointIndex );
+            bestIndex = pointIndex;
+        }
+        if( lowerBounds( splitDimension ) <= splitValue )
+        {
+            searchMinimumInBox( begin, middle, lowerBounds, upperBounds, bestIndex, bestValue );
+        }
+        if( upperBounds( splitDimension ) >= splitValue )
+        {
+            searchMinimumInBox( middle + 1, end, lowerBounds, upperBounds, bestIndex, bestValue );
+        }
+    }
+
+    //! Pointer to first point.
+    const double* points_;
+
+    //! Number of points.
+    int numberOfPoints_;
+
+    //! Number of coordinates per point.
+    int dimension_;
+
+    //! Distance (in doubles) between the start of two consecutive points.
+    int pointStride_;
+
+    //! Weights of each coordinate in the distance.
+    Eigen::VectorXd weights_;
+
+    //! Pointer to value of first point (nullptr if no values are used).
+    const double* values_;
+
+    //! Distance (in doubles) between the values of two consecutive points.
+    int valueStride_;
+
+    //! Permutation of point indices defining the tree.
+    const int* permutation_;
+
+    //! Splitting dimension of each node.
+    const int* splitDimensions_;
+
+    //! Minimum value in the subtree of each node.
+    const double* subtreeMinimumValues_;
+
+    //! Storage of permutation (if built by this object).
+    std::vector< int > permutationBuffer_;
+
+    //! Storage of splitting dimensions (if built by this object).
+    std::vector< int > splitDimensionBuffer_;
+
+    //! Storage of subtree minimum values (if built by this object).
+    std::vector< double > subtreeMinimumBuffer_;
+};
+
+}
+
+#endif // TUDAT_KDTREE_H
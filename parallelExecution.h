@@ -0,0 +1,121 @@
+#ifndef TUDAT_PARALLELEXECUTION_H
+#define TUDAT_PARALLELEXECUTION_H
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tudat_applications
+{
+
+//! Get the default number of threads to use for parallel evaluations (number of hardware threads, at least 1).
+static inline int getDefaultNumberOfThreads( )
+{
+    int numberOfThreads = static_cast< int >( std::thread::hardware_concurrency( ) );
+    return ( numberOfThreads > 0 ) ? numberOfThreads : 1;
+}
+
+//! Evaluate a function for all indices in [0, numberOfIndices), distributed dynamically over a number of threads.
+/*!
+ *  Evaluate a function for all indices in [0, numberOfIndices), distributed dynamically over a number of threads. The function
+ *  is called as function( index, threadIndex ), where threadIndex is in [0, numberOfThreads). The thread index can be used to
+ *  access per-thread resources (e.g. body maps, which may not be shared between threads). Indices are handed out one at a
+ *  time, so that evaluations of strongly varying cost (such as propagations) are balanced over the threads. If any evaluation
+ *  throws an exception, the remaining indices are skipped, and the first exception is rethrown in the calling thread.
+ *  \param numberOfIndices Number of indices to evaluate
+ *  \param function Function to evaluate for each index
+ *  \param numberOfThreads Number of threads to use (if smaller than 1, the default number of threads is used)
+ */
+template< typename FunctionType >
+void parallelForEachIndex( const int numberOfIndices, const FunctionType& function, int numberOfThreads = 0 )
+{
+    if( numberOfThreads < 1 )
+    {
+        numberOfThreads = getDefaultNumberOfThreads( );
+    }
+    numberOfThreads = std::max( 1, std::min( numberOfThreads, numberOfIndices ) );
+
+    // Evaluate directly in calling thread if no concurrency is possible
+    if( numberOfThreads == 1 )
+    {
+        for( int i = 0; i < numberOfIndices; i++ )
+        {
+            function( i, 0 );
+        }
+        return;
+    }
+
+    std::atomic< int > nextIndex( 0 );
+    std::exception_ptr firstException;
+    std::mutex exceptionMutex;
+
+    auto threadFunction = [ & ]( const int threadIndex )
+    {
+        int currentIndex;
+        while( ( currentIndex = nextIndex++ ) < numberOfIndices )
+        {
+            try
+            {
+                function( currentIndex, threadIndex );
+            }
+            catch( ... )
+            {
+                std::lock_guard< std::mutex > lock( exceptionMutex );
+                if( !firstException )
+                {
+                    firstException = std::current_exception( );
+                }
+                nextIndex = numberOfIndices;
+            }
+        }
+    };
+
+    std::vector< std::thread > threads;
+    for( int i = 1; i < numberOfThreads; i++ )
+    {
+        threads.push_back( std::thread( threadFunction, i ) );
+    }
+    threadFunction( 0 );
+    for( unsigned int i = 0; i < threads.size( ); i++ )
+    {
+        threads.at( i ).join( );
+    }
+
+    if( firstException )
+    {
+        std::rethrow_exception( firstException );
+    }
+}
+
+//! Evaluate a function on contiguous blocks of the range [0, numberOfIndices), one block per thread.
+/*!
+ *  Evaluate a function on contiguous blocks of the range [0, numberOfIndices), one block per thread. The function is called as
+ *  function( startIndex, blockSize, threadIndex ). This is to be used for evaluations of (near-)uniform cost, in which each
+ *  thread processes a contiguous block of structure-of-arrays data.
+ *  \param numberOfIndices Number of indices in the range
+ *  \param function Function to evaluate for each block
+ *  \param numberOfThreads Number of threads (and blocks) to use (if smaller than 1, the default number of threads is used)
+ */
+template< typename FunctionType >
+void parallelForEachBlock( const int numberOfIndices, const FunctionType& function, int numberOfThreads = 0 )
+{
+    if( numberOfThreads < 1 )
+    {
+        numberOfThreads = getDefaultNumberOfThreads( );
+    }
+    numberOfThreads = std::max( 1, std::min( numberOfThreads, numberOfIndices ) );
+
+    parallelForEachIndex( numberOfThreads, [ & ]( const int blockIndex, const int threadIndex )
+    {
+        int startIndex = ( blockIndex * numberOfIndices ) / numberOfThreads;
+        int endIndex = ( ( blockIndex + 1 ) * numberOfIndices ) / numberOfThreads;
+        function( startIndex, endIndex - startIndex, threadIndex );
+    }, numberOfThreads );
+}
+
+}
+
+#endif // TUDAT_PARALLELEXECUTION_H
@@ -0,0 +1,116 @@
+#ifndef TUDAT_PARAREALINTEGRATION_H
+#define TUDAT_PARAREALINTEGRATION_H
+
+#include <stdexcept>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "parallelExecution.h"
+
+namespace tudat_applications
+{
+
+//! Propagate a state over a number of consecutive time slices with the Parareal (parallel-in-time) algorithm.
+/*!
+ *  Propagate a state over a number of consecutive time slices with the Parareal (parallel-in-time) algorithm. A cheap coarse
+ *  propagator G is used to (serially) obtain an initial guess of the state at the start of each slice, after which the
+ *  expensive fine propagator F is run concurrently on all slices. The slice initial states are then updated serially with the
+ *  Parareal correction U_{n+1} = G( U_n^new ) + F( U_n^old ) - G( U_n^old ), and the procedure is repeated until the change in
+ *  all slice initial states is within the tolerance. After iteration k, the first k slices are exact (identical to a serial
+ *  fine propagation), so that the algorithm terminates after at most numberOfSlices iterations; slices that are already exact
+ *  are not propagated again. The speed-up w.r.t. a serial fine propagation is roughly numberOfSlices / numberOfIterations.
+ *
+ *  The coarse propagator is called as coarsePropagator( sliceIndex, sliceInitialState ), the fine propagator as
+ *  finePropagator( sliceIndex, sliceInitialState, threadIndex ), both returning the state at the end of the slice. The fine
+ *  propagator is called concurrently, and should use the thread index to access per-thread resources (e.g. body maps); the
+ *  last call for a given slice index is made from the final slice initial state to within the tolerance, so that the fine
+ *  propagator may store its (dense) results per slice. The coarse propagator is only called from the calling thread.
+ *  \param numberOfSlices Number of time slices
+ *  \param initialState State at the start of the first slice
+ *  \param coarsePropagator Coarse propagator
+ *  \param finePropagator Fine propagator
+ *  \param convergenceTolerances Tolerance on the absolute change in each element of the slice initial states
+ *  \param numberOfIterations Number of Parareal iterations that were performed, returned by reference
+ *  \param maximumNumberOfIterations Maximum number of iterations (if smaller than 1, or larger than the number of slices, the
+ *  number of slices is used, in which case the result is always converged)
+ *  \param numberOfThreads Number of threads to use (if smaller than 1, the default number of threads is used)
+ *  \return States at the start of each slice, and at the end of the last slice (size numberOfSlices + 1)
+ */
+template< typename CoarsePropagatorType, typename FinePropagatorType >
+std::vector< Eigen::VectorXd > propagateWithParareal(
+        const int numberOfSlices,
+        const Eigen::VectorXd& initialState,
+        const CoarsePropagatorType& coarsePropagator,
+        const FinePropagatorType& finePropagator,
+        const Eigen::VectorXd& convergenceTolerances,
+        int& numberOfIterations,
+        int maximumNumberOfIterations = 0,
+        const int numberOfThreads = 0 )
+{
+    if( numberOfSlices < 1 )
+    {
+        throw std::runtime_error( "Error in Parareal propagation, number of slices must be positive" );
+    }
+    if( convergenceTolerances.rows( ) != initialState.rows( ) )
+    {
+        throw std::runtime_error( "Error in Parareal propagation, inconsistent size of convergence tolerances" );
+    }
+    if( maximumNumberOfIterations < 1 || maximumNumberOfIterations > numberOfSlices )
+    {
+        maximumNumberOfIterations = numberOfSlices;
+    }
+
+    // Compute initial guess of slice initial states with coarse propagator
+    std::vector< Eigen::VectorXd > sliceStates( numberOfSlices + 1 );
+    std::vector< Eigen::VectorXd > coarseFinalStates( numberOfSlices );
+    std::vector< Eigen::VectorXd > fineFinalStates( numberOfSlices );
+    sliceStates[ 0 ] = initialState;
+    for( int i = 0; i < numberOfSlices; i++ )
+    {
+        coarseFinalStates[ i ] = coarsePropagator( i, sliceStates[ i ] );
+        sliceStates[ i + 1 ] = coarseFinalStates[ i ];
+    }
+
+    int firstInexactSlice = 0;
+    numberOfIterations = 0;
+    bool isConverged = false;
+    while( !isConverged && numberOfIterations < maximumNumberOfIterations )
+    {
+        // Run fine propagator concurrently on all slices for which the initial state is not yet exact
+        parallelForEachIndex( numberOfSlices - firstInexactSlice, [ & ]( const int index, const int threadIndex )
+        {
+            const int sliceIndex = firstInexactSlice + index;
+            fineFinalStates[ sliceIndex ] = finePropagator( sliceIndex, sliceStates[ sliceIndex ], threadIndex );
+        }, numberOfThreads );
+
+        // Apply Parareal correction to initial states of subsequent slices (first of which becomes exact)
+        isConverged = true;
+        for( int i = firstInexactSlice; i < numberOfSlices; i++ )
+        {
+            Eigen::VectorXd correctedState = fineFinalStates[ i ];
+            if( i > firstInexactSlice )
+            {
+                const Eigen::VectorXd newCoarseFinalState = coarsePropagator( i, sliceStates[ i ] );
+                correctedState += newCoarseFinalState - coarseFinalStates[ i ];
+                coarseFinalStates[ i ] = newCoarseFinalState;
+            }
+
+            if( !( ( correctedState - sliceStates[ i + 1 ] ).cwiseAbs( ).array( ) <=
+                   convergenceTolerances.array( ) ).all( ) )
+            {
+                isConverged = false;
+            }
+            sliceStates[ i + 1 ] = correctedState;
+        }
+
+        firstInexactSlice++;
+        numberOfIterations++;
+    }
+
+    return sliceStates;
+}
+
+}
+
+#endif // TUDAT_PARAREALINTEGRATION_H
@@ -0,0 +1,207 @@
+#ifndef TUDAT_SUNDMANPROPAGATION_H
+#define TUDAT_SUNDMANPROPAGATION_H
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+#include <Eigen/Core>
+
+namespace tudat_applications
+{
+
+//! Point mass gravity field of a central body and a set of perturbing bodies, for use in regularized propagation.
+/*!
+ *  Point mass gravity field of a central body and a set of perturbing bodies, for use in regularized propagation. The
+ *  acceleration is computed w.r.t. the (possibly accelerated) central body: the perturbing bodies act as third bodies,
+ *  including the indirect term due to the acceleration of the central body, as in the Cowell propagator of Tudat. In addition,
+ *  the distance to the nearest massive body is computed, scaled to the central body: the distance to each perturbing body is
+ *  multiplied by ( mu_central / mu_body )^(1/3), so that equal scaled distances correspond to equal orbital time scales.
+ */
+class PointMassGravityModel
+{
+public:
+
+    //! Constructor.
+    /*!
+     *  Constructor.
+     *  \param centralBodyGravitationalParameter Gravitational parameter of central body
+     *  \param perturbingBodyPositionFunctions Functions returning the position of each perturbing body w.r.t. the central body,
+     *  as a function of time
+     *  \param perturbingBodyGravitationalParameters Gravitational parameters of perturbing bodies
+     */
+    PointMassGravityModel( const double centralBodyGravitationalParameter,
+                           const std::vector< std::function< Eigen::Vector3d( const double ) > >&
+                           perturbingBodyPositionFunctions,
+                           const std::vector< double >& perturbingBodyGravitationalParameters ):
+        centralBodyGravitationalParameter_( centralBodyGravitationalParameter ),
+        perturbingBodyPositionFunctions_( perturbingBodyPositionFunctions ),
+        perturbingBodyGravitationalParameters_( perturbingBodyGravitationalParameters )
+    {
+        if( perturbingBodyPositionFunctions.size( ) != perturbingBodyGravitationalParameters.size( ) )
+        {
+            throw std::runtime_error( "Error when creating point mass gravity model, inconsistent perturbing body input" );
+        }
+
+        for( unsigned int i = 0; i < perturbingBodyGravitationalParameters.size( ); i++ )
+        {
+            distanceScalingFactors_.push_back( std::cbrt( centralBodyGravitationalParameter /
+                                                          perturbingBodyGravitationalParameters.at( i ) ) );
+        }
+    }
+
+    //! Compute the acceleration, and the scaled distance to the nearest massive body, at a given time and position.
+    void computeAccelerationAndScaledDistance( const double time, const Eigen::Vector3d& position,
+                                               Eigen::Vector3d& acceleration, double& scaledDistance ) const
+    {
+        double distance = position.norm( );
+        acceleration = -centralBodyGravitationalParameter_ / ( distance * distance * distance ) * position;
+        scaledDistance = distance;
+
+        for( unsigned int i = 0; i < perturbingBodyPositionFunctions_.size( ); i++ )
+        {
+            Eigen::Vector3d bodyPosition = perturbingBodyPositionFunctions_.at( i )( time );
+            Eigen::Vector3d relativePosition = position - bodyPosition;
+            double relativeDistance = relativePosition.norm( );
+            double bodyDistance = bodyPosition.norm( );
+            acceleration -= perturbingBodyGravitationalParameters_.at( i ) *
+                    ( relativePosition / ( relativeDistance * relativeDistance * relativeDistance ) +
+                      bodyPosition / ( bodyDistance * bodyDistance * bodyDistance ) );
+            scaledDistance = std::min( scaledDistance, relativeDistance * distanceScalingFactors_.at( i ) );
+        }
+    }
+
+private:
+
+    //! Gravitational parameter of central body.
+    double centralBodyGravitationalParameter_;
+
+    //! Functions returning the position of each perturbing body w.r.t. the central body.
+    std::vector< std::function< Eigen::Vector3d( const double ) > > perturbingBodyPositionFunctions_;
+
+    //! Gravitational parameters of perturbing bodies.
+    std::vector< double > perturbingBodyGravitationalParameters_;
+
+    //! Factors with which the distance to each perturbing body is scaled.
+    std::vector< double > distanceScalingFactors_;
+};
+
+//! Propagate a Cartesian state with a fixed-step RK4 integrator in Sundman-regularized time.
+/*!
+ *  Propagate a Cartesian state with a fixed-step RK4 integrator in Sundman-regularized time. The independent variable s is
+ *  related to physical time by dt/ds = ( r / r_ref )^alpha, with r the (scaled) distance to the nearest massive body, so that
+ *  uniform steps in s are large in cruise and automatically shrink near periapsis (alpha = 1 is the classical Sundman
+ *  transformation; alpha = 1.5 gives steps proportional to the local orbital time scale). Physical time is integrated along
+ *  with the state, and the final step is adjusted (by secant iterations on its length) such that the propagation terminates
+ *  exactly at the final time. The output is given as a function of physical time.
+ *  \param gravityModel Gravity model used to compute the accelerations and regularizing distance
+ *  \param initialTime Initial (physical) time
+ *  \param initialState Initial Cartesian state, w.r.t. central body of gravity model
+ *  \param finalTime Final (physical) time (propagation is performed backwards if smaller than initial time)
+ *  \param referenceDistance Distance r_ref at which a regularized step corresponds to an equal physical time step
+ *  \param regularizedStepSize Step size in regularized time (physical step size at the reference distance)
+ *  \param regularizationExponent Exponent alpha of the regularization
+ *  \param maximumNumberOfSteps Maximum number of steps, after which an exception is thrown
+ *  \return State history, as a function of physical time
+ */
+static inline std::map< double, Eigen::Matrix< double, 6, 1 > > propagateWithSundmanRegularization(
+        const PointMassGravityModel& gravityModel,
+        const double initialTime,
+        const Eigen::Matrix< double, 6, 1 >& initialState,
+        const double finalTime,
+        const double referenceDistance,
+        const double regularizedStepSize,
+        const double regularizationExponent = 1.0,
+        const int maximumNumberOfSteps = 10000000 )
+{
+    typedef Eigen::Matrix< double, 7, 1 > ExtendedState;
+
+    // Compute derivative of state and physical time w.r.t. regularized time
+    auto computeRegularizedDerivative = [ & ]( const ExtendedState& extendedState )
+    {
+        Eigen::Vector3d acceleration;
+        double scaledDistance;
+        gravityModel.computeAccelerationAndScaledDistance(
+                    extendedState( 6 ), extendedState.segment( 0, 3 ), acceleration, scaledDistance );
+        const double timeDerivative = std::pow( scaledDistance / referenceDistance, regularizationExponent );
+
+        ExtendedState derivative;
+        derivative.segment( 0, 3 ) = timeDerivative * extendedState.segment( 3, 3 );
+        derivative.segment( 3, 3 ) = timeDerivative * acceleration;
+        derivative( 6 ) = timeDerivative;
+        return derivative;
+    };
+
+    // Perform single RK4 step in regularized time
+    auto performStep = [ & ]( const ExtendedState& extendedState, const double stepSize )
+    {
+        const ExtendedState k1 = computeRegularizedDerivative( extendedState );
+        const ExtendedState k2 = computeRegularizedDerivative( extendedState + stepSize / 2.0 * k1 );
+        const ExtendedState k3 = computeRegularizedDerivative( extendedState + stepSize / 2.0 * k2 );
+        const ExtendedState k4 = computeRegularizedDerivative( extendedState + stepSize * k3 );
+        return ExtendedState( extendedState + stepSize / 6.0 * ( k1 + 2.0 * k2 + 2.0 * k3 + k4 ) );
+    };
+
+    if( !( regularizedStepSize > 0.0 ) || !( referenceDistance > 0.0 ) )
+    {
+        throw std::runtime_error( "Error in regularized propagation, step size and reference distance must be positive" );
+    }
+    const double propagationDirection = ( finalTime >= initialTime ) ? 1.0 : -1.0;
+    const double stepSize = propagationDirection * regularizedStepSize;
+
+    ExtendedState currentState;
+    currentState.segment( 0, 6 ) = initialState;
+    currentState( 6 ) = initialTime;
+
+    std::map< double, Eigen::Matrix< double, 6, 1 > > stateHistory;
+    stateHistory[ initialTime ] = initialState;
+
+    int numberOfSteps = 0;
+    while( propagationDirection * ( finalTime - currentState( 6 ) ) > 0.0 )
+    {
+        if( numberOfSteps++ >= maximumNumberOfSteps )
+        {
+            throw std::runtime_error( "Error in regularized propagation, maximum number of steps exceeded" );
+        }
+
+        ExtendedState nextState = performStep( currentState, stepSize );
+
+        // Shorten final step, such that propagation terminates at final time
+        if( propagationDirection * ( nextState( 6 ) - finalTime ) > 0.0 )
+        {
+            double previousStepSize = 0.0;
+            double previousTimeError = currentState( 6 ) - finalTime;
+            double currentStepSize = stepSize;
+            double currentTimeError = nextState( 6 ) - finalTime;
+            const double timeTolerance = 1.0E-9 * std::fabs( finalTime - initialTime );
+            for( int i = 0; i < 20 && std::fabs( currentTimeError ) > timeTolerance; i++ )
+            {
+                const double newStepSize = currentStepSize - currentTimeError *
+                        ( currentStepSize - previousStepSize ) / ( currentTimeError - previousTimeError );
+                previousStepSize = currentStepSize;
+                previousTimeError = currentTimeError;
+                currentStepSize = newStepSize;
+                nextState = performStep( currentState, currentStepSize );
+                currentTimeError = nextState( 6 ) - finalTime;
+            }
+
+            // Only snap to final time if the remaining error is within tolerance (also fails for a NaN error)
+            if( !( std::fabs( currentTimeError ) <= timeTolerance ) )
+            {
+                throw std::runtime_error( "Error in regularized propagation, final step did not converge to final time" );
+            }
+            nextState( 6 ) = finalTime;
+        }
+
+        currentState = nextState;
+        stateHistory[ currentState( 6 ) ] = currentState.segment( 0, 6 );
+    }
+    return stateHistory;
+}
+
+}
+
+#endif // TUDAT_SUNDMANPROPAGATION_H